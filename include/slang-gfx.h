@@ -62,7 +62,8 @@ enum class StructType
     D3D12DeviceExtendedDesc,
     D3D12ExperimentalFeaturesDesc,
     SlangSessionExtendedDesc,
-    RayTracingValidationDesc
+    RayTracingValidationDesc,
+    CPUDeviceExtendedDesc
 };
 
 // TODO: Rename to Stage
@@ -2979,4 +2980,17 @@ struct RayTracingValidationDesc
     bool enableRaytracingValidation = false;
 };
 
+/// Options for the CPU device.
+struct CPUDeviceExtendedDesc
+{
+    StructType structType = StructType::CPUDeviceExtendedDesc;
+    /// Number of threads compute dispatches are run on, including the calling thread. 1, the
+    /// default, runs dispatches on the calling thread only, and 0 uses all hardware threads.
+    ///
+    /// With more than one thread, thread groups run concurrently, as they would on a GPU. Only
+    /// the `Interlocked` functions are atomic on the CPU, so plain writes from different groups
+    /// to the same location race.
+    uint32_t threadCount = 1;
+};
+
 } // namespace gfx
@@ -1041,6 +1041,25 @@ typedef uint32_t SlangSizeT;
         DenormalModeFp32,
         DenormalModeFp64,
 
+        ParallelCodeGen, // intValue0: number of threads to use for code generation
+
+        CompilationCachePath,          // stringValue0: directory of the compilation cache
+        CompilationCacheMaxEntryCount, // intValue0: max entries in the compilation cache
+
+        ReportPerfTrace, // stringValue0: file to write a Chrome trace of the compiler's profile to
+
+        LazyIRLoading, // bool: defer deserializing function bodies of loaded modules until linked
+
+        MemoryMapModules, // bool: read precompiled modules in place from memory mapped files
+
+        ParallelModuleLoading, // intValue0: number of threads to read imported module files on
+
+        ReclaimIRMemory, // bool: reuse the memory of deallocated IR and compact linked IR modules
+
+        SPIRVOptimizerCache, // bool: reuse the output of the SPIR-V optimizer for identical input
+
+        DownstreamCompileConcurrency, // intValue0: max downstream compilations run at once
+
         CountOf,
     };
 
@@ -1752,6 +1771,24 @@ public:                                                              \
     };
 #define SLANG_UUID_ISlangProfiler ISlangProfiler::getTypeGuid()
 
+    /** The profiled scopes of a compile as a trace of timed events.
+    Query this interface from an `ISlangProfiler`.
+    */
+    struct ISlangProfilerTrace : public ISlangUnknown
+    {
+        SLANG_COM_INTERFACE(
+            0x5e0d2f7b,
+            0x3a91,
+            0x4c6e,
+            {0xb2, 0x48, 0x1f, 0x9c, 0x6d, 0x73, 0xa0, 0x85})
+        /** Get the profiled scopes of all threads in the Chrome trace event JSON format, which
+        can be loaded in chrome://tracing or https://ui.perfetto.dev.
+        @param outBlob Receives the JSON text.
+        */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL getChromeTrace(ISlangBlob** outBlob) = 0;
+    };
+#define SLANG_UUID_ISlangProfilerTrace ISlangProfilerTrace::getTypeGuid()
+
     namespace slang
     {
     struct IGlobalSession;
@@ -4579,6 +4616,41 @@ struct IModulePrecompileService_Experimental : public ISlangUnknown
     #define SLANG_UUID_IModulePrecompileService_Experimental \
         IModulePrecompileService_Experimental::getTypeGuid()
 
+/* Experimental interface for querying the persistent compilation cache of a session.
+
+The cache is enabled by setting the `CompilationCachePath` compiler option when creating
+the session. When enabled, `IComponentType::getEntryPointCode` and `getTargetCode` look up
+their result in the cache (keyed by the same hash as `getEntryPointHash`) before generating
+any code, and store newly generated code in it.
+
+Query this interface from an `ISession`.
+*/
+struct ICompilationCacheService_Experimental : public ISlangUnknown
+{
+    SLANG_COM_INTERFACE(
+        0x3c8f1d2a,
+        0x6b7e,
+        0x4e51,
+        {0x9a, 0x0d, 0x52, 0xc7, 0x84, 0x1f, 0x3e, 0x96})
+
+    /// Get the number of cache hits and misses since the session was created (or the
+    /// statistics were last reset), and the number of entries currently in the cache.
+    /// Returns SLANG_E_NOT_AVAILABLE if the session doesn't have a compilation cache.
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL getCacheStatistics(
+        SlangInt* outHitCount,
+        SlangInt* outMissCount,
+        SlangInt* outEntryCount) = 0;
+
+    /// Reset the hit and miss counts.
+    virtual SLANG_NO_THROW void SLANG_MCALL resetCacheStatistics() = 0;
+
+    /// Remove all entries from the cache.
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL clearCache() = 0;
+};
+
+    #define SLANG_UUID_ICompilationCacheService_Experimental \
+        ICompilationCacheService_Experimental::getTypeGuid()
+
 /** Argument used for specialization to types/values.
  */
 struct SpecializationArg
@@ -4753,6 +4825,17 @@ struct ByteCodeRunnerDesc
     /** The size of this structure, in bytes.
      */
     size_t structSize = sizeof(ByteCodeRunnerDesc);
+
+    /** Whether to pre-decode branch targets and fuse common instruction sequences when a
+        module is loaded.
+     */
+    bool enableOptimizations = true;
+
+    /** The number of times a function runs in the interpreter before it is compiled to native
+        code with slang-llvm, or 0 to never compile functions. Functions that can't be compiled,
+        and all functions if slang-llvm isn't available, keep running in the interpreter.
+     */
+    uint32_t jitInvocationThreshold = 0;
 };
 
 /// Represents a byte code runner that can execute Slang byte code.
@@ -4799,6 +4882,62 @@ public:
     setPrintCallback(VMPrintFunc callback, void* userData) = 0;
 };
 
+/// Executes the selected function of a byte code runner over a grid of groups on several
+/// threads. Query this interface from an `IByteCodeRunner`.
+class IByteCodeDispatchRunner : public ISlangUnknown
+{
+public:
+    // {9B42E6D0-1F58-4C3A-8D97-26E4A0B7C5F3}
+    SLANG_COM_INTERFACE(
+        0x9b42e6d0,
+        0x1f58,
+        0x4c3a,
+        {0x8d, 0x97, 0x26, 0xe4, 0xa0, 0xb7, 0xc5, 0xf3})
+
+    /// Execute the selected function once for each group of a grid of
+    /// `groupCount[0] * groupCount[1] * groupCount[2]` groups, spread over up to `threadCount`
+    /// threads, or over all hardware threads if `threadCount` is 0. The arguments are read from
+    /// `argumentData` as for `execute`, except that the first parameter of the function must be
+    /// a `uint3` that receives the ID of the group. External functions and the print callback
+    /// may be called from several threads at once.
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL dispatch(
+        const uint32_t groupCount[3],
+        const void* argumentData,
+        size_t argumentSize,
+        uint32_t threadCount) = 0;
+};
+
+/// Executes the selected function of a byte code runner for many invocations at once.
+/// Query this interface from an `IByteCodeRunner`.
+class IByteCodeBatchRunner : public ISlangUnknown
+{
+public:
+    // {3C8E5A21-7D4B-4F96-A0E3-5B19C2D86F47}
+    SLANG_COM_INTERFACE(
+        0x3c8e5a21,
+        0x7d4b,
+        0x4f96,
+        {0xa0, 0xe3, 0x5b, 0x19, 0xc2, 0xd8, 0x6f, 0x47})
+
+    /// Execute the selected function for `invocationCount` invocations, running them in
+    /// lockstep when the function allows it. The arguments of invocation `i` are read from
+    /// `argumentData + i * argumentStride`, and its return value is written to
+    /// `outReturnValues + i * returnValueSize` if `outReturnValues` isn't null.
+    ///
+    /// Invocations that run in lockstep execute each instruction for all of them before
+    /// moving on, so their loads and stores of memory outside of their own locals (such as
+    /// through pointers in the arguments) interleave, rather than happening one invocation
+    /// after another. Invocations that write memory that other invocations read or write
+    /// get unspecified results. Functions that call other functions, external functions or
+    /// print always run their invocations one after another.
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL executeBatch(
+        const void* argumentData,
+        size_t argumentSize,
+        size_t argumentStride,
+        uint32_t invocationCount,
+        void* outReturnValues) = 0;
+};
+
 } // namespace slang
 
 /// Create a byte code runner that can execute Slang byte code.
@@ -0,0 +1,34 @@
+#include "slang-compile-server-protocol.h"
+
+namespace CompileServerProtocol
+{
+
+static const StructRttiInfo _makeCompileArgsRtti()
+{
+    CompileArgs obj;
+    StructRttiBuilder builder(&obj, "CompileServerProtocol::CompileArgs", nullptr);
+    builder.addField("args", &obj.args);
+    builder.addField("workingDirectory", &obj.workingDirectory);
+    return builder.make();
+}
+/* static */ const StructRttiInfo CompileArgs::g_rttiInfo = _makeCompileArgsRtti();
+/* static */ const UnownedStringSlice CompileArgs::g_methodName =
+    UnownedStringSlice::fromLiteral("compile");
+
+static const StructRttiInfo _makeCompileResultRtti()
+{
+    CompileResult obj;
+    StructRttiBuilder builder(&obj, "CompileServerProtocol::CompileResult", nullptr);
+    builder.addField("stdOut", &obj.stdOut);
+    builder.addField("stdError", &obj.stdError);
+    builder.addField("result", &obj.result);
+    builder.addField("returnCode", &obj.returnCode);
+    builder.addField("reusedLinkage", &obj.reusedLinkage);
+    return builder.make();
+}
+/* static */ const StructRttiInfo CompileResult::g_rttiInfo = _makeCompileResultRtti();
+
+/* static */ const UnownedStringSlice QuitArgs::g_methodName =
+    UnownedStringSlice::fromLiteral("quit");
+
+} // namespace CompileServerProtocol
@@ -0,0 +1,43 @@
+#ifndef SLANG_COMPILER_CORE_COMPILE_SERVER_PROTOCOL_H
+#define SLANG_COMPILER_CORE_COMPILE_SERVER_PROTOCOL_H
+
+#include "../core/slang-rtti-info.h"
+#include "slang-com-helper.h"
+#include "slang-com-ptr.h"
+#include "slang-json-value.h"
+#include "slang.h"
+
+namespace CompileServerProtocol
+{
+
+using namespace Slang;
+
+/// Compile with a `slangc` command line, as if `slangc` was run in `workingDirectory`.
+struct CompileArgs
+{
+    List<String> args;       ///< The command line arguments, not including the executable name
+    String workingDirectory; ///< If empty the server's working directory is used
+
+    static const UnownedStringSlice g_methodName;
+    static const StructRttiInfo g_rttiInfo;
+};
+
+struct QuitArgs
+{
+    static const UnownedStringSlice g_methodName;
+};
+
+struct CompileResult
+{
+    String stdOut;
+    String stdError;
+    int32_t result = SLANG_OK;
+    int32_t returnCode = 0;     ///< As returned if invoked as command line
+    bool reusedLinkage = false; ///< True if modules loaded by an earlier compile were reused
+
+    static const StructRttiInfo g_rttiInfo;
+};
+
+} // namespace CompileServerProtocol
+
+#endif // SLANG_COMPILER_CORE_COMPILE_SERVER_PROTOCOL_H
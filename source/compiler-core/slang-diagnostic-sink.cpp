@@ -534,6 +534,7 @@ void DiagnosticSink::reset()
     m_internalErrorLocsNoted = 0;
 
     outputBuffer.clear();
+    m_deferredDiagnostics.clear();
 }
 
 
@@ -648,20 +649,37 @@ bool DiagnosticSink::diagnoseImpl(
     int argCount,
     DiagnosticArg const* args)
 {
+    if (m_isDeferred)
+    {
+        // The effective severity depends on state (such as `#pragma warning` tracking) that
+        // is only safe to consult when the diagnostic is replayed.
+        StringBuilder sb;
+        formatDiagnosticMessage(sb, info.messageFormat, argCount, args);
+        return _deferDiagnostic(pos, info, sb.produceString(), false);
+    }
+
     // Override the severity in the 'info' structure to pass it further into formatDiagnostics
     info.severity = getEffectiveMessageSeverity(info, pos);
 
     if (info.severity == Severity::Disable)
         return false;
 
+    StringBuilder sb;
+    formatDiagnosticMessage(sb, info.messageFormat, argCount, args);
+
+    return _diagnoseMessage(pos, info, sb.produceString());
+}
+
+bool DiagnosticSink::_diagnoseMessage(
+    SourceLoc const& pos,
+    DiagnosticInfo const& info,
+    const String& message)
+{
     StringBuilder messageBuilder;
     {
-        StringBuilder sb;
-        formatDiagnosticMessage(sb, info.messageFormat, argCount, args);
-
         Diagnostic diagnostic;
         diagnostic.ErrorID = info.id;
-        diagnostic.Message = sb.produceString();
+        diagnostic.Message = message;
         diagnostic.loc = pos;
         diagnostic.severity = info.severity;
 
@@ -672,6 +690,65 @@ bool DiagnosticSink::diagnoseImpl(
     return diagnoseImpl(info, messageBuilder.getUnownedSlice());
 }
 
+bool DiagnosticSink::_deferDiagnostic(
+    SourceLoc const& pos,
+    DiagnosticInfo const& info,
+    const String& message,
+    bool isRaw)
+{
+    DeferredDiagnostic deferred;
+    deferred.loc = pos;
+    deferred.info = info;
+    deferred.message = message;
+    deferred.flags = m_flags;
+    deferred.isRaw = isRaw;
+    m_deferredDiagnostics.add(deferred);
+
+    // We can only use the declared severity here. Any overrides are applied on replay.
+    if (info.severity >= Severity::Error)
+    {
+        m_errorCount++;
+    }
+
+    if (info.severity >= Severity::Fatal)
+    {
+        std::string abortMessage(message.begin(), message.end());
+        SLANG_ABORT_COMPILATION(abortMessage.c_str());
+    }
+    return true;
+}
+
+void DiagnosticSink::replayDeferredDiagnostics(DiagnosticSink* sink)
+{
+    // Take the recorded diagnostics first, as replaying a fatal diagnostic will abort.
+    List<DeferredDiagnostic> deferredDiagnostics = _Move(m_deferredDiagnostics);
+    m_deferredDiagnostics.clear();
+
+    const Flags sinkFlags = sink->getFlags();
+    for (const auto& deferred : deferredDiagnostics)
+    {
+        if (deferred.isRaw)
+        {
+            sink->diagnoseRaw(deferred.info.severity, deferred.message.getUnownedSlice());
+            continue;
+        }
+
+        DiagnosticInfo info = deferred.info;
+        info.severity = sink->getEffectiveMessageSeverity(info, deferred.loc);
+        if (info.severity == Severity::Disable)
+            continue;
+
+        // Display of the source line can be disabled per diagnostic (see
+        // `diagnoseWithoutSourceView`), so honor what was set when it was recorded.
+        if (!(deferred.flags & Flag::SourceLocationLine))
+            sink->resetFlag(Flag::SourceLocationLine);
+
+        sink->_diagnoseMessage(deferred.loc, info, deferred.message);
+
+        sink->setFlags(sinkFlags);
+    }
+}
+
 void DiagnosticSink::diagnoseRaw(Severity severity, char const* message)
 {
     return diagnoseRaw(severity, UnownedStringSlice(message));
@@ -679,6 +756,13 @@ void DiagnosticSink::diagnoseRaw(Severity severity, char const* message)
 
 void DiagnosticSink::diagnoseRaw(Severity severity, const UnownedStringSlice& message)
 {
+    if (m_isDeferred)
+    {
+        DiagnosticInfo info = {0, severity, nullptr, nullptr};
+        _deferDiagnostic(SourceLoc(), info, message, true);
+        return;
+    }
+
     if (severity >= Severity::Error)
     {
         m_errorCount++;
@@ -263,6 +263,20 @@ public:
         return m_sourceWarningStateTracker;
     }
 
+    /// Set whether this sink defers diagnostics.
+    ///
+    /// A deferred sink does not resolve the final severity of, format, or output diagnostics.
+    /// It only records them, so they can later be replayed in order into another sink with
+    /// `replayDeferredDiagnostics`. This allows work running on other threads to report
+    /// diagnostics without touching shared state (such as the source manager, or warning state
+    /// tracking), while keeping the final output deterministic.
+    void setDeferred(bool deferred) { m_isDeferred = deferred; }
+    bool isDeferred() const { return m_isDeferred; }
+
+    /// Replay all of the diagnostics recorded by this (deferred) sink into `sink`, in the order
+    /// they were reported. The recorded diagnostics are cleared.
+    void replayDeferredDiagnostics(DiagnosticSink* sink);
+
     /// Reset state.
     /// Resets error counts. Resets the output buffer.
     void reset();
@@ -289,6 +303,17 @@ public:
     ISlangWriter* writer = nullptr;
 
 protected:
+    /// A diagnostic recorded by a deferred sink. The message has had its arguments substituted,
+    /// but has not been formatted with location information.
+    struct DeferredDiagnostic
+    {
+        SourceLoc loc;
+        DiagnosticInfo info;
+        String message;
+        Flags flags = 0;
+        bool isRaw = false;
+    };
+
     // Returns true if a diagnostic is actually written.
     bool diagnoseImpl(
         SourceLoc const& pos,
@@ -297,6 +322,17 @@ protected:
         DiagnosticArg const* args);
     bool diagnoseImpl(DiagnosticInfo const& info, const UnownedStringSlice& formattedMessage);
 
+    /// Output a diagnostic whose message has already had its arguments substituted.
+    /// `info.severity` should already be the effective severity.
+    bool _diagnoseMessage(SourceLoc const& pos, DiagnosticInfo const& info, const String& message);
+
+    /// Record a diagnostic on a deferred sink.
+    bool _deferDiagnostic(
+        SourceLoc const& pos,
+        DiagnosticInfo const& info,
+        const String& message,
+        bool isRaw);
+
     Severity getEffectiveMessageSeverity(DiagnosticInfo const& info, SourceLoc const& location);
 
     /// If set all diagnostics (as formatted by *this* sink, will be routed to the parent).
@@ -320,6 +356,10 @@ protected:
     Dictionary<int, Severity> m_severityOverrides;
 
     RefPtr<SourceWarningStateTrackerBase> m_sourceWarningStateTracker = nullptr;
+
+    /// If set, diagnostics are recorded in m_deferredDiagnostics rather than output.
+    bool m_isDeferred = false;
+    List<DeferredDiagnostic> m_deferredDiagnostics;
 };
 
 /// An `ISlangWriter` that writes directly to a diagnostic sink.
@@ -0,0 +1,57 @@
+// slang-downstream-compile-scheduler.cpp
+#include "slang-downstream-compile-scheduler.h"
+
+namespace Slang
+{
+
+/* static */ bool DownstreamCompileScheduler::_isThreadSafe(IDownstreamCompiler* compiler)
+{
+    return (compiler->getDesc().flags & DownstreamCompilerDesc::Flag::ThreadSafe) != 0;
+}
+
+void DownstreamCompileScheduler::_acquire(IDownstreamCompiler* compiler, Count maxActiveCount)
+{
+    const bool isThreadSafe = _isThreadSafe(compiler);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto canStart = [&]()
+    {
+        if (maxActiveCount > 0 && m_activeCount >= maxActiveCount)
+            return false;
+        return isThreadSafe || !m_busyCompilers.contains(compiler);
+    };
+
+    m_stats.compileCount++;
+    if (!canStart())
+    {
+        m_stats.waitCount++;
+        m_condition.wait(lock, canStart);
+    }
+
+    m_activeCount++;
+    m_stats.maxActiveCount = Math::Max(m_stats.maxActiveCount, m_activeCount);
+    if (!isThreadSafe)
+        m_busyCompilers.add(compiler);
+}
+
+void DownstreamCompileScheduler::_release(IDownstreamCompiler* compiler)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activeCount--;
+        if (!_isThreadSafe(compiler))
+            m_busyCompilers.remove(compiler);
+    }
+    // Waiting compilations can have different limits, and wait on different compilers,
+    // so all of them need to check if they can start now.
+    m_condition.notify_all();
+}
+
+DownstreamCompileScheduler::Stats DownstreamCompileScheduler::getStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+} // namespace Slang
@@ -0,0 +1,76 @@
+#ifndef SLANG_DOWNSTREAM_COMPILE_SCHEDULER_H
+#define SLANG_DOWNSTREAM_COMPILE_SCHEDULER_H
+
+#include "../core/slang-basic.h"
+#include "slang-downstream-compiler.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace Slang
+{
+
+/// Decides when a downstream compilation can start, when code generation runs compilations
+/// from several threads.
+///
+/// At most a limited number of compilations run at the same time, and a compiler that
+/// doesn't have the `ThreadSafe` flag in its desc only runs one compilation at a time.
+/// Compilers that run each compilation in a separate process, or with separate state, can
+/// run as many compilations as the limit allows.
+class DownstreamCompileScheduler
+{
+public:
+    /// Holds the right to run a compilation with a compiler for as long as it's in scope.
+    /// Construction blocks until the compilation can start.
+    class Slot
+    {
+    public:
+        /// `maxActiveCount` is the most compilations that can run at once, including this one.
+        /// A value of 0 or less places no limit other than the thread safety of `compiler`.
+        Slot(DownstreamCompileScheduler* scheduler, IDownstreamCompiler* compiler, Count maxActiveCount)
+            : m_scheduler(scheduler), m_compiler(compiler)
+        {
+            m_scheduler->_acquire(compiler, maxActiveCount);
+        }
+        ~Slot() { m_scheduler->_release(m_compiler); }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+    private:
+        DownstreamCompileScheduler* m_scheduler;
+        IDownstreamCompiler* m_compiler;
+    };
+
+    struct Stats
+    {
+        /// Number of compilations started.
+        Count compileCount = 0;
+        /// Number of compilations that had to wait before they could start.
+        Count waitCount = 0;
+        /// Most compilations that were running at the same time.
+        Count maxActiveCount = 0;
+    };
+
+    Stats getStats();
+
+protected:
+    static bool _isThreadSafe(IDownstreamCompiler* compiler);
+
+    void _acquire(IDownstreamCompiler* compiler, Count maxActiveCount);
+    void _release(IDownstreamCompiler* compiler);
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    /// Number of compilations running.
+    Count m_activeCount = 0;
+    /// Compilers that aren't thread safe, and are running a compilation.
+    HashSet<IDownstreamCompiler*> m_busyCompilers;
+
+    Stats m_stats;
+};
+
+} // namespace Slang
+
+#endif
@@ -23,6 +23,15 @@ struct DownstreamCompilerDesc
 {
     typedef DownstreamCompilerDesc ThisType;
 
+    typedef uint32_t Flags;
+    struct Flag
+    {
+        enum Enum : Flags
+        {
+            ThreadSafe = 0x01, ///< Compilations can run concurrently on the same compiler
+        };
+    };
+
     HashCode getHashCode() const { return combineHash(HashCode(type), version.getHashCode()); }
     bool operator==(const ThisType& rhs) const
     {
@@ -51,6 +60,7 @@ struct DownstreamCompilerDesc
 
     SlangPassThrough type;   ///< The type of the compiler
     SemanticVersion version; ///< The version of the compiler
+    Flags flags = 0;         ///< Describes how the compiler can be used. Not part of its identity.
 };
 
 /* Placed at the start of structs that are versioned.
@@ -465,20 +475,25 @@ public:
         const ExecuteResult& exeResult,
         IArtifactDiagnostics* diagnostics) = 0;
 
+    // Each compilation runs in its own process, with its own temporary files, so
+    // compilations can run concurrently.
     CommandLineDownstreamCompiler(const Desc& desc, const ExecutableLocation& exe)
         : Super(desc)
     {
+        m_desc.flags |= Desc::Flag::ThreadSafe;
         m_cmdLine.setExecutableLocation(exe);
     }
 
     CommandLineDownstreamCompiler(const Desc& desc, const CommandLine& cmdLine)
         : Super(desc), m_cmdLine(cmdLine)
     {
+        m_desc.flags |= Desc::Flag::ThreadSafe;
     }
 
     CommandLineDownstreamCompiler(const Desc& desc)
         : Super(desc)
     {
+        m_desc.flags |= Desc::Flag::ThreadSafe;
     }
 
     CommandLine m_cmdLine;
@@ -299,6 +299,9 @@ SlangResult DXCDownstreamCompiler::init(ISlangSharedLibrary* library)
     }
 
     m_desc = Desc(SLANG_PASS_THROUGH_DXC, SemanticVersion(int(major), int(minor), int(patch)));
+    // Every compilation creates its own DXC compiler instances, and DXC supports using
+    // separate instances concurrently.
+    m_desc.flags |= Desc::Flag::ThreadSafe;
 
     return SLANG_OK;
 }
@@ -7,10 +7,18 @@
 
 #include "core/slang-char-encode.h"
 #include "core/slang-string-escape-util.h"
+#include "core/slang-uint-set.h"
 #include "slang-core-diagnostics.h"
 #include "slang-name.h"
 #include "slang-source-loc.h"
 
+#if SLANG_PROCESSOR_X86_64 || (SLANG_PROCESSOR_X86 && (defined(__SSE2__) || _M_IX86_FP >= 2))
+#define SLANG_LEXER_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define SLANG_LEXER_USE_SSE2 0
+#endif
+
 namespace Slang
 {
 Token TokenReader::getEndOfFileToken()
@@ -329,10 +337,173 @@ static void _handleNewLine(Lexer* lexer)
     _handleNewLineInner(lexer, c);
 }
 
+// Fast scanning
+//
+// Most of the input is made of runs of characters that only need to be stepped over, such as
+// the characters of an identifier or the body of a comment. Each character class below accepts
+// the bytes that can be skipped without going through `_peek`/`_advance`. None of them accept
+// `\`, NUL or non-ASCII bytes, so escaped newlines, code points and the end of the input are
+// still handled a code point at a time.
+//
+// With SSE2, 16 bytes are classified at once.
+
+#if SLANG_LEXER_USE_SSE2
+// Signed compares are used, so bytes >= 0x80 are negative and never inside an ASCII range.
+static SLANG_FORCE_INLINE __m128i _inRange(__m128i v, char lo, char hi)
+{
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(char(lo - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(char(hi + 1)), v));
+}
+
+static SLANG_FORCE_INLINE __m128i _isEqual(__m128i v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+// True for `\`, NUL and non-ASCII bytes.
+static SLANG_FORCE_INLINE __m128i _isSpecial(__m128i v)
+{
+    return _mm_or_si128(
+        _mm_or_si128(_isEqual(v, '\\'), _isEqual(v, 0)),
+        _mm_cmplt_epi8(v, _mm_setzero_si128()));
+}
+#endif
+
+static SLANG_FORCE_INLINE bool _isSpecial(Byte c)
+{
+    return c == '\\' || c == 0 || c >= 0x80;
+}
+
+struct IdentifierCharClass
+{
+    static bool accepts(Byte c)
+    {
+        return ('a' <= (c | 0x20) && (c | 0x20) <= 'z') || ('0' <= c && c <= '9') || c == '_';
+    }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v)
+    {
+        const __m128i isLetter = _inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+        return _mm_or_si128(_mm_or_si128(isLetter, _inRange(v, '0', '9')), _isEqual(v, '_'));
+    }
+#endif
+};
+
+struct DecimalDigitCharClass
+{
+    static bool accepts(Byte c) { return '0' <= c && c <= '9'; }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v) { return _inRange(v, '0', '9'); }
+#endif
+};
+
+struct HexDigitCharClass
+{
+    static bool accepts(Byte c)
+    {
+        return ('0' <= c && c <= '9') || ('a' <= (c | 0x20) && (c | 0x20) <= 'f');
+    }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v)
+    {
+        return _mm_or_si128(
+            _inRange(v, '0', '9'),
+            _inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'f'));
+    }
+#endif
+};
+
+struct HorizontalSpaceCharClass
+{
+    static bool accepts(Byte c) { return c == ' ' || c == '\t'; }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v) { return _mm_or_si128(_isEqual(v, ' '), _isEqual(v, '\t')); }
+#endif
+};
+
+// Anything up to the end of the line.
+struct LineCommentCharClass
+{
+    static bool accepts(Byte c) { return c != '\n' && c != '\r' && !_isSpecial(c); }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v)
+    {
+        const __m128i stop =
+            _mm_or_si128(_mm_or_si128(_isEqual(v, '\n'), _isEqual(v, '\r')), _isSpecial(v));
+        return _mm_andnot_si128(stop, _mm_set1_epi8(-1));
+    }
+#endif
+};
+
+// Anything up to a `*`, which might end the comment. Newlines don't need any handling inside
+// a block comment, so they are skipped too.
+struct BlockCommentCharClass
+{
+    static bool accepts(Byte c) { return c != '*' && !_isSpecial(c); }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v)
+    {
+        const __m128i stop = _mm_or_si128(_isEqual(v, '*'), _isSpecial(v));
+        return _mm_andnot_si128(stop, _mm_set1_epi8(-1));
+    }
+#endif
+};
+
+// Anything up to the closing quote of a string literal, an escape sequence, or a newline
+// (which is an error).
+struct StringLiteralCharClass
+{
+    static bool accepts(Byte c) { return c != '"' && c != '\n' && c != '\r' && !_isSpecial(c); }
+#if SLANG_LEXER_USE_SSE2
+    static __m128i accepts(__m128i v)
+    {
+        const __m128i stop = _mm_or_si128(
+            _mm_or_si128(_isEqual(v, '"'), _mm_or_si128(_isEqual(v, '\n'), _isEqual(v, '\r'))),
+            _isSpecial(v));
+        return _mm_andnot_si128(stop, _mm_set1_epi8(-1));
+    }
+#endif
+};
+
+/// Find the end of the run of characters accepted by `CharClass` starting at `cursor`.
+template<typename CharClass>
+static const char* _findRunEnd(const char* cursor, const char* end)
+{
+#if SLANG_LEXER_USE_SSE2
+    while (end - cursor >= 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)cursor);
+        const uint32_t accepted = uint32_t(_mm_movemask_epi8(CharClass::accepts(v)));
+        if (accepted != 0xffff)
+        {
+            return cursor + bitscanForward(uint64_t(~accepted & 0xffff));
+        }
+        cursor += 16;
+    }
+#endif
+    while (cursor < end && CharClass::accepts(Byte(*cursor)))
+    {
+        cursor++;
+    }
+    return cursor;
+}
+
+/// Step over the run of characters accepted by `CharClass` at the cursor.
+template<typename CharClass>
+static void _skipRun(Lexer* lexer)
+{
+    if (lexer->m_lexerFlags & kLexerFlag_DisableFastScan)
+        return;
+    lexer->m_cursor = _findRunEnd<CharClass>(lexer->m_cursor, lexer->m_end);
+}
+
 static void _lexLineComment(Lexer* lexer)
 {
     for (;;)
     {
+        _skipRun<LineCommentCharClass>(lexer);
+
         switch (_peek(lexer))
         {
         case '\n':
@@ -351,6 +522,8 @@ static void _lexBlockComment(Lexer* lexer)
 {
     for (;;)
     {
+        _skipRun<BlockCommentCharClass>(lexer);
+
         switch (_peek(lexer))
         {
         case kEOF:
@@ -385,6 +558,8 @@ static void _lexHorizontalSpace(Lexer* lexer)
 {
     for (;;)
     {
+        _skipRun<HorizontalSpaceCharClass>(lexer);
+
         switch (_peek(lexer))
         {
         case ' ':
@@ -407,6 +582,8 @@ static void _lexIdentifier(Lexer* lexer)
 {
     for (;;)
     {
+        _skipRun<IdentifierCharClass>(lexer);
+
         int c = _peek(lexer);
         if (('a' <= c) && (c <= 'z') || ('A' <= c) && (c <= 'Z') || ('0' <= c) && (c <= '9') ||
             (c == '_') || isNonAsciiCodePoint((unsigned int)c))
@@ -432,6 +609,12 @@ static void _lexDigits(Lexer* lexer, int base)
 {
     for (;;)
     {
+        // Digits that are valid for the base don't need to be checked one at a time.
+        if (base == 10)
+            _skipRun<DecimalDigitCharClass>(lexer);
+        else if (base == 16)
+            _skipRun<HexDigitCharClass>(lexer);
+
         int c = _peek(lexer);
 
         int digitVal = 0;
@@ -892,6 +1075,11 @@ static void _lexStringLiteralBody(Lexer* lexer, char quote, bool singleChar)
     int len = 0;
     for (;;)
     {
+        // Only the length of a character literal is checked, so the characters of a string
+        // literal can be skipped over.
+        if (quote == '"' && !singleChar)
+            _skipRun<StringLiteralCharClass>(lexer);
+
         int c = _peek(lexer);
         if (c == quote)
         {
@@ -108,6 +108,8 @@ enum
 {
     kLexerFlag_SuppressDiagnostics = 1
                                      << 2, ///< Suppress errors about invalid/unsupported characters
+    kLexerFlag_DisableFastScan = 1 << 3, ///< Scan one code point at a time, even over long runs
+                                         ///< of simple characters
 };
 
 struct Lexer
@@ -1,6 +1,8 @@
 // slang-name.cpp
 #include "slang-name.h"
 
+#include <atomic>
+
 namespace Slang
 {
 
@@ -21,16 +23,58 @@ const char* getCstr(Name* name)
     return name ? name->text.getBuffer() : nullptr;
 }
 
+RootNamePool::RootNamePool()
+{
+    static std::atomic<uint64_t> nextId = 1;
+    id = nextId++;
+}
+
+namespace
+{
+// The names a thread has looked up in a root name pool.
+struct ThreadNameCache
+{
+    uint64_t rootPoolId = 0;
+    Dictionary<String, Name*> names;
+};
+} // namespace
+
+static thread_local ThreadNameCache t_nameCache;
+
+// Get the cache of the current thread for `rootPool`. A thread only caches the names of one
+// pool at a time, which is the common case of a thread using a single session.
+static ThreadNameCache& _getThreadNameCache(RootNamePool* rootPool)
+{
+    auto& cache = t_nameCache;
+    if (cache.rootPoolId != rootPool->id)
+    {
+        cache.names.clear();
+        cache.rootPoolId = rootPool->id;
+    }
+    return cache;
+}
+
 Name* NamePool::getName(UnownedStringSlice text)
 {
-    RefPtr<Name> name;
-    if (rootPool->names.tryGetValue(text, name))
-        return name;
+    auto& cache = _getThreadNameCache(rootPool);
+    if (auto found = cache.names.tryGetValue(text))
+        return *found;
+
+    Name* result = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(rootPool->mutex);
 
-    name = new Name();
-    name->text = text;
-    rootPool->names.add(text, name);
-    return name;
+        RefPtr<Name> name;
+        if (!rootPool->names.tryGetValue(text, name))
+        {
+            name = new Name();
+            name->text = text;
+            rootPool->names.add(text, name);
+        }
+        result = name;
+    }
+    cache.names.add(text, result);
+    return result;
 }
 
 Name* NamePool::getName(String const& text)
@@ -40,6 +84,12 @@ Name* NamePool::getName(String const& text)
 
 Name* NamePool::tryGetName(String const& text)
 {
+    auto& cache = _getThreadNameCache(rootPool);
+    if (auto found = cache.names.tryGetValue(text))
+        return *found;
+
+    std::lock_guard<std::mutex> lock(rootPool->mutex);
+
     RefPtr<Name> name;
     if (rootPool->names.tryGetValue(text, name))
         return name;
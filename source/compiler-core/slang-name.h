@@ -7,6 +7,8 @@
 
 #include "../core/slang-basic.h"
 
+#include <mutex>
+
 namespace Slang
 {
 
@@ -48,10 +50,25 @@ const char* getCstr(Name* name);
 // get equivalent names for a string like `"Foo"`, then they need to use
 // the same root name pool (directly or indirectly).
 //
+// A root name pool is shared by all of the linkages created from a session,
+// which may be used from different threads. Names are looked up very often,
+// so rather than locking the pool for every lookup, each thread keeps its own
+// cache of the names it has used, and only locks the pool when the name isn't
+// in the cache.
+//
 struct RootNamePool
 {
+    RootNamePool();
+
     // The mapping from text strings to the corresponding name.
     Dictionary<String, RefPtr<Name>> names;
+
+    // Guards `names`.
+    std::mutex mutex;
+
+    // Identifies the pool in the cache of each thread. A pool can be created at
+    // the address of one that has been destroyed, so the address can't be used.
+    uint64_t id;
 };
 
 // A `NamePool` is effectively a way of storing a subset of the
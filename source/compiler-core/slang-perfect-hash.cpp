@@ -1,5 +1,6 @@
 #include "slang-perfect-hash.h"
 
+#include "../core/slang-dictionary.h"
 #include "../core/slang-string-util.h"
 #include "../core/slang-writer.h"
 
@@ -11,14 +12,12 @@ namespace Slang
 HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams)
 {
     // Check for uniqueness
-    for (Index i = 0; i < ss.getCount(); ++i)
+    HashSet<String> uniqueStrings;
+    for (const auto& s : ss)
     {
-        for (Index j = i + 1; j < ss.getCount(); ++j)
+        if (!uniqueStrings.add(s))
         {
-            if (ss[i] == ss[j])
-            {
-                return HashFindResult::NonUniqueKeys;
-            }
+            return HashFindResult::NonUniqueKeys;
         }
     }
 
@@ -41,10 +40,7 @@ HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams
         //
         // If you change this, don't forget to also sync the version below in
         // the printing code.
-        UInt32 h = salt;
-        for (const char c : s)
-            h = (h * 0x01000193) ^ c;
-        return h % nBuckets;
+        return perfectHash(s.getUnownedSlice(), salt, nBuckets);
     };
 
     // Assign the inputs into their buckets according to the hash without salt.
@@ -71,8 +67,11 @@ HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams
         s.reduceLength(0);
 
     // This mask will, in each salt tryout, be used to prevent collisions
-    // within a single bucket.
+    // within a single bucket. Only the destinations set by a tryout are
+    // cleared before the next one, so that the many tryouts needed to place
+    // the last buckets don't each cost time proportional to the input.
     List<bool> bucketDestinations = List<bool>::makeRepeated(false, nBuckets);
+    List<UInt32> setBucketDestinations;
 
     for (const auto& b : initialBuckets)
     {
@@ -89,10 +88,11 @@ HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams
         while (true)
         {
             bool collision = false;
-            for (auto& d : bucketDestinations)
+            for (const auto i : setBucketDestinations)
             {
-                d = false;
+                bucketDestinations[i] = false;
             }
+            setBucketDestinations.clear();
 
             for (const auto& s : b)
             {
@@ -103,6 +103,7 @@ HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams
                     break;
                 }
                 bucketDestinations[i] = true;
+                setBucketDestinations.add(i);
             }
             if (!collision)
             {
@@ -191,7 +192,7 @@ String perfectHashToEmbeddableCpp(
     line("    static const auto hash = [](const UnownedStringSlice& str, UInt32 salt){");
     line("        UInt32 h = salt;");
     line("        for (const char c : str)");
-    line("            h = (h * 0x01000193) ^ c;");
+    line("            h = (h * 0x01000193) ^ uint8_t(c);");
     w.print("        return h %% %d;\n", (int)hashParams.saltTable.getCount());
     line("    };");
     line("");
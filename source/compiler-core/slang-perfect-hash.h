@@ -22,6 +22,20 @@ enum class HashFindResult
 // Calculate a minimal perfect hash of a list of input strings
 HashFindResult minimalPerfectHash(const List<String>& ss, HashParams& hashParams);
 
+// The hash used by `minimalPerfectHash`. A string `str` from the input is found at
+// `destTable[perfectHash(str, saltTable[perfectHash(str, 0, n)], n)]`, where `n` is the
+// amount of input strings.
+//
+// The string is hashed as unsigned bytes, as the signedness of `char` depends on the platform,
+// and hashes are stored in serialized modules.
+inline UInt32 perfectHash(const UnownedStringSlice& str, UInt32 salt, UInt32 bucketCount)
+{
+    UInt32 h = salt;
+    for (const char c : str)
+        h = (h * 0x01000193) ^ uint8_t(c);
+    return h % bucketCount;
+}
+
 String perfectHashToEmbeddableCpp(
     const HashParams& hashParams,
     const UnownedStringSlice& valueType,
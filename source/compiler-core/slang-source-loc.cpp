@@ -749,6 +749,11 @@ void SourceManager::reset()
     _resetLoc();
 }
 
+void SourceManager::forgetSourceFileIdentities()
+{
+    m_sourceFileMap.clear();
+}
+
 UnownedStringSlice SourceManager::allocateStringSlice(const UnownedStringSlice& slice)
 {
     const UInt numChars = slice.getLength();
@@ -919,8 +924,11 @@ SourceFile* SourceManager::findSourceFileByPathRecursively(const String& name) c
 
 SourceFile* SourceManager::findSourceFileByPath(const String& name) const
 {
-    for (auto sourceFile : m_sourceFiles)
+    // Search the most recent files first, so that if a file was read again after
+    // `forgetSourceFileIdentities` the current contents are found.
+    for (Index i = m_sourceFiles.getCount() - 1; i >= 0; --i)
     {
+        SourceFile* sourceFile = m_sourceFiles[i];
         if (sourceFile->getPathInfo().foundPath == name)
         {
             return sourceFile;
@@ -649,6 +649,10 @@ struct SourceManager
     /// Resets state. Will release all views/source
     void reset();
 
+    /// Forget the unique identities of the source files, so that a file that is loaded again is
+    /// read again. The source files are kept, as views and tokens may still refer to them.
+    void forgetSourceFileIdentities();
+
     SourceManager()
         : m_memoryArena(2048), m_slicePool(StringSlicePool::Style::Default)
     {
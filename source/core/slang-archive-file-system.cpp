@@ -52,6 +52,27 @@ SlangResult loadArchiveFileSystem(
     return SLANG_OK;
 }
 
+SlangResult loadArchiveFileSystem(
+    ISlangBlob* archiveBlob,
+    ComPtr<ISlangFileSystemExt>& outFileSystem)
+{
+    const void* data = archiveBlob->getBufferPointer();
+    const size_t dataSizeInBytes = archiveBlob->getBufferSize();
+
+    // Only the RIFF archive can be read in place
+    if (!RiffFileSystem::isArchive(data, dataSizeInBytes))
+    {
+        return loadArchiveFileSystem(data, dataSizeInBytes, outFileSystem);
+    }
+
+    auto fileSystem = new RiffFileSystem(nullptr);
+    ComPtr<ISlangFileSystemExt> fileSystemHolder(fileSystem);
+    SLANG_RETURN_ON_FAIL(fileSystem->loadArchiveInPlace(archiveBlob));
+
+    outFileSystem = fileSystemHolder;
+    return SLANG_OK;
+}
+
 SlangResult createArchiveFileSystem(
     SlangArchiveType type,
     ComPtr<ISlangMutableFileSystem>& outFileSystem)
@@ -32,6 +32,11 @@ SlangResult loadArchiveFileSystem(
     const void* data,
     size_t dataSizeInBytes,
     ComPtr<ISlangFileSystemExt>& outFileSystem);
+/// Load an archive held in `archiveBlob`. Where the archive type allows, the contents of
+/// files are read in place from the blob, which is kept alive by the file system.
+SlangResult loadArchiveFileSystem(
+    ISlangBlob* archiveBlob,
+    ComPtr<ISlangFileSystemExt>& outFileSystem);
 SlangResult createArchiveFileSystem(
     SlangArchiveType type,
     ComPtr<ISlangMutableFileSystem>& outFileSystem);
@@ -197,6 +197,9 @@ public:
     /// Get the path style
     PathStyle getPathStyle() const { return m_pathStyle; }
 
+    /// Get the inner file system
+    ISlangFileSystem* getInnerFileSystem() const { return m_fileSystem; }
+
     /// Set the inner file system
     void setInnerFileSystem(
         ISlangFileSystem* fileSystem,
@@ -27,9 +27,11 @@
 #include <unistd.h>
 // For Path::find
 #include <dirent.h>
+#include <errno.h>
 #include <fnmatch.h>
 #include <ftw.h> // for nftw
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #endif
 
@@ -64,6 +66,39 @@ namespace Slang
 #endif
 }
 
+/* static */ SlangResult File::rename(const String& fromFileName, const String& toFileName)
+{
+#ifdef _WIN32
+    // https://learn.microsoft.com/en-us/windows/win32/api/winbase/nf-winbase-movefileexw
+    if (MoveFileExW(
+            fromFileName.toWString(),
+            toFileName.toWString(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        return SLANG_OK;
+    }
+    return SLANG_FAIL;
+#else
+    // https://man7.org/linux/man-pages/man2/rename.2.html
+    if (::rename(fromFileName.getBuffer(), toFileName.getBuffer()) == 0)
+    {
+        return SLANG_OK;
+    }
+    return SLANG_FAIL;
+#endif
+}
+
+/* static */ SlangResult File::getModificationTime(const String& fileName, uint64_t& outTime)
+{
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(fileName.getBuffer(), ec);
+    if (ec)
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+    outTime = uint64_t(time.time_since_epoch().count());
+    return SLANG_OK;
+}
 
 #ifdef _WIN32
 /* static */ SlangResult File::generateTemporary(
@@ -744,6 +779,13 @@ String Path::getCurrentPath()
     return path;
 }
 
+SlangResult Path::setCurrentPath(const String& path)
+{
+    std::error_code ec;
+    std::filesystem::current_path(path.getBuffer(), ec);
+    return ec ? SLANG_FAIL : SLANG_OK;
+}
+
 String Path::getRelativePath(String base, String path)
 {
     std::filesystem::path p1(base.getBuffer());
@@ -1415,4 +1457,150 @@ LockFile::~LockFile()
 {
     close();
 }
+
+SlangResult MemoryMappedFile::open(const String& fileName, Access access)
+{
+    const bool isWritable = (access == Access::ReadWrite);
+
+    close();
+
+#if SLANG_WINDOWS_FAMILY
+    // FILE_SHARE_DELETE allows the file to be replaced by a rename while it is mapped.
+    m_fileHandle = ::CreateFileW(
+        fileName.toWString(),
+        isWritable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        const auto err = ::GetLastError();
+        return (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND) ? SLANG_E_NOT_FOUND
+                                                                            : SLANG_E_CANNOT_OPEN;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(m_fileHandle, &fileSize))
+    {
+        ::CloseHandle(m_fileHandle);
+        return SLANG_E_CANNOT_OPEN;
+    }
+    m_size = size_t(fileSize.QuadPart);
+    m_mappingHandle = NULL;
+    m_data = nullptr;
+
+    if (m_size)
+    {
+        m_mappingHandle = ::CreateFileMappingW(
+            m_fileHandle,
+            NULL,
+            isWritable ? PAGE_READWRITE : PAGE_READONLY,
+            0,
+            0,
+            NULL);
+        if (m_mappingHandle)
+        {
+            m_data = ::MapViewOfFile(
+                m_mappingHandle,
+                isWritable ? FILE_MAP_READ | FILE_MAP_WRITE : FILE_MAP_READ,
+                0,
+                0,
+                0);
+        }
+        if (!m_data)
+        {
+            if (m_mappingHandle)
+                ::CloseHandle(m_mappingHandle);
+            ::CloseHandle(m_fileHandle);
+            return SLANG_E_CANNOT_OPEN;
+        }
+    }
+#else
+    m_fileHandle = ::open(fileName.getBuffer(), isWritable ? O_RDWR : O_RDONLY);
+    if (m_fileHandle == -1)
+    {
+        return errno == ENOENT ? SLANG_E_NOT_FOUND : SLANG_E_CANNOT_OPEN;
+    }
+
+    struct stat fileStat;
+    if (::fstat(m_fileHandle, &fileStat) != 0)
+    {
+        ::close(m_fileHandle);
+        return SLANG_E_CANNOT_OPEN;
+    }
+    m_size = size_t(fileStat.st_size);
+    m_data = nullptr;
+
+    if (m_size)
+    {
+        // A read only mapping is private, so that it never writes to the file, and pages are
+        // still shared with other mappings of the file for as long as they aren't written.
+        const int protection = isWritable ? PROT_READ | PROT_WRITE : PROT_READ;
+        const int flags = isWritable ? MAP_SHARED : MAP_PRIVATE;
+        void* data = ::mmap(nullptr, m_size, protection, flags, m_fileHandle, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(m_fileHandle);
+            return SLANG_E_CANNOT_OPEN;
+        }
+        m_data = data;
+    }
+#endif
+
+    m_isOpen = true;
+    return SLANG_OK;
+}
+
+void MemoryMappedFile::close()
+{
+    if (!m_isOpen)
+        return;
+
+#if SLANG_WINDOWS_FAMILY
+    if (m_data)
+        ::UnmapViewOfFile(m_data);
+    if (m_mappingHandle)
+        ::CloseHandle(m_mappingHandle);
+    ::CloseHandle(m_fileHandle);
+#else
+    if (m_data)
+        ::munmap(m_data, m_size);
+    ::close(m_fileHandle);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+MemoryMappedFile::MemoryMappedFile()
+    : m_data(nullptr), m_size(0), m_isOpen(false)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+/* static */ SlangResult MemoryMappedFileBlob::create(
+    const String& fileName,
+    ComPtr<ISlangBlob>& outBlob)
+{
+    auto blob = new MemoryMappedFileBlob;
+    ComPtr<ISlangBlob> blobHolder(blob);
+    SLANG_RETURN_ON_FAIL(blob->m_file.open(fileName, MemoryMappedFile::Access::Read));
+
+    // Small files gain little from sharing pages, and a copy isn't affected by the file
+    // being rewritten while in use.
+    if (blob->m_file.getSize() < kMinMappedFileSize)
+    {
+        outBlob = RawBlob::create(blob->m_file.getData(), blob->m_file.getSize());
+        return SLANG_OK;
+    }
+    outBlob = blobHolder;
+    return SLANG_OK;
+}
 } // namespace Slang
@@ -30,8 +30,17 @@ public:
 
     static SlangResult remove(const String& fileName);
 
+    /// Rename `fromFileName` to `toFileName`, replacing `toFileName` if it already exists.
+    /// When both are on the same volume the replacement is atomic, so other readers of
+    /// `toFileName` see either the old or the new file, never a partially written one.
+    static SlangResult rename(const String& fromFileName, const String& toFileName);
+
     static SlangResult makeExecutable(const String& fileName);
 
+    /// Get the time the file was last modified. The value is only meaningful when compared to
+    /// other values returned for the same file.
+    static SlangResult getModificationTime(const String& fileName, uint64_t& outTime);
+
     /// Creates a temporary file typically in some way based on the prefix
     /// The file will be *created* with the outFileName, on success.
     /// It's creation in necessary to lock that particular name.
@@ -228,6 +237,11 @@ public:
     /// @return The path in platform native format. Returns empty string if failed.
     static String getCurrentPath();
 
+    /// Sets the current working directory
+    /// @param path The path to make the current working directory
+    /// @return SLANG_OK on success
+    static SlangResult setCurrentPath(const String& path);
+
     /// Returns the executable path
     /// @return The path in platform native format. Returns empty string if failed.
     static String getExecutablePath();
@@ -325,6 +339,82 @@ private:
     bool m_isOpen;
 };
 
+/// A file mapped into memory for reading and in-place writing.
+/// The file size is fixed for the lifetime of the mapping.
+class MemoryMappedFile
+{
+public:
+    enum class Access
+    {
+        Read,      ///< The mapping is read only and private, but unmodified pages are shared
+        ReadWrite, ///< Writes to the mapping are written back to the file
+    };
+
+    /// Map the whole of an existing file.
+    /// An empty file can be opened, but will have no data.
+    /// @param fileName File name to open.
+    /// @param access How the file is accessed through the mapping.
+    /// @return SLANG_OK on success, SLANG_E_NOT_FOUND if the file does not exist.
+    SlangResult open(const String& fileName, Access access = Access::ReadWrite);
+
+    /// Unmap and close the file.
+    void close();
+
+    /// Returns true if the file is open.
+    bool isOpen() const { return m_isOpen; }
+
+    void* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+
+    MemoryMappedFile();
+    ~MemoryMappedFile();
+
+private:
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(MemoryMappedFile&&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+
+#if SLANG_WINDOWS_FAMILY
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#else
+    int m_fileHandle;
+#endif
+    void* m_data;
+    size_t m_size;
+    bool m_isOpen;
+};
+
+/// A read only blob holding the memory mapped contents of a file.
+///
+/// The file stays mapped for as long as the blob is alive, so the data is only paged in as it
+/// is touched, and is shared with any other process mapping the same file.
+///
+/// Reading a mapping faults if the file is truncated, for example by being rewritten in
+/// place, so files smaller than `kMinMappedFileSize` are copied into memory instead, and
+/// larger files should only be replaced by renaming a new file over them.
+class MemoryMappedFileBlob : public BlobBase
+{
+public:
+    // ISlangBlob
+    SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() SLANG_OVERRIDE
+    {
+        return m_file.getData();
+    }
+    SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() SLANG_OVERRIDE { return m_file.getSize(); }
+
+    /// Files smaller than this are read into memory rather than mapped.
+    static const size_t kMinMappedFileSize = 1024 * 1024;
+
+    /// Map the file at `fileName` into a blob, or read it if it is small.
+    /// @return SLANG_OK on success, SLANG_E_NOT_FOUND if the file does not exist.
+    static SlangResult create(const String& fileName, ComPtr<ISlangBlob>& outBlob);
+
+protected:
+    MemoryMappedFile m_file;
+};
+
 class LockFileGuard
 {
 public:
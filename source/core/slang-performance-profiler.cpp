@@ -1,90 +1,445 @@
 #include "slang-performance-profiler.h"
 
+#include "slang-blob.h"
 #include "slang-dictionary.h"
+#include "slang-string-escape-util.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace Slang
 {
+
+// Maximum number of scope events recorded per thread for the Chrome trace. Further events
+// are dropped, which keeps memory use bounded when profiling is left on for long periods.
+static const Count kMaxTraceEventCount = 1 << 16;
+
+// The scopes recorded by one thread in a profiler. Only that thread writes to it, so it
+// is only read by other threads once the thread has stopped recording.
+struct PerformanceThreadProfile
+{
+    struct Node
+    {
+        const char* name = nullptr;
+        Index parent = -1;
+        Index firstChild = -1;
+        Index lastChild = -1;
+        Index nextSibling = -1;
+        FuncProfileInfo info;
+    };
+
+    // Identifies the child of a node with a name.
+    struct ChildKey
+    {
+        Index parent;
+        const char* name;
+
+        bool operator==(const ChildKey& other) const
+        {
+            return parent == other.parent && name == other.name;
+        }
+        SLANG_COMPONENTWISE_HASHABLE_2
+    };
+
+    // Node 0 is the root of the call tree.
+    List<Node> nodes;
+    Dictionary<ChildKey, Index> childNodes;
+    Index currentNode = 0;
+    uint32_t generation = 0;
+
+    List<PerformanceTraceEvent> events;
+    Count droppedEventCount = 0;
+
+    // Index of the thread in the profiler, used as the thread id in traces. The thread that
+    // owns the profiler is thread 0.
+    Index threadIndex = 0;
+    // Set once the thread has stopped recording in the profiler, after which the profile is
+    // never written to again, and can be read by other threads.
+    std::atomic<bool> isRetired = false;
+
+    void reset()
+    {
+        nodes.clear();
+        nodes.add(Node());
+        childNodes.clear();
+        currentNode = 0;
+        generation++;
+        events.clear();
+        droppedEventCount = 0;
+    }
+};
+
+// The profiler the current thread records its scopes in, if set by
+// `PerformanceProfilerThreadRAII`, and the thread's profile in it.
+struct CurrentThreadProfiler
+{
+    PerformanceProfiler* profiler = nullptr;
+    PerformanceThreadProfile* profile = nullptr;
+};
+static thread_local CurrentThreadProfiler t_currentThreadProfiler;
+
 class PerformanceProfilerImpl : public PerformanceProfiler
 {
 public:
-    OrderedDictionary<const char*, FuncProfileInfo> data;
+    using Clock = std::chrono::high_resolution_clock;
+    using Node = PerformanceThreadProfile::Node;
+    using ThreadProfile = PerformanceThreadProfile;
+
+    PerformanceProfilerImpl() { m_ownProfile = addThreadProfile(); }
+
+    /// Add the profile of a thread that records in this profiler.
+    ThreadProfile* addThreadProfile()
+    {
+        auto profile = new ThreadProfile();
+        profile->reset();
+
+        std::lock_guard<std::mutex> threadsLock(m_threadsMutex);
+        profile->threadIndex = m_nextThreadIndex++;
+        m_threadProfiles.add(profile);
+        return profile;
+    }
+
+    /// Mark the profile of a thread as no longer written to. It is freed by the next `clear`.
+    void retireThreadProfile(ThreadProfile* profile)
+    {
+        profile->isRetired.store(true, std::memory_order_release);
+    }
 
     virtual FuncProfileContext enterFunction(const char* funcName) override
     {
-        auto entry = data.tryGetValue(funcName);
-        if (!entry)
+        ThreadProfile* profile = _getThreadProfile();
+
+        // Find the child of the current node with this name, or add it.
+        const ThreadProfile::ChildKey key = {profile->currentNode, funcName};
+        Index nodeIndex = -1;
+        if (!profile->childNodes.tryGetValue(key, nodeIndex))
         {
-            data.add(funcName, FuncProfileInfo());
-            entry = data.tryGetValue(funcName);
+            nodeIndex = profile->nodes.getCount();
+            profile->childNodes.add(key, nodeIndex);
+
+            Node node;
+            node.name = funcName;
+            node.parent = profile->currentNode;
+            profile->nodes.add(node);
+
+            Node& parent = profile->nodes[node.parent];
+            if (parent.lastChild >= 0)
+                profile->nodes[parent.lastChild].nextSibling = nodeIndex;
+            else
+                parent.firstChild = nodeIndex;
+            parent.lastChild = nodeIndex;
         }
-        entry->invocationCount++;
+
+        profile->nodes[nodeIndex].info.invocationCount++;
+        profile->currentNode = nodeIndex;
+
         FuncProfileContext ctx;
         ctx.funcName = funcName;
-        ctx.startTime = std::chrono::high_resolution_clock::now();
+        ctx.nodeIndex = nodeIndex;
+        ctx.generation = profile->generation;
+        ctx.startTime = Clock::now();
         return ctx;
     }
+
     virtual void exitFunction(FuncProfileContext ctx) override
     {
-        auto endTime = std::chrono::high_resolution_clock::now();
+        auto endTime = Clock::now();
         auto duration = endTime - ctx.startTime;
-        auto entry = data.tryGetValue(ctx.funcName);
-        entry->duration += duration;
+
+        ThreadProfile* profile = _getThreadProfile();
+
+        // If the profile was cleared since entering, the node no longer exists.
+        if (ctx.generation != profile->generation)
+        {
+            return;
+        }
+
+        Node& node = profile->nodes[ctx.nodeIndex];
+        node.info.duration += duration;
+        profile->currentNode = node.parent;
+
+        if (profile->events.getCount() < kMaxTraceEventCount)
+        {
+            PerformanceTraceEvent event;
+            event.name = ctx.funcName;
+            event.start =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(ctx.startTime - m_startTime)
+                    .count();
+            event.duration =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+            profile->events.add(event);
+        }
+        else
+        {
+            profile->droppedEventCount++;
+        }
+    }
+
+    virtual void getFlatResult(List<const char*>& outNames, List<FuncProfileInfo>& outInfos)
+        override
+    {
+        OrderedDictionary<const char*, FuncProfileInfo> data;
+
+        std::lock_guard<std::mutex> threadsLock(m_threadsMutex);
+        for (auto profile : m_threadProfiles)
+        {
+            if (!_canRead(profile))
+                continue;
+
+            for (Index i = 1; i < profile->nodes.getCount(); ++i)
+            {
+                const Node& node = profile->nodes[i];
+                auto entry = data.tryGetValue(node.name);
+                if (!entry)
+                {
+                    data.add(node.name, FuncProfileInfo());
+                    entry = data.tryGetValue(node.name);
+                }
+                entry->invocationCount += node.info.invocationCount;
+                entry->duration += node.info.duration;
+            }
+        }
+
+        outNames.clear();
+        outInfos.clear();
+        for (const auto& func : data)
+        {
+            outNames.add(func.key);
+            outInfos.add(func.value);
+        }
     }
+
     virtual void getResult(StringBuilder& out) override
     {
         char buffer[512];
-        for (const auto& func : data)
+
+        List<const char*> names;
+        List<FuncProfileInfo> infos;
+        getFlatResult(names, infos);
+        for (Index i = 0; i < names.getCount(); ++i)
         {
             memset(buffer, 0, sizeof(buffer));
-            snprintf(buffer, sizeof(buffer), "[*] %30s", func.key);
+            snprintf(buffer, sizeof(buffer), "[*] %30s", names[i]);
             out << buffer << " \t";
             auto milliseconds =
-                std::chrono::duration_cast<std::chrono::milliseconds>(func.value.duration);
-            out << func.value.invocationCount << " \t"
+                std::chrono::duration_cast<std::chrono::milliseconds>(infos[i].duration);
+            out << infos[i].invocationCount << " \t"
+                << static_cast<uint64_t>(milliseconds.count()) << "ms\n";
+        }
+
+        std::lock_guard<std::mutex> threadsLock(m_threadsMutex);
+        for (auto profile : m_threadProfiles)
+        {
+            if (!_canRead(profile) || profile->nodes.getCount() <= 1)
+                continue;
+
+            out << "\nThread " << profile->threadIndex << ":\n";
+            _writeTree(*profile, profile->nodes[0].firstChild, 1, out);
+        }
+    }
+
+    virtual void getTrace(PerformanceTrace& outTrace) override
+    {
+        outTrace.threads.clear();
+
+        std::lock_guard<std::mutex> threadsLock(m_threadsMutex);
+        for (auto profile : m_threadProfiles)
+        {
+            if (!_canRead(profile) || profile->events.getCount() == 0)
+                continue;
+
+            PerformanceTrace::Thread thread;
+            thread.threadIndex = profile->threadIndex;
+            thread.events = profile->events;
+            thread.droppedEventCount = profile->droppedEventCount;
+            outTrace.threads.add(_Move(thread));
+        }
+    }
+
+    virtual void clear() override
+    {
+        std::lock_guard<std::mutex> threadsLock(m_threadsMutex);
+
+        // Profiles of threads that have stopped recording can be freed. Those of threads still
+        // recording in the profiler can't be written here, and are kept as they are.
+        ThreadProfile* currentProfile = _getThreadProfile();
+        Index writeIndex = 0;
+        for (auto profile : m_threadProfiles)
+        {
+            if (profile->isRetired.load(std::memory_order_acquire))
+            {
+                delete profile;
+                continue;
+            }
+            if (profile == currentProfile)
+                profile->reset();
+            m_threadProfiles[writeIndex++] = profile;
+        }
+        m_threadProfiles.setCount(writeIndex);
+    }
+
+    virtual void dispose() override
+    {
+        clear();
+
+        ThreadProfile* profile = _getThreadProfile();
+        profile->nodes = List<Node>();
+        profile->nodes.add(Node());
+        profile->childNodes = Dictionary<ThreadProfile::ChildKey, Index>();
+        profile->events = List<PerformanceTraceEvent>();
+    }
+
+    ~PerformanceProfilerImpl()
+    {
+        for (auto profile : m_threadProfiles)
+        {
+            delete profile;
+        }
+    }
+
+protected:
+    ThreadProfile* _getThreadProfile()
+    {
+        // Only the owning thread uses this profiler without having added a profile.
+        const auto& current = t_currentThreadProfiler;
+        return current.profiler == this ? current.profile : m_ownProfile;
+    }
+
+    // Only the calling thread's profile, and those of threads that have stopped recording,
+    // are safe to read.
+    bool _canRead(ThreadProfile* profile)
+    {
+        return profile == _getThreadProfile() ||
+               profile->isRetired.load(std::memory_order_acquire);
+    }
+
+    void _writeTree(const ThreadProfile& profile, Index nodeIndex, Index depth, StringBuilder& out)
+    {
+        for (; nodeIndex >= 0; nodeIndex = profile.nodes[nodeIndex].nextSibling)
+        {
+            const Node& node = profile.nodes[nodeIndex];
+            auto milliseconds =
+                std::chrono::duration_cast<std::chrono::milliseconds>(node.info.duration);
+            for (Index i = 0; i < depth; ++i)
+                out << "  ";
+            out << node.name << " \t" << node.info.invocationCount << " \t"
                 << static_cast<uint64_t>(milliseconds.count()) << "ms\n";
+
+            _writeTree(profile, node.firstChild, depth + 1, out);
         }
     }
-    virtual void clear() override { data.clear(); }
-    virtual void dispose() override { data = decltype(data)(); }
+
+    Clock::time_point m_startTime = Clock::now();
+
+    // Guards the list of thread profiles, but not the profiles themselves.
+    std::mutex m_threadsMutex;
+    List<ThreadProfile*> m_threadProfiles;
+    Index m_nextThreadIndex = 0;
+
+    // The profile of the thread that owns the profiler.
+    ThreadProfile* m_ownProfile = nullptr;
 };
 
+void PerformanceTrace::writeChromeTrace(StringBuilder& out) const
+{
+    auto handler = StringEscapeUtil::getHandler(StringEscapeUtil::Style::JSON);
+
+    out << "{\"traceEvents\":[";
+    bool isFirst = true;
+    auto beginEvent = [&]()
+    {
+        out << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+    };
+
+    for (const auto& thread : threads)
+    {
+        beginEvent();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadIndex
+            << ",\"args\":{\"name\":\"slang thread " << thread.threadIndex << "\"}}";
+
+        for (const auto& event : thread.events)
+        {
+            beginEvent();
+            out << "{\"name\":";
+            StringEscapeUtil::appendQuoted(handler, UnownedStringSlice(event.name), out);
+            // Times are in microseconds.
+            out << ",\"cat\":\"slang\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadIndex
+                << ",\"ts\":" << String(event.start / 1000.0, "%.3f")
+                << ",\"dur\":" << String(event.duration / 1000.0, "%.3f") << "}";
+        }
+
+        if (thread.droppedEventCount)
+        {
+            beginEvent();
+            out << "{\"name\":\"dropped events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":"
+                << thread.threadIndex << ",\"ts\":0,\"args\":{\"count\":"
+                << thread.droppedEventCount << "}}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
 PerformanceProfiler* Slang::PerformanceProfiler::getProfiler()
 {
-    thread_local static PerformanceProfilerImpl profiler = PerformanceProfilerImpl();
+    if (auto profiler = t_currentThreadProfiler.profiler)
+        return profiler;
+
+    thread_local PerformanceProfilerImpl profiler;
     return &profiler;
 }
 
+PerformanceProfilerThreadRAII::PerformanceProfilerThreadRAII(PerformanceProfiler* profiler)
+    : m_previousProfiler(t_currentThreadProfiler.profiler)
+    , m_previousProfile(t_currentThreadProfiler.profile)
+{
+    m_profile = static_cast<PerformanceProfilerImpl*>(profiler)->addThreadProfile();
+    t_currentThreadProfiler.profiler = profiler;
+    t_currentThreadProfiler.profile = m_profile;
+}
+
+PerformanceProfilerThreadRAII::~PerformanceProfilerThreadRAII()
+{
+    static_cast<PerformanceProfilerImpl*>(t_currentThreadProfiler.profiler)
+        ->retireThreadProfile(m_profile);
+    t_currentThreadProfiler.profiler = m_previousProfiler;
+    t_currentThreadProfiler.profile = m_previousProfile;
+}
+
 SlangProfiler::SlangProfiler(PerformanceProfiler* profiler)
 {
-    PerformanceProfilerImpl* profilerImpl = static_cast<PerformanceProfilerImpl*>(profiler);
-    size_t entryCount = profilerImpl->data.getCount();
+    List<const char*> names;
+    List<FuncProfileInfo> infos;
+    profiler->getFlatResult(names, infos);
 
-    m_profilEntries.reserve(entryCount);
+    m_profilEntries.reserve(names.getCount());
 
-    int index = 0;
-    for (auto func : profilerImpl->data)
+    for (Index i = 0; i < names.getCount(); ++i)
     {
         ProfileInfo profileEntry{};
-        size_t strSize = std::min(sizeof(profileEntry.funcName) - 1, strlen(func.key));
+        size_t strSize = std::min(sizeof(profileEntry.funcName) - 1, strlen(names[i]));
 
         if (strSize > 0)
         {
-            memcpy(profileEntry.funcName, func.key, strSize);
+            memcpy(profileEntry.funcName, names[i], strSize);
         }
-        profileEntry.invocationCount = func.value.invocationCount;
-        profileEntry.duration = func.value.duration;
+        profileEntry.invocationCount = infos[i].invocationCount;
+        profileEntry.duration = infos[i].duration;
 
-        m_profilEntries.insert(index, profileEntry);
-        index++;
+        m_profilEntries.add(profileEntry);
     }
+
+    profiler->getTrace(m_trace);
 }
 
 ISlangUnknown* SlangProfiler::getInterface(const Guid& guid)
 {
-    if (guid == SlangProfiler::getTypeGuid())
-        return static_cast<ISlangUnknown*>(this);
-    else
-        return nullptr;
+    if (guid == ISlangUnknown::getTypeGuid() || guid == ISlangProfiler::getTypeGuid())
+        return static_cast<ISlangProfiler*>(this);
+    if (guid == ISlangProfilerTrace::getTypeGuid())
+        return static_cast<ISlangProfilerTrace*>(this);
+    return nullptr;
 }
 
 size_t SlangProfiler::getEntryCount()
@@ -117,4 +472,15 @@ uint32_t SlangProfiler::getEntryInvocationTimes(uint32_t index)
 
     return m_profilEntries[index].invocationCount;
 }
+
+SlangResult SlangProfiler::getChromeTrace(ISlangBlob** outBlob)
+{
+    if (!outBlob)
+        return SLANG_E_INVALID_ARG;
+
+    StringBuilder chromeTrace;
+    m_trace.writeChromeTrace(chromeTrace);
+    *outBlob = StringBlob::create(chromeTrace.produceString()).detach();
+    return SLANG_OK;
+}
 } // namespace Slang
@@ -21,14 +21,86 @@ struct FuncProfileContext
 {
     const char* funcName = nullptr;
     std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
+    // The node in the calling thread's call tree that was entered.
+    Index nodeIndex = -1;
+    // Used to detect the profile being cleared while the function was active.
+    uint32_t generation = 0;
 };
 
+/// A scope recorded for a trace
+struct PerformanceTraceEvent
+{
+    const char* name;
+    // Start time and duration, in nanoseconds since the profiler was created.
+    int64_t start;
+    int64_t duration;
+};
+
+/// The scopes recorded for a trace, by thread
+struct PerformanceTrace
+{
+    struct Thread
+    {
+        Index threadIndex = 0;
+        List<PerformanceTraceEvent> events;
+        // Events not recorded, because the thread recorded too many.
+        Count droppedEventCount = 0;
+    };
+
+    /// Write the events in the Chrome trace event JSON format, as understood by
+    /// chrome://tracing and https://ui.perfetto.dev.
+    void writeChromeTrace(StringBuilder& out) const;
+
+    List<Thread> threads;
+};
+
+struct PerformanceThreadProfile;
+
+/// Profiles named scopes (typically functions) of the compiler.
+///
+/// Every thread has a profiler of its own, returned by `getProfiler`, so that compiles on
+/// different threads don't see or clear each other's results. Work that a compile hands
+/// to other threads is recorded in the compiling thread's profiler with
+/// `PerformanceProfilerThreadRAII`.
+///
+/// Within a profiler, every thread records its own tree of scopes, so time is attributed to
+/// the chain of scopes it was spent in (e.g. `simplifyIR` under `specializeModule`). Each
+/// thread also records a bounded list of timed scope events, which can be written out as a
+/// Chrome trace.
+///
+/// A thread updates its own tree without locking, so scopes are cheap enough to always be
+/// compiled in. The trees are only combined when results are requested, which is done by the
+/// thread that owns the profiler. Results include the scopes of that thread and of threads
+/// that have stopped recording in the profiler, but not of threads still recording in it.
+///
+/// Scope names must be string literals (or otherwise outlive the profiler), as they are
+/// identified by pointer.
 class PerformanceProfiler
 {
 public:
     virtual FuncProfileContext enterFunction(const char* funcName) = 0;
     virtual void exitFunction(FuncProfileContext context) = 0;
+
+    /// Write a flat table of invocation counts and durations for each scope name, summed over
+    /// all threads and call paths, followed by the call tree of every thread.
     virtual void getResult(StringBuilder& out) = 0;
+
+    /// Get the flat table of invocation counts and durations, summed over all threads and call
+    /// paths, in order of first invocation.
+    virtual void getFlatResult(List<const char*>& outNames, List<FuncProfileInfo>& outInfos) = 0;
+
+    /// Get the recorded scope events of all threads.
+    virtual void getTrace(PerformanceTrace& outTrace) = 0;
+
+    /// Write the recorded scope events of all threads in the Chrome trace event JSON format.
+    void getChromeTrace(StringBuilder& out)
+    {
+        PerformanceTrace trace;
+        getTrace(trace);
+        trace.writeChromeTrace(out);
+    }
+
+    /// Clear the data recorded in this profiler.
     virtual void clear() = 0;
     virtual void dispose() = 0;
 
@@ -49,7 +121,45 @@ struct PerformanceProfilerFuncRAIIContext
     }
 };
 
-struct SlangProfiler : public ISlangProfiler, public RefObject
+/// Records the scopes of the current thread in `profiler` rather than in the thread's own
+/// profiler, for as long as this object exists. The thread's scopes are kept apart from
+/// those of the thread that owns `profiler`, which must outlive this object.
+struct PerformanceProfilerThreadRAII
+{
+    PerformanceProfilerThreadRAII(PerformanceProfiler* profiler);
+    ~PerformanceProfilerThreadRAII();
+
+private:
+    PerformanceProfiler* m_previousProfiler;
+    PerformanceThreadProfile* m_previousProfile;
+    PerformanceThreadProfile* m_profile;
+};
+
+/// Profiles a sequence of consecutive stages within a scope, such that entering a stage
+/// ends the previous one. The last stage ends with the scope.
+struct PerformanceProfilerStageRAIIContext
+{
+    FuncProfileContext context;
+    bool isInStage = false;
+
+    void enterStage(const char* stageName)
+    {
+        leaveStage();
+        context = PerformanceProfiler::getProfiler()->enterFunction(stageName);
+        isInStage = true;
+    }
+    void leaveStage()
+    {
+        if (isInStage)
+        {
+            PerformanceProfiler::getProfiler()->exitFunction(context);
+            isInStage = false;
+        }
+    }
+    ~PerformanceProfilerStageRAIIContext() { leaveStage(); }
+};
+
+struct SlangProfiler : public ISlangProfiler, public ISlangProfilerTrace, public RefObject
 {
 public:
     SLANG_REF_OBJECT_IUNKNOWN_ALL
@@ -67,12 +177,19 @@ public:
     virtual SLANG_NO_THROW long SLANG_MCALL getEntryTimeMS(uint32_t index) override;
     virtual SLANG_NO_THROW uint32_t SLANG_MCALL getEntryInvocationTimes(uint32_t index) override;
 
+    // ISlangProfilerTrace
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL getChromeTrace(ISlangBlob** outBlob) override;
+
 private:
     List<ProfileInfo> m_profilEntries;
+    // Only written as a Chrome trace if it is asked for.
+    PerformanceTrace m_trace;
 };
 
 #define SLANG_PROFILE PerformanceProfilerFuncRAIIContext _profileContext(__func__)
 #define SLANG_PROFILE_SECTION(s) PerformanceProfilerFuncRAIIContext _profileContext##s(#s)
+#define SLANG_PROFILE_STAGES PerformanceProfilerStageRAIIContext _profileStages
+#define SLANG_PROFILE_STAGE(s) _profileStages.enterStage(#s)
 
 } // namespace Slang
 
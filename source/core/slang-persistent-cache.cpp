@@ -2,30 +2,54 @@
 
 #include "../core/slang-blob.h"
 #include "../core/slang-io.h"
+#include "../core/slang-process.h"
 #include "../core/slang-stream.h"
 #include "../core/slang-string-util.h"
 
+#include <chrono>
+#include <thread>
+
 namespace Slang
 {
 
+static const char* kMagic = "SLS$";
+static const uint32_t kVersion = 2;
+
+static const char* kSummaryMagic = "SLSS";
+static const uint32_t kSummaryVersion = 1;
+
+// Maximum number of attempts to replace a file that is currently in use by a reader, backing
+// off exponentially from `kRenameRetryDelay`. This can only fail on Windows, where readers
+// hold the index mapping for the duration of a lookup.
+static const int kRenameAttemptCount = 10;
+static const std::chrono::microseconds kRenameRetryDelay(100);
+
 PersistentCache::PersistentCache(const Desc& desc)
 {
     m_cacheDirectory = Path::simplify(desc.directory);
     Path::createDirectory(m_cacheDirectory);
 
     m_lockFileName = Path::simplify(m_cacheDirectory + "/lock");
-    m_indexFileName = Path::simplify(m_cacheDirectory + "/index");
 
     m_lockFile.open(m_lockFileName);
 
     m_maxEntryCount = desc.maxEntryCount;
+    m_maxTotalSize = desc.maxTotalSize;
 
-    resetStats();
+    // Shards are selected by the first byte of the key.
+    m_shardCount = 1;
+    while (m_shardCount < desc.shardCount && m_shardCount < 256)
+    {
+        m_shardCount *= 2;
+    }
 
     initialize();
 }
 
-PersistentCache::~PersistentCache() {}
+PersistentCache::~PersistentCache()
+{
+    flushPendingChanges();
+}
 
 SlangResult PersistentCache::clear()
 {
@@ -51,7 +75,6 @@ SlangResult PersistentCache::clear()
         void accept(Path::Type type, const UnownedStringSlice& fileName) SLANG_OVERRIDE
         {
             String fullPath = Path::simplify(directory + "/" + fileName);
-            ;
             if (type == Path::Type::File && lockFileName != fullPath)
             {
                 Path::remove(fullPath);
@@ -62,76 +85,113 @@ SlangResult PersistentCache::clear()
     Visitor visitor(m_cacheDirectory, m_lockFileName);
     Path::find(m_cacheDirectory, nullptr, &visitor);
 
-    m_stats.entryCount = 0;
+    {
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        m_pendingAccesses.clear();
+        m_pendingEntries.clear();
+        m_pendingEntryCount = 0;
+    }
+
+    // Write an empty summary, so that the next write doesn't need to rebuild it.
+    CacheSummary summary;
+    summary.setCount(m_shardCount);
+    ::memset(summary.getBuffer(), 0, summary.getCount() * sizeof(ShardSummary));
+    writeSummary(summary);
+
+    m_entryCount = 0;
 
     return SLANG_OK;
 }
 
+PersistentCache::Stats PersistentCache::getStats() const
+{
+    Stats stats;
+    stats.hitCount = m_hitCount.load();
+    stats.missCount = m_missCount.load();
+    stats.entryCount = m_entryCount.load();
+    return stats;
+}
+
 void PersistentCache::resetStats()
 {
-    m_stats.entryCount = 0;
-    m_stats.hitCount = 0;
-    m_stats.missCount = 0;
+    // The entry count describes the contents of the cache rather than its use, so it stays.
+    m_hitCount = 0;
+    m_missCount = 0;
 }
 
 SlangResult PersistentCache::readEntry(const Key& key, ISlangBlob** outData)
 {
     // Be pessimistic and assume we have a cache miss.
-    ++m_stats.missCount;
+    ++m_missCount;
 
-    if (!m_lockFile.isOpen())
+    // Look up the entry in the mapped shard index. This does not take the lock, as the index
+    // is only ever replaced as a whole (see `writeFileAtomic`), so the mapping is always of a
+    // complete index, even if it is no longer the latest one. The mapping is closed before
+    // reading the entry, as on Windows the index can't be replaced while it is mapped.
+    bool isIndexed;
     {
-        return SLANG_E_CANNOT_OPEN;
-    }
-
-    // Acquire the exclusive lock.
-    std::lock_guard<std::mutex> mutexLock(m_mutex);
-    LockFileGuard fileLock(m_lockFile);
+        MemoryMappedFile indexFile;
+        SlangResult result = indexFile.open(getIndexFileName(key), MemoryMappedFile::Access::Read);
+        if (SLANG_FAILED(result) && result != SLANG_E_NOT_FOUND)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
 
-    // Return if index does not exist.
-    if (!File::exists(m_indexFileName))
-    {
-        return SLANG_E_NOT_FOUND;
+        CacheEntry* entries = nullptr;
+        uint32_t count = 0;
+        if (SLANG_SUCCEEDED(result))
+        {
+            SLANG_RETURN_ON_FAIL(
+                validateIndex(indexFile.getData(), indexFile.getSize(), &entries, &count));
+        }
+        isIndexed = findEntry(entries, count, key) != -1;
     }
 
-    // Read the cache index.
-    CacheIndex cacheIndex;
-    SLANG_RETURN_ON_FAIL(readIndex(m_indexFileName, cacheIndex));
-
-    // Increase the age of all entries in the cache.
-    for (auto& entry : cacheIndex)
+    // An entry whose shard index couldn't be written is only known to this process.
+    if (!isIndexed && m_pendingEntryCount > 0)
     {
-        ++entry.age;
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        isIndexed = m_pendingEntries.containsKey(key);
     }
-
-    // Find the entry.
-    Index entryIndex =
-        cacheIndex.findFirstIndex([&key](const CacheEntry& entry) { return entry.key == key; });
-    if (entryIndex == -1)
+    if (!isIndexed)
     {
         return SLANG_E_NOT_FOUND;
     }
 
     // Read the entry.
-    String entryFileName = getEntryFileName(key);
     ScopedAllocation data;
-    SlangResult result = File::readAllBytes(entryFileName, data);
+    SlangResult result = File::readAllBytes(getEntryFileName(key), data);
     if (result == SLANG_OK)
     {
-        --m_stats.missCount;
-        ++m_stats.hitCount;
-        cacheIndex[entryIndex].age = 0;
+        --m_missCount;
+        ++m_hitCount;
+
+        // Record the access, to be written to the index by the next write to the shard.
+        if (m_lockFile.isOpen())
+        {
+            const uint64_t accessTime = getAccessTime();
+            std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+            m_pendingAccesses.set(key, accessTime);
+        }
+
         auto blob = RawBlob::moveCreate(data);
         *outData = blob.detach();
+        return SLANG_OK;
     }
-    else
+
+    // The entry file is missing or unreadable, so remove the entry from the index.
+    // This requires the exclusive lock. If the entry is no longer in the index, it has been
+    // evicted concurrently since we looked it up, which is just a regular miss.
+    if (!m_lockFile.isOpen())
     {
-        cacheIndex.removeAt(entryIndex);
+        return SLANG_E_NOT_FOUND;
+    }
+    std::lock_guard<std::mutex> mutexLock(m_mutex);
+    LockFileGuard fileLock(m_lockFile);
+    if (removeEntry(key) == SLANG_E_NOT_FOUND)
+    {
+        return SLANG_E_NOT_FOUND;
     }
-
-    // Write the cache index.
-    SLANG_RETURN_ON_FAIL(writeIndex(m_indexFileName, cacheIndex));
-    m_stats.entryCount = (Count)cacheIndex.getCount();
 
     return result;
 }
@@ -149,64 +209,207 @@ SlangResult PersistentCache::writeEntry(const Key& key, ISlangBlob* data)
     std::lock_guard<std::mutex> mutexLock(m_mutex);
     LockFileGuard fileLock(m_lockFile);
 
-    // Read the cache index.
+    const Index shardIndex = getShardIndex(key);
+
+    // Write the cache entry.
+    String entryFileName = getEntryFileName(key);
+    SLANG_RETURN_ON_FAIL(
+        writeFileAtomic(entryFileName, data->getBufferPointer(), data->getBufferSize()));
+
+    // The summary has the totals and oldest access time of every shard, so only the shard
+    // written to and the shards evicted from need to be loaded.
+    CacheSummary summary;
+    loadSummary(summary);
+
+    List<CacheIndex> shards;
+    List<bool> shardLoaded;
+    List<bool> shardDirty;
+    shards.setCount(m_shardCount);
+    shardLoaded.setCount(m_shardCount);
+    shardDirty.setCount(m_shardCount);
+    for (Index i = 0; i < m_shardCount; ++i)
+    {
+        shardLoaded[i] = false;
+        shardDirty[i] = false;
+    }
+
+    // Load a shard index, with the changes pending in this process applied. The summary of
+    // the shard is updated, as it may be out of date, e.g. if a process was terminated
+    // between writing the index and the summary.
     // We ignore any errors when reading the index and just write a new one.
-    CacheIndex cacheIndex;
-    readIndex(m_indexFileName, cacheIndex);
-
-    // Increase the age of all entries in the cache and get the index of
-    // the oldest entry.
-    Index oldestEntryIndex = -1;
-    uint32_t oldestEntryAge = 0;
-    for (Index entryIndex = 0; entryIndex < cacheIndex.getCount(); ++entryIndex)
-    {
-        auto& entry = cacheIndex[entryIndex];
-        ++entry.age;
-        if (entry.age > oldestEntryAge)
+    auto loadShard = [&](Index i)
+    {
+        if (shardLoaded[i])
+            return;
+        if (SLANG_FAILED(readIndex(getIndexFileName(i), shards[i])))
+        {
+            shards[i].clear();
+        }
+        applyPendingChanges(i, shards[i]);
+        summary[i] = summarizeShard(shards[i]);
+        shardLoaded[i] = true;
+    };
+
+    const CacheEntry newEntry = {key, (uint32_t)data->getBufferSize(), getAccessTime()};
+    loadShard(shardIndex);
+    setEntry(shards[shardIndex], newEntry);
+    summary[shardIndex] = summarizeShard(shards[shardIndex]);
+    shardDirty[shardIndex] = true;
+
+    // Entries that couldn't be indexed earlier are retried along with this one.
+    if (m_pendingEntryCount > 0)
+    {
+        List<Index> pendingShardIndices;
+        {
+            std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+            for (const auto& [pendingKey, _] : m_pendingEntries)
+                pendingShardIndices.add(getShardIndex(pendingKey));
+        }
+        for (Index i : pendingShardIndices)
         {
-            oldestEntryIndex = entryIndex;
-            oldestEntryAge = entry.age;
+            loadShard(i);
+            shardDirty[i] = true;
         }
     }
 
-    // Write the cache entry.
-    String entryFileName = getEntryFileName(key);
-    SLANG_RETURN_ON_FAIL(
-        File::writeAllBytes(entryFileName, data->getBufferPointer(), data->getBufferSize()));
+    Count totalCount = 0;
+    uint64_t totalSize = 0;
+    for (const auto& shardSummary : summary)
+    {
+        totalCount += shardSummary.count;
+        totalSize += shardSummary.totalSize;
+    }
 
-    // Update the index.
-    if (m_maxEntryCount > 0 && cacheIndex.getCount() >= m_maxEntryCount)
+    // Evict the least recently used entries until the cache is within its budget.
+    // The shard holding the oldest entry is found from the summary. Its summary may be older
+    // than the accesses pending in this process, so it is loaded before evicting from it,
+    // after which the oldest shard is looked for again.
+    List<Key> evictedKeys;
+    List<Index> evictedShardIndices;
+    auto isOverBudget = [&]()
+    {
+        return (m_maxEntryCount > 0 && totalCount > m_maxEntryCount) ||
+               (m_maxTotalSize > 0 && totalSize > m_maxTotalSize);
+    };
+    while (isOverBudget())
     {
-        // Replace oldest entry.
-        SLANG_ASSERT(oldestEntryIndex >= 0);
-        File::remove(getEntryFileName(cacheIndex[oldestEntryIndex].key));
-        cacheIndex[oldestEntryIndex] = CacheEntry{key, 0};
+        Index oldestShardIndex = -1;
+        for (Index i = 0; i < m_shardCount; ++i)
+        {
+            // Never evict the entry we just wrote.
+            const uint32_t minCount = i == shardIndex ? 2 : 1;
+            if (summary[i].count < minCount)
+                continue;
+            if (oldestShardIndex == -1 ||
+                summary[i].oldestAccess < summary[oldestShardIndex].oldestAccess)
+            {
+                oldestShardIndex = i;
+            }
+        }
+
+        if (oldestShardIndex == -1)
+        {
+            break;
+        }
+        if (!shardLoaded[oldestShardIndex])
+        {
+            const ShardSummary oldSummary = summary[oldestShardIndex];
+            loadShard(oldestShardIndex);
+            totalCount += Count(summary[oldestShardIndex].count) - Count(oldSummary.count);
+            totalSize += summary[oldestShardIndex].totalSize - oldSummary.totalSize;
+            continue;
+        }
+
+        auto& index = shards[oldestShardIndex];
+        Index oldestEntryIndex = -1;
+        for (Index j = 0; j < index.getCount(); ++j)
+        {
+            if (index[j].key == key)
+                continue;
+            if (oldestEntryIndex == -1 || index[j].lastAccess < index[oldestEntryIndex].lastAccess)
+            {
+                oldestEntryIndex = j;
+            }
+        }
+        SLANG_ASSERT(oldestEntryIndex != -1);
+
+        evictedKeys.add(index[oldestEntryIndex].key);
+        evictedShardIndices.add(oldestShardIndex);
+        totalCount -= 1;
+        totalSize -= index[oldestEntryIndex].size;
+        index.removeAt(oldestEntryIndex);
+        summary[oldestShardIndex] = summarizeShard(index);
+        shardDirty[oldestShardIndex] = true;
     }
-    else
+
+    // Write the modified shard indices.
+    SlangResult result = SLANG_OK;
+    List<bool> shardWritten;
+    shardWritten.setCount(m_shardCount);
+    for (Index i = 0; i < m_shardCount; ++i)
     {
-        // Add new entry.
-        cacheIndex.add(CacheEntry{key, 0});
+        shardWritten[i] = false;
+        if (!shardDirty[i])
+            continue;
+
+        SlangResult shardResult = writeIndex(getIndexFileName(i), shards[i]);
+        if (SLANG_SUCCEEDED(shardResult))
+        {
+            shardWritten[i] = true;
+            commitPendingChanges(i);
+            continue;
+        }
+
+        if (i == shardIndex)
+        {
+            result = shardResult;
+        }
+        // The index on disk is unchanged, so go back to its summary.
+        CacheIndex index;
+        if (SLANG_FAILED(readIndex(getIndexFileName(i), index)))
+        {
+            index.clear();
+        }
+        summary[i] = summarizeShard(index);
     }
 
-    // Write the cache index.
-    SlangResult result = writeIndex(m_indexFileName, cacheIndex);
-    if (result == SLANG_OK)
+    if (result == SLANG_E_TIME_OUT)
     {
-        m_stats.entryCount = (Count)cacheIndex.getCount();
+        // The index is in use by a reader and couldn't be replaced. Rather than dropping the
+        // entry, keep it pending, so that it is visible to this process and is indexed by the
+        // next write or when the cache is destroyed.
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        m_pendingEntries.set(key, newEntry);
+        m_pendingEntryCount = (Count)m_pendingEntries.getCount();
+        result = SLANG_OK;
     }
-    else
+    else if (SLANG_FAILED(result))
     {
         // If writing the index failed, remove the entry file to avoid growing the cache.
         Path::remove(entryFileName);
     }
 
+    // Entries evicted from a shard that couldn't be written are still indexed.
+    for (Index i = 0; i < evictedKeys.getCount(); ++i)
+    {
+        if (shardWritten[evictedShardIndices[i]])
+            File::remove(getEntryFileName(evictedKeys[i]));
+    }
+
+    writeSummary(summary);
+    updateEntryCount(summary);
+
     return result;
 }
 
 SlangResult PersistentCache::initialize()
 {
+    CacheSummary summary;
     if (!m_lockFile.isOpen())
     {
+        // The cache can't be written, so there is no need for the lock. Index files are only
+        // replaced as a whole, so their contents are still consistent.
+        loadSummary(summary);
         return SLANG_E_CANNOT_OPEN;
     }
 
@@ -214,15 +417,16 @@ SlangResult PersistentCache::initialize()
     std::lock_guard<std::mutex> mutexLock(m_mutex);
     LockFileGuard fileLock(m_lockFile);
 
-    CacheIndex cacheIndex;
-    if (SLANG_SUCCEEDED(readIndex(m_indexFileName, cacheIndex)))
-    {
-        m_stats.entryCount = (Count)cacheIndex.getCount();
-    }
+    loadSummary(summary);
 
     return SLANG_OK;
 }
 
+Index PersistentCache::getShardIndex(const Key& key) const
+{
+    return Index(((const uint8_t*)key.data)[0] & (m_shardCount - 1));
+}
+
 String PersistentCache::getEntryFileName(const Key& key)
 {
     StringBuilder str;
@@ -230,59 +434,383 @@ String PersistentCache::getEntryFileName(const Key& key)
     return str;
 }
 
-struct CacheIndexHeader
+String PersistentCache::getSummaryFileName()
+{
+    StringBuilder str;
+    str << m_cacheDirectory << "/summary";
+    return str;
+}
+
+String PersistentCache::getIndexFileName(Index shardIndex)
 {
-    char magic[4];
-    uint32_t version;
-    uint32_t count;
-    uint32_t reserved;
-};
+    static const char kHexDigits[] = "0123456789abcdef";
 
-static const char* kMagic = "SLS$";
-static const uint32_t kVersion = 1;
+    StringBuilder str;
+    str << m_cacheDirectory << "/index-" << kHexDigits[(shardIndex >> 4) & 0xf]
+        << kHexDigits[shardIndex & 0xf];
+    return str;
+}
 
-SlangResult PersistentCache::readIndex(const String& fileName, CacheIndex& outIndex)
+uint64_t PersistentCache::getAccessTime()
 {
-    FileStream fs;
-    SLANG_RETURN_ON_FAIL(fs.init(fileName, FileMode::Open));
+    const uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+
+    uint64_t last = m_lastAccessTime.load();
+    uint64_t next;
+    do
+    {
+        next = now > last ? now : last + 1;
+    } while (!m_lastAccessTime.compare_exchange_weak(last, next));
+    return next;
+}
 
-    // Get file size.
-    SLANG_RETURN_ON_FAIL(fs.seek(SeekOrigin::End, 0));
-    size_t fileSize = (size_t)fs.getPosition();
-    SLANG_RETURN_ON_FAIL(fs.seek(SeekOrigin::Start, 0));
+/* static */ SlangResult PersistentCache::validateIndex(
+    const void* data,
+    size_t size,
+    CacheEntry** outEntries,
+    uint32_t* outCount)
+{
+    if (size < sizeof(CacheIndexHeader))
+    {
+        return SLANG_E_INTERNAL_FAIL;
+    }
 
     CacheIndexHeader header;
-    SLANG_RETURN_ON_FAIL(fs.readExactly(&header, sizeof(header)));
+    ::memcpy(&header, data, sizeof(header));
     if (::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion)
     {
         return SLANG_E_INTERNAL_FAIL;
     }
 
     // Return if payload does not have the right size.
-    if (header.count * sizeof(CacheEntry) != fileSize - sizeof(header))
+    if (uint64_t(header.count) * sizeof(CacheEntry) != size - sizeof(header))
     {
         return SLANG_E_INTERNAL_FAIL;
     }
 
-    outIndex.setCount(header.count);
-    SLANG_RETURN_ON_FAIL(fs.readExactly(outIndex.getBuffer(), header.count * sizeof(CacheEntry)));
+    *outEntries = (CacheEntry*)((uint8_t*)data + sizeof(header));
+    *outCount = header.count;
 
     return SLANG_OK;
 }
 
-SlangResult PersistentCache::writeIndex(const String& fileName, const CacheIndex& index)
+/* static */ Index PersistentCache::findEntry(
+    const CacheEntry* entries,
+    uint32_t count,
+    const Key& key)
 {
-    FileStream fs;
-    SLANG_RETURN_ON_FAIL(fs.init(fileName, FileMode::Create));
+    // Binary search, entries are sorted by key.
+    Index lo = 0;
+    Index hi = Index(count);
+    while (lo < hi)
+    {
+        const Index mid = lo + (hi - lo) / 2;
+        const int cmp = ::memcmp(&entries[mid].key, &key, sizeof(Key));
+        if (cmp == 0)
+        {
+            return mid;
+        }
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return -1;
+}
 
+/* static */ void PersistentCache::setEntry(CacheIndex& index, const CacheEntry& entry)
+{
+    const Index entryIndex = findEntry(index.getBuffer(), (uint32_t)index.getCount(), entry.key);
+    if (entryIndex >= 0)
+    {
+        index[entryIndex] = entry;
+        return;
+    }
+
+    // Keep the index sorted by key.
+    Index insertIndex = 0;
+    while (insertIndex < index.getCount() &&
+           ::memcmp(&index[insertIndex].key, &entry.key, sizeof(Key)) < 0)
+    {
+        ++insertIndex;
+    }
+    index.insert(insertIndex, entry);
+}
+
+/* static */ PersistentCache::ShardSummary PersistentCache::summarizeShard(
+    const CacheIndex& index)
+{
+    ShardSummary summary = {};
+    summary.count = (uint32_t)index.getCount();
+    for (const auto& entry : index)
+    {
+        summary.totalSize += entry.size;
+        if (summary.oldestAccess == 0 || entry.lastAccess < summary.oldestAccess)
+            summary.oldestAccess = entry.lastAccess;
+    }
+    return summary;
+}
+
+SlangResult PersistentCache::readIndex(const String& fileName, CacheIndex& outIndex)
+{
+    ScopedAllocation data;
+    SLANG_RETURN_ON_FAIL(File::readAllBytes(fileName, data));
+
+    CacheEntry* entries = nullptr;
+    uint32_t count = 0;
+    SLANG_RETURN_ON_FAIL(validateIndex(data.getData(), data.getSizeInBytes(), &entries, &count));
+
+    outIndex.setCount(count);
+    if (count)
+    {
+        ::memcpy(outIndex.getBuffer(), entries, count * sizeof(CacheEntry));
+    }
+
+    return SLANG_OK;
+}
+
+SlangResult PersistentCache::writeIndex(const String& fileName, const CacheIndex& index)
+{
     CacheIndexHeader header;
     ::memcpy(header.magic, kMagic, 4);
     header.version = kVersion;
     header.count = (uint32_t)index.getCount();
     header.reserved = 0;
-    SLANG_RETURN_ON_FAIL(fs.write(&header, sizeof(header)));
+    header.totalSize = 0;
+    for (const auto& entry : index)
+    {
+        header.totalSize += entry.size;
+    }
+
+    const size_t payloadSize = index.getCount() * sizeof(CacheEntry);
+    List<uint8_t> data;
+    data.setCount(sizeof(header) + payloadSize);
+    ::memcpy(data.getBuffer(), &header, sizeof(header));
+    if (payloadSize)
+    {
+        ::memcpy(data.getBuffer() + sizeof(header), index.getBuffer(), payloadSize);
+    }
+
+    return writeFileAtomic(fileName, data.getBuffer(), data.getCount());
+}
+
+SlangResult PersistentCache::writeFileAtomic(const String& fileName, const void* data, size_t size)
+{
+    // The temporary file name must be unique over all threads and processes using the cache.
+    StringBuilder tempFileName;
+    tempFileName << fileName << ".tmp" << Process::getId() << "-" << m_tempFileCounter++;
+
+    SLANG_RETURN_ON_FAIL(File::writeAllBytes(tempFileName, data, size));
+
+    // On Windows, a file can't be replaced while it is mapped, which readers only do for the
+    // duration of a lookup, so the rename is retried for a while.
+    std::chrono::microseconds delay = kRenameRetryDelay;
+    for (int attempt = 0; attempt < kRenameAttemptCount; ++attempt)
+    {
+        if (SLANG_SUCCEEDED(File::rename(tempFileName, fileName)))
+        {
+            return SLANG_OK;
+        }
+        std::this_thread::sleep_for(delay);
+        delay *= 2;
+    }
+
+    File::remove(tempFileName);
+    return SLANG_E_TIME_OUT;
+}
+
+SlangResult PersistentCache::readSummary(CacheSummary& outSummary)
+{
+    ScopedAllocation data;
+    SLANG_RETURN_ON_FAIL(File::readAllBytes(getSummaryFileName(), data));
+
+    CacheSummaryHeader header;
+    if (data.getSizeInBytes() != sizeof(header) + m_shardCount * sizeof(ShardSummary))
+    {
+        return SLANG_E_INTERNAL_FAIL;
+    }
+    ::memcpy(&header, data.getData(), sizeof(header));
+    if (::memcmp(header.magic, kSummaryMagic, 4) != 0 || header.version != kSummaryVersion ||
+        header.shardCount != uint32_t(m_shardCount))
+    {
+        return SLANG_E_INTERNAL_FAIL;
+    }
+
+    outSummary.setCount(m_shardCount);
+    ::memcpy(
+        outSummary.getBuffer(),
+        (const uint8_t*)data.getData() + sizeof(header),
+        m_shardCount * sizeof(ShardSummary));
+
+    return SLANG_OK;
+}
+
+SlangResult PersistentCache::writeSummary(const CacheSummary& summary)
+{
+    CacheSummaryHeader header;
+    ::memcpy(header.magic, kSummaryMagic, 4);
+    header.version = kSummaryVersion;
+    header.shardCount = uint32_t(m_shardCount);
+    header.reserved = 0;
+
+    const size_t payloadSize = summary.getCount() * sizeof(ShardSummary);
+    List<uint8_t> data;
+    data.setCount(sizeof(header) + payloadSize);
+    ::memcpy(data.getBuffer(), &header, sizeof(header));
+    ::memcpy(data.getBuffer() + sizeof(header), summary.getBuffer(), payloadSize);
+
+    return writeFileAtomic(getSummaryFileName(), data.getBuffer(), data.getCount());
+}
+
+void PersistentCache::rebuildSummary(CacheSummary& outSummary)
+{
+    outSummary.setCount(m_shardCount);
+    for (Index i = 0; i < m_shardCount; ++i)
+    {
+        // Corrupt shards are treated as empty, they are rewritten on the next write to them.
+        CacheIndex index;
+        if (SLANG_FAILED(readIndex(getIndexFileName(i), index)))
+        {
+            index.clear();
+        }
+        outSummary[i] = summarizeShard(index);
+    }
+}
+
+void PersistentCache::loadSummary(CacheSummary& outSummary)
+{
+    if (SLANG_FAILED(readSummary(outSummary)))
+    {
+        rebuildSummary(outSummary);
+        if (m_lockFile.isOpen())
+        {
+            writeSummary(outSummary);
+        }
+    }
+    updateEntryCount(outSummary);
+}
+
+void PersistentCache::updateEntryCount(const CacheSummary& summary)
+{
+    Count totalCount = 0;
+    for (const auto& shardSummary : summary)
+    {
+        totalCount += shardSummary.count;
+    }
+    m_entryCount = totalCount + m_pendingEntryCount;
+}
+
+void PersistentCache::applyPendingChanges(Index shardIndex, CacheIndex& index)
+{
+    std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+    for (const auto& [key, entry] : m_pendingEntries)
+    {
+        if (getShardIndex(key) == shardIndex)
+            setEntry(index, entry);
+    }
+    for (const auto& [key, accessTime] : m_pendingAccesses)
+    {
+        if (getShardIndex(key) != shardIndex)
+            continue;
+        const Index entryIndex = findEntry(index.getBuffer(), (uint32_t)index.getCount(), key);
+        if (entryIndex >= 0 && index[entryIndex].lastAccess < accessTime)
+            index[entryIndex].lastAccess = accessTime;
+    }
+}
+
+void PersistentCache::commitPendingChanges(Index shardIndex)
+{
+    std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+    m_pendingEntries.removeIf([&](const auto& pair)
+                              { return getShardIndex(pair.first) == shardIndex; });
+    m_pendingAccesses.removeIf([&](const auto& pair)
+                               { return getShardIndex(pair.first) == shardIndex; });
+    m_pendingEntryCount = (Count)m_pendingEntries.getCount();
+}
+
+void PersistentCache::flushPendingChanges()
+{
+    if (!m_lockFile.isOpen())
+    {
+        return;
+    }
+
+    List<bool> shardPending;
+    shardPending.setCount(m_shardCount);
+    for (Index i = 0; i < m_shardCount; ++i)
+    {
+        shardPending[i] = false;
+    }
+    bool hasPendingChanges = false;
+    {
+        std::lock_guard<std::mutex> pendingLock(m_pendingMutex);
+        for (const auto& [key, _] : m_pendingEntries)
+            shardPending[getShardIndex(key)] = true;
+        for (const auto& [key, _] : m_pendingAccesses)
+            shardPending[getShardIndex(key)] = true;
+        hasPendingChanges = m_pendingEntries.getCount() || m_pendingAccesses.getCount();
+    }
+    if (!hasPendingChanges)
+    {
+        return;
+    }
+
+    // Acquire the exclusive lock.
+    std::lock_guard<std::mutex> mutexLock(m_mutex);
+    LockFileGuard fileLock(m_lockFile);
+
+    CacheSummary summary;
+    loadSummary(summary);
+
+    for (Index i = 0; i < m_shardCount; ++i)
+    {
+        if (!shardPending[i])
+            continue;
+
+        CacheIndex index;
+        if (SLANG_FAILED(readIndex(getIndexFileName(i), index)))
+        {
+            index.clear();
+        }
+        applyPendingChanges(i, index);
+        if (SLANG_SUCCEEDED(writeIndex(getIndexFileName(i), index)))
+        {
+            commitPendingChanges(i);
+            summary[i] = summarizeShard(index);
+        }
+    }
+
+    writeSummary(summary);
+    updateEntryCount(summary);
+}
+
+SlangResult PersistentCache::removeEntry(const Key& key)
+{
+    const String indexFileName = getIndexFileName(key);
+
+    CacheIndex index;
+    SLANG_RETURN_ON_FAIL(readIndex(indexFileName, index));
+
+    const Index entryIndex = findEntry(index.getBuffer(), (uint32_t)index.getCount(), key);
+    if (entryIndex == -1)
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+
+    index.removeAt(entryIndex);
+    SLANG_RETURN_ON_FAIL(writeIndex(indexFileName, index));
 
-    SLANG_RETURN_ON_FAIL(fs.write(index.getBuffer(), index.getCount() * sizeof(CacheEntry)));
+    CacheSummary summary;
+    loadSummary(summary);
+    summary[getShardIndex(key)] = summarizeShard(index);
+    writeSummary(summary);
+    updateEntryCount(summary);
 
     return SLANG_OK;
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include "../core/slang-crypto.h"
+#include "../core/slang-dictionary.h"
 #include "../core/slang-io.h"
 #include "../core/slang-string.h"
 #include "slang.h"
 
+#include <atomic>
 #include <mutex>
 
 namespace Slang
@@ -11,9 +13,21 @@ namespace Slang
 
 /// Implements a simple persistent cache on the filesystem for storing key/value pairs.
 /// Keys are SHA1 hashes and values are arbitrary blobs of data.
-/// The cache is save for concurrent access from multiple threads/processes by using
-/// a lock file within the cache directory. Furthermore, the cache implements a LRU
-/// eviction policy.
+///
+/// Entries are distributed over a number of shards by key prefix, each shard having its own
+/// index file, so that updating the index only requires rewriting a small part of it.
+/// A summary file holds the entry count, total size and oldest access time of every shard,
+/// so a write only needs to load the shard it writes to, plus the shards it evicts from.
+/// The cache is safe for concurrent access from multiple threads/processes. Modifications
+/// are serialized by a lock file within the cache directory, while cache hits are served from
+/// a read only mapping of the shard index without taking the lock. Entry and index files are
+/// written to a temporary file and then renamed, so readers never observe partial files.
+/// Readers never write to the index. Instead, accesses are recorded in memory and written
+/// to a shard index by the next write that modifies that shard, or when the cache is
+/// destroyed. A cache in a directory that can't be written to can still be read, but reads
+/// don't update the LRU order.
+/// Furthermore, the cache implements a LRU eviction policy, limited by entry count and/or
+/// total size.
 class PersistentCache : public RefObject
 {
 public:
@@ -23,6 +37,12 @@ public:
         const char* directory = nullptr;
         // The maximum number of entries stored in the cache. By default, there is no limit.
         Count maxEntryCount = 0;
+        // The maximum total size in bytes of all entries stored in the cache. By default, there
+        // is no limit.
+        uint64_t maxTotalSize = 0;
+        // The number of shards the index is split into. Rounded up to a power of two and
+        // clamped to [1, 256]. All users of a cache directory must use the same shard count.
+        Count shardCount = 256;
     };
 
     struct Stats
@@ -43,7 +63,8 @@ public:
     /// Clear the contents of the cache by removing the cache index and all entry files.
     SlangResult clear();
 
-    const Stats& getStats() const { return m_stats; }
+    Stats getStats() const;
+    /// Reset the hit and miss counts. The entry count is left as it is.
     void resetStats();
 
     /// Read an entry from the cache.
@@ -58,21 +79,112 @@ private:
     struct CacheEntry
     {
         Key key;
-        uint32_t age;
+        // Size of the entry data in bytes.
+        uint32_t size;
+        // Time of the last access, used for LRU eviction.
+        uint64_t lastAccess;
     };
 
+    struct CacheIndexHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+        // Sum of the sizes of all entries in the shard.
+        uint64_t totalSize;
+    };
+
+    // Entries in a shard index are sorted by key.
     using CacheIndex = List<CacheEntry>;
 
+    struct CacheSummaryHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t shardCount;
+        uint32_t reserved;
+    };
+
+    struct ShardSummary
+    {
+        uint32_t count;
+        uint32_t reserved;
+        // Sum of the sizes of all entries in the shard.
+        uint64_t totalSize;
+        // Smallest access time of all entries in the shard, used to find the shard to evict
+        // from.
+        uint64_t oldestAccess;
+    };
+
+    // One summary per shard, indexed by shard index.
+    using CacheSummary = List<ShardSummary>;
+
     SlangResult initialize();
 
+    Index getShardIndex(const Key& key) const;
+
     String getEntryFileName(const Key& key);
+    String getIndexFileName(Index shardIndex);
+    String getIndexFileName(const Key& key) { return getIndexFileName(getShardIndex(key)); }
+    String getSummaryFileName();
+
+    /// Get a new access time, strictly increasing within this process.
+    uint64_t getAccessTime();
+
+    /// Validate an index image (as mapped or read from disk) and return the entries.
+    static SlangResult validateIndex(
+        const void* data,
+        size_t size,
+        CacheEntry** outEntries,
+        uint32_t* outCount);
+
+    static Index findEntry(const CacheEntry* entries, uint32_t count, const Key& key);
+
+    /// Add an entry to an index, or replace the entry with the same key.
+    static void setEntry(CacheIndex& index, const CacheEntry& entry);
+
+    static ShardSummary summarizeShard(const CacheIndex& index);
 
     SlangResult readIndex(const String& fileName, CacheIndex& outIndex);
     SlangResult writeIndex(const String& fileName, const CacheIndex& index);
 
+    /// Read the summary file.
+    /// Returns a failure if it is missing or doesn't match the shard count.
+    SlangResult readSummary(CacheSummary& outSummary);
+    SlangResult writeSummary(const CacheSummary& summary);
+
+    /// Compute the summary from the index files of all shards. Only needed when the summary
+    /// file is missing or corrupt.
+    void rebuildSummary(CacheSummary& outSummary);
+
+    /// Read the summary, rebuilding it if needed, and update the entry count from it.
+    /// Must be called with the exclusive lock held, unless the cache can't be written.
+    void loadSummary(CacheSummary& outSummary);
+
+    /// Set the entry count to the total of the summary and the pending entries.
+    void updateEntryCount(const CacheSummary& summary);
+
+    /// Write a file atomically by writing to a temporary file and renaming it.
+    /// Returns SLANG_E_TIME_OUT if the file couldn't be replaced, because it was in use.
+    SlangResult writeFileAtomic(const String& fileName, const void* data, size_t size);
+
+    /// Apply the pending accesses and entries of a shard to its index.
+    void applyPendingChanges(Index shardIndex, CacheIndex& index);
+
+    /// Forget the pending accesses and entries of a shard once its index has been written.
+    void commitPendingChanges(Index shardIndex);
+
+    /// Write all pending accesses and entries to their shard indices.
+    void flushPendingChanges();
+
+    /// Remove an entry from its shard index.
+    /// Returns SLANG_E_NOT_FOUND if the entry is not in the index.
+    /// Must be called with the exclusive lock held.
+    SlangResult removeEntry(const Key& key);
+
     String m_cacheDirectory;
     String m_lockFileName;
-    String m_indexFileName;
 
     // For exclusive locking we need both a mutex (acquired first)
     // followed by a a file lock. The mutex is needed because on Linux
@@ -81,8 +193,25 @@ private:
     Slang::LockFile m_lockFile;
 
     Count m_maxEntryCount;
-
-    Stats m_stats;
+    uint64_t m_maxTotalSize;
+    Count m_shardCount;
+
+    // Changes that haven't been written to the shard indices yet, protected by
+    // `m_pendingMutex`. Accesses are recorded by readers, which don't take the lock. Entries
+    // are only pending if their shard index couldn't be replaced, as on Windows a file can't
+    // be replaced while it is mapped by a reader.
+    std::mutex m_pendingMutex;
+    Dictionary<Key, uint64_t> m_pendingAccesses;
+    Dictionary<Key, CacheEntry> m_pendingEntries;
+    std::atomic<Count> m_pendingEntryCount = 0;
+
+    std::atomic<uint64_t> m_lastAccessTime = 0;
+    std::atomic<uint64_t> m_tempFileCounter = 0;
+
+    // Stats are updated from the lock-free read path, so are kept as atomics.
+    std::atomic<Count> m_hitCount = 0;
+    std::atomic<Count> m_missCount = 0;
+    std::atomic<Count> m_entryCount = 0;
 
     // Used for unit tests.
     friend struct PersistentCacheTest;
@@ -115,6 +115,22 @@ SlangResult RiffFileSystem::saveFileBlob(const char* path, ISlangBlob* dataBlob)
 }
 
 SlangResult RiffFileSystem::loadArchive(const void* archive, size_t archiveSizeInBytes)
+{
+    return _loadArchive(archive, archiveSizeInBytes, nullptr);
+}
+
+SlangResult RiffFileSystem::loadArchiveInPlace(ISlangBlob* archiveBlob)
+{
+    return _loadArchive(
+        archiveBlob->getBufferPointer(),
+        archiveBlob->getBufferSize(),
+        archiveBlob);
+}
+
+SlangResult RiffFileSystem::_loadArchive(
+    const void* archive,
+    size_t archiveSizeInBytes,
+    ISlangBlob* archiveBlob)
 {
     // Load the riff
     auto rootList = RIFF::RootChunk::getFromBlob(archive, archiveSizeInBytes);
@@ -206,9 +222,20 @@ SlangResult RiffFileSystem::loadArchive(const void* archive, size_t archiveSizeI
                         return SLANG_FAIL;
                     }
 
-                    // Get the compressed data
-                    dstEntry.m_contents =
-                        RawBlob::create(reader.getRemainingData(), srcEntry.compressedSize);
+                    // Get the compressed data, referencing the archive if it can be kept alive
+                    if (archiveBlob)
+                    {
+                        dstEntry.m_contents = ScopeBlob::create(
+                            UnownedRawBlob::create(
+                                reader.getRemainingData(),
+                                srcEntry.compressedSize),
+                            archiveBlob);
+                    }
+                    else
+                    {
+                        dstEntry.m_contents =
+                            RawBlob::create(reader.getRemainingData(), srcEntry.compressedSize);
+                    }
                     break;
                 }
             case SLANG_PATH_TYPE_DIRECTORY:
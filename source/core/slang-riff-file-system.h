@@ -82,6 +82,13 @@ public:
         m_compressionStyle = style;
     }
 
+    /// Load an archive held in `archiveBlob`, without copying the contents of its files.
+    ///
+    /// The contents of each file are viewed in place in the archive, and hold a reference to
+    /// `archiveBlob` to keep it alive. For an uncompressed archive, `loadFile` then returns
+    /// those views as is.
+    SlangResult loadArchiveInPlace(ISlangBlob* archiveBlob);
+
     /// Pass in nullptr, if no compression is wanted.
     explicit RiffFileSystem(ICompressionSystem* compressionSystem);
 
@@ -92,6 +99,13 @@ protected:
     void* getInterface(const Guid& guid);
     void* getObject(const Guid& guid);
 
+    /// Load the archive. If `archiveBlob` is set it holds the archive, and file contents
+    /// reference it instead of being copied.
+    SlangResult _loadArchive(
+        const void* archive,
+        size_t archiveSizeInBytes,
+        ISlangBlob* archiveBlob);
+
     ComPtr<ICompressionSystem> m_compressionSystem;
 
     CompressionStyle m_compressionStyle;
@@ -0,0 +1,123 @@
+#include "slang-thread-pool.h"
+
+namespace Slang
+{
+
+/* static */ Count ThreadPool::getHardwareThreadCount()
+{
+    const auto count = std::thread::hardware_concurrency();
+    return count > 0 ? Count(count) : 1;
+}
+
+ThreadPool::ThreadPool(Count threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = getHardwareThreadCount();
+    }
+
+    // The thread submitting the work also runs it, so we need one less worker.
+    for (Index i = 1; i < threadCount; ++i)
+    {
+        m_threads.add(std::thread([this]() { _workerThread(); }));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+    }
+    m_workCondition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+/* static */ void ThreadPool::_runBatch(Batch* batch)
+{
+    for (;;)
+    {
+        const Index index = batch->nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= batch->count)
+        {
+            break;
+        }
+        (*batch->func)(index);
+    }
+}
+
+void ThreadPool::_workerThread()
+{
+    uint64_t lastBatchId = 0;
+    for (;;)
+    {
+        Batch* batch = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCondition.wait(
+                lock,
+                [&]() { return m_isShuttingDown || (m_batch && m_batchId != lastBatchId); });
+
+            if (m_isShuttingDown)
+            {
+                return;
+            }
+
+            lastBatchId = m_batchId;
+            batch = m_batch;
+            m_activeWorkerCount++;
+        }
+
+        _runBatch(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_activeWorkerCount == 0)
+            {
+                m_doneCondition.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::parallelFor(Index count, const std::function<void(Index)>& func)
+{
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+
+    // If there is nothing to gain from other threads, just run everything inline.
+    if (count <= 1 || m_threads.getCount() == 0)
+    {
+        for (Index i = 0; i < count; ++i)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    Batch batch;
+    batch.func = &func;
+    batch.count = count;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batch = &batch;
+        m_batchId++;
+    }
+    m_workCondition.notify_all();
+
+    _runBatch(&batch);
+
+    // All indices have been handed out, but workers may still be running the last of them.
+    // Unpublish the batch so no other worker picks it up, and wait for those already in it.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batch = nullptr;
+        m_doneCondition.wait(lock, [&]() { return m_activeWorkerCount == 0; });
+    }
+}
+
+} // namespace Slang
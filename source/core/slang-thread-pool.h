@@ -0,0 +1,73 @@
+#ifndef SLANG_CORE_THREAD_POOL_H
+#define SLANG_CORE_THREAD_POOL_H
+
+#include "slang-list.h"
+#include "slang-smart-pointer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Slang
+{
+
+/// A fixed size pool of worker threads for running independent pieces of work concurrently.
+///
+/// Work is submitted as a batch of indices with `parallelFor`. The thread that submits a batch
+/// takes part in running it, so a pool created with a thread count of 1 has no worker threads
+/// and runs everything on the calling thread.
+class ThreadPool : public RefObject
+{
+public:
+    /// Get the number of hardware threads available, always at least 1.
+    static Count getHardwareThreadCount();
+
+    /// Invoke `func(index)` for every index in [0, count), and return once all invocations
+    /// have completed.
+    ///
+    /// Indices are handed out to threads dynamically, so the order in which they run is
+    /// unspecified, but each index is run exactly once. `func` must not throw. Only one batch
+    /// can run at a time - concurrent calls are serialized, and calling `parallelFor` from
+    /// within `func` is not allowed.
+    void parallelFor(Index count, const std::function<void(Index)>& func);
+
+    /// Get the total number of threads work is run on, including the submitting thread.
+    Count getThreadCount() const { return m_threads.getCount() + 1; }
+
+    /// Create a pool that runs work on `threadCount` threads in total, including the thread
+    /// that submits the work. A `threadCount` of 0 or less uses `getHardwareThreadCount()`.
+    explicit ThreadPool(Count threadCount = 0);
+    ~ThreadPool();
+
+protected:
+    struct Batch
+    {
+        const std::function<void(Index)>* func = nullptr;
+        Index count = 0;
+        std::atomic<Index> nextIndex = 0;
+    };
+
+    static void _runBatch(Batch* batch);
+    void _workerThread();
+
+    List<std::thread> m_threads;
+
+    // Held for the duration of a `parallelFor`, so only one batch is ever active.
+    std::mutex m_submitMutex;
+
+    // Guards all of the members below.
+    std::mutex m_mutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_doneCondition;
+
+    Batch* m_batch = nullptr;
+    uint64_t m_batchId = 0;
+    Index m_activeWorkerCount = 0;
+    bool m_isShuttingDown = false;
+};
+
+} // namespace Slang
+
+#endif
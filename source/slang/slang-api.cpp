@@ -2,6 +2,7 @@
 
 #include "../core/slang-performance-profiler.h"
 #include "../core/slang-platform.h"
+#include "../core/slang-process.h"
 #include "../core/slang-rtti-info.h"
 #include "../core/slang-shared-library.h"
 #include "../core/slang-signal.h"
@@ -49,19 +50,30 @@ SlangResult tryLoadBuiltinModuleFromCache(
     {
         return SLANG_FAIL;
     }
-    Slang::ScopedAllocation cacheData;
-    SLANG_RETURN_ON_FAIL(Slang::File::readAllBytes(cacheFileName, cacheData));
+
+    // The cache is mapped rather than read, so that only the parts of the module that
+    // are used get paged in, and processes using the same cache share the pages.
+    Slang::ComPtr<ISlangBlob> cacheBlob;
+    SLANG_RETURN_ON_FAIL(Slang::MemoryMappedFileBlob::create(cacheFileName, cacheBlob));
+    const auto cacheData = (const uint8_t*)cacheBlob->getBufferPointer();
+    const size_t cacheSize = cacheBlob->getBufferSize();
 
     // The first 8 bytes stores the timestamp of the slang dll that created this core module cache.
-    if (cacheData.getSizeInBytes() < sizeof(uint64_t))
+    if (cacheSize < sizeof(uint64_t))
         return SLANG_FAIL;
-    auto cacheTimestamp = *(uint64_t*)(cacheData.getData());
+    uint64_t cacheTimestamp = 0;
+    ::memcpy(&cacheTimestamp, cacheData, sizeof(cacheTimestamp));
     if (cacheTimestamp != currentLibTimestamp)
         return SLANG_FAIL;
-    SLANG_RETURN_ON_FAIL(globalSession->loadBuiltinModule(
-        builtinModuleName,
-        (uint8_t*)cacheData.getData() + sizeof(uint64_t),
-        cacheData.getSizeInBytes() - sizeof(uint64_t)));
+
+    // The module archive follows the timestamp, and keeps the mapping alive
+    auto moduleBlob = Slang::ScopeBlob::create(
+        Slang::UnownedRawBlob::create(
+            cacheData + sizeof(uint64_t),
+            cacheSize - sizeof(uint64_t)),
+        cacheBlob);
+    SLANG_RETURN_ON_FAIL(
+        Slang::asInternal(globalSession)->loadBuiltinModuleFromBlob(builtinModuleName, moduleBlob));
     return SLANG_OK;
 }
 
@@ -84,10 +96,10 @@ SlangResult tryLoadBuiltinModuleFromDLL(
     typedef ISlangBlob*(GetEmbeddedModuleFunc)();
     auto getEmbeddedModule = (GetEmbeddedModuleFunc*)ptr;
     auto blob = getEmbeddedModule();
-    SLANG_RETURN_ON_FAIL(globalSession->loadBuiltinModule(
-        builtinModuleName,
-        (uint8_t*)blob->getBufferPointer(),
-        blob->getBufferSize()));
+
+    // The library is never unloaded, so the embedded module can be read in place.
+    SLANG_RETURN_ON_FAIL(
+        Slang::asInternal(globalSession)->loadBuiltinModuleFromBlob(builtinModuleName, blob));
     return SLANG_OK;
 }
 
@@ -99,19 +111,31 @@ SlangResult trySaveBuiltinModuleToCache(
 {
     if (dllTimestamp != 0 && cacheFilename.getLength() != 0)
     {
+        // The cache is stored uncompressed, so that it can be read in place when it is loaded.
         Slang::ComPtr<ISlangBlob> coreModuleBlobPtr;
         SLANG_RETURN_ON_FAIL(globalSession->saveBuiltinModule(
             builtinModuleName,
-            SLANG_ARCHIVE_TYPE_RIFF_LZ4,
+            SLANG_ARCHIVE_TYPE_RIFF,
             coreModuleBlobPtr.writeRef()));
 
-        Slang::FileStream fileStream;
-        SLANG_RETURN_ON_FAIL(fileStream.init(cacheFilename, Slang::FileMode::Create));
+        // Other processes may have the cache mapped, so rather than overwrite it in place, the
+        // new cache is written to a temporary file that then replaces it.
+        Slang::StringBuilder tempFilename;
+        tempFilename << cacheFilename << ".tmp" << Slang::Process::getId();
+        {
+            Slang::FileStream fileStream;
+            SLANG_RETURN_ON_FAIL(fileStream.init(tempFilename, Slang::FileMode::Create));
 
-        SLANG_RETURN_ON_FAIL(fileStream.write(&dllTimestamp, sizeof(dllTimestamp)));
-        SLANG_RETURN_ON_FAIL(fileStream.write(
-            coreModuleBlobPtr->getBufferPointer(),
-            coreModuleBlobPtr->getBufferSize()))
+            SLANG_RETURN_ON_FAIL(fileStream.write(&dllTimestamp, sizeof(dllTimestamp)));
+            SLANG_RETURN_ON_FAIL(fileStream.write(
+                coreModuleBlobPtr->getBufferPointer(),
+                coreModuleBlobPtr->getBufferSize()))
+        }
+        if (SLANG_FAILED(Slang::File::rename(tempFilename, cacheFilename)))
+        {
+            Slang::File::remove(tempFilename);
+            return SLANG_FAIL;
+        }
     }
 
     return SLANG_OK;
@@ -140,14 +164,18 @@ SLANG_API SlangResult slang_createGlobalSessionImpl(
 
     SLANG_RETURN_ON_FAIL(
         slang_createGlobalSessionWithoutCoreModule(desc->apiVersion, globalSession.writeRef()));
+    Slang::asInternal(globalSession)->deferBuiltinFunctionBodies =
+        internalDesc->deferBuiltinFunctionBodies;
 
     // If we have the embedded core module, load from that, else compile it
     ISlangBlob* coreModuleBlob = slang_getEmbeddedCoreModule();
     if (coreModuleBlob)
     {
-        SLANG_RETURN_ON_FAIL(globalSession->loadCoreModule(
-            coreModuleBlob->getBufferPointer(),
-            coreModuleBlob->getBufferSize()));
+        // The embedded module is static data, so it can be read in place.
+        SLANG_RETURN_ON_FAIL(Slang::asInternal(globalSession)
+                                 ->loadBuiltinModuleFromBlob(
+                                     slang::BuiltinModuleName::Core,
+                                     coreModuleBlob));
     }
     else
     {
@@ -429,6 +457,11 @@ SLANG_API void spSetCommandLineCompilerMode(slang::ICompileRequest* request)
     request->setCommandLineCompilerMode();
 }
 
+SLANG_API void slang_setCompileRequestRestoresLinkage(slang::ICompileRequest* request)
+{
+    Slang::asInternal(request)->setRestoreLinkageOnDestroy();
+}
+
 SLANG_API void spSetCodeGenTarget(slang::ICompileRequest* request, SlangCompileTarget target)
 {
     SLANG_ASSERT(request);
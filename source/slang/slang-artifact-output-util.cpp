@@ -2,6 +2,7 @@
 
 #include "../core/slang-hex-dump-util.h"
 #include "../core/slang-io.h"
+#include "../core/slang-performance-profiler.h"
 #include "../core/slang-platform.h"
 #include "../core/slang-string-util.h"
 #include "../core/slang-type-text-util.h"
@@ -20,6 +21,7 @@ namespace Slang
     Session* session,
     IArtifact* artifact,
     DiagnosticSink* sink,
+    Count downstreamConcurrency,
     IArtifact** outArtifact)
 {
     auto desc = artifact->getDesc();
@@ -67,7 +69,14 @@ namespace Slang
         return SLANG_FAIL;
     }
     auto downstreamStartTime = std::chrono::high_resolution_clock::now();
-    SLANG_RETURN_ON_FAIL(compiler->convert(artifact, assemblyDesc, outArtifact));
+    {
+        DownstreamCompileScheduler::Slot slot(
+            &session->m_downstreamCompileScheduler,
+            compiler,
+            downstreamConcurrency);
+        SLANG_PROFILE_SECTION(downstreamConvert);
+        SLANG_RETURN_ON_FAIL(compiler->convert(artifact, assemblyDesc, outArtifact));
+    }
     auto downstreamElapsedTime =
         (std::chrono::high_resolution_clock::now() - downstreamStartTime).count() * 0.000000001;
     session->addDownstreamCompileTime(downstreamElapsedTime);
@@ -78,6 +87,7 @@ SlangResult ArtifactOutputUtil::maybeDisassemble(
     Session* session,
     IArtifact* artifact,
     DiagnosticSink* sink,
+    Count downstreamConcurrency,
     ComPtr<IArtifact>& outArtifact)
 {
     const auto desc = artifact->getDesc();
@@ -98,6 +108,7 @@ SlangResult ArtifactOutputUtil::maybeDisassemble(
                 session,
                 artifact,
                 sink,
+                downstreamConcurrency,
                 disassemblyArtifact.writeRef())))
         {
             // Check it is now text
@@ -190,6 +201,7 @@ static SlangResult _requireBlob(
     Session* session,
     IArtifact* artifact,
     DiagnosticSink* sink,
+    Count downstreamConcurrency,
     const UnownedStringSlice& writerName,
     ISlangWriter* writer)
 {
@@ -197,7 +209,7 @@ static SlangResult _requireBlob(
     if (writer->isConsole())
     {
         ComPtr<IArtifact> disassemblyArtifact;
-        maybeDisassemble(session, artifact, sink, disassemblyArtifact);
+        maybeDisassemble(session, artifact, sink, downstreamConcurrency, disassemblyArtifact);
 
         if (disassemblyArtifact)
         {
@@ -15,10 +15,13 @@ struct ArtifactOutputUtil
 {
     /// Attempts to disassembly artifact into outArtifact.
     /// Errors are output to sink if set. If not desired pass nullptr
+    /// `downstreamConcurrency` is the most downstream compilations that may run at once, as set
+    /// by `-downstream-compile-concurrency`, or 0 for no limit.
     static SlangResult dissassembleWithDownstream(
         Session* session,
         IArtifact* artifact,
         DiagnosticSink* sink,
+        Count downstreamConcurrency,
         IArtifact** outArtifact);
 
     /// Disassembles if that is plausible
@@ -27,6 +30,7 @@ struct ArtifactOutputUtil
         Session* session,
         IArtifact* artifact,
         DiagnosticSink* sink,
+        Count downstreamConcurrency,
         ComPtr<IArtifact>& outArtifact);
 
     /// Writes output to writer, will convert into disassembly if that is possible and appropriate
@@ -36,6 +40,7 @@ struct ArtifactOutputUtil
         Session* session,
         IArtifact* artifact,
         DiagnosticSink* sink,
+        Count downstreamConcurrency,
         const UnownedStringSlice& writerName,
         ISlangWriter* writer);
 
@@ -8,6 +8,7 @@
 #include "slang-ast-support-types.h"
 #include "slang-ir.h"
 
+#include <mutex>
 #include <type_traits>
 
 namespace Slang
@@ -194,6 +195,7 @@ class ASTBuilder : public RefObject
 public:
     Val* _getOrCreateImpl(ValNodeDesc&& desc)
     {
+        auto lock = _lockIfThreadSafe();
         if (auto found = m_cachedNodes.tryGetValue(desc))
             return *found;
 
@@ -216,6 +218,7 @@ public:
     template<typename T>
     T* createImpl()
     {
+        auto lock = _lockIfThreadSafe();
         auto alloced = m_arena.allocate(sizeof(T));
         memset(alloced, 0, sizeof(T));
         auto result = _initAndAdd(new (alloced) T);
@@ -225,6 +228,7 @@ public:
     template<typename T, typename... TArgs>
     T* createImpl(TArgs&&... args)
     {
+        auto lock = _lockIfThreadSafe();
         auto alloced = m_arena.allocate(sizeof(T));
         memset(alloced, 0, sizeof(T));
         auto result = _initAndAdd(new (alloced) T(std::forward<TArgs>(args)...));
@@ -665,6 +669,10 @@ public:
 
     BreakableStmt::UniqueID generateUniqueIDForStmt() { return create<UniqueStmtIDNode>(); }
 
+    /// Set while the builder may be used by multiple threads at once, such as during
+    /// parallel code generation. Creating and looking up nodes is then serialized.
+    void setThreadSafe(bool isThreadSafe) { m_isThreadSafe = isThreadSafe; }
+
     /// Ctor
     ASTBuilder(SharedASTBuilder* sharedASTBuilder, const String& name);
 
@@ -676,6 +684,13 @@ protected:
     ASTBuilder();
 
 
+    std::unique_lock<std::recursive_mutex> _lockIfThreadSafe()
+    {
+        if (!m_isThreadSafe)
+            return std::unique_lock<std::recursive_mutex>();
+        return std::unique_lock<std::recursive_mutex>(m_mutex);
+    }
+
     template<typename T>
     SLANG_FORCE_INLINE T* _initAndAdd(T* node)
     {
@@ -709,6 +724,10 @@ protected:
     SharedASTBuilder* m_sharedASTBuilder;
 
     MemoryArena m_arena;
+
+    // Creating a node can create other nodes, so the lock is recursive.
+    bool m_isThreadSafe = false;
+    std::recursive_mutex m_mutex;
 };
 
 // Retrieves the ASTBuilder for the current compilation session.
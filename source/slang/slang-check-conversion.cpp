@@ -2027,7 +2027,7 @@ bool SemanticsVisitor::canCoerce(
 
     if (cacheKey.isValid())
     {
-        if (typeCheckingCache->conversionCostCache.tryGetValue(cacheKey, cost))
+        if (typeCheckingCache->tryGetConversionCost(cacheKey, cost))
         {
             if (outCost)
                 *outCost = cost;
@@ -247,6 +247,94 @@ struct OperatorOverloadCacheKey
     }
 };
 
+/// Key for the cached result of overload resolution for an ordinary call to a function
+/// that is overloaded in the core module, such as `lerp(a, b, t)` or `dot(a, b)`.
+///
+/// A call can only use the cache if every declaration its callee name found is a function
+/// from the core module (or the GLSL module, in GLSL mode), so that the same name always
+/// finds the same declarations. The lookup result is then identified by its first
+/// declaration and the amount of declarations.
+struct CallOverloadCacheKey
+{
+    static const Index kMaxArgCount = 4;
+
+    Decl* firstDecl;
+    Index declCount;
+    bool isGLSLMode;
+    Index argCount;
+    BasicTypeKey args[kMaxArgCount];
+
+    bool operator==(const CallOverloadCacheKey& key) const
+    {
+        if (firstDecl != key.firstDecl || declCount != key.declCount ||
+            isGLSLMode != key.isGLSLMode || argCount != key.argCount)
+            return false;
+        for (Index i = 0; i < argCount; i++)
+        {
+            if (!(args[i] == key.args[i]))
+                return false;
+        }
+        return true;
+    }
+    HashCode getHashCode() const
+    {
+        HashCode hash = combineHash(
+            Slang::getHashCode(firstDecl),
+            Slang::getHashCode(declCount),
+            isGLSLMode ? 1 : 0);
+        for (Index i = 0; i < argCount; i++)
+            hash = combineHash(hash, args[i].getRaw());
+        return hash;
+    }
+    bool fromInvokeExpr(InvokeExpr* invokeExpr, ModuleDecl* glslModuleDecl)
+    {
+        isGLSLMode = glslModuleDecl != nullptr;
+
+        // Only a plain name can be the callee; member calls and explicit generic
+        // arguments depend on more than the name and the argument types.
+        auto overloadedExpr = as<OverloadedExpr>(invokeExpr->functionExpr);
+        if (!overloadedExpr || overloadedExpr->base)
+            return false;
+
+        argCount = invokeExpr->arguments.getCount();
+        if (argCount == 0 || argCount > kMaxArgCount)
+            return false;
+
+        for (Index i = 0; i < argCount; i++)
+        {
+            auto arg = invokeExpr->arguments[i];
+            auto key = makeBasicTypeKey(arg->type, arg);
+            if (key.getRaw() == BasicTypeKey::invalid().getRaw())
+                return false;
+            args[i] = key;
+        }
+
+        // Every candidate has to be a function from a builtin module that was found
+        // directly, so that the lookup result is the same wherever the name is used.
+        declCount = 0;
+        firstDecl = nullptr;
+        for (auto item : overloadedExpr->lookupResult2)
+        {
+            if (item.breadcrumbs)
+                return false;
+
+            Decl* decl = item.declRef.getDecl();
+            Decl* funcDecl = decl;
+            if (auto genDecl = as<GenericDecl>(funcDecl))
+                funcDecl = genDecl->inner;
+            if (!as<FunctionDeclBase>(funcDecl))
+                return false;
+            if (!isFromCoreModule(decl) && !(isGLSLMode && getModuleDecl(decl) == glslModuleDecl))
+                return false;
+
+            if (!firstDecl)
+                firstDecl = decl;
+            declCount++;
+        }
+        return firstDecl != nullptr;
+    }
+};
+
 struct OverloadCandidate
 {
     enum class Flavor
@@ -303,6 +391,7 @@ struct OverloadCandidate
     SubstitutionSet subst;
 };
 
+// The cached result of overload resolution for an operator or ordinary call.
 struct ResolvedOperatorOverload
 {
     // The resolved decl.
@@ -318,13 +407,136 @@ struct ResolvedOperatorOverload
     int cacheVersion;
 };
 
+// A table of type checking cache entries. Tables are never modified once they are part of a
+// published `SharedTypeCheckingCache`.
+struct TypeCheckingCacheTable : public RefObject
+{
+    Dictionary<OperatorOverloadCacheKey, ResolvedOperatorOverload> resolvedOperatorOverloadCache;
+    Dictionary<CallOverloadCacheKey, ResolvedOperatorOverload> resolvedCallOverloadCache;
+    Dictionary<BasicTypeKeyPair, ConversionCost> conversionCostCache;
+
+    Index getEntryCount() const
+    {
+        return resolvedOperatorOverloadCache.getCount() + resolvedCallOverloadCache.getCount() +
+               conversionCostCache.getCount();
+    }
+};
+
+// An immutable snapshot of the type checking cache entries shared by all the linkages of a
+// session, so linkages on any thread look entries up without locking.
+//
+// `Session::mergeTypeCheckingCache` publishes a new snapshot with the entries staged by a
+// linkage added as a new table. To avoid copying all of the entries on every merge, the new
+// table is only combined with the newest tables that aren't larger than it, so there are
+// O(log n) tables and each entry is copied O(log n) times.
+struct SharedTypeCheckingCache : public RefObject
+{
+    // Oldest first, where newer tables override older ones.
+    List<RefPtr<TypeCheckingCacheTable>> tables;
+
+    Index getEntryCount() const
+    {
+        Index count = 0;
+        for (const auto& table : tables)
+            count += table->getEntryCount();
+        return count;
+    }
+};
+
+// The type checking cache of a linkage.
+//
+// A linkage is only used by one thread at a time, so new entries are staged here without
+// locking, and looked up before the `shared` entries. Staged entries are merged into the
+// shared entries of the session once there are `kMergeThreshold` of them, and when the
+// linkage is destroyed. Each merge also moves the linkage on to the latest snapshot.
 struct TypeCheckingCache : public RefObject
 {
+    static const Index kMergeThreshold = 256;
+
     Dictionary<OperatorOverloadCacheKey, ResolvedOperatorOverload> resolvedOperatorOverloadCache;
+    Dictionary<CallOverloadCacheKey, ResolvedOperatorOverload> resolvedCallOverloadCache;
     Dictionary<BasicTypeKeyPair, ConversionCost> conversionCostCache;
 
+    // The snapshot of the shared entries of the session. References to it are only taken or
+    // released with the session mutex held, as RefObject reference counts aren't atomic.
+    RefPtr<SharedTypeCheckingCache> shared;
+
+    // Lookups since the last merge.
+    TypeCheckingCacheStats stats;
+
+    // The amount of ordinary calls that were, and weren't, resolved from
+    // `resolvedCallOverloadCache`.
+    UInt64 callOverloadCacheHitCount = 0;
+    UInt64 callOverloadCacheMissCount = 0;
+
     // The version used to invalidate the cached declRefs in ResolvedOperatorOverload entries.
+    // Each cache has its own version, so entries shared by other linkages only reuse
+    // declRefs that don't depend on the linkage that created them.
     int version = 0;
+
+    bool tryGetResolvedOperatorOverload(
+        const OperatorOverloadCacheKey& key,
+        ResolvedOperatorOverload& outResult)
+    {
+        return _tryGetValue(
+            resolvedOperatorOverloadCache,
+            &TypeCheckingCacheTable::resolvedOperatorOverloadCache,
+            key,
+            outResult);
+    }
+    bool tryGetResolvedCallOverload(
+        const CallOverloadCacheKey& key,
+        ResolvedOperatorOverload& outResult)
+    {
+        return _tryGetValue(
+            resolvedCallOverloadCache,
+            &TypeCheckingCacheTable::resolvedCallOverloadCache,
+            key,
+            outResult);
+    }
+    bool tryGetConversionCost(const BasicTypeKeyPair& key, ConversionCost& outCost)
+    {
+        return _tryGetValue(
+            conversionCostCache,
+            &TypeCheckingCacheTable::conversionCostCache,
+            key,
+            outCost);
+    }
+
+    Index getStagedEntryCount() const
+    {
+        return resolvedOperatorOverloadCache.getCount() + resolvedCallOverloadCache.getCount() +
+               conversionCostCache.getCount();
+    }
+
+private:
+    template<typename K, typename V>
+    bool _tryGetValue(
+        const Dictionary<K, V>& staged,
+        Dictionary<K, V> TypeCheckingCacheTable::* sharedEntries,
+        const K& key,
+        V& outValue)
+    {
+        if (staged.tryGetValue(key, outValue))
+        {
+            stats.localHitCount++;
+            return true;
+        }
+        if (shared)
+        {
+            for (Index i = shared->tables.getCount() - 1; i >= 0; --i)
+            {
+                TypeCheckingCacheTable* table = shared->tables[i];
+                if ((table->*sharedEntries).tryGetValue(key, outValue))
+                {
+                    stats.sharedHitCount++;
+                    return true;
+                }
+            }
+        }
+        stats.missCount++;
+        return false;
+    }
 };
 
 enum class CoercionSite
@@ -2650,7 +2650,7 @@ Expr* SemanticsVisitor::ResolveInvoke(InvokeExpr* expr)
         {
             key.isGLSLMode = getShared()->glslModuleDecl != nullptr;
             ResolvedOperatorOverload candidate;
-            if (typeCheckingCache->resolvedOperatorOverloadCache.tryGetValue(key, candidate))
+            if (typeCheckingCache->tryGetResolvedOperatorOverload(key, candidate))
             {
                 // We should only use the cached candidate if it is persistent direct declref
                 // created from GlobalSession's ASTBuilder, or it is created in the current Linkage.
@@ -2674,6 +2674,40 @@ Expr* SemanticsVisitor::ResolveInvoke(InvokeExpr* expr)
             }
         }
     }
+    // Likewise, an ordinary call to a function overloaded in the core module with
+    // arguments of basic types can use a cached result.
+    bool shouldAddCallToCache = false;
+    CallOverloadCacheKey callKey;
+    if (!as<OperatorExpr>(expr) && !as<ExplicitCtorInvokeExpr>(expr) &&
+        callKey.fromInvokeExpr(expr, getShared()->glslModuleDecl))
+    {
+        ResolvedOperatorOverload candidate;
+        if (typeCheckingCache->tryGetResolvedCallOverload(callKey, candidate))
+        {
+            if (candidate.cacheVersion == typeCheckingCache->version ||
+                findNextOuterGeneric(candidate.decl) == nullptr)
+            {
+                typeCheckingCache->callOverloadCacheHitCount++;
+                context.bestCandidateStorage = candidate.candidate;
+                context.bestCandidate = &context.bestCandidateStorage;
+            }
+            else
+            {
+                // The entry is stale, and only names the declaration to resolve again, so
+                // it counts as a miss.
+                typeCheckingCache->callOverloadCacheMissCount++;
+                LookupResultItem overloadCandidate = {};
+                overloadCandidate.declRef = getOuterGenericOrSelf(candidate.decl);
+                AddDeclRefOverloadCandidates(overloadCandidate, context, 0);
+                shouldAddCallToCache = true;
+            }
+        }
+        else
+        {
+            typeCheckingCache->callOverloadCacheMissCount++;
+            shouldAddCallToCache = true;
+        }
+    }
 
     // We run a special case here where an `InvokeExpr`
     // with a single argument where the base/func expression names
@@ -2856,6 +2890,15 @@ Expr* SemanticsVisitor::ResolveInvoke(InvokeExpr* expr)
                 typeCheckingCache->resolvedOperatorOverloadCache[key] = overloadResult;
             }
         }
+        if (shouldAddCallToCache &&
+            context.bestCandidate->status == OverloadCandidate::Status::Applicable)
+        {
+            ResolvedOperatorOverload overloadResult;
+            overloadResult.candidate = *context.bestCandidate;
+            overloadResult.decl = context.bestCandidate->item.declRef.getDecl();
+            overloadResult.cacheVersion = typeCheckingCache->version;
+            typeCheckingCache->resolvedCallOverloadCache[callKey] = overloadResult;
+        }
 
         // Now that we have resolved the overload candidate, we need to undo an `openExistential`
         // operation that was applied to `out` arguments.
@@ -167,6 +167,25 @@ void CompilerOptionSet::buildHash(DigestBuilder<SHA1>& builder)
 {
     for (auto& kv : options)
     {
+        // Options that only control how the compiler does its work, and not what it
+        // produces, don't contribute to the hash.
+        switch (kv.key)
+        {
+        case CompilerOptionName::ParallelCodeGen:
+        case CompilerOptionName::CompilationCachePath:
+        case CompilerOptionName::CompilationCacheMaxEntryCount:
+        case CompilerOptionName::ReportPerfTrace:
+        case CompilerOptionName::LazyIRLoading:
+        case CompilerOptionName::MemoryMapModules:
+        case CompilerOptionName::ParallelModuleLoading:
+        case CompilerOptionName::ReclaimIRMemory:
+        case CompilerOptionName::SPIRVOptimizerCache:
+        case CompilerOptionName::DownstreamCompileConcurrency:
+            continue;
+        default:
+            break;
+        }
+
         builder.append(kv.key);
         builder.append(kv.value.getCount());
         for (auto& v : kv.value)
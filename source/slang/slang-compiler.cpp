@@ -11,6 +11,7 @@
 #include "../core/slang-platform.h"
 #include "../core/slang-riff.h"
 #include "../core/slang-string-util.h"
+#include "../core/slang-thread-pool.h"
 #include "../core/slang-type-convert-util.h"
 #include "../core/slang-type-text-util.h"
 #include "slang-check-impl.h"
@@ -31,6 +32,7 @@
 #include "slang-artifact-output-util.h"
 #include "slang-emit-cuda.h"
 #include "slang-extension-tracker.h"
+#include "slang-ir-link.h"
 #include "slang-lower-to-ir.h"
 #include "slang-mangle.h"
 #include "slang-parameter-binding.h"
@@ -1922,7 +1924,15 @@ SlangResult CodeGenContext::emitWithDownstreamForEntryPoints(ComPtr<IArtifact>&
     // Compile
     ComPtr<IArtifact> artifact;
     auto downstreamStartTime = std::chrono::high_resolution_clock::now();
-    SLANG_RETURN_ON_FAIL(compiler->compile(options, artifact.writeRef()));
+    {
+        DownstreamCompileScheduler::Slot slot(
+            &getSession()->m_downstreamCompileScheduler,
+            compiler,
+            getTargetProgram()->getOptionSet().getIntOption(
+                CompilerOptionName::DownstreamCompileConcurrency));
+        SLANG_PROFILE_SECTION(downstreamCompile);
+        SLANG_RETURN_ON_FAIL(compiler->compile(options, artifact.writeRef()));
+    }
     auto downstreamElapsedTime =
         (std::chrono::high_resolution_clock::now() - downstreamStartTime).count() * 0.000000001;
     getSession()->addDownstreamCompileTime(downstreamElapsedTime);
@@ -2011,6 +2021,8 @@ SlangResult CodeGenContext::_emitEntryPoints(ComPtr<IArtifact>& outArtifact)
                 getSession(),
                 intermediateArtifact,
                 getSink(),
+                getTargetProgram()->getOptionSet().getIntOption(
+                    CompilerOptionName::DownstreamCompileConcurrency),
                 disassemblyArtifact.writeRef()));
 
             // Also disassemble the debug artifact if one exists.
@@ -2022,6 +2034,8 @@ SlangResult CodeGenContext::_emitEntryPoints(ComPtr<IArtifact>& outArtifact)
                     getSession(),
                     debugArtifact,
                     getSink(),
+                    getTargetProgram()->getOptionSet().getIntOption(
+                        CompilerOptionName::DownstreamCompileConcurrency),
                     disassemblyDebugArtifact.writeRef()));
                 disassemblyDebugArtifact->setName(debugArtifact->getName());
 
@@ -2177,6 +2191,7 @@ void EndToEndCompileRequest::writeArtifactToStandardOutput(
         session,
         artifact,
         sink,
+        getOptionSet().getIntOption(CompilerOptionName::DownstreamCompileConcurrency),
         toSlice("stdout"),
         getWriter(WriterChannel::StdOutput));
 }
@@ -2341,9 +2356,7 @@ IArtifact* TargetProgram::_createEntryPointResult(
     // constructed all at once rather than incrementally, to avoid
     // this problem.
     //
-    if (entryPointIndex >= m_entryPointResults.getCount())
-        m_entryPointResults.setCount(entryPointIndex + 1);
-
+    _ensureEntryPointResultCount(entryPointIndex + 1);
 
     CodeGenContext::EntryPointIndices entryPointIndices;
     entryPointIndices.add(entryPointIndex);
@@ -2765,16 +2778,160 @@ void EndToEndCompileRequest::generateOutput(ComponentType* program)
     // has specified, and generate code for each of them.
     //
     auto linkage = getLinkage();
+    List<TargetProgram*> targetPrograms;
     for (auto targetReq : linkage->targets)
     {
         if (targetReq->getOptionSet().getBoolOption(CompilerOptionName::EmbedDownstreamIR))
             continue;
 
-        auto targetProgram = program->getTargetProgram(targetReq);
+        targetPrograms.add(program->getTargetProgram(targetReq));
+    }
+
+    if (getOptionSet().hasOption(CompilerOptionName::ParallelCodeGen))
+    {
+        Count threadCount = getOptionSet().getIntOption(CompilerOptionName::ParallelCodeGen);
+        if (threadCount <= 0)
+            threadCount = ThreadPool::getHardwareThreadCount();
+
+        if (threadCount > 1)
+        {
+            _generateOutputInParallel(targetPrograms, threadCount);
+            return;
+        }
+    }
+
+    for (auto targetProgram : targetPrograms)
+    {
         generateOutput(targetProgram);
     }
 }
 
+void EndToEndCompileRequest::_generateOutputInParallel(
+    List<TargetProgram*> const& targetPrograms,
+    Count threadCount)
+{
+    // Each job produces the result for a single entry point on a target, or for
+    // all of the entry points of a target if it is generating a whole program.
+    //
+    // Code generation for each job links and optimizes its own copy of the IR,
+    // so jobs are mostly independent of each other. The state they share is set
+    // up below before they run. Diagnostics are reported to a sink shared by the
+    // whole request, so each job is given its own deferred sink, and the
+    // diagnostics are replayed into the request's sink in the same order a serial
+    // compile would have produced them.
+    //
+    struct CodeGenJob
+    {
+        TargetProgram* targetProgram = nullptr;
+        Index entryPointIndex = -1; ///< -1 if generating a whole program
+        DiagnosticSink sink;
+        std::exception_ptr exception;
+    };
+
+    List<CodeGenJob> jobs;
+    for (auto targetProgram : targetPrograms)
+    {
+        if (targetProgram->getOptionSet().getBoolOption(CompilerOptionName::GenerateWholeProgram))
+        {
+            CodeGenJob job;
+            job.targetProgram = targetProgram;
+            jobs.add(job);
+        }
+        else
+        {
+            const Index entryPointCount = targetProgram->getProgram()->getEntryPointCount();
+
+            // Make sure there is space for all of the results up front, so that jobs can
+            // write their result without changing the list.
+            targetProgram->_ensureEntryPointResultCount(entryPointCount);
+
+            for (Index ii = 0; ii < entryPointCount; ++ii)
+            {
+                CodeGenJob job;
+                job.targetProgram = targetProgram;
+                job.entryPointIndex = ii;
+                jobs.add(job);
+            }
+        }
+    }
+
+    auto sink = getSink();
+    for (auto& job : jobs)
+    {
+        job.sink.init(sink->getSourceManager(), sink->getSourceLocationLexer());
+        job.sink.setFlags(sink->getFlags());
+        job.sink.setSourceLineMaxLength(sink->getSourceLineMaxLength());
+        job.sink.setDeferred(true);
+    }
+
+    // Emitting source looks up the line of source locations, and the line breaks of a
+    // source file are found the first time they are needed. Find them up front, so that
+    // jobs only ever read them.
+    for (auto sourceManager = getLinkage()->getSourceManager(); sourceManager;
+         sourceManager = sourceManager->getParent())
+    {
+        for (auto sourceFile : sourceManager->getSourceFiles())
+            sourceFile->getLineBreakOffsets();
+    }
+
+    // Linking a job's IR materializes the deferred function bodies of the modules it links
+    // from, which adds uses to their globals. Those modules are shared by all of the jobs, and
+    // the loader's lock doesn't cover other jobs reading them, so materialize the bodies the
+    // jobs could link before any job runs. Bodies no entry point can reach stay deferred.
+    for (auto targetProgram : targetPrograms)
+    {
+        materializeBodiesForLinking(targetProgram);
+    }
+
+    // Jobs create types and other AST nodes with the linkage's AST builder. Nodes are
+    // deduplicated by the builder, so jobs can't use builders of their own, and it is
+    // locked instead for as long as jobs run.
+    auto astBuilder = getLinkage()->getASTBuilder();
+    astBuilder->setThreadSafe(true);
+
+    // Profiled scopes of the jobs are recorded in the profiler of the compiling thread.
+    auto profiler = PerformanceProfiler::getProfiler();
+
+    RefPtr<ThreadPool> threadPool = new ThreadPool(Math::Min(threadCount, jobs.getCount()));
+    threadPool->parallelFor(
+        jobs.getCount(),
+        [&](Index jobIndex)
+        {
+            auto& job = jobs[jobIndex];
+
+            // The current AST builder is thread local, so each worker needs it set.
+            SLANG_AST_BUILDER_RAII(astBuilder);
+            PerformanceProfilerThreadRAII profilerScope(profiler);
+            try
+            {
+                if (job.entryPointIndex < 0)
+                    job.targetProgram->_createWholeProgramResult(&job.sink, this);
+                else
+                    job.targetProgram->_createEntryPointResult(
+                        job.entryPointIndex,
+                        &job.sink,
+                        this);
+            }
+            catch (...)
+            {
+                job.exception = std::current_exception();
+            }
+        });
+    astBuilder->setThreadSafe(false);
+
+    // Replaying a fatal diagnostic will abort compilation, just as it would have done
+    // when it was first reported in a serial compile. Other exceptions are rethrown
+    // once the diagnostics that came before them have been reported.
+    for (auto& job : jobs)
+    {
+        job.sink.replayDeferredDiagnostics(sink);
+        if (job.exception)
+        {
+            std::rethrow_exception(job.exception);
+        }
+    }
+}
+
 void EndToEndCompileRequest::generateOutput()
 {
     SLANG_PROFILE;
@@ -2849,7 +3006,13 @@ void CodeGenContext::_dumpIntermediateMaybeWithAssembly(IArtifact* artifact)
     _dumpIntermediate(artifact);
 
     ComPtr<IArtifact> assembly;
-    ArtifactOutputUtil::maybeDisassemble(getSession(), artifact, nullptr, assembly);
+    ArtifactOutputUtil::maybeDisassemble(
+        getSession(),
+        artifact,
+        nullptr,
+        getTargetProgram()->getOptionSet().getIntOption(
+            CompilerOptionName::DownstreamCompileConcurrency),
+        assembly);
 
     if (assembly)
     {
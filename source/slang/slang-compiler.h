@@ -3,6 +3,7 @@
 
 #include "../compiler-core/slang-artifact-representation-impl.h"
 #include "../compiler-core/slang-command-line-args.h"
+#include "../compiler-core/slang-downstream-compile-scheduler.h"
 #include "../compiler-core/slang-downstream-compiler-util.h"
 #include "../compiler-core/slang-downstream-compiler.h"
 #include "../compiler-core/slang-include-system.h"
@@ -13,6 +14,7 @@
 #include "../core/slang-command-options.h"
 #include "../core/slang-crypto.h"
 #include "../core/slang-file-system.h"
+#include "../core/slang-persistent-cache.h"
 #include "../core/slang-shared-library.h"
 #include "../core/slang-std-writers.h"
 #include "slang-capability.h"
@@ -27,7 +29,9 @@
 #include "slang-syntax.h"
 #include "slang.h"
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
 
 namespace Slang
 {
@@ -402,6 +406,10 @@ public:
     /// The `target` must be a target on the `Linkage` that was used to create this program.
     TargetProgram* getTargetProgram(TargetRequest* target);
 
+    /// Drop the target-specific version of this program for `target`, when `target` is
+    /// removed from the `Linkage`.
+    void removeTargetProgram(TargetRequest* target) { m_targetPrograms.remove(target); }
+
     /// Update the hash builder with the dependencies for this component type.
     virtual void buildHash(DigestBuilder<SHA1>& builder) = 0;
 
@@ -614,6 +622,13 @@ protected:
     std::unique_ptr<Dictionary<String, IntVal*>> m_mapMangledNameToIntVal;
 
     Dictionary<Int, ComPtr<IArtifact>> m_targetArtifacts;
+
+    /// Append the names identifying the entry point at `entryPointIndex` to `builder`.
+    void _appendEntryPointToHash(DigestBuilder<SHA1>& builder, SlangInt entryPointIndex);
+
+    /// Get the key for the code for an entry point on a target in the compilation cache.
+    /// An `entryPointIndex` of -1 gets the key for the code for the whole program.
+    PersistentCache::Key _getCompilationCacheKey(SlangInt entryPointIndex, SlangInt targetIndex);
 };
 
 /// A component type built up from other component types.
@@ -2170,6 +2185,21 @@ const char* getBuildTagString();
 
 struct TypeCheckingCache;
 
+/// Statistics of the type checking caches of the linkages in a session
+struct TypeCheckingCacheStats
+{
+    /// Lookups of entries that the linkage added itself
+    UInt64 localHitCount = 0;
+    /// Lookups of entries that were shared by other linkages
+    UInt64 sharedHitCount = 0;
+    /// Lookups that didn't find an entry
+    UInt64 missCount = 0;
+    /// Amount of times staged entries were merged into the shared entries
+    UInt64 mergeCount = 0;
+    /// Amount of shared entries
+    UInt64 sharedEntryCount = 0;
+};
+
 struct ContainerTypeKey
 {
     slang::TypeReflection* elementType;
@@ -2228,7 +2258,9 @@ enum ModuleBlobType
 };
 
 /// A context for loading and re-using code modules.
-class Linkage : public RefObject, public slang::ISession
+class Linkage : public RefObject,
+                public slang::ISession,
+                public slang::ICompilationCacheService_Experimental
 {
 public:
     SLANG_REF_OBJECT_IUNKNOWN_ALL
@@ -2349,6 +2381,12 @@ public:
 
     NamePool* getNamePool() { return &namePool; }
 
+    // Tokens of files brought in with `#include`, shared by each translation unit
+    // preprocessed for this linkage
+    RefPtr<IncludedFileTokenCache> m_includedFileTokenCache;
+
+    IncludedFileTokenCache* getIncludedFileTokenCache() { return m_includedFileTokenCache; }
+
     ASTBuilder* getASTBuilder() { return m_astBuilder; }
 
     RefPtr<ASTBuilder> m_astBuilder;
@@ -2362,6 +2400,21 @@ public:
 
     RefPtr<RefObject> m_typeCheckingCache = nullptr;
 
+    /// Get the persistent cache of generated code, or nullptr if the
+    /// `CompilationCachePath` option isn't set.
+    PersistentCache* getCompilationCache();
+
+    RefPtr<PersistentCache> m_compilationCache;
+    bool m_isCompilationCacheInitialized = false;
+
+    // ICompilationCacheService_Experimental
+    SLANG_NO_THROW SlangResult SLANG_MCALL getCacheStatistics(
+        SlangInt* outHitCount,
+        SlangInt* outMissCount,
+        SlangInt* outEntryCount) override;
+    SLANG_NO_THROW void SLANG_MCALL resetCacheStatistics() override;
+    SLANG_NO_THROW SlangResult SLANG_MCALL clearCache() override;
+
     // Modules that have been dynamically loaded via `import`
     //
     // This is a list of unique modules loaded, in the order they were encountered.
@@ -2453,6 +2506,32 @@ public:
         SourceLoc const& loc,
         DiagnosticSink* sink);
 
+    /// Load the contents of the module file found at `pathInfo`, which will be
+    /// memory mapped for a binary module if `-mmap-modules` is enabled.
+    SlangResult _loadModuleFile(
+        ModuleBlobType blobType,
+        const PathInfo& pathInfo,
+        IncludeSystem& includeSystem,
+        ComPtr<ISlangBlob>& outBlob);
+
+    /// A file that a module with a given name could be loaded from.
+    struct ModuleFileCandidate
+    {
+        ModuleBlobType type;
+        String fileName;
+    };
+
+    /// Get the files to search for when importing the module `moduleName`,
+    /// in order of preference.
+    void _getModuleFileCandidates(Name* moduleName, List<ModuleFileCandidate>& outCandidates);
+
+    /// Read the files of the modules imported by `moduleDecl` that have not been
+    /// loaded yet, so they are ready by the time semantic checking imports them.
+    ///
+    /// The files are read concurrently when `-parallel-module-loading` is enabled and
+    /// the linkage uses the OS file system, and otherwise this does nothing.
+    void prefetchImportedModuleFiles(ModuleDecl* moduleDecl);
+
     /// Either finds a previously-loaded module matching what
     /// was serialized into `moduleChunk`, or else attempts
     /// to load the serialized module.
@@ -2596,6 +2675,13 @@ private:
     // Any modules currently being imported will be listed here
     ModuleBeingImportedRAII* m_modulesBeingImported = nullptr;
 
+    // Contents of module files read by `prefetchImportedModuleFiles`, keyed by found path.
+    // An entry is removed once the module is loaded from it.
+    Dictionary<String, ComPtr<ISlangBlob>> m_prefetchedModuleFiles;
+
+    // Threads `prefetchImportedModuleFiles` reads files on, created when first needed.
+    RefPtr<ThreadPool> m_moduleLoadingThreadPool;
+
     /// Is the given module in the middle of being imported?
     bool isBeingImported(Module* module);
 
@@ -2859,6 +2945,8 @@ public:
     ///
     IArtifact* getExistingEntryPointResult(Int entryPointIndex)
     {
+        if (entryPointIndex >= m_entryPointResults.getCount())
+            return nullptr;
         return m_entryPointResults[entryPointIndex];
     }
 
@@ -2878,6 +2966,17 @@ public:
         DiagnosticSink* sink,
         EndToEndCompileRequest* endToEndReq = nullptr);
 
+    /// Make sure there is space to hold results for at least `count` entry points.
+    ///
+    /// Results for different entry points can be created concurrently, once space
+    /// has been made for all of them.
+    ///
+    void _ensureEntryPointResultCount(Count count)
+    {
+        if (count > m_entryPointResults.getCount())
+            m_entryPointResults.setCount(count);
+    }
+
     RefPtr<IRModule> getOrCreateIRModuleForLayout(DiagnosticSink* sink);
 
     RefPtr<IRModule> getExistingIRModuleForLayout() { return m_irModuleForLayout; }
@@ -3483,6 +3582,11 @@ public:
 
     CompilerOptionSet& getOptionSet() { return m_linkage->m_optionSet; }
 
+    /// Put the linkage back as it is now when this request is destroyed, so that options and
+    /// targets of this request don't apply to later requests for the same linkage. Modules the
+    /// request loads stay loaded. Only used by `slangc -server`.
+    void setRestoreLinkageOnDestroy();
+
 private:
     String _getWholeProgramPath(TargetRequest* targetReq);
     String _getEntryPointPath(TargetRequest* targetReq, Index entryPointIndex);
@@ -3503,10 +3607,22 @@ private:
     void generateOutput(ComponentType* program);
     void generateOutput(TargetProgram* targetProgram);
 
+    /// Generate output for all entry points of `targetPrograms`, using up to `threadCount`
+    /// threads. Results and diagnostics match those of generating output serially.
+    void _generateOutputInParallel(List<TargetProgram*> const& targetPrograms, Count threadCount);
+
     void init();
 
+    /// Restore the options and targets the linkage had when this request was created for it.
+    void _restoreLinkage();
+
     Session* m_session = nullptr;
     RefPtr<Linkage> m_linkage;
+
+    // Set by `setRestoreLinkageOnDestroy`, along with the state to restore.
+    bool m_restoreLinkage = false;
+    CompilerOptionSet m_savedLinkageOptionSet;
+    Index m_savedLinkageTargetCount = 0;
     DiagnosticSink m_sink;
     RefPtr<FrontEndCompileRequest> m_frontEndReq;
     RefPtr<ComponentType> m_specializedGlobalComponentType;
@@ -3680,6 +3796,16 @@ public:
         SlangArchiveType archiveType,
         ISlangBlob** outBlob) override;
 
+    /// Load a builtin module from the archive held in `moduleBlob`, which is kept alive for as
+    /// long as the module needs it.
+    ///
+    /// If the archive is uncompressed (`SLANG_ARCHIVE_TYPE_RIFF`), the module is read in
+    /// place from the blob, so a blob that maps a file or static data only has the parts of
+    /// the module that are used paged in.
+    SlangResult loadBuiltinModuleFromBlob(
+        slang::BuiltinModuleName moduleName,
+        ISlangBlob* moduleBlob);
+
     SLANG_NO_THROW SlangCapabilityID SLANG_MCALL findCapability(char const* name) override;
 
     SLANG_NO_THROW void SLANG_MCALL setDownstreamCompilerForTransition(
@@ -3726,6 +3852,10 @@ public:
     ModuleDecl* baseModuleDecl = nullptr;
     List<RefPtr<Module>> coreModules;
 
+    /// If set, the bodies of functions in builtin modules that are loaded from serialized
+    /// modules are only deserialized when they are linked.
+    bool deferBuiltinFunctionBodies = true;
+
     SourceManager builtinSourceManager;
 
     SourceManager* getBuiltinSourceManager() { return &builtinSourceManager; }
@@ -3809,14 +3939,31 @@ public:
         Module*& outModule);
     ~Session();
 
-    void addDownstreamCompileTime(double time) { m_downstreamCompileTime += time; }
-    void addTotalCompileTime(double time) { m_totalCompileTime += time; }
+    void addDownstreamCompileTime(double time)
+    {
+        std::lock_guard<std::mutex> lock(m_compileTimeMutex);
+        m_downstreamCompileTime += time;
+    }
+    void addTotalCompileTime(double time)
+    {
+        std::lock_guard<std::mutex> lock(m_compileTimeMutex);
+        m_totalCompileTime += time;
+    }
 
     ComPtr<ISlangSharedLibraryLoader>
         m_sharedLibraryLoader; ///< The shared library loader (never null)
 
     int m_downstreamCompilerInitialized = 0;
 
+    /// Guards lazy loading of downstream compilers, which can happen from multiple threads
+    /// when code generation is run in parallel. Recursive as loading the generic C/C++
+    /// compiler loads each of the specific compilers.
+    std::recursive_mutex m_downstreamCompilerMutex;
+
+    /// Decides when a downstream compiler can be invoked, when code generation is run in
+    /// parallel. Only compilers that are marked as thread safe are run concurrently.
+    DownstreamCompileScheduler m_downstreamCompileScheduler;
+
     RefPtr<DownstreamCompilerSet>
         m_downstreamCompilerSet; ///< Information about all available downstream compilers.
     ComPtr<IDownstreamCompiler> m_downstreamCompilers[int(
@@ -3829,9 +3976,39 @@ public:
 
     int m_typeDictionarySize = 0;
 
-    RefPtr<RefObject> m_typeCheckingCache;
-    TypeCheckingCache* getTypeCheckingCache();
+    /// Memory of linked IR modules reclaimed with `-reclaim-ir-memory`, for the performance
+    /// benchmark report.
+    std::atomic<UInt64> m_recycledIRMemory{0};
+    std::atomic<UInt64> m_compactedIRMemory{0};
+
+    /// Output of the SPIR-V optimizer cached with `-spirv-opt-cache`, keyed by a hash of the
+    /// unoptimized SPIR-V and the optimizer options.
+    Dictionary<SHA1::Digest, ComPtr<ISlangBlob>> m_spirvOptimizerCache;
+    /// Total size in bytes of the blobs in `m_spirvOptimizerCache`.
+    size_t m_spirvOptimizerCacheSize = 0;
+    std::mutex m_spirvOptimizerCacheMutex;
+    std::atomic<UInt64> m_spirvOptimizerCacheHitCount{0};
+    std::atomic<UInt64> m_spirvOptimizerCacheMissCount{0};
+
+    /// The latest snapshot of the type checking cache entries shared by all linkages, as a
+    /// `SharedTypeCheckingCache`. It is created with the first linkage cache, and replaced by
+    /// every merge. References to snapshots are only added or released with
+    /// `m_typeCheckingCacheMutex` held.
+    RefPtr<RefObject> m_sharedTypeCheckingCache;
     std::mutex m_typeCheckingCacheMutex;
+    int m_typeCheckingCacheVersion = 0;
+    TypeCheckingCacheStats m_typeCheckingCacheStats;
+
+    /// Create a type checking cache for a linkage, which reads the shared entries
+    RefPtr<TypeCheckingCache> createTypeCheckingCache();
+
+    /// Merge the entries staged in the cache of a linkage into the shared entries
+    void mergeTypeCheckingCache(TypeCheckingCache* cache);
+
+    /// Release the cache of a linkage, along with its reference to the shared entries
+    void releaseTypeCheckingCache(RefPtr<RefObject>& cache);
+
+    TypeCheckingCacheStats getTypeCheckingCacheStats();
 
 private:
     struct BuiltinModuleInfo
@@ -3863,6 +4040,7 @@ private:
     // Describes a conversion from one code gen target (source) to another (target)
     CodeGenTransitionMap m_codeGenTransitionMap;
 
+    std::mutex m_compileTimeMutex;
     double m_downstreamCompileTime = 0.0;
     double m_totalCompileTime = 0.0;
 };
@@ -1,6 +1,7 @@
 // slang-emit-spirv.cpp
 
 #include "../core/slang-memory-arena.h"
+#include "../core/slang-performance-profiler.h"
 #include "slang-compiler.h"
 #include "slang-emit-base.h"
 #include "slang-ir-call-graph.h"
@@ -111,15 +112,44 @@ static const uint32_t kSPIRVSlangCompilerId = 40 << 16;
 // the global scope.
 //
 // To deal with the above issues, our strategy will be to emit
-// SPIR-V instructions into a lightweight intermediate structure
-// that simplifies dealing with ordering constraiints on
-// instructions.
+// the words of each SPIR-V instruction as soon as it is complete,
+// into a stream of words that belongs to its parent: one of the
+// logical sections of the module, a function, or a block. Emitting
+// into a stream per parent takes care of the ordering constraints,
+// and at the end the streams are spliced together into the final
+// module.
 //
 // We will start by forward-declaring the type we will
 // use to represent instructions:
 //
 struct SpvInst;
 
+/// The encoded words of the instructions that belong to a parent.
+///
+/// Besides the words themselves, the stream records the few things that have
+/// to be fixed up when it is flattened into the final module: instructions that
+/// have children of their own (whose streams follow their words), instructions
+/// that have been given more operands after they were written, and ranges of
+/// words that have been removed because their instruction was moved.
+///
+struct SpvWordStream : RefObject
+{
+    /// The words of the instructions in the stream, in the order they were written
+    List<SpvWord> words;
+
+    /// Instructions in the stream with children or extra operand words
+    List<SpvInst*> splicedInsts;
+
+    struct Range
+    {
+        Index offset;
+        Index count;
+    };
+
+    /// Ranges of `words` that are not part of the module anymore
+    List<Range> removedRanges;
+};
+
 // Next, we will define a base type that can serve as a parent
 // to SPIR-V instructions. Both the logical sections defined
 // earlier and instructions such as functions will be used
@@ -127,38 +157,31 @@ struct SpvInst;
 
 /// Base type for SPIR-V instructions and logical sections of a module
 ///
-/// Holds and supports appending to a list of child instructions.
+/// Refers to the stream of words of the child instructions, which is only
+/// created when the first child is written.
 struct SpvInstParent
 {
 public:
-    /// Add an instruction to the end of the list of children
-    void addInst(SpvInst* inst);
+    /// The words of the children, if there are any.
+    SpvWordStream* m_stream = nullptr;
 
-    /// Dump all children, recursively, to a flattened list of SPIR-V words
-    void dumpTo(List<SpvWord>& ioWords);
-
-    /// The first child, if any.
-    SpvInst* m_firstChild = nullptr;
-
-    /// A pointer to the null pointer at the end of the linked list.
-    ///
-    /// If the list of children is empty this points to `m_firstChild`,
-    /// while if it is non-empty it points to the `nextSibling` field
-    /// of the last instruction.
-    ///
-    SpvInst* m_lastChild = nullptr;
+    /// Set if this parent is a `SpvInst`
+    bool m_isInst = false;
 };
 
 // A SPIR-V instruction is then (in the general case) a potential
 // parent to other instructions.
 
-/// A type to represent a SPIR-V instruction to be emitted.
+/// A type to represent a SPIR-V instruction that has been emitted.
 ///
-/// This type alows the instruction to be built up across
-/// multiple steps in a mutable fashion.
+/// The words of the instruction are stored in the stream of its parent,
+/// so this only holds what is needed to refer to the instruction, and to
+/// find its words again.
 ///
 struct SpvInst : SpvInstParent
 {
+    SpvInst() { m_isInst = true; }
+
     // [2.3: Physical Layout of a SPIR-V Module and Instruction]
     //
     // > Each instruction is a stream of words
@@ -166,117 +189,31 @@ struct SpvInst : SpvInstParent
     // > Opcode: The 16 high-order bits are the WordCount of the instruction.
     // >         The 16 low-order bits are the opcode enumerant.
     //
-    // We will store the "opcode enumerant" directly in our
-    // intermediate structure, and compute the word count on
-    // the fly when writing an instruction to an output buffer.
+    // The operand words are only known once the instruction is complete,
+    // so we keep the opcode around until then.
 
     /// The SPIR-V opcode for the instruction
     SpvOp opcode;
 
-    // [2.3: Physical Layout of a SPIR-V Module and Instruction]
-    //
-    // > Optional instruction type <id> (presence determined by opcode)
-    // > Optional instruction Result <id> (presence determined by opcode)
-    // > Operand 1 (if needed)
-    // > Operand 2 (if needed)
-    // > ...
-    //
-    // We represent the remaining words of the instruction (after
-    // the opcode word) as an undifferentiated array. Any code
-    // that encodes an instruction is responsible for knowing the
-    // opcode-specific data that is required.
-    //
-    // Our code does not need to process instruction operands after
-    // they have been written into a `SpvInst`. If we ever had
-    // cases where we needed to do post-processing, then we would
-    // need to store a more refined representation here.
-
-    /// The additional words of the instruction after the opcode
-    SpvWord* operandWords = nullptr;
-    /// The amount of operand words
-    uint32_t operandWordsCount = 0;
-
-    // We will store the instructions in a given `SpvInstParent`
-    // using an intrusive linked list.
-
-    SpvInstParent* parent = nullptr;
-
-    /// The next instruction in the same `SpvInstParent`
-    SpvInst* nextSibling = nullptr;
-
-    SpvInst* prevSibling = nullptr;
+    /// The number of words written for the instruction, including the opcode word,
+    /// or zero if the instruction hasn't been written into a parent yet.
+    uint32_t wordCount = 0;
 
     /// The result <id> produced by this instruction, or zero if it has no result.
     SpvWord id = 0;
 
-    /// Dump the instruction (and any children, recursively) into the flat array of SPIR-V words.
-    void dumpTo(List<SpvWord>& ioWords)
-    {
-        // [2.2: Terms]
-        //
-        // > Word Count: The complete number of words taken by an instruction,
-        // > including the word holding the word count and opcode, and any optional
-        // > operands. An instruction’s word count is the total space taken by the instruction.
-        //
-        SpvWord wordCount = 1 + SpvWord(operandWordsCount);
-
-        // [2.3: Physical Layout of a SPIR-V Module and Instruction]
-        //
-        // > Opcode: The 16 high-order bits are the WordCount of the instruction.
-        // >         The 16 low-order bits are the opcode enumerant.
-        //
-        ioWords.add(wordCount << 16 | opcode);
-
-        // The operand words simply follow the opcode word.
-        //
-        ioWords.addRange(operandWords, operandWordsCount);
-
-        // In our representation choice, the children of a
-        // parent instruction will always follow the encoded
-        // words of a parent:
-        //
-        // * The instructions inside a function always follow the `OpFunction`
-        // * The instructions inside a block always follow the `OpLabel`
-        //
-        SpvInstParent::dumpTo(ioWords);
-    }
+    /// Set once the instruction has been added to the spliced instructions of its parent
+    bool isSpliced = false;
 
-    void removeFromParent()
-    {
-        auto oldParent = parent;
-
-        // If we don't currently have a parent, then
-        // we are doing fine.
-        if (!oldParent)
-            return;
-
-        auto pp = prevSibling;
-        auto nn = nextSibling;
+    SpvInstParent* parent = nullptr;
 
-        if (pp)
-        {
-            SLANG_ASSERT(pp->parent == oldParent);
-            pp->nextSibling = nn;
-        }
-        else
-        {
-            oldParent->m_firstChild = nn;
-        }
+    /// The offset of the first word of the instruction in the stream of `parent`
+    Index wordOffset = 0;
 
-        if (nn)
-        {
-            SLANG_ASSERT(nn->parent == oldParent);
-            nn->prevSibling = pp;
-        }
-        else
-        {
-            oldParent->m_lastChild = pp;
-        }
-
-        prevSibling = nullptr;
-        nextSibling = nullptr;
-        parent = nullptr;
-    }
+    /// Operand words added after the instruction was written, which follow the
+    /// written words in the final module.
+    SpvWord* extraOperandWords = nullptr;
+    uint32_t extraOperandWordsCount = 0;
 };
 
 /// A logical section of a SPIR-V module
@@ -284,38 +221,6 @@ struct SpvLogicalSection : SpvInstParent
 {
 };
 
-// Now that we've filled in the definition of `SpvInst`, we can
-// go back and define the key operations on `SpvInstParent`.
-
-void SpvInstParent::addInst(SpvInst* inst)
-{
-    SLANG_ASSERT(inst);
-    SLANG_ASSERT(!inst->nextSibling);
-
-    if (m_firstChild == nullptr)
-    {
-        m_firstChild = m_lastChild = inst;
-        return;
-    }
-
-    // The user shouldn't be trying to add multiple instructions at once.
-    // If they really want that then they probably wanted to give `inst`
-    // some children.
-    //
-    m_lastChild->nextSibling = inst;
-    inst->prevSibling = m_lastChild;
-    inst->parent = this;
-    m_lastChild = inst;
-}
-
-void SpvInstParent::dumpTo(List<SpvWord>& ioWords)
-{
-    for (auto child = m_firstChild; child; child = child->nextSibling)
-    {
-        child->dumpTo(ioWords);
-    }
-}
-
 /// The context for inlining a SPV assembly snippet.
 struct SpvSnippetEmitContext
 {
@@ -511,12 +416,191 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
     /// Get a logical section based on its `SpvLogicalSectionID`
     SpvLogicalSection* getSection(SpvLogicalSectionID id) { return &m_sections[int(id)]; }
 
+    /// Holds the word streams of all the parents in the module.
+    List<RefPtr<SpvWordStream>> m_wordStreams;
+
+    /// Get the stream that the children of `parent` are written to, creating it if needed.
+    SpvWordStream* _getWordStream(SpvInstParent* parent)
+    {
+        if (!parent->m_stream)
+        {
+            RefPtr<SpvWordStream> stream = new SpvWordStream();
+            m_wordStreams.add(stream);
+            parent->m_stream = stream;
+
+            // The children of an instruction follow its words, so it has to be
+            // spliced when its parent is flattened.
+            if (parent->m_isInst)
+                _spliceInst(static_cast<SpvInst*>(parent));
+        }
+        return parent->m_stream;
+    }
+
+    /// Make sure `inst` is visited when the stream of its parent is flattened.
+    void _spliceInst(SpvInst* inst)
+    {
+        // An instruction that hasn't been written yet is spliced when it is.
+        if (inst->isSpliced || !inst->wordCount)
+            return;
+        inst->isSpliced = true;
+        _getWordStream(inst->parent)->splicedInsts.add(inst);
+    }
+
+    /// Add `inst`, which is being constructed, to the end of the children of `parent`.
+    ///
+    /// The words of `inst` are written into the stream of `parent` when its construction
+    /// ends.
+    void _addInst(SpvInstParent* parent, SpvInst* inst)
+    {
+        SLANG_ASSERT(parent);
+        SLANG_ASSERT(inst);
+        SLANG_ASSERT(!inst->parent);
+        inst->parent = parent;
+    }
+
+    /// Write the words of `inst` to the end of the stream of its parent.
+    void _writeInst(SpvInst* inst, const SpvWord* operandWords, Index operandWordsCount)
+    {
+        auto stream = _getWordStream(inst->parent);
+
+        // [2.2: Terms]
+        //
+        // > Word Count: The complete number of words taken by an instruction,
+        // > including the word holding the word count and opcode, and any optional
+        // > operands. An instruction’s word count is the total space taken by the instruction.
+        //
+        inst->wordOffset = stream->words.getCount();
+        inst->wordCount = uint32_t(1 + operandWordsCount);
+
+        // [2.3: Physical Layout of a SPIR-V Module and Instruction]
+        //
+        // > Opcode: The 16 high-order bits are the WordCount of the instruction.
+        // >         The 16 low-order bits are the opcode enumerant.
+        //
+        stream->words.add(SpvWord(inst->wordCount) << 16 | inst->opcode);
+        stream->words.addRange(operandWords, operandWordsCount);
+
+        if (inst->m_stream)
+            _spliceInst(inst);
+    }
+
+    /// Add `words` to the end of the operands of `inst`, which has already been written.
+    void _appendOperandWords(SpvInst* inst, const SpvWord* words, Index wordsCount)
+    {
+        auto newWords =
+            m_memoryArena.allocateArray<SpvWord>(inst->extraOperandWordsCount + wordsCount);
+        ::memcpy(newWords, inst->extraOperandWords, inst->extraOperandWordsCount * sizeof(SpvWord));
+        ::memcpy(newWords + inst->extraOperandWordsCount, words, wordsCount * sizeof(SpvWord));
+        inst->extraOperandWords = newWords;
+        inst->extraOperandWordsCount += uint32_t(wordsCount);
+
+        _spliceInst(inst);
+    }
+
+    /// Move `inst`, which has already been written, to the end of the children of its parent.
+    void _moveInstToEnd(SpvInst* inst)
+    {
+        auto stream = _getWordStream(inst->parent);
+        auto& words = stream->words;
+        stream->removedRanges.add({inst->wordOffset, Index(inst->wordCount)});
+
+        // Make sure that `words` won't be reallocated while we copy from it.
+        words.reserve(words.getCount() + inst->wordCount);
+        const Index newOffset = words.getCount();
+        words.addRange(words.getBuffer() + inst->wordOffset, inst->wordCount);
+        inst->wordOffset = newOffset;
+    }
+
     // At the end of emission we need a single linear stream of words,
     // so we will eventually flatten `m_sections` into a single array.
 
     /// The final array of SPIR-V words that defines the encoded module
     List<SpvWord> m_words;
 
+    /// Get the number of words that the children of `parent` flatten to.
+    Count _calcFlattenedWordCount(SpvInstParent* parent)
+    {
+        auto stream = parent->m_stream;
+        if (!stream)
+            return 0;
+
+        Count count = stream->words.getCount();
+        for (const auto& range : stream->removedRanges)
+            count -= range.count;
+        for (auto inst : stream->splicedInsts)
+            count += inst->extraOperandWordsCount + _calcFlattenedWordCount(inst);
+        return count;
+    }
+
+    /// Write the words of the children of `parent`, recursively, to `dst`, and return
+    /// the end of the words written. The stream of `parent` is freed afterwards.
+    SpvWord* _flattenTo(SpvInstParent* parent, SpvWord* dst)
+    {
+        auto stream = parent->m_stream;
+        if (!stream)
+            return dst;
+
+        auto& splicedInsts = stream->splicedInsts;
+        auto& removedRanges = stream->removedRanges;
+        splicedInsts.sort([](SpvInst* a, SpvInst* b) { return a->wordOffset < b->wordOffset; });
+        removedRanges.sort([](const SpvWordStream::Range& a, const SpvWordStream::Range& b)
+                           { return a.offset < b.offset; });
+
+        const SpvWord* words = stream->words.getBuffer();
+        Index cursor = 0;
+        auto copyUpTo = [&](Index end)
+        {
+            ::memcpy(dst, words + cursor, (end - cursor) * sizeof(SpvWord));
+            dst += end - cursor;
+            cursor = end;
+        };
+
+        Index splicedIndex = 0;
+        Index removedIndex = 0;
+        while (splicedIndex < splicedInsts.getCount() || removedIndex < removedRanges.getCount())
+        {
+            if (removedIndex < removedRanges.getCount() &&
+                (splicedIndex == splicedInsts.getCount() ||
+                 removedRanges[removedIndex].offset < splicedInsts[splicedIndex]->wordOffset))
+            {
+                const auto& range = removedRanges[removedIndex++];
+                copyUpTo(range.offset);
+                cursor += range.count;
+                continue;
+            }
+
+            auto inst = splicedInsts[splicedIndex++];
+            copyUpTo(inst->wordOffset);
+            if (inst->extraOperandWordsCount)
+            {
+                // The word count in the opcode word has to include the extra operands.
+                *dst++ = SpvWord(inst->wordCount + inst->extraOperandWordsCount) << 16 |
+                         inst->opcode;
+                cursor++;
+                copyUpTo(inst->wordOffset + inst->wordCount);
+                ::memcpy(dst, inst->extraOperandWords, inst->extraOperandWordsCount * sizeof(SpvWord));
+                dst += inst->extraOperandWordsCount;
+            }
+            else
+            {
+                copyUpTo(inst->wordOffset + inst->wordCount);
+            }
+
+            // In our representation choice, the children of a
+            // parent instruction will always follow the encoded
+            // words of a parent:
+            //
+            // * The instructions inside a function always follow the `OpFunction`
+            // * The instructions inside a block always follow the `OpLabel`
+            //
+            dst = _flattenTo(inst, dst);
+        }
+        copyUpTo(stream->words.getCount());
+
+        stream->words.clearAndDeallocate();
+        return dst;
+    }
+
     /// Emit the concrete words that make up the binary SPIR-V module.
     ///
     /// This function fills in `m_words` based on the data in `m_sections`.
@@ -524,19 +608,26 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
     ///
     void emitPhysicalLayout()
     {
+        const Index kHeaderWordCount = 5;
+        Count wordCount = kHeaderWordCount;
+        for (auto& section : m_sections)
+            wordCount += _calcFlattenedWordCount(&section);
+        m_words.setCount(wordCount);
+        SpvWord* dst = m_words.getBuffer();
+
         // [2.3: Physical Layout of a SPIR-V Module and Instruction]
         //
         // > Magic Number
         //
-        m_words.add(SpvMagicNumber);
+        *dst++ = SpvMagicNumber;
 
         // > Version nuumber
         //
-        m_words.add(m_spvVersion);
+        *dst++ = m_spvVersion;
 
         // > Generator's magic number.
         //
-        m_words.add(kSPIRVSlangCompilerId);
+        *dst++ = kSPIRVSlangCompilerId;
 
         // > Bound
         //
@@ -544,11 +635,11 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         // <id>s, so its value when we are done emitting code
         // can serve as the bound.
         //
-        m_words.add(m_nextID);
+        *dst++ = m_nextID;
 
         // > 0 (Reserved for instruction schema, if needed.)
         //
-        m_words.add(0);
+        *dst++ = 0;
 
         // > First word of instruction stream
         // > All remaining words are a linear sequence of instructions.
@@ -556,10 +647,11 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         // Once we are done emitting the header, we emit all
         // the instructions in our logical sections.
         //
-        for (int ii = 0; ii < int(SpvLogicalSectionID::Count); ++ii)
+        for (auto& section : m_sections)
         {
-            m_sections[ii].dumpTo(m_words);
+            dst = _flattenTo(&section, dst);
         }
+        SLANG_ASSERT(dst == m_words.end());
     }
 
     // We will often need to refer to an instrcition by its
@@ -759,14 +851,14 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         const Index operandsCount = m_operandStack.getCount() - operandsStartIndex;
 
 
-        if (operandsCount)
+        // Write the instruction into its parent, if it was added to one. An instruction
+        // that wasn't isn't part of the module.
+        if (m_currentInst->parent)
         {
-            // Allocate the operands
-            m_currentInst->operandWords = m_memoryArena.allocateAndCopyArray(
+            _writeInst(
+                m_currentInst,
                 m_operandStack.getBuffer() + operandsStartIndex,
                 operandsCount);
-            // Set the count
-            m_currentInst->operandWordsCount = uint32_t(operandsCount);
         }
 
         // Make the previous inst active
@@ -1232,7 +1324,7 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         InstConstructScope scopeInst(this, opcode, irInst);
         SpvInst* spvInst = scopeInst;
         f();
-        parent->addInst(spvInst);
+        _addInst(parent, spvInst);
         return spvInst;
     }
 
@@ -1278,8 +1370,8 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
 
         // Hash the whole global stack and opcode
         SpvTypeInstKey key;
-        key.words.add(opcode);
-        key.words.addRange(ourOperands);
+        key.opcode = opcode;
+        key.operands = makeConstArrayView(ourOperands.getBuffer(), ourOperands.getCount());
 
         // If we have seen this before, return the memoized instruction
         if (SpvInst** memoized = m_spvTypeInsts.tryGetValue(key))
@@ -1298,13 +1390,13 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         // Otherwise, we can construct our instruction and record the result
         InstConstructScope scopeInst(this, opcode, irInst);
         SpvInst* spvInst = scopeInst;
-        m_spvTypeInsts[key] = spvInst;
+        _addMemoizedInst(opcode, ourOperands, spvInst);
 
         // Emit our operands, this time with the resultId too
         emitOperand(resultId);
         m_operandStack.addRange(ourOperands);
 
-        parent->addInst(spvInst);
+        _addInst(parent, spvInst);
         return spvInst;
     }
 
@@ -1326,8 +1418,8 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
 
         // Hash the whole global stack and opcode
         SpvTypeInstKey key;
-        key.words.add(opcode);
-        key.words.addRange(ourOperands);
+        key.opcode = opcode;
+        key.operands = makeConstArrayView(ourOperands.getBuffer(), ourOperands.getCount());
 
         // If we have seen this before, return the memoized instruction
         if (SpvInst** memoized = m_spvTypeInsts.tryGetValue(key))
@@ -1336,11 +1428,11 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         // Otherwise, we can construct our instruction and record the result
         InstConstructScope scopeInst(this, opcode, irInst);
         SpvInst* spvInst = scopeInst;
-        m_spvTypeInsts[key] = spvInst;
+        _addMemoizedInst(opcode, ourOperands, spvInst);
 
         m_operandStack.addRange(ourOperands);
 
-        parent->addInst(spvInst);
+        _addInst(parent, spvInst);
         return spvInst;
     }
     //
@@ -1674,19 +1766,46 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
         return m_extensionInsts.containsKey(name);
     }
 
+    /// Identifies a memoized instruction by its opcode and operands (other than its result <id>).
+    ///
+    /// The operand words are not owned by the key, so that looking up an instruction
+    /// doesn't have to copy them. The keys stored in `m_spvTypeInsts` refer to copies
+    /// in `m_memoryArena`.
     struct SpvTypeInstKey
     {
-        List<SpvWord> words;
-        bool operator==(const SpvTypeInstKey& other) const { return words == other.words; }
+        SpvOp opcode;
+        ConstArrayView<SpvWord> operands;
+
+        bool operator==(const SpvTypeInstKey& other) const
+        {
+            return opcode == other.opcode && operands.getCount() == other.operands.getCount() &&
+                   ::memcmp(
+                       operands.getBuffer(),
+                       other.operands.getBuffer(),
+                       operands.getCount() * sizeof(SpvWord)) == 0;
+        }
         const static bool kHasUniformHash = true;
         auto getHashCode() const
         {
-            return Slang::getHashCode(
-                reinterpret_cast<const char*>(words.getBuffer()),
-                words.getCount() * sizeof(SpvWord));
+            return combineHash(
+                Slang::getHashCode(
+                    reinterpret_cast<const char*>(operands.getBuffer()),
+                    operands.getCount() * sizeof(SpvWord)),
+                HashCode64(opcode));
         }
     };
 
+    /// Record `spvInst` as the memoized instruction for `opcode` and `operands`.
+    void _addMemoizedInst(SpvOp opcode, const List<SpvWord>& operands, SpvInst* spvInst)
+    {
+        SpvTypeInstKey key;
+        key.opcode = opcode;
+        key.operands = makeConstArrayView(
+            m_memoryArena.allocateAndCopyArray(operands.getBuffer(), operands.getCount()),
+            operands.getCount());
+        m_spvTypeInsts[key] = spvInst;
+    }
+
     Dictionary<SpvTypeInstKey, SpvInst*> m_spvTypeInsts;
 
     bool shouldEmitSPIRVReflectionInfo()
@@ -6753,7 +6872,7 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
                     break;
                 }
             }
-            parent->addInst(spvInst);
+            _addInst(parent, spvInst);
             emittedInsts.add(spvInst);
         }
         auto resultInst = emittedInsts.getLast();
@@ -8361,16 +8480,10 @@ struct SPIRVEmitContext : public SourceEmitterBase, public SPIRVEmitSharedContex
             if (m_mapForwardRefsToDebugType.tryGetValue(type, forwardRef))
             {
                 // "OpExtInstWithForwardRefsKHR" requires "forward declared ID" at the end.
-                auto tmp = m_memoryArena.allocateArray<SpvWord>(
-                    forwardRef->operandWordsCount + members.getCount());
-                memcpy(
-                    tmp,
-                    forwardRef->operandWords,
-                    forwardRef->operandWordsCount * sizeof(SpvWord));
-                for (Index i = 0; i < members.getCount(); i++)
-                    tmp[forwardRef->operandWordsCount + i] = getID(members[i]);
-                forwardRef->operandWords = tmp;
-                forwardRef->operandWordsCount += (uint32_t)members.getCount();
+                List<SpvWord> memberIDs;
+                for (auto member : members)
+                    memberIDs.add(getID(member));
+                _appendOperandWords(forwardRef, memberIDs.getBuffer(), memberIDs.getCount());
             }
 
             return emitOpDebugTypeComposite(
@@ -9197,6 +9310,8 @@ SlangResult emitSPIRVFromIR(
     const List<IRFunc*>& irEntryPoints,
     List<uint8_t>& spirvOut)
 {
+    SLANG_PROFILE;
+
     spirvOut.clear();
 
     bool symbolsEmitted = false;
@@ -9311,9 +9426,7 @@ SlangResult emitSPIRVFromIR(
             // forward-declared pointer types, so we need to
             // keep iterating until we have emitted all of them.
             context.ensureInst(ptrType.value->getValueType());
-            auto parent = spvPtrType->parent;
-            spvPtrType->removeFromParent();
-            parent->addInst(spvPtrType);
+            context._moveInstToEnd(spvPtrType);
         }
     } while (context.m_forwardDeclaredPointers.getCount() != 0);
 
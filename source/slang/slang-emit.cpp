@@ -667,6 +667,61 @@ static void addDenormalModeDecorations(IRModule* irModule, CodeGenContext* codeG
     }
 }
 
+// Reclaim the memory of the instructions that have been deallocated from the linked IR,
+// if enabled with `-reclaim-ir-memory`. Must only be called between passes.
+//
+// Once enough of the module is garbage, it is compacted, which moves every instruction.
+// The only instructions held across this call are those of `linkedIR` and `entryPoints`,
+// which are updated here. Anything else that held an instruction of the module would be
+// left dangling, so when IR validation is enabled the module is always compacted and then
+// validated, so that tests exercise compaction at every call.
+//
+static void reclaimIRMemory(
+    CodeGenContext* codeGenContext,
+    LinkedIR& linkedIR,
+    List<IRFunc*>& entryPoints)
+{
+    auto irModule = linkedIR.module;
+    if (!irModule->isInstRecyclingEnabled())
+        return;
+
+    SLANG_PROFILE;
+    irModule->recycleDeallocatedInsts();
+
+    const bool shouldValidate = codeGenContext->shouldValidateIR();
+    const auto stats = irModule->getMemoryStats();
+    if (!shouldValidate && stats.freeListBytes * 2 < stats.arenaUsedBytes)
+        return;
+
+    Dictionary<IRInst*, IRInst*> mapOldToNew;
+    if (!irModule->compact(mapOldToNew))
+        return;
+
+    auto remap = [&](auto& inst)
+    {
+        if (!inst)
+            return;
+        IRInst* newInst = nullptr;
+        // An instruction that is no longer in the module is dropped along with it.
+        mapOldToNew.tryGetValue(inst, newInst);
+        inst = static_cast<std::remove_reference_t<decltype(inst)>>(newInst);
+    };
+    remap(linkedIR.globalScopeVarLayout);
+    for (auto& entryPoint : linkedIR.entryPoints)
+    {
+        remap(entryPoint);
+        SLANG_ASSERT(entryPoint);
+    }
+    for (auto& entryPoint : entryPoints)
+    {
+        remap(entryPoint);
+        SLANG_ASSERT(entryPoint);
+    }
+
+    if (shouldValidate)
+        validateIRModule(irModule, codeGenContext->getSink());
+}
+
 // Helper function to convert a 20 byte SHA1 to a hexadecimal string,
 // needed for the build identifier instruction.
 String getBuildIdentifierString(ComponentType* component)
@@ -688,6 +743,7 @@ Result linkAndOptimizeIR(
     LinkedIR& outLinkedIR)
 {
     SLANG_PROFILE;
+    SLANG_PROFILE_STAGES;
     auto session = codeGenContext->getSession();
     auto sink = codeGenContext->getSink();
     auto target = codeGenContext->getTargetFormat();
@@ -698,6 +754,7 @@ Result linkAndOptimizeIR(
     // Get the artifact desc for the target
     const auto artifactDesc = ArtifactDescUtil::makeDescForCompileTarget(asExternal(target));
 
+    SLANG_PROFILE_STAGE(linkIR);
     // We start out by performing "linking" at the level of the IR.
     // This step will create a fresh IR module to be used for
     // code generation, and will copy in any IR definitions that
@@ -710,6 +767,9 @@ Result linkAndOptimizeIR(
     auto irModule = outLinkedIR.module;
     auto irEntryPoints = outLinkedIR.entryPoints;
 
+    if (targetCompilerOptions.getBoolOption(CompilerOptionName::ReclaimIRMemory))
+        irModule->setInstRecyclingEnabled(true);
+
     // For now, only emit the debug build identifier if separate debug info is enabled
     // and only if there are targets.
     // TODO: We will ultimately need to change this to always emit the instruction.
@@ -734,6 +794,7 @@ Result linkAndOptimizeIR(
     // un-specialized IR.
     dumpIRIfEnabled(codeGenContext, irModule, "POST IR VALIDATION");
 
+    SLANG_PROFILE_STAGE(preSpecializationLowering);
     // Scan the IR module and determine which lowering/legalization passes are needed.
     RequiredLoweringPassSet& requiredLoweringPassSet = codeGenContext->getRequiredLoweringPassSet();
     requiredLoweringPassSet = {};
@@ -898,6 +959,7 @@ Result linkAndOptimizeIR(
     deadCodeEliminationOptions.keepGlobalParamsAlive =
         targetProgram->getOptionSet().getBoolOption(CompilerOptionName::PreserveParameters);
 
+    SLANG_PROFILE_STAGE(initialSimplification);
     simplifyIR(targetProgram, irModule, defaultIRSimplificationOptions, sink);
 
     if (targetProgram->getOptionSet().getBoolOption(CompilerOptionName::ValidateUniformity))
@@ -936,6 +998,7 @@ Result linkAndOptimizeIR(
         checkAutodiffPatterns(targetProgram, irModule, sink);
     }
 
+    SLANG_PROFILE_STAGE(specializationAndAutodiff);
     // Next, we need to ensure that the code we emit for
     // the target doesn't contain any operations that would
     // be illegal on the target platform. For example,
@@ -1021,6 +1084,7 @@ Result linkAndOptimizeIR(
             break;
     }
 
+    SLANG_PROFILE_STAGE(finalizeSpecialization);
     // Report checkpointing information
     if (codeGenContext->shouldReportCheckpointIntermediates())
     {
@@ -1033,6 +1097,7 @@ Result linkAndOptimizeIR(
     //
     finalizeAutoDiffPass(targetProgram, irModule);
     eliminateDeadCode(irModule, deadCodeEliminationOptions);
+    reclaimIRMemory(codeGenContext, outLinkedIR, irEntryPoints);
 
     // After auto-diff, we can perform more aggressive specialization with dynamic-dispatch
     // lowering.
@@ -1164,6 +1229,7 @@ Result linkAndOptimizeIR(
         SLANG_RETURN_ON_FAIL(checkGetStringHashInsts(irModule, sink));
     }
 
+    SLANG_PROFILE_STAGE(lowerGenerics);
     // For targets that supports dynamic dispatch, we need to lower the
     // generics / interface types to ordinary functions and types using
     // function pointers.
@@ -1186,6 +1252,7 @@ Result linkAndOptimizeIR(
         return SLANG_OK;
     }
 
+    SLANG_PROFILE_STAGE(postGenericsLowering);
     // After dynamic dispatch logic is resolved into ordinary function calls,
     // we can now run our stage specialization logic.
     if (requiredLoweringPassSet.specializeStageSwitch)
@@ -1222,6 +1289,7 @@ Result linkAndOptimizeIR(
     {
         simplifyIR(targetProgram, irModule, defaultIRSimplificationOptions, sink);
     }
+    reclaimIRMemory(codeGenContext, outLinkedIR, irEntryPoints);
 
     validateIRModuleIfEnabled(codeGenContext, irModule);
 
@@ -1255,6 +1323,7 @@ Result linkAndOptimizeIR(
         addUserTypeHintDecorations(irModule);
     }
 
+    SLANG_PROFILE_STAGE(typeLegalization);
     legalizeEmptyArray(irModule, sink);
 
     // We don't need the legalize pass for C/C++ based types
@@ -1343,6 +1412,7 @@ Result linkAndOptimizeIR(
         eliminateDeadCode(irModule, deadCodeEliminationOptions);
     else
         simplifyIR(targetProgram, irModule, fastIRSimplificationOptions, sink);
+    reclaimIRMemory(codeGenContext, outLinkedIR, irEntryPoints);
 
     if (requiredLoweringPassSet.dynamicResourceHeap)
         lowerDynamicResourceHeap(targetProgram, irModule, sink);
@@ -1352,6 +1422,7 @@ Result linkAndOptimizeIR(
 #endif
     validateIRModuleIfEnabled(codeGenContext, irModule);
 
+    SLANG_PROFILE_STAGE(resourceSpecialization);
     // After type legalization and subsequent SSA cleanup we expect
     // that any resource types passed to functions are exposed
     // as their own top-level parameters (which might have
@@ -1410,6 +1481,7 @@ Result linkAndOptimizeIR(
         break;
     }
 
+    SLANG_PROFILE_STAGE(targetLegalization);
     // For all targets, we translate load/store operations
     // of aggregate types from/to byte-address buffers into
     // stores of individual scalar or vector values.
@@ -1744,6 +1816,7 @@ Result linkAndOptimizeIR(
 #endif
     validateIRModuleIfEnabled(codeGenContext, irModule);
 
+    SLANG_PROFILE_STAGE(finalLowering);
     // Validate vectors and matrices according to what the target allows
     validateVectorsAndMatrices(irModule, sink, targetRequest);
 
@@ -1756,6 +1829,7 @@ Result linkAndOptimizeIR(
     // We run DCE pass again to clean things up.
     //
     eliminateDeadCode(irModule, deadCodeEliminationOptions);
+    reclaimIRMemory(codeGenContext, outLinkedIR, irEntryPoints);
 
     cleanUpVoidType(irModule);
 
@@ -1826,6 +1900,7 @@ Result linkAndOptimizeIR(
         simplifyIR(targetProgram, irModule, simplificationOptions, sink);
     }
 
+    SLANG_PROFILE_STAGE(phiElimination);
     // As a late step, we need to take the SSA-form IR and move things *out*
     // of SSA form, by eliminating all "phi nodes" (block parameters) and
     // introducing explicit temporaries instead. Doing this at the IR level
@@ -1908,6 +1983,7 @@ Result linkAndOptimizeIR(
 
     validateIRModuleIfEnabled(codeGenContext, irModule);
 
+    SLANG_PROFILE_STAGE(finalCleanup);
     // Run a final round of simplifications to clean up unused things after phi-elimination.
     simplifyNonSSAIR(targetProgram, irModule, fastIRSimplificationOptions);
 
@@ -1944,6 +2020,13 @@ Result linkAndOptimizeIR(
 
     outLinkedIR.metadata = metadata;
 
+    if (irModule->isInstRecyclingEnabled())
+    {
+        const auto memoryStats = irModule->getMemoryStats();
+        session->m_recycledIRMemory += memoryStats.recycledBytes;
+        session->m_compactedIRMemory += memoryStats.compactedBytes;
+    }
+
     if (!targetProgram->getOptionSet().shouldPerformMinimumOptimizations())
         checkUnsupportedInst(codeGenContext->getTargetReq(), irModule, sink);
 
@@ -2440,6 +2523,90 @@ static SlangResult stripDbgSpirvFromArtifact(
     return SLANG_OK;
 }
 
+// Optimize the SPIR-V in `options` with `compiler`.
+//
+// With `-spirv-opt-cache`, the optimized SPIR-V is cached in the global session under
+// a hash of the unoptimized SPIR-V and the options the optimizer runs with. Different
+// permutations of a shader often lower to identical SPIR-V, and the optimizer can take
+// longer than the rest of the compilation, so each distinct input only has to be
+// optimized once.
+static SlangResult optimizeSPIRVWithCache(
+    CodeGenContext* codeGenContext,
+    IDownstreamCompiler* compiler,
+    const DownstreamCompileOptions& options,
+    ComPtr<IArtifact>& outArtifact)
+{
+    auto session = codeGenContext->getSession();
+    auto& optionSet = codeGenContext->getTargetProgram()->getOptionSet();
+    auto optimize = [&]()
+    {
+        DownstreamCompileScheduler::Slot slot(
+            &session->m_downstreamCompileScheduler,
+            compiler,
+            optionSet.getIntOption(CompilerOptionName::DownstreamCompileConcurrency));
+        return compiler->compile(options, outArtifact.writeRef());
+    };
+
+    if (!optionSet.getBoolOption(CompilerOptionName::SPIRVOptimizerCache))
+    {
+        return optimize();
+    }
+
+    ComPtr<ISlangBlob> spirvBlob;
+    SLANG_RETURN_ON_FAIL(
+        options.sourceArtifacts[0]->loadBlob(ArtifactKeep::Yes, spirvBlob.writeRef()));
+
+    // The output also depends on the version of the optimizer, which matters if the
+    // downstream compiler library is replaced while the session is alive.
+    DigestBuilder<SHA1> builder;
+    builder.append(compiler->getDesc().type);
+    ComPtr<ISlangBlob> versionBlob;
+    if (SLANG_SUCCEEDED(compiler->getVersionString(versionBlob.writeRef())))
+        builder.append(versionBlob);
+    builder.append(options.optimizationLevel);
+    builder.append(options.debugInfoType);
+    builder.append(spirvBlob);
+    const auto key = builder.finalize();
+
+    ComPtr<ISlangBlob> optimizedBlob;
+    {
+        std::lock_guard<std::mutex> lock(session->m_spirvOptimizerCacheMutex);
+        session->m_spirvOptimizerCache.tryGetValue(key, optimizedBlob);
+    }
+    if (optimizedBlob)
+    {
+        session->m_spirvOptimizerCacheHitCount++;
+        outArtifact = ArtifactUtil::createArtifactForCompileTarget(options.targetType);
+        outArtifact->addRepresentationUnknown(optimizedBlob);
+        return SLANG_OK;
+    }
+    session->m_spirvOptimizerCacheMissCount++;
+
+    SLANG_RETURN_ON_FAIL(optimize());
+
+    // Only successful results are cached. The optimizer doesn't report diagnostics
+    // when it succeeds, so nothing is lost by replaying just the blob.
+    auto diagnostics = findAssociatedRepresentation<IArtifactDiagnostics>(outArtifact);
+    if (diagnostics && (SLANG_FAILED(diagnostics->getResult()) || diagnostics->getCount()))
+        return SLANG_OK;
+    if (SLANG_FAILED(outArtifact->loadBlob(ArtifactKeep::Yes, optimizedBlob.writeRef())))
+        return SLANG_OK;
+
+    // Bound the memory held by the cache by starting over once it gets too large.
+    const size_t kMaxCacheSize = 256 * 1024 * 1024;
+    {
+        std::lock_guard<std::mutex> lock(session->m_spirvOptimizerCacheMutex);
+        if (session->m_spirvOptimizerCacheSize + optimizedBlob->getBufferSize() > kMaxCacheSize)
+        {
+            session->m_spirvOptimizerCache.clear();
+            session->m_spirvOptimizerCacheSize = 0;
+        }
+        if (session->m_spirvOptimizerCache.addIfNotExists(key, optimizedBlob))
+            session->m_spirvOptimizerCacheSize += optimizedBlob->getBufferSize();
+    }
+    return SLANG_OK;
+}
+
 // Helper function to create an artifact from IR used internally by
 // emitSPIRVForEntryPointsDirectly.
 static SlangResult createArtifactFromIR(
@@ -2584,7 +2751,16 @@ static SlangResult createArtifactFromIR(
             break;
         }
         auto downstreamStartTime = std::chrono::high_resolution_clock::now();
-        if (SLANG_SUCCEEDED(compiler->compile(downstreamOptions, optimizedArtifact.writeRef())))
+        SlangResult optimizeResult = SLANG_OK;
+        {
+            SLANG_PROFILE_SECTION(downstreamOptimizeSPIRV);
+            optimizeResult = optimizeSPIRVWithCache(
+                codeGenContext,
+                compiler,
+                downstreamOptions,
+                optimizedArtifact);
+        }
+        if (SLANG_SUCCEEDED(optimizeResult))
         {
             // Check if we need to output a separate SPIRV file containing debug info. If so
             // then strip all debug instructions from the artifact. The dbgArtifact will still
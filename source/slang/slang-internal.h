@@ -8,6 +8,10 @@ namespace Slang
 struct GlobalSessionInternalDesc
 {
     bool isBootstrap = false;
+
+    /// Only deserialize the bodies of functions in builtin modules when they are linked.
+    /// Turning this off reads all of them when the module is loaded.
+    bool deferBuiltinFunctionBodies = true;
 };
 } // namespace Slang
 
@@ -16,4 +20,10 @@ SLANG_API SlangResult slang_createGlobalSessionImpl(
     const Slang::GlobalSessionInternalDesc* internalDesc,
     slang::IGlobalSession** outGlobalSession);
 
+/// Make `request`, which was created with `ISession::createCompileRequest`, put the session back
+/// as it is now when the request is destroyed. The options and targets the request adds are
+/// removed, and the file system cache is cleared, but modules the request loads stay loaded.
+/// This lets `slangc -server` reuse a session for many command lines.
+SLANG_API void slang_setCompileRequestRestoresLinkage(slang::ICompileRequest* request);
+
 #endif
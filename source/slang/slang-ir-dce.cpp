@@ -93,8 +93,6 @@ struct DeadCodeEliminationContext
     {
         bool result = false;
 
-        module->invalidateAllAnalysis();
-
         for (;;)
         {
             // Clear the `alive` bits by initializing all scratchData to 0.
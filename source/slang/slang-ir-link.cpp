@@ -833,6 +833,11 @@ void cloneGlobalValueWithCodeCommon(
     IRGlobalValueWithCode* originalValue,
     IROriginalValuesForClone const& originalValues)
 {
+    // The original may come from a module that was loaded with its function
+    // bodies deferred, in which case this is the point where its body is needed.
+    if (auto originalModule = originalValue->getModule())
+        originalModule->ensureBodyMaterialized(originalValue);
+
     // Next we are going to clone the actual code.
     IRBuilder builderStorage = *context->builder;
     IRBuilder* builder = &builderStorage;
@@ -2082,6 +2087,8 @@ LinkedIR linkIR(CodeGenContext* codeGenContext)
     {
         if (sharedContext->useAutodiff)
             break;
+        // Note that modules loaded with deferred function bodies read any body that
+        // could affect this up front, so it is safe to scan them as they are.
         sharedContext->useAutodiff = doesModuleUseAutodiff(irModule->getModuleInst());
     }
 
@@ -2340,5 +2347,140 @@ void replaceGlobalConstants(IRModule* module)
     pass.process(module);
 }
 
+void materializeBodiesForLinking(TargetProgram* targetProgram)
+{
+    SLANG_PROFILE;
+
+    // Find the modules `linkIR` links from, split the same way.
+    auto program = targetProgram->getProgram();
+    auto globalSession = static_cast<Session*>(program->getLinkage()->getGlobalSession());
+    List<IRModule*> userModules;
+    List<IRModule*> irModules;
+    for (auto& m : globalSession->coreModules)
+        irModules.add(m->getIRModule());
+    program->enumerateIRModules(
+        [&](IRModule* module)
+        {
+            if (module->getName() == globalSession->glslModuleName)
+                irModules.add(module);
+            else
+                userModules.add(module);
+        });
+    auto irModuleForLayout = targetProgram->getExistingIRModuleForLayout();
+    if (irModuleForLayout)
+        userModules.add(irModuleForLayout);
+    irModules.addRange(userModules);
+
+    bool useAutodiff = false;
+    for (auto irModule : userModules)
+        useAutodiff = useAutodiff || doesModuleUseAutodiff(irModule->getModuleInst());
+    const bool shouldCopyGlobalParams =
+        program->getLinkage()->m_optionSet.getBoolOption(CompilerOptionName::PreserveParameters);
+
+    // Walk everything linking could read, starting from the values `linkIR` clones. The walk
+    // follows every reference, and resolves a symbol to all of its definitions rather than the
+    // best one, so it reaches at least the bodies that linking materializes.
+    //
+    HashSet<IRInst*> visited;
+    List<IRInst*> workList;
+    auto add = [&](IRInst* inst)
+    {
+        if (inst && visited.add(inst))
+            workList.add(inst);
+    };
+    auto addSymbol = [&](UnownedStringSlice mangledName)
+    {
+        ImmutableHashedString hashedName(mangledName);
+        for (auto irModule : irModules)
+        {
+            for (auto inst : irModule->findSymbolByMangledName(hashedName))
+                add(inst);
+        }
+    };
+
+    for (Index i = 0; i < program->getEntryPointCount(); ++i)
+        addSymbol(program->getEntryPointMangledName(i).getUnownedSlice());
+    if (irModuleForLayout)
+        add(irModuleForLayout->getModuleInst()->findDecoration<IRLayoutDecoration>());
+    for (auto irModule : userModules)
+    {
+        for (auto inst : irModule->getGlobalInsts())
+        {
+            switch (inst->getOp())
+            {
+            case kIROp_BindGlobalGenericParam:
+            case kIROp_DebugSource:
+            case kIROp_DebugBuildIdentifier:
+                add(inst);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    for (auto irModule : irModules)
+    {
+        for (auto inst : irModule->getGlobalInsts())
+        {
+            if (_isHLSLExported(inst) || shouldCopyGlobalParams && as<IRGlobalParam>(inst) ||
+                useAutodiff && (as<IRDifferentiableTypeAnnotation>(inst) ||
+                                inst->findDecorationImpl(kIROp_AutoDiffBuiltinDecoration)))
+            {
+                add(inst);
+            }
+        }
+    }
+
+    // Linking only clones the witness table entries for keys that are used, so entries are
+    // put aside until their key has been reached.
+    HashSet<UnownedStringSlice> usedKeys;
+    List<IRWitnessTableEntry*> pendingEntries;
+    for (;;)
+    {
+        while (workList.getCount())
+        {
+            auto inst = workList.getLast();
+            workList.removeLast();
+
+            if (as<IRGlobalValueWithCode>(inst))
+                inst->getModule()->ensureBodyMaterialized(inst);
+
+            add(inst->getFullType());
+            for (UInt i = 0; i < inst->getOperandCount(); ++i)
+                add(inst->getOperand(i));
+            if (auto parent = inst->getParent(); parent && !as<IRModuleInst>(parent))
+                add(parent);
+
+            if (as<IRStructKey>(inst))
+                usedKeys.add(getMangledName(inst));
+
+            const auto mangledName = getMangledName(inst);
+            if (mangledName.getLength())
+                addSymbol(mangledName);
+
+            for (auto child : inst->getDecorationsAndChildren())
+            {
+                auto entry = as<IRWitnessTableEntry>(child);
+                if (entry && !visited.contains(entry))
+                    pendingEntries.add(entry);
+                else
+                    add(child);
+            }
+        }
+
+        Index writeIndex = 0;
+        for (auto entry : pendingEntries)
+        {
+            if (usedKeys.contains(getMangledName(entry->getRequirementKey())))
+                add(entry);
+            else
+                pendingEntries[writeIndex++] = entry;
+        }
+        if (writeIndex == pendingEntries.getCount())
+            break;
+        pendingEntries.setCount(writeIndex);
+    }
+}
+
 
 } // namespace Slang
@@ -8,6 +8,9 @@ namespace Slang
 {
 struct IRVarLayout;
 
+/// The result of linking. When `-reclaim-ir-memory` compacts the module, the instructions held
+/// here are updated to their new locations, so no other instructions of the module may be held
+/// across `reclaimIRMemory` in `linkAndOptimizeIR`.
 struct LinkedIR
 {
     RefPtr<IRModule> module;
@@ -25,6 +28,13 @@ struct LinkedIR
 //
 LinkedIR linkIR(CodeGenContext* codeGenContext);
 
+// Materialize the deferred function bodies that `linkIR` could read when linking any
+// entry points of `targetProgram`, so that linking only reads the modules it links from.
+// Linking for several entry points at once on different threads requires this, because
+// materializing a body changes the module it is in.
+//
+void materializeBodiesForLinking(TargetProgram* targetProgram);
+
 // Replace any global constants in the IR module with their
 // definitions, if possible.
 //
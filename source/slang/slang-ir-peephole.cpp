@@ -1314,9 +1314,6 @@ struct PeepholeContext : InstPassBase
 
     bool processFunc(IRInst* func)
     {
-        if (!useFastAnalysis)
-            func->getModule()->invalidateAllAnalysis();
-
         bool lastIsInGeneric = isInGeneric;
         if (!isInGeneric)
             isInGeneric = as<IRGeneric>(func) != nullptr;
@@ -7,7 +7,10 @@ namespace Slang
 {
 
 // A context for computing and caching reachability between blocks on the CFG.
-struct ReachabilityContext
+//
+// It is reference counted so that an `IRModule` can cache it as an analysis of a function,
+// see `IRModule::findOrCreateReachability`.
+struct ReachabilityContext : public RefObject
 {
     Dictionary<IRBlock*, int> mapBlockToId;
     List<IRBlock*> allBlocks;
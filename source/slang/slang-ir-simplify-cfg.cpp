@@ -92,7 +92,7 @@ bool isTrivialSingleIterationLoop(
     // We need to verify this is a trivial loop by checking if there is any multi-level breaks
     // that skips out of this loop.
     if (!domTree)
-        domTree = computeDominatorTree(func);
+        domTree = func->getModule()->findOrCreateDominatorTree(func);
     bool hasMultiLevelBreaks = false;
     auto loopBlocks = collectBlocksInRegion(domTree, loop, &hasMultiLevelBreaks);
     if (hasMultiLevelBreaks)
@@ -163,7 +163,7 @@ static bool doesLoopHasSideEffect(
 {
     bool hasMultiLevelBreaks = false;
     if (!context.domTree)
-        context.domTree = computeDominatorTree(func);
+        context.domTree = func->getModule()->findOrCreateDominatorTree(func);
     auto blocks = collectBlocksInRegion(context.domTree.get(), loopInst, &hasMultiLevelBreaks);
 
     // We'll currently not deal with loops that contain multi-level breaks.
@@ -816,8 +816,7 @@ static bool processFunc(IRGlobalValueWithCode* func, CFGSimplificationOptions op
 
     IRBuilder builder(func->getModule());
 
-    bool isReachabilityContextValid = false;
-    ReachabilityContext reachabilityContext;
+    RefPtr<ReachabilityContext> reachabilityContext;
     CFGSimplificationContext simplificationContext;
 
     bool changed = false;
@@ -857,7 +856,8 @@ static bool processFunc(IRGlobalValueWithCode* func, CFGSimplificationOptions op
                     // a normal branch.
                     auto targetBlock = loop->getTargetBlock();
                     if (!simplificationContext.domTree)
-                        simplificationContext.domTree = computeDominatorTree(func);
+                        simplificationContext.domTree =
+                            func->getModule()->findOrCreateDominatorTree(func);
                     if (options.removeTrivialSingleIterationLoops &&
                         isTrivialSingleIterationLoop(simplificationContext.domTree, func, loop))
                     {
@@ -874,14 +874,11 @@ static bool processFunc(IRGlobalValueWithCode* func, CFGSimplificationOptions op
                     }
                     else if (options.removeSideEffectFreeLoops)
                     {
-                        if (!isReachabilityContextValid)
-                        {
-                            isReachabilityContextValid = true;
-                            reachabilityContext = ReachabilityContext(func);
-                        }
+                        if (!reachabilityContext)
+                            reachabilityContext = func->getModule()->findOrCreateReachability(func);
                         if (!doesLoopHasSideEffect(
                                 simplificationContext,
-                                reachabilityContext,
+                                *reachabilityContext,
                                 func,
                                 loop))
                         {
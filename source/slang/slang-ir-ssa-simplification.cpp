@@ -75,6 +75,12 @@ void simplifyIR(
         changed |= peepholeOptimizeGlobalScope(target, module);
         changed |= trimOptimizableTypes(module);
 
+        // The passes below only change the body of one function, but they can't run on
+        // several functions concurrently: they allocate from the module's memory arena,
+        // deduplicate hoistable instructions and constants through the module's global
+        // deduplication map, and link uses into the use lists of shared global values,
+        // none of which is synchronized.
+        //
         for (auto inst : module->getGlobalInsts())
         {
             auto func = as<IRGlobalValueWithCode>(inst);
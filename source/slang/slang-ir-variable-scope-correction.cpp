@@ -63,7 +63,7 @@ void VariableScopeCorrectionContext::processModule()
 
 void VariableScopeCorrectionContext::_processFunction(IRFunc* funcInst)
 {
-    IRDominatorTree* dominatorTree = m_module->findOrCreateDominatorTree(funcInst);
+    RefPtr<IRDominatorTree> dominatorTree = m_module->findOrCreateDominatorTree(funcInst);
     List<IRInst*> workList;
     Dictionary<IRBlock*, List<IRLoop*>> loopHeaderMap;
 
@@ -5,6 +5,7 @@
 #include "../core/slang-writer.h"
 #include "slang-ir-dominators.h"
 #include "slang-ir-insts.h"
+#include "slang-ir-reachability.h"
 #include "slang-ir-util.h"
 #include "slang-mangle.h"
 
@@ -141,11 +142,36 @@ void IRUse::init(IRInst* u, IRInst* v)
 #endif
 }
 
+// Discard the cached analyses of the function whose control flow graph `inst` is part of,
+// if any, because `inst` is being added, removed or retargeted.
+static void _invalidateAnalysisForCFGChange(IRInst* inst)
+{
+    IRInst* parent = inst->getParent();
+    if (parent && IRTerminatorInst::isaImpl(inst->getOp()))
+        parent = parent->getParent();
+    else if (inst->getOp() != kIROp_Block)
+        return;
+
+    auto func = as<IRGlobalValueWithCode>(parent);
+    if (!func)
+        return;
+    if (auto module = func->getModule())
+        module->invalidateAnalysisForInst(func);
+}
+
 void IRUse::set(IRInst* uv)
 {
     // Normally we should never be modifying the operand of an hoistable inst.
     // They can be modified by `replaceUsesWith`, or to be replaced by a new inst.
     SLANG_ASSERT(!getIROpInfo(user->getOp()).isHoistable() || uv == usedValue);
+
+    // Changing the target of a branch changes the control flow graph.
+    if (uv != usedValue && ((uv && uv->getOp() == kIROp_Block) ||
+                            (usedValue && usedValue->getOp() == kIROp_Block)))
+    {
+        _invalidateAnalysisForCFGChange(user);
+    }
+
     init(user, uv);
 }
 
@@ -1462,6 +1488,73 @@ IRInst* mergeCandidateParentsForHoistableInst(IRInst* left, IRInst* right)
     return parent;
 }
 
+// The instructions held by each free list of an `IRModule` have space for at least
+// this many bytes.
+static size_t _getInstFreeListSize(Index freeListIndex)
+{
+    return sizeof(IRInst) + freeListIndex * sizeof(IRUse);
+}
+
+// Get the first free list whose instructions all have space for `size` bytes, which is
+// `kInstFreeListCount` or more if there isn't one.
+static Index _getInstFreeListIndexForSize(size_t size)
+{
+    if (size <= sizeof(IRInst))
+        return 0;
+    return Index((size - sizeof(IRInst) + sizeof(IRUse) - 1) / sizeof(IRUse));
+}
+
+// Get the free list to put a deallocated instruction that has space for `size` bytes in,
+// which is `kInstFreeListCount` or more if it belongs in the last one. This rounds down, so
+// that every instruction in a free list has space for at least `_getInstFreeListSize` bytes
+// of it. For example the memory of an `IRIntLit` has space for more than an instruction
+// with no operands, but less than one with an operand.
+static Index _getInstFreeListIndexForCapacity(size_t size)
+{
+    SLANG_ASSERT(size >= sizeof(IRInst));
+    return Index((size - sizeof(IRInst)) / sizeof(IRUse));
+}
+
+// Get the number of bytes that were allocated for `inst`. This is exact unless operands
+// have been removed from `inst`, in which case it is smaller.
+static size_t _calcInstAllocSize(IRInst* inst)
+{
+    const size_t defaultSize = sizeof(IRInst) + inst->getOperandCount() * sizeof(IRUse);
+
+    // The same sizes as `IRBuilder::_findOrEmitConstant` allocates.
+    size_t minSize = 0;
+    if (auto constInst = as<IRConstant>(inst))
+    {
+        const size_t prefixSize = SLANG_OFFSET_OF(IRConstant, value);
+        switch (inst->getOp())
+        {
+        case kIROp_BoolLit:
+        case kIROp_IntLit:
+            minSize = prefixSize + sizeof(IRIntegerValue);
+            break;
+        case kIROp_FloatLit:
+            minSize = prefixSize + sizeof(IRFloatingPointValue);
+            break;
+        case kIROp_PtrLit:
+            minSize = prefixSize + sizeof(void*);
+            break;
+        case kIROp_StringLit:
+        case kIROp_BlobLit:
+            minSize = prefixSize + SLANG_OFFSET_OF(IRConstant::StringValue, chars) +
+                      constInst->value.stringVal.numChars;
+            break;
+        default:
+            minSize = prefixSize;
+            break;
+        }
+    }
+    else if (inst->getOp() == kIROp_ModuleInst)
+    {
+        minSize = sizeof(IRModuleInst);
+    }
+    return minSize > defaultSize ? minSize : defaultSize;
+}
+
 IRInst* IRModule::_allocateInst(IROp op, Int operandCount, size_t minSizeInBytes)
 {
     // There are two basic cases for instructions that affect how we compute size:
@@ -1481,7 +1574,23 @@ IRInst* IRModule::_allocateInst(IROp op, Int operandCount, size_t minSizeInBytes
     size_t defaultSize = sizeof(IRInst) + (operandCount) * sizeof(IRUse);
     size_t totalSize = minSizeInBytes > defaultSize ? minSizeInBytes : defaultSize;
 
-    IRInst* inst = (IRInst*)m_memoryArena.allocateAndZero(totalSize);
+    // Reuse the memory of a deallocated instruction of the same size if there is one.
+    IRInst* inst = nullptr;
+    const Index freeListIndex = _getInstFreeListIndexForSize(totalSize);
+    if (freeListIndex < kInstFreeListCount && m_instFreeLists[freeListIndex])
+    {
+        void* mem = m_instFreeLists[freeListIndex];
+        m_instFreeLists[freeListIndex] = *(void**)mem;
+        m_freeListBytes -= _getInstFreeListSize(freeListIndex);
+        m_recycledBytes += totalSize;
+
+        memset(mem, 0, totalSize);
+        inst = (IRInst*)mem;
+    }
+    else
+    {
+        inst = (IRInst*)m_memoryArena.allocateAndZero(totalSize);
+    }
 
     // TODO: Is it actually important to run a constructor here?
     new (inst) IRInst();
@@ -4719,16 +4828,247 @@ void IRModule::buildMangledNameToGlobalInstMap()
 
 IRDominatorTree* IRModule::findOrCreateDominatorTree(IRGlobalValueWithCode* func)
 {
+    IRAnalysis& analysis = m_mapInstToAnalysis.getOrAddValue(func, IRAnalysis());
+    if (!analysis.domTree)
+        analysis.domTree = computeDominatorTree(func);
+    return analysis.getDominatorTree();
+}
+
+ReachabilityContext* IRModule::findOrCreateReachability(IRGlobalValueWithCode* func)
+{
+    IRAnalysis& analysis = m_mapInstToAnalysis.getOrAddValue(func, IRAnalysis());
+    if (!analysis.reachability)
+        analysis.reachability = new ReachabilityContext(func);
+    return analysis.getReachability();
+}
+
+void IRModule::invalidateAnalysisForInst(
+    IRGlobalValueWithCode* func,
+    IRAnalysisKind::Flags preserved)
+{
+    // This is called for every change to a control flow graph, which is
+    // usually when nothing has been cached.
+    if (m_mapInstToAnalysis.getCount() == 0)
+        return;
+
+    if (preserved == IRAnalysisKind::None)
+    {
+        m_mapInstToAnalysis.remove(func);
+        return;
+    }
+
     IRAnalysis* analysis = m_mapInstToAnalysis.tryGetValue(func);
-    if (analysis)
-        return analysis->getDominatorTree();
-    else
+    if (!analysis)
+        return;
+    if (!(preserved & IRAnalysisKind::DominatorTree))
+        analysis->domTree = nullptr;
+    if (!(preserved & IRAnalysisKind::Reachability))
+        analysis->reachability = nullptr;
+}
+
+IRModule::MemoryStats IRModule::getMemoryStats() const
+{
+    MemoryStats stats;
+    stats.arenaUsedBytes = m_memoryArena.calcTotalMemoryUsed();
+    stats.arenaAllocatedBytes = m_memoryArena.calcTotalMemoryAllocated();
+    stats.freeListBytes = m_freeListBytes;
+    stats.recycledBytes = m_recycledBytes;
+    stats.compactedBytes = m_compactedBytes;
+    return stats;
+}
+
+void IRModule::recycleDeallocatedInsts()
+{
+    if (m_deallocatedInsts.getCount() == 0)
+        return;
+
+    // An instruction can be deallocated more than once.
+    m_deallocatedInsts.sort();
+
+    IRInst* prevInst = nullptr;
+    for (auto inst : m_deallocatedInsts)
+    {
+        if (inst == prevInst)
+            continue;
+        prevInst = inst;
+
+        // An instruction that is still referenced, or has been put back into the IR,
+        // can't be reused.
+        if (inst->getParent() || inst->firstUse || inst->getFirstDecorationOrChild())
+            continue;
+
+        const size_t allocSize = _calcInstAllocSize(inst);
+        Index freeListIndex = _getInstFreeListIndexForCapacity(allocSize);
+        if (freeListIndex >= kInstFreeListCount)
+            freeListIndex = kInstFreeListCount - 1;
+        SLANG_ASSERT(_getInstFreeListSize(freeListIndex) <= allocSize);
+
+        // The address may be reused by an unrelated instruction, which must not pick up
+        // the analyses of this one.
+        if (m_mapInstToAnalysis.getCount())
+            m_mapInstToAnalysis.remove(inst);
+
+        *(void**)inst = m_instFreeLists[freeListIndex];
+        m_instFreeLists[freeListIndex] = inst;
+        m_freeListBytes += _getInstFreeListSize(freeListIndex);
+    }
+    m_deallocatedInsts.clear();
+
+    // The map may hold instructions that have just been freed.
+    if (m_mapMangledNameToGlobalInst.getCount())
+        buildMangledNameToGlobalInstMap();
+}
+
+bool IRModule::compact(Dictionary<IRInst*, IRInst*>& outMap)
+{
+    outMap.clear();
+
+    // Instructions with deferred bodies are referenced by the loader.
+    if (m_deferredBodyLoader)
+        return false;
+
+    // Find all the instructions in the module, in the order they will be laid out.
+    List<IRInst*> insts;
+    insts.add(m_moduleInst);
+    for (Index i = 0; i < insts.getCount(); ++i)
     {
-        m_mapInstToAnalysis[func] = IRAnalysis();
-        analysis = m_mapInstToAnalysis.tryGetValue(func);
+        for (auto child : insts[i]->getDecorationsAndChildren())
+            insts.add(child);
     }
-    analysis->domTree = computeDominatorTree(func);
-    return analysis->getDominatorTree();
+
+    outMap.reserve(insts.getCount());
+    for (auto inst : insts)
+        outMap.add(inst, nullptr);
+
+    for (auto inst : insts)
+    {
+        auto typeInst = inst->getFullType();
+        if (typeInst && !outMap.containsKey(typeInst))
+        {
+            outMap.clear();
+            return false;
+        }
+        for (UInt i = 0; i < inst->getOperandCount(); ++i)
+        {
+            auto operand = inst->getOperand(i);
+            if (operand && !outMap.containsKey(operand))
+            {
+                outMap.clear();
+                return false;
+            }
+        }
+    }
+
+    auto mapInst = [&](IRInst* inst) -> IRInst*
+    { return inst ? outMap.getValue(inst) : nullptr; };
+    auto mapUse = [&](IRUse& use, IRInst* newUser)
+    {
+        use.usedValue = mapInst(use.usedValue);
+        use.user = newUser;
+        use.nextUse = nullptr;
+        use.prevLink = nullptr;
+    };
+
+    MemoryArena newArena(kMemoryArenaBlockSize);
+    for (auto inst : insts)
+    {
+        const size_t size = _calcInstAllocSize(inst);
+        auto newInst = (IRInst*)newArena.allocate(size);
+        memcpy((void*)newInst, inst, size);
+        outMap[inst] = newInst;
+    }
+
+    for (auto inst : insts)
+    {
+        auto newInst = outMap.getValue(inst);
+        newInst->parent = mapInst(inst->parent);
+        newInst->next = mapInst(inst->next);
+        newInst->prev = mapInst(inst->prev);
+        newInst->m_decorationsAndChildren.first = mapInst(inst->m_decorationsAndChildren.first);
+        newInst->m_decorationsAndChildren.last = mapInst(inst->m_decorationsAndChildren.last);
+        newInst->firstUse = nullptr;
+
+        mapUse(newInst->typeUse, newInst);
+        for (UInt i = 0; i < newInst->getOperandCount(); ++i)
+            mapUse(newInst->getOperands()[i], newInst);
+    }
+
+    // Rebuild the use lists in their original order, leaving out the uses by instructions
+    // that are no longer in the module.
+    for (auto inst : insts)
+    {
+        auto newInst = outMap.getValue(inst);
+        IRUse** link = &newInst->firstUse;
+        for (auto use = inst->firstUse; use; use = use->nextUse)
+        {
+            IRInst* newUser = nullptr;
+            if (!outMap.tryGetValue(use->getUser(), newUser))
+                continue;
+            auto newUse = (IRUse*)((char*)newUser + ((char*)use - (char*)use->getUser()));
+            *link = newUse;
+            newUse->prevLink = link;
+            link = &newUse->nextUse;
+        }
+    }
+
+    // Rebuild the maps of the module, which are keyed on (the operands of) instructions.
+    // This must be done while the old instructions are still alive.
+    {
+        auto& oldValueNumberingMap = m_deduplicationContext.getGlobalValueNumberingMap();
+        IRDeduplicationContext::GlobalValueNumberingMap valueNumberingMap;
+        for (const auto& [key, value] : oldValueNumberingMap)
+        {
+            IRInst* newKey = nullptr;
+            IRInst* newValue = nullptr;
+            if (outMap.tryGetValue(key.getInst(), newKey) && outMap.tryGetValue(value, newValue))
+                valueNumberingMap[IRInstKey{newKey}] = newValue;
+        }
+        oldValueNumberingMap = _Move(valueNumberingMap);
+
+        auto& oldConstantMap = m_deduplicationContext.getConstantMap();
+        IRDeduplicationContext::ConstantMap constantMap;
+        for (const auto& [key, value] : oldConstantMap)
+        {
+            IRInst* newValue = nullptr;
+            if (outMap.tryGetValue(value, newValue))
+            {
+                auto newConst = static_cast<IRConstant*>(newValue);
+                constantMap[IRConstantKey{newConst}] = newConst;
+            }
+        }
+        oldConstantMap = _Move(constantMap);
+
+        auto& oldReplacementMap = m_deduplicationContext.getInstReplacementMap();
+        Dictionary<IRInst*, IRInst*> replacementMap;
+        for (const auto& [key, value] : oldReplacementMap)
+        {
+            IRInst* newKey = nullptr;
+            IRInst* newValue = nullptr;
+            if (outMap.tryGetValue(key, newKey) && outMap.tryGetValue(value, newValue))
+                replacementMap[newKey] = newValue;
+        }
+        oldReplacementMap = _Move(replacementMap);
+    }
+
+    m_moduleInst = static_cast<IRModuleInst*>(outMap.getValue(m_moduleInst));
+    m_mapInstToAnalysis.clear();
+
+    m_deallocatedInsts.clear();
+    for (auto& freeList : m_instFreeLists)
+        freeList = nullptr;
+    m_freeListBytes = 0;
+
+    const size_t oldUsedBytes = m_memoryArena.calcTotalMemoryUsed();
+    m_memoryArena.swapWith(newArena);
+    const size_t newUsedBytes = m_memoryArena.calcTotalMemoryUsed();
+    if (oldUsedBytes > newUsedBytes)
+        m_compactedBytes += oldUsedBytes - newUsedBytes;
+
+    if (m_mapMangledNameToGlobalInst.getCount())
+        buildMangledNameToGlobalInstMap();
+
+    // The old instructions are freed along with `newArena`, which now holds the old memory.
+    return true;
 }
 
 IRInst* IRBuilder::addDifferentiableTypeDictionaryDecoration(IRInst* target)
@@ -8259,6 +8599,13 @@ static void _replaceInstUsesWith(IRInst* thisInst, IRInst* other)
 
 void IRInst::replaceUsesWith(IRInst* other)
 {
+    // Replacing a block retargets every branch to it.
+    if (getOp() == kIROp_Block || (other && other->getOp() == kIROp_Block))
+    {
+        for (auto use = firstUse; use; use = use->nextUse)
+            _invalidateAnalysisForCFGChange(use->getUser());
+    }
+
     _replaceInstUsesWith(this, other);
 }
 
@@ -8318,6 +8665,8 @@ void IRInst::_insertAt(IRInst* inPrev, IRInst* inNext, IRInst* inParent)
     this->next = inNext;
     this->parent = inParent;
 
+    _invalidateAnalysisForCFGChange(this);
+
 #if _DEBUG
     validateIRInstOperands(this);
 #endif
@@ -8378,6 +8727,8 @@ void IRInst::removeFromParent()
     if (!oldParent)
         return;
 
+    _invalidateAnalysisForCFGChange(this);
+
     auto pp = getPrevInst();
     auto nn = getNextInst();
 
@@ -8418,6 +8769,10 @@ void IRInst::removeArguments()
 
 void IRInst::removeOperand(Index index)
 {
+    // Removing the last operand doesn't go through `IRUse::set`, so a branch
+    // losing a target has to be detected here.
+    _invalidateAnalysisForCFGChange(this);
+
     for (Index i = index; i < (Index)operandCount - 1; i++)
     {
         getOperands()[i].set(getOperand(i + 1));
@@ -8433,7 +8788,8 @@ void IRInst::removeAndDeallocate()
 {
     removeAndDeallocateAllDecorationsAndChildren();
 
-    if (auto module = getModule())
+    auto module = getModule();
+    if (module)
     {
         if (getIROpInfo(getOp()).isHoistable())
         {
@@ -8449,6 +8805,9 @@ void IRInst::removeAndDeallocate()
     }
     removeArguments();
     removeFromParent();
+
+    if (module)
+        module->_deallocateInst(this);
 }
 
 void IRInst::removeAndDeallocateAllDecorationsAndChildren()
@@ -8976,7 +9335,13 @@ bool isDefinition(IRInst* inVal)
     switch (val->getOp())
     {
     case kIROp_Func:
-        return val->getFirstChild() != nullptr;
+        if (val->getFirstChild())
+            return true;
+        // A function loaded from a serialized module may have its body deferred until
+        // it is needed, but it is still a definition.
+        if (auto module = val->getModule())
+            return module->hasDeferredBody(val);
+        return false;
 
     case kIROp_GlobalConstant:
         return cast<IRGlobalConstant>(val)->getValue() != nullptr;
@@ -9045,6 +9410,11 @@ IRDominatorTree* IRAnalysis::getDominatorTree()
     return static_cast<IRDominatorTree*>(domTree.get());
 }
 
+ReachabilityContext* IRAnalysis::getReachability()
+{
+    return static_cast<ReachabilityContext*>(reachability.get());
+}
+
 bool isMovableInst(IRInst* inst)
 {
     // Don't try to modify hoistable insts, they are already globally deduplicated.
@@ -2350,11 +2350,63 @@ private:
 };
 
 struct IRDominatorTree;
+struct ReachabilityContext;
 
+/// Supplies the bodies of functions in an `IRModule` that were left out when the module was
+/// loaded, so that they are only deserialized when something first needs them.
+///
+/// Only the blocks of a function are deferred. The function instruction itself, along with its
+/// type and decorations, is always present, so that symbol lookup works on the whole module.
+class IRDeferredBodyLoader : public RefObject
+{
+public:
+    struct Stats
+    {
+        Count deferredBodyCount = 0;     ///< Function bodies that were left out at load time
+        Count materializedBodyCount = 0; ///< How many of those have been materialized since
+        Count deferredInstCount = 0;     ///< Instructions in all of the deferred bodies
+        Count materializedInstCount = 0; ///< Instructions in the materialized bodies
+        size_t serialDataSize = 0;       ///< Bytes of serialized IR the module was read from
+        size_t copiedSerialDataSize = 0; ///< Bytes of that which had to be copied to be read
+    };
+
+    /// Returns true if the body of `inst` has been deferred and not yet materialized.
+    virtual bool hasDeferredBody(IRInst* inst) = 0;
+    /// Materialize the body of `inst`, if it is deferred.
+    virtual void materializeBody(IRInst* inst) = 0;
+    /// Materialize all of the bodies that are still deferred.
+    virtual void materializeAllBodies() = 0;
+
+    virtual Stats getStats() = 0;
+};
+
+/// The kinds of analysis of a function body that an `IRModule` caches.
+///
+/// All of them are derived from the control flow graph of the function alone. The module
+/// discards them when a block or a terminator is added to or removed from the function, or
+/// when a terminator has a block operand changed, so passes that only change instructions
+/// within blocks keep them valid without doing anything.
+struct IRAnalysisKind
+{
+    typedef uint32_t Flags;
+    enum Enum : Flags
+    {
+        None = 0,
+        DominatorTree = 0x1,
+        Reachability = 0x2,
+
+        All = DominatorTree | Reachability,
+    };
+};
+
+/// The analyses cached for a function, each of which is null until it is first requested.
 struct IRAnalysis
 {
     RefPtr<RefObject> domTree;
+    RefPtr<RefObject> reachability;
+
     IRDominatorTree* getDominatorTree();
+    ReachabilityContext* getReachability();
 };
 
 struct IRModule : RefObject
@@ -2399,14 +2451,51 @@ public:
         return nullptr;
     }
     IRDominatorTree* findOrCreateDominatorTree(IRGlobalValueWithCode* func);
-    void invalidateAnalysisForInst(IRGlobalValueWithCode* func)
-    {
-        m_mapInstToAnalysis.remove(func);
-    }
+
+    /// Get the reachability between the blocks of `func`, computing it if it isn't cached.
+    ReachabilityContext* findOrCreateReachability(IRGlobalValueWithCode* func);
+
+    /// Discard the analyses cached for `func`, other than the kinds in `preserved`.
+    ///
+    /// Changes to the control flow graph of a function are detected without this being called,
+    /// so it is only needed by a pass that invalidates an analysis some other way.
+    void invalidateAnalysisForInst(
+        IRGlobalValueWithCode* func,
+        IRAnalysisKind::Flags preserved = IRAnalysisKind::None);
     void invalidateAllAnalysis() { m_mapInstToAnalysis.clear(); }
 
     IRInstListBase getGlobalInsts() const { return getModuleInst()->getChildren(); }
 
+    /// Returns true if the body of `inst` has not been deserialized yet.
+    ///
+    /// Such an instruction is still a definition, but its blocks must be materialized with
+    /// `ensureBodyMaterialized` before they are accessed.
+    bool hasDeferredBody(IRInst* inst)
+    {
+        return m_deferredBodyLoader && m_deferredBodyLoader->hasDeferredBody(inst);
+    }
+    /// Make sure the body of `inst` has been deserialized.
+    ///
+    /// Materializing a body adds uses to the module's globals, so it must not run while
+    /// another thread reads the module, even though the loader serializes materialization.
+    void ensureBodyMaterialized(IRInst* inst)
+    {
+        if (m_deferredBodyLoader)
+            m_deferredBodyLoader->materializeBody(inst);
+    }
+    /// Make sure every function body in the module has been deserialized.
+    ///
+    /// Must be called before any code that walks the whole module, rather than reaching
+    /// function bodies through symbol lookup (e.g. when re-serializing the module).
+    void ensureAllBodiesMaterialized()
+    {
+        if (m_deferredBodyLoader)
+            m_deferredBodyLoader->materializeAllBodies();
+    }
+
+    IRDeferredBodyLoader* getDeferredBodyLoader() const { return m_deferredBodyLoader; }
+    void setDeferredBodyLoader(IRDeferredBodyLoader* loader) { m_deferredBodyLoader = loader; }
+
     Name* getName() const { return m_name; }
     void setName(Name* name) { m_name = name; }
 
@@ -2439,6 +2528,47 @@ public:
         return (T*)_allocateInst(op, operandCount, sizeof(T));
     }
 
+    /// Called by `IRInst::removeAndDeallocate` once `inst` has been removed from the module.
+    void _deallocateInst(IRInst* inst)
+    {
+        if (m_isInstRecyclingEnabled)
+            m_deallocatedInsts.add(inst);
+    }
+
+    /// Statistics about the memory held by the instructions of a module.
+    struct MemoryStats
+    {
+        size_t arenaUsedBytes = 0;      ///< Bytes allocated from the memory arena
+        size_t arenaAllocatedBytes = 0; ///< Bytes of memory held by the memory arena
+        size_t freeListBytes = 0;       ///< Bytes of deallocated instructions waiting for reuse
+        size_t recycledBytes = 0;       ///< Bytes of instructions allocated from the free lists
+        size_t compactedBytes = 0;      ///< Bytes of arena usage removed by `compact`
+    };
+
+    MemoryStats getMemoryStats() const;
+
+    /// Enable reusing the memory of deallocated instructions.
+    ///
+    /// Passes often keep pointers to instructions they have deallocated (e.g. as keys of
+    /// a map, or in a work list that is checked for removed instructions), so the memory
+    /// of a deallocated instruction is not reused straight away. It is only made available
+    /// by `recycleDeallocatedInsts`, which must be called between passes.
+    void setInstRecyclingEnabled(bool enabled) { m_isInstRecyclingEnabled = enabled; }
+    bool isInstRecyclingEnabled() const { return m_isInstRecyclingEnabled; }
+
+    /// Make the memory of the instructions deallocated since the last call available for
+    /// new instructions, other than any that are still referenced by the module.
+    void recycleDeallocatedInsts();
+
+    /// Copy all instructions in the module into a new, densely packed memory arena, and
+    /// free the old one.
+    ///
+    /// On success, `outMap` maps every instruction in the module to its copy, and any
+    /// pointer to an instruction of the module held outside of it must be updated with it.
+    /// Fails without changing anything if a function body has not been deserialized yet,
+    /// or an instruction of the module references one that is not in it.
+    bool compact(Dictionary<IRInst*, IRInst*>& outMap);
+
     ContainerPool& getContainerPool() { return m_containerPool; }
 
 private:
@@ -2469,6 +2599,26 @@ private:
     /// are allocated.
     MemoryArena m_memoryArena;
 
+    enum
+    {
+        /// Deallocated instructions are kept in free lists by the number of operands they
+        /// have space for, with those that have space for more sharing the last list.
+        kInstFreeListCount = 16,
+    };
+
+    /// Set if the memory of deallocated instructions is reused.
+    bool m_isInstRecyclingEnabled = false;
+
+    /// Instructions deallocated since the last call to `recycleDeallocatedInsts`.
+    List<IRInst*> m_deallocatedInsts;
+
+    /// The first free instruction of each size, linked through their first word.
+    void* m_instFreeLists[kInstFreeListCount] = {};
+
+    size_t m_freeListBytes = 0;
+    size_t m_recycledBytes = 0;
+    size_t m_compactedBytes = 0;
+
     /// A pool to allow reuse of common types of containers to reduce memory allocations
     /// and rehashing.
     ContainerPool m_containerPool;
@@ -2482,6 +2632,9 @@ private:
     Dictionary<IRInst*, IRAnalysis> m_mapInstToAnalysis;
 
     Dictionary<ImmutableHashedString, List<IRInst*>> m_mapMangledNameToGlobalInst;
+
+    /// Set if the module was loaded with some of its function bodies deferred.
+    RefPtr<IRDeferredBodyLoader> m_deferredBodyLoader;
 };
 
 
@@ -497,6 +497,11 @@ void initCommandOptions(CommandOptions& options)
          "-report-perf-benchmark",
          nullptr,
          "Reports compiler performance benchmark results."},
+        {OptionKind::ReportPerfTrace,
+         "-report-perf-trace",
+         "-report-perf-trace <file>",
+         "Writes the compiler's profile of all threads to <file> in the Chrome trace event JSON "
+         "format, which can be viewed with chrome://tracing or https://ui.perfetto.dev."},
         {OptionKind::ReportCheckpointIntermediates,
          "-report-checkpoint-intermediates",
          nullptr,
@@ -541,6 +546,28 @@ void initCommandOptions(CommandOptions& options)
          nullptr,
          "Preserve all resource parameters in the output code, even if they are not used by the "
          "shader."},
+        {OptionKind::LazyIRLoading,
+         "-lazy-ir-loading",
+         nullptr,
+         "Defer deserializing the bodies of functions in precompiled modules until they are "
+         "first linked."},
+        {OptionKind::MemoryMapModules,
+         "-mmap-modules",
+         nullptr,
+         "Memory map precompiled modules found on disk and read them in place, instead of "
+         "loading a copy of each file. Modules smaller than 1 MiB are still loaded as a copy. "
+         "Mapped files must not be modified in place while in use, only replaced."},
+        {OptionKind::ReclaimIRMemory,
+         "-reclaim-ir-memory",
+         nullptr,
+         "Reuse the memory of instructions deallocated while optimizing linked IR, and compact "
+         "the IR after the main dead code elimination steps."},
+        {OptionKind::SPIRVOptimizerCache,
+         "-spirv-opt-cache",
+         nullptr,
+         "Cache the output of the SPIR-V optimizer in the global session, keyed by a hash of the "
+         "unoptimized SPIR-V and the optimizer options, and reuse it when identical SPIR-V is "
+         "optimized again."},
         {OptionKind::TypeConformance,
          "-conformance",
          "-conformance <typeName>:<interfaceName>[=<sequentialID>]",
@@ -896,6 +923,25 @@ void initCommandOptions(CommandOptions& options)
          "-embed-downstream-ir",
          nullptr,
          "Embed downstream IR into emitted slang IR"},
+        {OptionKind::ParallelCodeGen,
+         "-parallel-codegen",
+         "-parallel-codegen <count>",
+         "Generate code for each target and entry point pair concurrently, on up to <count> "
+         "threads. A <count> of 0 uses one thread per hardware thread. Output and diagnostics "
+         "are the same as for a serial compile."},
+        {OptionKind::ParallelModuleLoading,
+         "-parallel-module-loading",
+         "-parallel-module-loading <count>",
+         "Read the files of the modules imported by a module concurrently, on up to <count> "
+         "threads, before they are loaded. A <count> of 0 uses one thread per hardware thread. "
+         "Only applies when modules are loaded from the OS file system."},
+        {OptionKind::DownstreamCompileConcurrency,
+         "-downstream-compile-concurrency",
+         "-downstream-compile-concurrency <count>",
+         "Run at most <count> downstream compilations at the same time when code is generated "
+         "in parallel. A <count> of 0 places no limit other than the number of code generation "
+         "threads. Downstream compilers that are not thread safe always run one compilation at "
+         "a time."},
     };
     _addOptions(makeConstArrayView(experimentalOpts), options);
 
@@ -2236,6 +2282,10 @@ SlangResult OptionsParser::_parse(int argc, char const* const* argv)
         case OptionKind::LoopInversion:
         case OptionKind::UnscopedEnum:
         case OptionKind::PreserveParameters:
+        case OptionKind::LazyIRLoading:
+        case OptionKind::MemoryMapModules:
+        case OptionKind::ReclaimIRMemory:
+        case OptionKind::SPIRVOptimizerCache:
             linkage->m_optionSet.set(optionKind, true);
             break;
         case OptionKind::MatrixLayoutRow:
@@ -3048,6 +3098,34 @@ SlangResult OptionsParser::_parse(int argc, char const* const* argv)
                 linkage->m_optionSet.add(OptionKind::BindlessSpaceIndex, (int)index);
                 break;
             }
+        case OptionKind::ReportPerfTrace:
+            {
+                CommandLineArg fileName;
+                SLANG_RETURN_ON_FAIL(m_reader.expectArg(fileName));
+                linkage->m_optionSet.set(OptionKind::ReportPerfTrace, fileName.value);
+                break;
+            }
+        case OptionKind::ParallelCodeGen:
+            {
+                Int threadCount = 0;
+                SLANG_RETURN_ON_FAIL(_expectInt(arg, threadCount));
+                linkage->m_optionSet.set(OptionKind::ParallelCodeGen, (int)threadCount);
+                break;
+            }
+        case OptionKind::ParallelModuleLoading:
+            {
+                Int threadCount = 0;
+                SLANG_RETURN_ON_FAIL(_expectInt(arg, threadCount));
+                linkage->m_optionSet.set(OptionKind::ParallelModuleLoading, (int)threadCount);
+                break;
+            }
+        case OptionKind::DownstreamCompileConcurrency:
+            {
+                Int count = 0;
+                SLANG_RETURN_ON_FAIL(_expectInt(arg, count));
+                linkage->m_optionSet.set(OptionKind::DownstreamCompileConcurrency, (int)count);
+                break;
+            }
         case OptionKind::DumpModule:
             {
                 CommandLineArg fileName;
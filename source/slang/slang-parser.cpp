@@ -1,5 +1,6 @@
 #include "slang-parser.h"
 
+#include "../core/slang-performance-profiler.h"
 #include "../core/slang-semantic-version.h"
 #include "slang-ast-decl.h"
 #include "slang-check-impl.h"
@@ -8748,6 +8749,7 @@ void parseSourceFile(
     Scope* outerScope,
     ContainerDecl* parentDecl)
 {
+    SLANG_PROFILE;
     ParserOptions options = {};
     options.stage = ParsingStage::Decl;
     options.enableEffectAnnotations = translationUnit->compileRequest->optionSet.getBoolOption(
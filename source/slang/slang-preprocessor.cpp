@@ -12,6 +12,7 @@
 // to another.
 
 #include "../compiler-core/slang-lexer.h"
+#include "../core/slang-performance-profiler.h"
 #include "slang-compiler.h"
 #include "slang-diagnostics.h"
 
@@ -38,6 +39,27 @@ void PreprocessorHandler::handleFileDependency(SourceFile* sourceFile)
     SLANG_UNUSED(sourceFile);
 }
 
+IncludedFileTokenCache::Entry* IncludedFileTokenCache::findEntry(
+    const String& uniqueIdentity,
+    const SHA1::Digest& digest)
+{
+    RefPtr<Entry> entry;
+    if (m_entries.tryGetValue(uniqueIdentity, entry) && entry->digest == digest)
+        return entry;
+    return nullptr;
+}
+
+void IncludedFileTokenCache::setEntry(const String& uniqueIdentity, Entry* entry)
+{
+    RefPtr<Entry> previousEntry;
+    if (m_entries.tryGetValue(uniqueIdentity, previousEntry) &&
+        previousEntry->digest != entry->digest)
+    {
+        invalidatedCount++;
+    }
+    m_entries[uniqueIdentity] = entry;
+}
+
 // In order to simplify the naming scheme, we will nest the implementaiton of the
 // preprocessor under an additional namesspace, so taht we can have, e.g.,
 // `MacroDefinition` instead of `PreprocessorMacroDefinition`.
@@ -518,7 +540,12 @@ struct LexerInputStream : InputStream
 {
     typedef InputStream Super;
 
-    LexerInputStream(Preprocessor* preprocessor, SourceView* sourceView);
+    /// Initialize to lex the contents of `sourceView`, or to play back `cachedTokens` if they
+    /// are set, which must have been lexed from the same contents
+    LexerInputStream(
+        Preprocessor* preprocessor,
+        SourceView* sourceView,
+        IncludedFileTokenCache::Entry* cachedTokens = nullptr);
 
     Lexer* getLexer() { return &m_lexer; }
 
@@ -544,6 +571,18 @@ private:
     /// Read a token from the lexer, bypassing lookahead
     Token _readTokenImpl()
     {
+        if (m_cachedTokens)
+        {
+            // Cached tokens have already had whitespace and comments removed, and
+            // just need their locations moved into this view.
+            //
+            Token token = m_cachedTokens->tokens[m_cachedTokenIndex];
+            if (token.type != TokenType::EndOfFile)
+                m_cachedTokenIndex++;
+            token.loc = m_lexer.m_startLoc + Int(token.loc.getRaw());
+            return token;
+        }
+
         for (;;)
         {
             Token token = m_lexer.lexToken();
@@ -563,6 +602,12 @@ private:
     /// The lexer state that will provide input
     Lexer m_lexer;
 
+    /// If set, tokens are played back from here instead of being lexed
+    RefPtr<IncludedFileTokenCache::Entry> m_cachedTokens;
+
+    /// Index of the next token to play back from `m_cachedTokens`
+    Index m_cachedTokenIndex = 0;
+
     /// One token of lookahead
     Token m_lookaheadToken;
 };
@@ -943,7 +988,10 @@ private:
 ///
 struct InputFile
 {
-    InputFile(Preprocessor* preprocessor, SourceView* sourceView);
+    InputFile(
+        Preprocessor* preprocessor,
+        SourceView* sourceView,
+        IncludedFileTokenCache::Entry* cachedTokens = nullptr);
 
     ~InputFile();
 
@@ -979,6 +1027,27 @@ struct InputFile
 
     bool isIncludedFile() { return m_parent != nullptr; }
 
+    /// How much of an include guard has been seen in this file.
+    ///
+    /// A file is include guarded if everything in it other than whitespace and comments is
+    /// inside of a single `#ifndef` conditional without an `#else` or `#elif`. Including the
+    /// file again while the macro is defined would produce no tokens, so it can be skipped.
+    enum class IncludeGuardState
+    {
+        Start,      ///< Nothing but whitespace and comments has been seen
+        Inside,     ///< Inside of the `#ifndef` that may be an include guard
+        After,      ///< After the `#endif` of the include guard
+        NotGuarded, ///< Something was seen that means the file isn't include guarded
+    };
+
+    IncludeGuardState m_includeGuardState = IncludeGuardState::Start;
+
+    /// The conditional that may be an include guard, when `m_includeGuardState` is `Inside`
+    Conditional* m_includeGuardConditional = nullptr;
+
+    /// The macro tested by the include guard
+    Name* m_includeGuardName = nullptr;
+
 private:
     friend struct Preprocessor;
 
@@ -1288,6 +1357,13 @@ struct Preprocessor
     /// stop them from being included again.
     HashSet<String> pragmaOnceUniqueIdentities;
 
+    /// The include guard macro of each unique identity of a path found to be include guarded.
+    /// The file doesn't need to be included again while the macro is defined.
+    Dictionary<String, Name*> includeGuardMacros;
+
+    /// Cache of tokens for included files, if set
+    IncludedFileTokenCache* includedFileTokenCache = nullptr;
+
     WarningStateTracker* warningStateTracker = nullptr;
 
     /// Name pool to use when creating `Name`s from strings
@@ -1386,19 +1462,28 @@ DiagnosticSink* InputStream::getSink()
 // Basic Input Handling
 //
 
-LexerInputStream::LexerInputStream(Preprocessor* preprocessor, SourceView* sourceView)
-    : Super(preprocessor)
+LexerInputStream::LexerInputStream(
+    Preprocessor* preprocessor,
+    SourceView* sourceView,
+    IncludedFileTokenCache::Entry* cachedTokens)
+    : Super(preprocessor), m_cachedTokens(cachedTokens)
 {
+    // The lexer is initialized even when playing back cached tokens, because
+    // the view and the location of line ends are found through it.
+    //
     MemoryArena* memoryArena = sourceView->getSourceManager()->getMemoryArena();
     m_lexer.initialize(sourceView, GetSink(preprocessor), preprocessor->getNamePool(), memoryArena);
     m_lookaheadToken = _readTokenImpl();
 }
 
-InputFile::InputFile(Preprocessor* preprocessor, SourceView* sourceView)
+InputFile::InputFile(
+    Preprocessor* preprocessor,
+    SourceView* sourceView,
+    IncludedFileTokenCache::Entry* cachedTokens)
 {
     m_preprocessor = preprocessor;
 
-    m_lexerStream = new LexerInputStream(preprocessor, sourceView);
+    m_lexerStream = new LexerInputStream(preprocessor, sourceView, cachedTokens);
     m_expansionStream = new ExpansionInputStream(preprocessor, m_lexerStream);
 }
 
@@ -3286,6 +3371,15 @@ static void HandleIfNDefDirective(PreprocessorDirectiveContext* context)
 
     // Check if the name is defined.
     beginConditional(context, LookupMacro(context, name) == NULL);
+
+    // An `#ifndef` before anything else in a file may be an include guard.
+    InputFile* inputFile = getInputFile(context);
+    if (inputFile->m_includeGuardState == InputFile::IncludeGuardState::Start)
+    {
+        inputFile->m_includeGuardState = InputFile::IncludeGuardState::Inside;
+        inputFile->m_includeGuardConditional = inputFile->getInnerMostConditional();
+        inputFile->m_includeGuardName = name;
+    }
 }
 
 // Handle a `#else` directive
@@ -3427,6 +3521,13 @@ static void HandleEndIfDirective(PreprocessorDirectiveContext* context)
         return;
     }
 
+    if (inputFile->m_includeGuardState == InputFile::IncludeGuardState::Inside &&
+        conditional == inputFile->m_includeGuardConditional)
+    {
+        inputFile->m_includeGuardState = InputFile::IncludeGuardState::After;
+        inputFile->m_includeGuardConditional = nullptr;
+    }
+
     inputFile->popConditional();
 
     updateLexerFlagsForConditionals(inputFile);
@@ -3497,6 +3598,75 @@ void Preprocessor::pushInputFile(InputFile* inputFile, SourceLoc loc)
     m_currentInputFile = inputFile;
 }
 
+/// Find the cached tokens for the file in `sourceView`, lexing the file into the cache if it
+/// isn't there already. Returns nullptr if the file should be lexed as it is read instead.
+static IncludedFileTokenCache::Entry* _findOrLexIncludedFileTokens(
+    Preprocessor* preprocessor,
+    SourceView* sourceView)
+{
+    auto cache = preprocessor->includedFileTokenCache;
+    if (!cache)
+        return nullptr;
+
+    SourceFile* sourceFile = sourceView->getSourceFile();
+    const PathInfo& pathInfo = sourceFile->getPathInfo();
+    if (!pathInfo.hasUniqueIdentity() || !sourceFile->hasContent())
+        return nullptr;
+
+    const auto digest = sourceFile->getDigest();
+    if (auto entry = cache->findEntry(pathInfo.uniqueIdentity, digest))
+    {
+        if (entry->hasDiagnostics)
+            return nullptr;
+        cache->replayCount++;
+        return entry;
+    }
+    cache->lexCount++;
+
+    RefPtr<IncludedFileTokenCache::Entry> entry = new IncludedFileTokenCache::Entry();
+    entry->digest = digest;
+    entry->contentBlob = sourceFile->getContentBlob();
+
+    // Lex the whole file with a sink of its own, so we can tell if the lexer
+    // had anything to report.
+    //
+    DiagnosticSink sink(preprocessor->getSourceManager(), nullptr);
+
+    Lexer lexer;
+    lexer.initialize(sourceView, &sink, preprocessor->getNamePool(), &entry->memoryArena);
+
+    const SourceLoc startLoc = lexer.m_startLoc;
+    for (;;)
+    {
+        Token token = lexer.lexToken();
+        switch (token.type)
+        {
+        case TokenType::WhiteSpace:
+        case TokenType::BlockComment:
+        case TokenType::LineComment:
+            continue;
+
+        default:
+            break;
+        }
+
+        token.loc = SourceLoc::fromRaw(token.loc.getRaw() - startLoc.getRaw());
+        entry->tokens.add(token);
+
+        if (token.type == TokenType::EndOfFile)
+            break;
+    }
+
+    if (sink.getErrorCount() != 0 || sink.outputBuffer.getLength() != 0)
+    {
+        entry->hasDiagnostics = true;
+        entry->tokens = List<Token>();
+    }
+
+    cache->setEntry(pathInfo.uniqueIdentity, entry);
+    return entry->hasDiagnostics ? nullptr : entry.get();
+}
+
 // Handle a `#include` directive
 static void HandleIncludeDirective(PreprocessorDirectiveContext* context)
 {
@@ -3577,6 +3747,17 @@ static void HandleIncludeDirective(PreprocessorDirectiveContext* context)
         return;
     }
 
+    // Check whether we've previously included this file and found it to be include guarded
+    // by a macro that is still defined, in which case including it again would do nothing.
+    Name* includeGuardName = nullptr;
+    if (context->m_preprocessor->includeGuardMacros.tryGetValue(
+            filePathInfo.uniqueIdentity,
+            includeGuardName) &&
+        LookupMacro(context, includeGuardName))
+    {
+        return;
+    }
+
     // Simplify the path
     filePathInfo.foundPath = includeSystem->simplifyPath(filePathInfo.foundPath);
 
@@ -3613,7 +3794,9 @@ static void HandleIncludeDirective(PreprocessorDirectiveContext* context)
     SourceView* sourceView =
         sourceManager->createSourceView(sourceFile, &filePathInfo, directiveLoc);
 
-    InputFile* inputFile = new InputFile(context->m_preprocessor, sourceView);
+    auto cachedTokens = _findOrLexIncludedFileTokens(context->m_preprocessor, sourceView);
+
+    InputFile* inputFile = new InputFile(context->m_preprocessor, sourceView, cachedTokens);
 
     context->m_preprocessor->pushInputFile(inputFile, directiveLoc);
 }
@@ -4523,6 +4706,41 @@ static const PreprocessorDirective kInvalidDirective = {
     0,
 };
 
+/// Update what is known about whether the current file is include guarded, for a `directive`
+/// that is about to be handled
+static void _updateIncludeGuardState(
+    PreprocessorDirectiveContext* context,
+    PreprocessorDirective const* directive)
+{
+    InputFile* inputFile = getInputFile(context);
+    switch (inputFile->m_includeGuardState)
+    {
+    case InputFile::IncludeGuardState::Start:
+        // Only an `#ifndef` can start an include guard, which is checked when it is handled.
+        if (directive->callback != &HandleIfNDefDirective)
+            inputFile->m_includeGuardState = InputFile::IncludeGuardState::NotGuarded;
+        break;
+
+    case InputFile::IncludeGuardState::Inside:
+        // An `#else` or `#elif` of the include guard could produce tokens when the
+        // macro is defined.
+        if ((directive->callback == &HandleElseDirective ||
+             directive->callback == &HandleElifDirective) &&
+            inputFile->getInnerMostConditional() == inputFile->m_includeGuardConditional)
+        {
+            inputFile->m_includeGuardState = InputFile::IncludeGuardState::NotGuarded;
+        }
+        break;
+
+    case InputFile::IncludeGuardState::After:
+        inputFile->m_includeGuardState = InputFile::IncludeGuardState::NotGuarded;
+        break;
+
+    default:
+        break;
+    }
+}
+
 // Look up the directive with the given name.
 static PreprocessorDirective const* FindDirective(String const& name)
 {
@@ -4571,6 +4789,8 @@ static void HandleDirective(PreprocessorDirectiveContext* context)
     // Look up the handler for the directive.
     PreprocessorDirective const* directive = FindDirective(GetDirectiveName(context));
 
+    _updateIncludeGuardState(context, directive);
+
     // If we are skipping disabled code, and the directive is not one
     // of the small number that need to run even in that case, skip it.
     if (isSkipping(context) && !(directive->flags & PreprocessorDirectiveFlag::ProcessWhenSkipping))
@@ -4649,6 +4869,17 @@ void Preprocessor::popInputFile()
             absoluteSourceLocCounter);
     }
 
+    // If the whole file was inside of an include guard, then remember the macro so
+    // that the file can be skipped if it is included again.
+    //
+    if (inputFile->m_includeGuardState == InputFile::IncludeGuardState::After)
+    {
+        SourceFile* sourceFile = inputFile->getLexer()->m_sourceView->getSourceFile();
+        const PathInfo& pathInfo = sourceFile->getPathInfo();
+        if (pathInfo.hasUniqueIdentity())
+            includeGuardMacros[pathInfo.uniqueIdentity] = inputFile->m_includeGuardName;
+    }
+
     delete inputFile;
 }
 
@@ -4696,6 +4927,10 @@ static Token ReadToken(Preprocessor* preprocessor)
             continue;
         }
 
+        // A token that isn't inside of an include guard means the file isn't include guarded.
+        if (inputFile->m_includeGuardState != InputFile::IncludeGuardState::Inside)
+            inputFile->m_includeGuardState = InputFile::IncludeGuardState::NotGuarded;
+
         token = expansionStream->peekToken();
         if (token.type == TokenType::EndOfFile)
         {
@@ -4872,6 +5107,7 @@ TokenList preprocessSource(
     desc.fileSystem = linkage->getFileSystemExt();
     desc.namePool = linkage->getNamePool();
     desc.sourceManager = linkage->getSourceManager();
+    desc.includedFileTokenCache = linkage->getIncludedFileTokenCache();
 
     if (linkage->isInLanguageServer())
     {
@@ -4891,6 +5127,7 @@ TokenList preprocessSource(
     SourceLanguage& outDetectedLanguage,
     SlangLanguageVersion& outLanguageVersion)
 {
+    SLANG_PROFILE;
     using namespace preprocessor;
 
     Preprocessor preprocessor;
@@ -4903,6 +5140,7 @@ TokenList preprocessSource(
     preprocessor.endOfFileToken.type = TokenType::EndOfFile;
     preprocessor.endOfFileToken.flags = TokenFlag::AtStartOfLine;
     preprocessor.contentAssistInfo = desc.contentAssistInfo;
+    preprocessor.includedFileTokenCache = desc.includedFileTokenCache;
 
     preprocessor.warningStateTracker =
         dynamicCast<preprocessor::WarningStateTracker>(desc.sink->getSourceWarningStateTracker());
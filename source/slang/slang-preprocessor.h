@@ -33,6 +33,55 @@ struct PreprocessorHandler
     virtual void handleFileDependency(SourceFile* sourceFile);
 };
 
+/// Lexed tokens of files brought in with `#include`, so that files included more than once, or
+/// by more than one translation unit, don't need to be lexed again.
+///
+/// Entries are found by the unique identity of a file, and are only used if the digest of the
+/// file contents matches, so a file that has changed will be lexed again.
+///
+/// The tokens hold `Name`s, so a cache must only be used with a single `NamePool`.
+class IncludedFileTokenCache : public RefObject
+{
+public:
+    struct Entry : RefObject
+    {
+        Entry() { memoryArena.init(1024); }
+
+        /// Digest of the contents the tokens were lexed from
+        SHA1::Digest digest;
+
+        /// Keeps the contents that the tokens reference alive
+        ComPtr<ISlangBlob> contentBlob;
+
+        /// Holds the contents of tokens that needed escaped newlines removed
+        MemoryArena memoryArena;
+
+        /// Tokens without whitespace or comments, ending with `EndOfFile`. The location of each
+        /// token is held as an offset from the start of the file.
+        List<Token> tokens;
+
+        /// Set if lexing produced diagnostics. Such a file is always lexed as it is read, so
+        /// that diagnostics are only reported outside of disabled conditionals.
+        bool hasDiagnostics = false;
+    };
+
+    /// Find an entry for the file with `uniqueIdentity` whose contents have `digest`
+    Entry* findEntry(const String& uniqueIdentity, const SHA1::Digest& digest);
+
+    /// Set the entry for the file with `uniqueIdentity`, replacing any previous entry
+    void setEntry(const String& uniqueIdentity, Entry* entry);
+
+    /// Number of times the tokens of an entry were used instead of lexing the file
+    Count replayCount = 0;
+    /// Number of times a file was lexed into the cache
+    Count lexCount = 0;
+    /// Number of entries that were replaced because the contents of their file changed
+    Count invalidatedCount = 0;
+
+protected:
+    Dictionary<String, RefPtr<Entry>> m_entries;
+};
+
 /// Description of a preprocessor options/dependencies
 struct PreprocessorDesc
 {
@@ -59,6 +108,9 @@ struct PreprocessorDesc
 
     /// Optional: additional information for code assist.
     PreprocessorContentAssistInfo* contentAssistInfo = nullptr;
+
+    /// Optional: cache of tokens for included files, which must use the same `namePool`
+    IncludedFileTokenCache* includedFileTokenCache = nullptr;
 };
 
 /// Take a source `file` and preprocess it into a list of tokens.
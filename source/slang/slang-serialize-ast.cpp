@@ -1,6 +1,7 @@
 // slang-serialize-ast.cpp
 #include "slang-serialize-ast.h"
 
+#include "../compiler-core/slang-perfect-hash.h"
 #include "slang-ast-dispatch.h"
 #include "slang-check.h"
 #include "slang-compiler.h"
@@ -327,6 +328,19 @@ struct ContainerDeclDirectMemberDeclsInfo
     // the given name).
     //
     FIDDLE() OrderedDictionary<String, FossilUInt> mapNameToDeclIndex;
+
+    // Containers with many named members (such as the module scopes
+    // of the core module, which hold thousands of intrinsics) also
+    // store a minimal perfect hash of the names in `mapNameToDeclIndex`,
+    // so that a lookup is a single probe rather than a binary search.
+    //
+    // The `nameHashSalts` are indexed by the unsalted hash of a name,
+    // and `nameHashEntryIndices` by the salted hash, to give the index
+    // of the one entry in `mapNameToDeclIndex` that could match.
+    // Both lists are empty if no perfect hash was stored.
+    //
+    FIDDLE() List<FossilUInt> nameHashSalts;
+    FIDDLE() List<FossilUInt> nameHashEntryIndices;
 };
 
 //
@@ -1897,6 +1911,34 @@ static ContainerDeclDirectMemberDeclsInfo _collectContainerDeclDirectMemberDecls
         info.mapNameToDeclIndex.add(entry.key, entry.value);
     }
 
+    // A perfect hash only pays for itself (in both the time to build
+    // it and the space to store it) when there are enough names that
+    // a binary search would take a good number of steps.
+    //
+    static const Count kMinNameCountForPerfectHash = 64;
+    if (nameIndexPairs.getCount() >= kMinNameCountForPerfectHash)
+    {
+        List<String> names;
+        Dictionary<String, FossilUInt> mapNameToEntryIndex;
+        for (Index i = 0; i < nameIndexPairs.getCount(); ++i)
+        {
+            names.add(nameIndexPairs[i].key);
+            mapNameToEntryIndex.add(nameIndexPairs[i].key, FossilUInt(i));
+        }
+
+        // If no perfect hash can be found, lookup will simply fall
+        // back to the binary search.
+        //
+        HashParams hashParams;
+        if (minimalPerfectHash(names, hashParams) == HashFindResult::Success)
+        {
+            for (auto salt : hashParams.saltTable)
+                info.nameHashSalts.add(FossilUInt(salt));
+            for (auto& name : hashParams.destTable)
+                info.nameHashEntryIndices.add(mapNameToEntryIndex[name]);
+        }
+    }
+
     return info;
 }
 
@@ -2245,6 +2287,33 @@ T const* _findEntryInFossilizedDictionaryWithSortedKeys(
     return nullptr;
 }
 
+//
+// Dictionaries with many entries may also have a minimal perfect
+// hash of their keys stored alongside them, which lets us find
+// the only entry that could match a key with one comparison.
+//
+
+template<typename T>
+T const* _findEntryInFossilizedDictionaryWithPerfectHash(
+    FossilizedDictionary<FossilizedString, T> const& dictionary,
+    Fossilized<List<FossilUInt>> const& salts,
+    Fossilized<List<FossilUInt>> const& entryIndices,
+    UnownedStringSlice const& key)
+{
+    const UInt32 count = UInt32(salts.getElementCount());
+    SLANG_ASSERT(count == UInt32(entryIndices.getElementCount()));
+    SLANG_ASSERT(count == UInt32(dictionary.getElementCount()));
+
+    const UInt32 salt = salts[perfectHash(key, 0, count)];
+    const UInt32 entryIndex = entryIndices[perfectHash(key, salt, count)];
+
+    auto element = dictionary.getBuffer() + entryIndex;
+    if (compare(element->key, key) != 0)
+        return nullptr;
+
+    return &element->value;
+}
+
 Decl* ModuleDecl::_findSerializedDeclByMangledExportName(UnownedStringSlice const& mangledName)
 {
     // Each of the accessors defined in this file should only
@@ -2315,11 +2384,18 @@ Decl* ContainerDeclDirectMemberDecls::_readSerializedDeclsOfName(Name* name) con
 
     // Once we are sure that `name` is valid, the overall logic here
     // is quite similar to `findExportedDeclByMangledName()` above:
-    // we do a lookup in the serialized dictionary by binary search.
-    //
-    auto found = _findEntryInFossilizedDictionaryWithSortedKeys(
-        fossilizedInfo.mapNameToDeclIndex,
-        name->text.getUnownedSlice());
+    // we do a lookup in the serialized dictionary, using the perfect
+    // hash if one was stored, and by binary search otherwise.
+    //
+    auto found = fossilizedInfo.nameHashSalts.getElementCount() != 0
+                     ? _findEntryInFossilizedDictionaryWithPerfectHash(
+                           fossilizedInfo.mapNameToDeclIndex,
+                           fossilizedInfo.nameHashSalts,
+                           fossilizedInfo.nameHashEntryIndices,
+                           name->text.getUnownedSlice())
+                     : _findEntryInFossilizedDictionaryWithSortedKeys(
+                           fossilizedInfo.mapNameToDeclIndex,
+                           name->text.getUnownedSlice());
     if (!found)
         return nullptr;
 
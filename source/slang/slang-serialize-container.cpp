@@ -579,30 +579,44 @@ SlangResult readSourceLocationsFromDebugChunk(
 SlangResult decodeModuleIR(
     RefPtr<IRModule>& outIRModule,
     IRModuleChunk const* chunk,
+    ISlangBlob* blobHoldingSerializedData,
     Session* session,
-    SerialSourceLocReader* sourceLocReader)
+    SerialSourceLocReader* sourceLocReader,
+    bool deferFunctionBodies)
 {
+    if (deferFunctionBodies)
+    {
+        return IRSerialReader::readLazily(
+            chunk,
+            blobHoldingSerializedData,
+            session,
+            sourceLocReader,
+            outIRModule);
+    }
+
     // IR serialization still uses the older approach, where
-    // data gets deserialized from the RIFF into an intermediate
-    // data structure (`IRSerialData`), and then the actual
-    // in-memory structures are created based on the intermediate.
+    // the arrays of an intermediate data structure (`IRSerialData`)
+    // are read from the RIFF, and then the actual in-memory
+    // structures are created based on the intermediate.
     //
-    // Thus we start by running the `IRSerialReader::readContainer`
-    // logic to get the `IRSerialData` representation.
+    // The arrays are used in place in the RIFF where their
+    // alignment allows, and only copied otherwise, so we get
+    // an `IRSerialDataView`, with `serialData` holding any copies.
     //
     // TODO(tfoley): This should all get streamlined so that we
     // are deserializing IR nodes directly from the format written
     // into the RIFF.
     //
     IRSerialData serialData;
-    SLANG_RETURN_ON_FAIL(IRSerialReader::readFrom(chunk, &serialData));
+    IRSerialDataView serialDataView;
+    SLANG_RETURN_ON_FAIL(IRSerialReader::readInPlace(chunk, &serialData, &serialDataView));
 
     // Next we read the actual IR representation out from the
     // `serialData`. This is the step that may pull source-location
     // information from the provided `sourceLocReader`.
     //
     IRSerialReader reader;
-    SLANG_RETURN_ON_FAIL(reader.read(serialData, session, sourceLocReader, outIRModule));
+    SLANG_RETURN_ON_FAIL(reader.read(serialDataView, session, sourceLocReader, outIRModule));
 
     return SLANG_OK;
 }
@@ -129,11 +129,18 @@ SlangResult readSourceLocationsFromDebugChunk(
     SourceManager* sourceManager,
     RefPtr<SerialSourceLocReader>& outReader);
 
+/// Decode the IR module held in `chunk`.
+///
+/// If `deferFunctionBodies` is set, the bodies of functions are only deserialized
+/// when they are first needed (see `IRSerialReader::readLazily`). Those bodies are
+/// read in place from `blobHoldingSerializedData`, which must hold `chunk`, if it is set.
 SlangResult decodeModuleIR(
     RefPtr<IRModule>& outIRModule,
     IRModuleChunk const* chunk,
+    ISlangBlob* blobHoldingSerializedData,
     Session* session,
-    SerialSourceLocReader* sourceLocReader);
+    SerialSourceLocReader* sourceLocReader,
+    bool deferFunctionBodies = false);
 
 } // namespace Slang
 
@@ -47,6 +47,18 @@ static size_t _calcArraySize(const List<T>& list)
     return list.getCount() * sizeof(T);
 }
 
+template<typename T>
+static size_t _calcArraySize(const ConstArrayView<T>& view)
+{
+    return view.getCount() * sizeof(T);
+}
+
+template<typename T>
+static ConstArrayView<T> _makeView(const List<T>& list)
+{
+    return makeConstArrayView(list.getBuffer(), list.getCount());
+}
+
 size_t IRSerialData::calcSizeInBytes() const
 {
     return _calcArraySize(m_insts) + _calcArraySize(m_childRuns) +
@@ -89,4 +101,23 @@ bool IRSerialData::operator==(const ThisType& rhs) const
             SerialListUtil::isEqual(m_debugSourceLocRuns, rhs.m_debugSourceLocRuns));
 }
 
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! IRSerialDataView !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+IRSerialDataView::IRSerialDataView(const IRSerialData& data)
+    : m_insts(_makeView(data.m_insts))
+    , m_rawSourceLocs(_makeView(data.m_rawSourceLocs))
+    , m_childRuns(_makeView(data.m_childRuns))
+    , m_externalOperands(_makeView(data.m_externalOperands))
+    , m_stringTable(_makeView(data.m_stringTable))
+    , m_debugSourceLocRuns(_makeView(data.m_debugSourceLocRuns))
+{
+}
+
+size_t IRSerialDataView::calcSizeInBytes() const
+{
+    return _calcArraySize(m_insts) + _calcArraySize(m_childRuns) +
+           _calcArraySize(m_externalOperands) + _calcArraySize(m_stringTable) +
+           _calcArraySize(m_rawSourceLocs) + _calcArraySize(m_debugSourceLocRuns);
+}
+
 } // namespace Slang
@@ -199,6 +199,34 @@ struct IRSerialData
     static const PayloadInfo s_payloadInfos[int(Inst::PayloadType::CountOf)];
 };
 
+/// A read only view of the arrays of IRSerialData.
+///
+/// The arrays can either be those of an `IRSerialData`, or be held directly in the chunks of
+/// a serialized module (see `IRSerialReader::readInPlace`), in which case the memory holding
+/// the chunks must outlive the view.
+struct IRSerialDataView
+{
+    typedef IRSerialData Ser;
+
+    /// Get the operands of an instruction
+    SLANG_FORCE_INLINE int getOperands(const Ser::Inst& inst, const Ser::InstIndex** operandsOut)
+        const;
+
+    /// Calculate the amount of memory viewed
+    size_t calcSizeInBytes() const;
+
+    IRSerialDataView() = default;
+    /// View the arrays held in `data`
+    IRSerialDataView(const IRSerialData& data);
+
+    ConstArrayView<Ser::Inst> m_insts;
+    ConstArrayView<Ser::RawSourceLoc> m_rawSourceLocs;
+    ConstArrayView<Ser::InstRun> m_childRuns;
+    ConstArrayView<Ser::InstIndex> m_externalOperands;
+    ConstArrayView<char> m_stringTable;
+    ConstArrayView<Ser::SourceLocRun> m_debugSourceLocRuns;
+};
+
 // --------------------------------------------------------------------------
 SLANG_FORCE_INLINE int IRSerialData::Inst::getNumOperands() const
 {
@@ -262,6 +290,24 @@ SLANG_FORCE_INLINE int IRSerialData::getOperands(const Inst& inst, const InstInd
     }
 }
 
+// --------------------------------------------------------------------------
+SLANG_FORCE_INLINE int IRSerialDataView::getOperands(
+    const Ser::Inst& inst,
+    const Ser::InstIndex** operandsOut) const
+{
+    if (inst.m_payloadType == Ser::Inst::PayloadType::OperandExternal)
+    {
+        *operandsOut =
+            m_externalOperands.begin() + int(inst.m_payload.m_externalOperand.m_arrayIndex);
+        return int(inst.m_payload.m_externalOperand.m_size);
+    }
+    else
+    {
+        *operandsOut = inst.m_payload.m_operands;
+        return Ser::s_payloadInfos[int(inst.m_payloadType)].m_numOperands;
+    }
+}
+
 
 } // namespace Slang
 
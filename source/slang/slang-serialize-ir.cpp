@@ -4,7 +4,12 @@
 #include "../core/slang-byte-encode-util.h"
 #include "../core/slang-math.h"
 #include "../core/slang-text-io.h"
+#include "../core/slang-performance-profiler.h"
 #include "slang-ir-insts.h"
+#include "slang-ir-util.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace Slang
 {
@@ -116,6 +121,9 @@ Result IRSerialWriter::write(
 
     serialData->clear();
 
+    // The whole module is written, so any bodies that haven't been read yet are needed
+    module->ensureAllBodiesMaterialized();
+
     // We reserve 0 for null
     m_insts.clear();
     m_insts.add(nullptr);
@@ -361,6 +369,8 @@ Result _writeInstArrayChunk(
 
 /* static */ void IRSerialWriter::calcInstructionList(IRModule* module, List<IRInst*>& instsOut)
 {
+    module->ensureAllBodiesMaterialized();
+
     // We reserve 0 for null
     instsOut.setCount(1);
     instsOut[0] = nullptr;
@@ -461,8 +471,115 @@ static Result _readInstArrayChunk(RIFF::DataChunk const* chunk, List<IRSerialDat
     return SLANG_OK;
 }
 
-Result IRSerialReader::read(
-    const IRSerialData& data,
+template<typename T>
+static Result _readArrayChunkInPlace(
+    RIFF::DataChunk const* dataChunk,
+    List<T>& outList,
+    ConstArrayView<T>& outView)
+{
+    // The layout matches `SerialRiffUtil::writeArrayChunk`
+    const Size payloadSize = dataChunk->getPayloadSize();
+    if (payloadSize < sizeof(SerialBinary::ArrayHeader))
+    {
+        return SLANG_FAIL;
+    }
+    SerialBinary::ArrayHeader header;
+    ::memcpy(&header, dataChunk->getPayload(), sizeof(header));
+    if (Size(header.numEntries) * sizeof(T) != payloadSize - sizeof(header))
+    {
+        return SLANG_FAIL;
+    }
+
+    // RIFF chunks are only 2-byte aligned, so the entries can only be used in place if they
+    // happen to be aligned well enough for `T`.
+    auto entries = (const uint8_t*)dataChunk->getPayload() + sizeof(header);
+    if ((size_t(entries) & (alignof(T) - 1)) == 0)
+    {
+        outView = makeConstArrayView((const T*)entries, Count(header.numEntries));
+        return SLANG_OK;
+    }
+
+    SLANG_RETURN_ON_FAIL(SerialRiffUtil::readArrayChunk(dataChunk, outList));
+    outView = makeConstArrayView(outList.getBuffer(), outList.getCount());
+    return SLANG_OK;
+}
+
+/* static */ Result IRSerialReader::readInPlace(
+    IRModuleChunk const* irModuleChunk,
+    IRSerialData* outData,
+    IRSerialDataView* outView)
+{
+    typedef IRSerialBinary Bin;
+
+    outData->clear();
+    *outView = IRSerialDataView(*outData);
+
+    for (auto chunk : irModuleChunk->getChildren())
+    {
+        auto dataChunk = as<RIFF::DataChunk>(chunk);
+        if (!dataChunk)
+        {
+            continue;
+        }
+
+        switch (dataChunk->getType())
+        {
+        case Bin::kInstFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(
+                    _readArrayChunkInPlace(dataChunk, outData->m_insts, outView->m_insts));
+                break;
+            }
+        case Bin::kChildRunFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(
+                    _readArrayChunkInPlace(dataChunk, outData->m_childRuns, outView->m_childRuns));
+                break;
+            }
+        case Bin::kExternalOperandsFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunkInPlace(
+                    dataChunk,
+                    outData->m_externalOperands,
+                    outView->m_externalOperands));
+                break;
+            }
+        case SerialBinary::kStringTableFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunkInPlace(
+                    dataChunk,
+                    outData->m_stringTable,
+                    outView->m_stringTable));
+                break;
+            }
+        case Bin::kUInt32RawSourceLocFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunkInPlace(
+                    dataChunk,
+                    outData->m_rawSourceLocs,
+                    outView->m_rawSourceLocs));
+                break;
+            }
+        case Bin::kDebugSourceLocRunFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunkInPlace(
+                    dataChunk,
+                    outData->m_debugSourceLocRuns,
+                    outView->m_debugSourceLocRuns));
+                break;
+            }
+        default:
+            {
+                break;
+            }
+        }
+    }
+
+    return SLANG_OK;
+}
+
+Result IRSerialReader::_initialize(
+    const IRSerialDataView& data,
     Session* session,
     SerialSourceLocReader* sourceLocReader,
     RefPtr<IRModule>& outModule)
@@ -470,7 +587,8 @@ Result IRSerialReader::read(
     // Only used in debug builds
     [[maybe_unused]] typedef Ser::Inst::PayloadType PayloadType;
 
-    m_serialData = &data;
+    m_serialData = data;
+    m_sourceLocReader = sourceLocReader;
 
     auto module = IRModule::create(session);
     outModule = module;
@@ -482,6 +600,271 @@ Result IRSerialReader::read(
         data.m_stringTable.getCount(),
         m_stringTable);
 
+    const Index numInsts = data.m_insts.getCount();
+
+    SLANG_ASSERT(numInsts > 0);
+
+    // Nothing has been allocated yet
+    m_insts.setCount(numInsts);
+    ::memset(m_insts.getBuffer(), 0, sizeof(IRInst*) * numInsts);
+
+    // 0 holds null
+    // 1 holds the IRModuleInst
+    {
+        // Check that insts[1] is the module inst
+        const Ser::Inst& srcInst = data.m_insts[1];
+        SLANG_RELEASE_ASSERT(srcInst.m_op == kIROp_ModuleInst);
+        SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Empty);
+
+        // The root IR instruction for the module will already have
+        // been created as part of creating `module` above.
+        //
+        auto moduleInst = module->getModuleInst();
+
+        // Set the IRModuleInst
+        m_insts[1] = moduleInst;
+    }
+
+    return SLANG_OK;
+}
+
+Result IRSerialReader::_allocateInst(Index index)
+{
+    // Only used in debug builds
+    [[maybe_unused]] typedef Ser::Inst::PayloadType PayloadType;
+
+    const Ser::Inst& srcInst = m_serialData.m_insts[index];
+    IRModule* module = m_module;
+
+    const IROp op((IROp)srcInst.m_op);
+
+    if (_isConstant(op))
+    {
+        // Handling of constants
+
+        // Calculate the minimum object size (ie not including the payload of value)
+        const size_t prefixSize = SLANG_OFFSET_OF(IRConstant, value);
+
+        // All IR constants have zero operands.
+        Int operandCount = 0;
+
+        IRConstant* irConst = nullptr;
+        switch (op)
+        {
+        case kIROp_BoolLit:
+            {
+                // TODO: Most of these cases could use the templated `_allocateInst<T>`
+                // *if* we had distinct `IRConstant` subtypes to represent these
+                // cases and their subtype-specific payloads.
+
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::UInt32);
+                irConst = static_cast<IRConstant*>(module->_allocateInst(
+                    op,
+                    operandCount,
+                    prefixSize + sizeof(IRIntegerValue)));
+                irConst->value.intVal = srcInst.m_payload.m_uint32 != 0;
+                break;
+            }
+        case kIROp_IntLit:
+            {
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Int64);
+                irConst = static_cast<IRConstant*>(module->_allocateInst(
+                    op,
+                    operandCount,
+                    prefixSize + sizeof(IRIntegerValue)));
+                irConst->value.intVal = srcInst.m_payload.m_int64;
+                break;
+            }
+        case kIROp_PtrLit:
+            {
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Int64);
+                irConst = static_cast<IRConstant*>(
+                    module->_allocateInst(op, operandCount, prefixSize + sizeof(void*)));
+                irConst->value.ptrVal = (void*)(intptr_t)srcInst.m_payload.m_int64;
+                break;
+            }
+        case kIROp_FloatLit:
+            {
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Float64);
+                irConst = static_cast<IRConstant*>(module->_allocateInst(
+                    op,
+                    operandCount,
+                    prefixSize + sizeof(IRFloatingPointValue)));
+                irConst->value.floatVal = srcInst.m_payload.m_float64;
+                break;
+            }
+        case kIROp_VoidLit:
+            {
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Empty);
+                irConst =
+                    static_cast<IRConstant*>(module->_allocateInst(op, operandCount, prefixSize));
+                break;
+            }
+        case kIROp_BlobLit:
+        case kIROp_StringLit:
+            {
+                SLANG_ASSERT(srcInst.m_payloadType == PayloadType::String_1);
+
+                const UnownedStringSlice slice = m_stringTable.getSlice(
+                    StringSlicePool::Handle(srcInst.m_payload.m_stringIndices[0]));
+
+                const size_t sliceSize = slice.getLength();
+                const size_t instSize =
+                    prefixSize + SLANG_OFFSET_OF(IRConstant::StringValue, chars) + sliceSize;
+
+                irConst =
+                    static_cast<IRConstant*>(module->_allocateInst(op, operandCount, instSize));
+
+                IRConstant::StringValue& dstString = irConst->value.stringVal;
+
+                dstString.numChars = uint32_t(sliceSize);
+                // Turn into pointer to avoid warning of array overrun
+                char* dstChars = dstString.chars;
+                // Copy the chars
+                memcpy(dstChars, slice.begin(), sliceSize);
+                break;
+            }
+        default:
+            {
+                SLANG_ASSERT(!"Unknown constant type");
+                return SLANG_FAIL;
+            }
+        }
+
+        m_insts[index] = irConst;
+    }
+    else
+    {
+        int numOperands = srcInst.getNumOperands();
+        m_insts[index] = module->_allocateInst(op, numOperands);
+    }
+    return SLANG_OK;
+}
+
+void IRSerialReader::_patchOperands(Index index)
+{
+    const Ser::Inst& srcInst = m_serialData.m_insts[index];
+
+    IRInst* dstInst = m_insts[index];
+
+    // Set the result type
+    if (srcInst.m_resultTypeIndex != Ser::InstIndex(0))
+    {
+        IRInst* resultInst = m_insts[int(srcInst.m_resultTypeIndex)];
+        // NOTE! Counter intuitively the IRType* paramter may not be IRType* derived for example
+        // IRGlobalGenericParam is valid, but isn't IRType* derived
+
+        // SLANG_RELEASE_ASSERT(as<IRType>(resultInst));
+        dstInst->setFullType(static_cast<IRType*>(resultInst));
+    }
+
+    // if (!isParentDerived(op))
+    {
+        const Ser::InstIndex* srcOperandIndices;
+        const int numOperands = m_serialData.getOperands(srcInst, &srcOperandIndices);
+
+        auto dstOperands = dstInst->getOperands();
+
+        for (int j = 0; j < numOperands; j++)
+        {
+            dstOperands[j].init(dstInst, m_insts[int(srcOperandIndices[j])]);
+        }
+    }
+}
+
+void IRSerialReader::_addChildren(const Ser::InstRun& run, Index startIndex, Index endIndex)
+{
+    IRInst* inst = m_insts[int(run.m_parentIndex)];
+
+    for (Index i = startIndex; i < endIndex; ++i)
+    {
+        IRInst* child = m_insts[i];
+        SLANG_ASSERT(child->parent == nullptr);
+        child->insertAtEnd(inst);
+    }
+}
+
+void IRSerialReader::_applySourceLocs(
+    const Ser::SourceLocRun* runs,
+    Index runCount,
+    Index startIndex,
+    Index endIndex)
+{
+    // Re-add source locations, if they are defined
+    if (m_serialData.m_rawSourceLocs.getCount() == m_serialData.m_insts.getCount())
+    {
+        const Ser::RawSourceLoc* srcLocs = m_serialData.m_rawSourceLocs.begin();
+        for (Index i = startIndex; i < endIndex; ++i)
+        {
+            if (IRInst* dstInst = m_insts[i])
+            {
+                dstInst->sourceLoc.setRaw(Slang::SourceLoc::RawValue(srcLocs[i]));
+            }
+        }
+    }
+
+    // We now need to apply the runs
+    if (!m_sourceLocReader)
+    {
+        return;
+    }
+
+    // Just guess initially 0 for the source file that contains the initial run
+    SerialSourceLocData::SourceRange range = SerialSourceLocData::SourceRange::getInvalid();
+    int fix = 0;
+
+    for (Index i = 0; i < runCount; ++i)
+    {
+        const auto& run = runs[i];
+
+        // Only the part of the run in the range is written
+        const Index runStart = Math::Max(Index(run.m_startInstIndex), startIndex);
+        const Index runEnd = Math::Min(Index(run.m_startInstIndex) + run.m_numInst, endIndex);
+        if (runStart >= runEnd)
+        {
+            continue;
+        }
+
+        // Work out the fixed source location
+        SourceLoc sourceLoc;
+        if (run.m_sourceLoc)
+        {
+            if (!range.contains(run.m_sourceLoc))
+            {
+                fix = m_sourceLocReader->calcFixSourceLoc(run.m_sourceLoc, range);
+            }
+            sourceLoc = m_sourceLocReader->calcFixedLoc(run.m_sourceLoc, fix, range);
+        }
+
+        // Write to all the instructions
+        SLANG_ASSERT(runEnd <= m_insts.getCount());
+        for (Index j = runStart; j < runEnd; ++j)
+        {
+            if (IRInst* dstInst = m_insts[j])
+            {
+                dstInst->sourceLoc = sourceLoc;
+            }
+        }
+    }
+}
+
+Result IRSerialReader::read(
+    const IRSerialData& data,
+    Session* session,
+    SerialSourceLocReader* sourceLocReader,
+    RefPtr<IRModule>& outModule)
+{
+    return read(IRSerialDataView(data), session, sourceLocReader, outModule);
+}
+
+Result IRSerialReader::read(
+    const IRSerialDataView& data,
+    Session* session,
+    SerialSourceLocReader* sourceLocReader,
+    RefPtr<IRModule>& outModule)
+{
+    SLANG_RETURN_ON_FAIL(_initialize(data, session, sourceLocReader, outModule));
+
     // Each IR instruction has:
     //
     // * An opcode
@@ -515,247 +898,680 @@ Result IRSerialReader::read(
     // uses the `IRBuilder` interface instead might be possible, but would need a
     // plan for how to handle forward and/or circular references in the IR module.
 
-    // Add all the instructions
-    List<IRInst*> insts;
-
     const Index numInsts = data.m_insts.getCount();
 
-    SLANG_ASSERT(numInsts > 0);
+    // Add all the instructions
+    for (Index i = 2; i < numInsts; ++i)
+    {
+        SLANG_RETURN_ON_FAIL(_allocateInst(i));
+    }
 
-    insts.setCount(numInsts);
-    insts[0] = nullptr;
+    // Patch up the operands
+    for (Index i = 1; i < numInsts; ++i)
+    {
+        _patchOperands(i);
+    }
 
-    // 0 holds null
-    // 1 holds the IRModuleInst
+    // Patch up the children
+    for (const auto& run : data.m_childRuns)
     {
-        // Check that insts[1] is the module inst
-        const Ser::Inst& srcInst = data.m_insts[1];
-        SLANG_RELEASE_ASSERT(srcInst.m_op == kIROp_ModuleInst);
-        SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Empty);
+        const Index startIndex = Index(run.m_startInstIndex);
+        _addChildren(run, startIndex, startIndex + run.m_numChildren);
+    }
 
-        // The root IR instruction for the module will already have
-        // been created as part of creating `module` above.
-        //
-        auto moduleInst = module->getModuleInst();
+    // Source locations are applied in source location order, so that finding the fix for
+    // each run can mostly reuse the range found for the previous one.
+    List<IRSerialData::SourceLocRun> sourceRuns;
+    sourceRuns.addRange(
+        m_serialData.m_debugSourceLocRuns.getBuffer(),
+        m_serialData.m_debugSourceLocRuns.getCount());
+    sourceRuns.sort();
+    _applySourceLocs(sourceRuns.getBuffer(), sourceRuns.getCount(), 1, numInsts);
 
-        // Set the IRModuleInst
-        insts[1] = moduleInst;
-    }
+    outModule->buildMangledNameToGlobalInstMap();
 
-    for (Index i = 2; i < numInsts; ++i)
+    return SLANG_OK;
+}
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! IRSerialDeferredBodyLoader !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+// Reads a module with `IRSerialReader::readLazily`, and then materializes the deferred
+// function bodies as they are asked for.
+//
+// The writer emits the children of an instruction as a contiguous run, and traverses
+// depth first, so all of the instructions below a function (its blocks, and everything in
+// them) occupy a contiguous range of instruction indices, and a contiguous range of child
+// runs directly after the run holding the function's own children. A deferred body is such
+// a range, minus the function's decorations, which are read up front along with everything
+// that is not inside a function.
+class IRSerialDeferredBodyLoader : public IRDeferredBodyLoader, public IRSerialReader
+{
+public:
+    virtual bool hasDeferredBody(IRInst* inst) SLANG_OVERRIDE;
+    virtual void materializeBody(IRInst* inst) SLANG_OVERRIDE;
+    virtual void materializeAllBodies() SLANG_OVERRIDE;
+    virtual Stats getStats() SLANG_OVERRIDE;
+
+    Result load(
+        IRModuleChunk const* irModuleChunk,
+        ISlangBlob* blobHoldingSerializedData,
+        Session* session,
+        SerialSourceLocReader* sourceLocReader,
+        RefPtr<IRModule>& outModule);
+
+protected:
+    struct Body
     {
-        const Ser::Inst& srcInst = data.m_insts[i];
+        Index funcIndex;    ///< The function the body belongs to
+        Index startIndex;   ///< The first instruction of the body (its first block)
+        Index endIndex;     ///< One past the last instruction of the body
+        Index funcRunIndex; ///< The run holding the function's decorations and blocks
+        Index endRunIndex;  ///< One past the last run of the body
+        bool isDeferred;
+    };
 
-        const IROp op((IROp)srcInst.m_op);
+    /// Find the function bodies that could be deferred
+    void _findBodies();
+    /// Get the body that the instruction at `index` is in, or -1 if not in one.
+    Index _findBody(Index index) const;
+    /// Returns true if the instruction at `index` is in a body that is (still) deferred
+    bool _isDeferred(Index index) const;
+
+    /// Invoke `func` with each of the instruction indices referenced by the instruction at
+    /// `index`, as its type or an operand
+    template<typename F>
+    void _forEachReference(Index index, const F& func) const;
+
+    /// Read the bodies that are referenced from outside of themselves up front, as
+    /// otherwise reading the instructions that refer to them would require them anyway.
+    void _keepReferencedBodies();
+
+    /// Returns true if the body needs to be read up front because it affects whether the
+    /// linker enables automatic differentiation. The linker decides that by scanning user
+    /// modules in full, which would otherwise see an empty body.
+    bool _bodyUsesAutodiff(const Body& body) const;
+    bool _isDiffPairType(Ser::InstIndex typeIndex) const;
+    bool _resolvesToDifferentiate(Ser::InstIndex calleeIndex) const;
+
+    /// Materialize the body, if it is still deferred. `m_mutex` must be held, or the module
+    /// must not have been returned from `load` yet.
+    void _materializeBody(Index bodyIndex);
+    /// Free the serial data, once no bodies are deferred
+    void _releaseSerialData();
+
+    // Holds the arrays of serial data that can't be read in place from the blob, which is all
+    // of them if there is no blob
+    IRSerialData m_data;
+    ComPtr<ISlangBlob> m_blobHoldingSerializedData;
+
+    // Held for as long as bodies are deferred, as the reader is used to fix up source locations
+    RefPtr<SerialSourceLocReader> m_sourceLocReaderHolder;
+
+    // All bodies ordered by index, so they can be found with a binary search
+    List<Body> m_bodies;
+    Dictionary<IRInst*, Index> m_bodyForFunc;
+
+    // The debug source locations runs ordered by instruction index
+    List<Ser::SourceLocRun> m_sourceLocRuns;
+
+    // Guards the module and all of the members, once the module has been returned from `load`.
+    std::mutex m_mutex;
+    // The number of bodies still deferred, so that fully read modules can skip the lock.
+    std::atomic<Count> m_deferredBodyCount = 0;
+    Stats m_stats;
+};
+
+void IRSerialDeferredBodyLoader::_findBodies()
+{
+    const auto& runs = m_serialData.m_childRuns;
+    const Index runCount = runs.getCount();
 
-        if (_isConstant(op))
+    for (Index runIndex = 0; runIndex < runCount;)
+    {
+        const auto& run = runs[runIndex];
+        const Index funcIndex = Index(run.m_parentIndex);
+        if (m_serialData.m_insts[funcIndex].m_op != kIROp_Func)
         {
-            // Handling of constants
+            runIndex++;
+            continue;
+        }
 
-            // Calculate the minimum object size (ie not including the payload of value)
-            const size_t prefixSize = SLANG_OFFSET_OF(IRConstant, value);
+        // The children of a function are its decorations followed by its blocks.
+        const Index runStart = Index(run.m_startInstIndex);
+        const Index runEnd = runStart + run.m_numChildren;
 
-            // All IR constants have zero operands.
-            Int operandCount = 0;
+        Index bodyStart = runStart;
+        while (bodyStart < runEnd && m_serialData.m_insts[bodyStart].m_op != kIROp_Block)
+        {
+            bodyStart++;
+        }
+        bool canDefer = bodyStart < runEnd;
+        for (Index i = bodyStart; i < runEnd; ++i)
+        {
+            canDefer = canDefer && m_serialData.m_insts[i].m_op == kIROp_Block;
+        }
 
-            IRConstant* irConst = nullptr;
-            switch (op)
+        // Take all of the runs that follow for instructions below the function.
+        Index endRunIndex = runIndex + 1;
+        Index bodyEnd = runEnd;
+        for (; endRunIndex < runCount; ++endRunIndex)
+        {
+            const auto& childRun = runs[endRunIndex];
+            const Index parentIndex = Index(childRun.m_parentIndex);
+            if (parentIndex < runStart || parentIndex >= bodyEnd)
             {
-            case kIROp_BoolLit:
-                {
-                    // TODO: Most of these cases could use the templated `_allocateInst<T>`
-                    // *if* we had distinct `IRConstant` subtypes to represent these
-                    // cases and their subtype-specific payloads.
-
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::UInt32);
-                    irConst = static_cast<IRConstant*>(module->_allocateInst(
-                        op,
-                        operandCount,
-                        prefixSize + sizeof(IRIntegerValue)));
-                    irConst->value.intVal = srcInst.m_payload.m_uint32 != 0;
-                    break;
-                }
-            case kIROp_IntLit:
-                {
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Int64);
-                    irConst = static_cast<IRConstant*>(module->_allocateInst(
-                        op,
-                        operandCount,
-                        prefixSize + sizeof(IRIntegerValue)));
-                    irConst->value.intVal = srcInst.m_payload.m_int64;
-                    break;
-                }
-            case kIROp_PtrLit:
-                {
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Int64);
-                    irConst = static_cast<IRConstant*>(
-                        module->_allocateInst(op, operandCount, prefixSize + sizeof(void*)));
-                    irConst->value.ptrVal = (void*)(intptr_t)srcInst.m_payload.m_int64;
-                    break;
-                }
-            case kIROp_FloatLit:
-                {
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Float64);
-                    irConst = static_cast<IRConstant*>(module->_allocateInst(
-                        op,
-                        operandCount,
-                        prefixSize + sizeof(IRFloatingPointValue)));
-                    irConst->value.floatVal = srcInst.m_payload.m_float64;
-                    break;
-                }
-            case kIROp_VoidLit:
-                {
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Empty);
-                    irConst = static_cast<IRConstant*>(
-                        module->_allocateInst(op, operandCount, prefixSize));
-                    break;
-                }
-            case kIROp_BlobLit:
-            case kIROp_StringLit:
-                {
-                    SLANG_ASSERT(srcInst.m_payloadType == PayloadType::String_1);
+                break;
+            }
+            // Only blocks are deferred, so nothing below a decoration can be
+            canDefer = canDefer && parentIndex >= bodyStart &&
+                       Index(childRun.m_startInstIndex) == bodyEnd;
+            bodyEnd = Index(childRun.m_startInstIndex) + childRun.m_numChildren;
+        }
 
-                    const UnownedStringSlice slice = m_stringTable.getSlice(
-                        StringSlicePool::Handle(srcInst.m_payload.m_stringIndices[0]));
+        if (canDefer)
+        {
+            Body body;
+            body.funcIndex = funcIndex;
+            body.startIndex = bodyStart;
+            body.endIndex = bodyEnd;
+            body.funcRunIndex = runIndex;
+            body.endRunIndex = endRunIndex;
+            body.isDeferred = true;
+            m_bodies.add(body);
+        }
 
-                    const size_t sliceSize = slice.getLength();
-                    const size_t instSize =
-                        prefixSize + SLANG_OFFSET_OF(IRConstant::StringValue, chars) + sliceSize;
+        runIndex = endRunIndex;
+    }
+}
 
-                    irConst =
-                        static_cast<IRConstant*>(module->_allocateInst(op, operandCount, instSize));
+Index IRSerialDeferredBodyLoader::_findBody(Index index) const
+{
+    // Find the last body that starts at or before the index
+    Index lo = 0;
+    Index hi = m_bodies.getCount();
+    while (lo < hi)
+    {
+        const Index mid = (lo + hi) / 2;
+        if (m_bodies[mid].startIndex <= index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo > 0 && index < m_bodies[lo - 1].endIndex)
+    {
+        return lo - 1;
+    }
+    return -1;
+}
 
-                    IRConstant::StringValue& dstString = irConst->value.stringVal;
+bool IRSerialDeferredBodyLoader::_isDeferred(Index index) const
+{
+    const Index bodyIndex = _findBody(index);
+    return bodyIndex >= 0 && m_bodies[bodyIndex].isDeferred;
+}
 
-                    dstString.numChars = uint32_t(sliceSize);
-                    // Turn into pointer to avoid warning of array overrun
-                    char* dstChars = dstString.chars;
-                    // Copy the chars
-                    memcpy(dstChars, slice.begin(), sliceSize);
-                    break;
-                }
-            default:
-                {
-                    SLANG_ASSERT(!"Unknown constant type");
-                    return SLANG_FAIL;
-                }
-            }
+template<typename F>
+void IRSerialDeferredBodyLoader::_forEachReference(Index index, const F& func) const
+{
+    const Ser::Inst& srcInst = m_serialData.m_insts[index];
+    if (srcInst.m_resultTypeIndex != Ser::InstIndex(0))
+    {
+        func(Index(srcInst.m_resultTypeIndex));
+    }
 
-            insts[i] = irConst;
-        }
-        else
+    const Ser::InstIndex* operandIndices;
+    const int operandCount = m_serialData.getOperands(srcInst, &operandIndices);
+    for (int i = 0; i < operandCount; ++i)
+    {
+        if (operandIndices[i] != Ser::InstIndex(0))
         {
-            int numOperands = srcInst.getNumOperands();
-            insts[i] = module->_allocateInst(op, numOperands);
+            func(Index(operandIndices[i]));
         }
     }
+}
 
-    // Patch up the operands
+void IRSerialDeferredBodyLoader::_keepReferencedBodies()
+{
+    // Bodies should only ever be referenced from inside of themselves, but the format
+    // doesn't guarantee it, so any body referenced from elsewhere is read up front.
+    List<Index> bodiesToScan;
+    auto keepReferencedBody = [&](Index referencedIndex)
+    {
+        const Index bodyIndex = _findBody(referencedIndex);
+        if (bodyIndex >= 0 && m_bodies[bodyIndex].isDeferred)
+        {
+            m_bodies[bodyIndex].isDeferred = false;
+            bodiesToScan.add(bodyIndex);
+        }
+    };
+
+    // Scan all of the instructions outside of bodies
+    const Index numInsts = m_serialData.m_insts.getCount();
+    Index nextBodyIndex = 0;
     for (Index i = 1; i < numInsts; ++i)
     {
-        const Ser::Inst& srcInst = data.m_insts[i];
-        const IROp op((IROp)srcInst.m_op);
-        SLANG_UNUSED(op);
+        if (nextBodyIndex < m_bodies.getCount() && i == m_bodies[nextBodyIndex].startIndex)
+        {
+            i = m_bodies[nextBodyIndex++].endIndex - 1;
+            continue;
+        }
+        _forEachReference(i, keepReferencedBody);
+    }
 
-        IRInst* dstInst = insts[i];
+    // The bodies that will now be read up front can reference other bodies in turn
+    while (bodiesToScan.getCount())
+    {
+        const Body& body = m_bodies[bodiesToScan.getLast()];
+        bodiesToScan.removeLast();
 
-        // Set the result type
-        if (srcInst.m_resultTypeIndex != Ser::InstIndex(0))
+        for (Index i = body.startIndex; i < body.endIndex; ++i)
         {
-            IRInst* resultInst = insts[int(srcInst.m_resultTypeIndex)];
-            // NOTE! Counter intuitively the IRType* paramter may not be IRType* derived for example
-            // IRGlobalGenericParam is valid, but isn't IRType* derived
-
-            // SLANG_RELEASE_ASSERT(as<IRType>(resultInst));
-            dstInst->setFullType(static_cast<IRType*>(resultInst));
+            _forEachReference(i, keepReferencedBody);
         }
+    }
+}
 
-        // if (!isParentDerived(op))
-        {
-            const Ser::InstIndex* srcOperandIndices;
-            const int numOperands = data.getOperands(srcInst, &srcOperandIndices);
+bool IRSerialDeferredBodyLoader::_isDiffPairType(Ser::InstIndex typeIndex) const
+{
+    IRInst* type = m_insts[Index(typeIndex)];
+    if (!type)
+    {
+        // The type is defined in a body that hasn't been read, so assume it could be.
+        return typeIndex != Ser::InstIndex(0);
+    }
 
-            auto dstOperands = dstInst->getOperands();
+    // Matches `isDiffPairType` in the linker
+    for (;;)
+    {
+        auto type1 = (IRType*)unwrapAttributedType(type);
+        auto type2 = unwrapArray(type1);
+        if (type2 == type)
+            break;
+        type = type2;
+    }
+    return as<IRDifferentialPairTypeBase>(type) != nullptr;
+}
 
-            for (int j = 0; j < numOperands; j++)
-            {
-                dstOperands[j].init(dstInst, insts[int(srcOperandIndices[j])]);
-            }
-        }
+static bool _isDifferentiateOp(IROp op)
+{
+    switch (op)
+    {
+    case kIROp_ForwardDifferentiate:
+    case kIROp_BackwardDifferentiate:
+    case kIROp_BackwardDifferentiatePrimal:
+    case kIROp_BackwardDifferentiatePropagate:
+        return true;
+    default:
+        return false;
     }
+}
 
-    // Patch up the children
+bool IRSerialDeferredBodyLoader::_resolvesToDifferentiate(Ser::InstIndex calleeIndex) const
+{
+    // Follow any specializations that haven't been read yet
+    while (calleeIndex != Ser::InstIndex(0) && !m_insts[Index(calleeIndex)])
     {
-        const Index numChildRuns = data.m_childRuns.getCount();
-        for (Index i = 0; i < numChildRuns; i++)
+        const Ser::Inst& srcInst = m_serialData.m_insts[Index(calleeIndex)];
+        if (srcInst.m_op != kIROp_Specialize)
         {
-            const auto& run = data.m_childRuns[i];
+            return _isDifferentiateOp(IROp(srcInst.m_op));
+        }
+        const Ser::InstIndex* operandIndices;
+        if (m_serialData.getOperands(srcInst, &operandIndices) == 0)
+        {
+            return false;
+        }
+        calleeIndex = operandIndices[0];
+    }
+    if (calleeIndex == Ser::InstIndex(0))
+    {
+        return false;
+    }
 
-            IRInst* inst = insts[int(run.m_parentIndex)];
+    auto callee = getResolvedInstForDecorations(m_insts[Index(calleeIndex)]);
+    return callee && _isDifferentiateOp(callee->getOp());
+}
 
-            for (int j = 0; j < int(run.m_numChildren); ++j)
+bool IRSerialDeferredBodyLoader::_bodyUsesAutodiff(const Body& body) const
+{
+    // This mirrors what `doesModuleUseAutodiff` looks for in the linker.
+    for (Index i = body.startIndex; i < body.endIndex; ++i)
+    {
+        const Ser::Inst& srcInst = m_serialData.m_insts[i];
+        const IROp op = IROp(srcInst.m_op);
+        if (_isDifferentiateOp(op))
+        {
+            return true;
+        }
+        switch (op)
+        {
+        case kIROp_DifferentialPairGetDifferentialUserCode:
+        case kIROp_DifferentialPairGetPrimalUserCode:
+        case kIROp_DifferentialPtrPairGetPrimal:
+        case kIROp_DifferentialPtrPairGetDifferential:
+        case kIROp_AutoPyBindCudaDecoration:
+        case kIROp_AutoPyBindExportInfoDecoration:
+        case kIROp_StructField:
+            return true;
+        case kIROp_Param:
+            if (_isDiffPairType(srcInst.m_resultTypeIndex))
+                return true;
+            break;
+        case kIROp_Call:
             {
-                IRInst* child = insts[j + int(run.m_startInstIndex)];
-                SLANG_ASSERT(child->parent == nullptr);
-                child->insertAtEnd(inst);
+                const Ser::InstIndex* operandIndices;
+                if (m_serialData.getOperands(srcInst, &operandIndices) > 0 &&
+                    _resolvesToDifferentiate(operandIndices[0]))
+                {
+                    return true;
+                }
+                break;
             }
+        default:
+            break;
         }
     }
+    return false;
+}
 
-    // Re-add source locations, if they are defined
-    if (m_serialData->m_rawSourceLocs.getCount() == numInsts)
+void IRSerialDeferredBodyLoader::_materializeBody(Index bodyIndex)
+{
+    Body& body = m_bodies[bodyIndex];
+    if (!body.isDeferred)
     {
-        const Ser::RawSourceLoc* srcLocs = m_serialData->m_rawSourceLocs.begin();
-        for (Index i = 1; i < numInsts; ++i)
-        {
-            IRInst* dstInst = insts[i];
+        return;
+    }
+    body.isDeferred = false;
+
+    SLANG_PROFILE_SECTION(materializeIRBody);
 
-            dstInst->sourceLoc.setRaw(Slang::SourceLoc::RawValue(srcLocs[i]));
+    for (Index i = body.startIndex; i < body.endIndex; ++i)
+    {
+        if (SLANG_FAILED(_allocateInst(i)))
+        {
+            SLANG_UNEXPECTED("invalid instruction in serialized IR");
         }
     }
 
-    // We now need to apply the runs
-    if (sourceLocReader && m_serialData->m_debugSourceLocRuns.getCount())
+    // Make sure anything the body refers to has been read, before the operands are set.
+    for (Index i = body.startIndex; i < body.endIndex; ++i)
+    {
+        _forEachReference(
+            i,
+            [&](Index referencedIndex)
+            {
+                if (!m_insts[referencedIndex])
+                {
+                    const Index referencedBodyIndex = _findBody(referencedIndex);
+                    SLANG_ASSERT(referencedBodyIndex >= 0);
+                    _materializeBody(referencedBodyIndex);
+                }
+            });
+    }
+
+    for (Index i = body.startIndex; i < body.endIndex; ++i)
     {
-        List<IRSerialData::SourceLocRun> sourceRuns(m_serialData->m_debugSourceLocRuns);
-        // They are now in source location order
-        sourceRuns.sort();
+        _patchOperands(i);
+    }
 
-        // Just guess initially 0 for the source file that contains the initial run
-        SerialSourceLocData::SourceRange range = SerialSourceLocData::SourceRange::getInvalid();
-        int fix = 0;
+    // The blocks are the tail of the run for the function's children
+    const auto& funcRun = m_serialData.m_childRuns[body.funcRunIndex];
+    _addChildren(
+        funcRun,
+        body.startIndex,
+        Index(funcRun.m_startInstIndex) + funcRun.m_numChildren);
+    for (Index r = body.funcRunIndex + 1; r < body.endRunIndex; ++r)
+    {
+        const auto& run = m_serialData.m_childRuns[r];
+        const Index startIndex = Index(run.m_startInstIndex);
+        _addChildren(run, startIndex, startIndex + run.m_numChildren);
+    }
 
-        const Index numRuns = sourceRuns.getCount();
-        for (Index i = 0; i < numRuns; ++i)
+    // Find the first source location run that could overlap the body
+    Index runIndex = 0;
+    {
+        Index hi = m_sourceLocRuns.getCount();
+        while (runIndex < hi)
         {
-            const auto& run = sourceRuns[i];
+            const Index mid = (runIndex + hi) / 2;
+            const auto& run = m_sourceLocRuns[mid];
+            if (Index(run.m_startInstIndex) + run.m_numInst <= body.startIndex)
+                runIndex = mid + 1;
+            else
+                hi = mid;
+        }
+    }
+    Index endRunIndex = runIndex;
+    while (endRunIndex < m_sourceLocRuns.getCount() &&
+           Index(m_sourceLocRuns[endRunIndex].m_startInstIndex) < body.endIndex)
+    {
+        endRunIndex++;
+    }
+    _applySourceLocs(
+        m_sourceLocRuns.getBuffer() + runIndex,
+        endRunIndex - runIndex,
+        body.startIndex,
+        body.endIndex);
+
+    m_stats.materializedBodyCount++;
+    m_stats.materializedInstCount += body.endIndex - body.startIndex;
+
+    if (--m_deferredBodyCount == 0)
+    {
+        _releaseSerialData();
+    }
+}
+
+void IRSerialDeferredBodyLoader::_releaseSerialData()
+{
+    m_serialData = IRSerialDataView();
+    m_blobHoldingSerializedData.setNull();
+
+    m_data.clear();
+    m_data.m_insts.clearAndDeallocate();
+    m_data.m_childRuns.clearAndDeallocate();
+    m_data.m_externalOperands.clearAndDeallocate();
+    m_data.m_rawSourceLocs.clearAndDeallocate();
+    m_data.m_stringTable.clearAndDeallocate();
+    m_data.m_debugSourceLocRuns.clearAndDeallocate();
+
+    m_insts.clearAndDeallocate();
+    m_bodies.clearAndDeallocate();
+    m_bodyForFunc.clear();
+    m_sourceLocRuns.clearAndDeallocate();
+    m_stringTable.clear();
+
+    m_sourceLocReader = nullptr;
+    m_sourceLocReaderHolder.setNull();
+}
 
-            // Work out the fixed source location
-            SourceLoc sourceLoc;
-            if (run.m_sourceLoc)
+Result IRSerialDeferredBodyLoader::load(
+    IRModuleChunk const* irModuleChunk,
+    ISlangBlob* blobHoldingSerializedData,
+    Session* session,
+    SerialSourceLocReader* sourceLocReader,
+    RefPtr<IRModule>& outModule)
+{
+    // If the serialized data will stay alive, the bodies can be read from it in place.
+    IRSerialDataView view;
+    if (blobHoldingSerializedData)
+    {
+        SLANG_RETURN_ON_FAIL(IRSerialReader::readInPlace(irModuleChunk, &m_data, &view));
+        m_blobHoldingSerializedData = blobHoldingSerializedData;
+    }
+    else
+    {
+        SLANG_RETURN_ON_FAIL(IRSerialReader::readFrom(irModuleChunk, &m_data));
+        view = IRSerialDataView(m_data);
+    }
+    if (view.m_insts.getCount() < 2)
+    {
+        return SLANG_FAIL;
+    }
+    m_stats.serialDataSize = view.calcSizeInBytes();
+    m_stats.copiedSerialDataSize =
+        blobHoldingSerializedData ? m_data.calcSizeInBytes() : m_stats.serialDataSize;
+
+    RefPtr<IRModule> module;
+    SLANG_RETURN_ON_FAIL(_initialize(view, session, sourceLocReader, module));
+    m_sourceLocReaderHolder = sourceLocReader;
+
+    _findBodies();
+    _keepReferencedBodies();
+
+    // Everything outside of the deferred bodies is read the same way as `IRSerialReader::read`
+    const Index numInsts = m_serialData.m_insts.getCount();
+    for (Index i = 2; i < numInsts; ++i)
+    {
+        if (!_isDeferred(i))
+        {
+            SLANG_RETURN_ON_FAIL(_allocateInst(i));
+        }
+    }
+    for (Index i = 1; i < numInsts; ++i)
+    {
+        if (m_insts[i])
+        {
+            _patchOperands(i);
+        }
+    }
+    {
+        const Index runCount = m_serialData.m_childRuns.getCount();
+        Index nextBodyIndex = 0;
+        for (Index r = 0; r < runCount; ++r)
+        {
+            while (nextBodyIndex < m_bodies.getCount() &&
+                   (!m_bodies[nextBodyIndex].isDeferred ||
+                    m_bodies[nextBodyIndex].funcRunIndex < r))
             {
-                if (!range.contains(run.m_sourceLoc))
-                {
-                    fix = sourceLocReader->calcFixSourceLoc(run.m_sourceLoc, range);
-                }
-                sourceLoc = sourceLocReader->calcFixedLoc(run.m_sourceLoc, fix, range);
+                nextBodyIndex++;
             }
 
-            // Write to all the instructions
-            SLANG_ASSERT(Index(uint32_t(run.m_startInstIndex) + run.m_numInst) <= insts.getCount());
-            IRInst** dstInsts = insts.getBuffer() + int(run.m_startInstIndex);
-
-            const int runSize = int(run.m_numInst);
-            for (int j = 0; j < runSize; ++j)
+            const auto& run = m_serialData.m_childRuns[r];
+            const Index startIndex = Index(run.m_startInstIndex);
+            if (nextBodyIndex < m_bodies.getCount() && m_bodies[nextBodyIndex].funcRunIndex == r)
             {
-                dstInsts[j]->sourceLoc = sourceLoc;
+                // Only add the decorations of the function, and skip the rest of the body
+                const Body& body = m_bodies[nextBodyIndex];
+                _addChildren(run, startIndex, body.startIndex);
+                r = body.endRunIndex - 1;
+                continue;
             }
+            _addChildren(run, startIndex, startIndex + run.m_numChildren);
         }
     }
 
-    outModule->buildMangledNameToGlobalInstMap();
+    m_sourceLocRuns.addRange(
+        m_serialData.m_debugSourceLocRuns.getBuffer(),
+        m_serialData.m_debugSourceLocRuns.getCount());
+    m_sourceLocRuns.sort([](const Ser::SourceLocRun& a, const Ser::SourceLocRun& b)
+                         { return a.m_startInstIndex < b.m_startInstIndex; });
+    _applySourceLocs(m_sourceLocRuns.getBuffer(), m_sourceLocRuns.getCount(), 1, numInsts);
+
+    module->buildMangledNameToGlobalInstMap();
+
+    for (Index b = 0; b < m_bodies.getCount(); ++b)
+    {
+        const Body& body = m_bodies[b];
+        if (!body.isDeferred)
+        {
+            continue;
+        }
+        m_stats.deferredBodyCount++;
+        m_stats.deferredInstCount += body.endIndex - body.startIndex;
+        m_bodyForFunc.add(m_insts[body.funcIndex], b);
+        m_deferredBodyCount++;
+    }
+
+    // Only now that everything outside of the bodies has been read can the remaining
+    // bodies be checked for use of autodiff, as the checks look through global values.
+    for (Index b = 0; b < m_bodies.getCount(); ++b)
+    {
+        if (m_bodies[b].isDeferred && _bodyUsesAutodiff(m_bodies[b]))
+        {
+            _materializeBody(b);
+        }
+    }
 
+    if (m_deferredBodyCount > 0)
+    {
+        module->setDeferredBodyLoader(this);
+    }
+    else
+    {
+        _releaseSerialData();
+    }
+
+    outModule = module;
     return SLANG_OK;
 }
 
+bool IRSerialDeferredBodyLoader::hasDeferredBody(IRInst* inst)
+{
+    if (m_deferredBodyCount == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto bodyIndex = m_bodyForFunc.tryGetValue(inst))
+    {
+        return m_bodies[*bodyIndex].isDeferred;
+    }
+    return false;
+}
+
+void IRSerialDeferredBodyLoader::materializeBody(IRInst* inst)
+{
+    if (m_deferredBodyCount == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto bodyIndex = m_bodyForFunc.tryGetValue(inst))
+    {
+        _materializeBody(*bodyIndex);
+    }
+}
+
+void IRSerialDeferredBodyLoader::materializeAllBodies()
+{
+    if (m_deferredBodyCount == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Materializing the last body releases the list, so check the count each time around
+    for (Index b = 0; m_deferredBodyCount > 0 && b < m_bodies.getCount(); ++b)
+    {
+        _materializeBody(b);
+    }
+}
+
+IRDeferredBodyLoader::Stats IRSerialDeferredBodyLoader::getStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+/* static */ Result IRSerialReader::readLazily(
+    IRModuleChunk const* irModuleChunk,
+    ISlangBlob* blobHoldingSerializedData,
+    Session* session,
+    SerialSourceLocReader* sourceLocReader,
+    RefPtr<IRModule>& outModule)
+{
+    SLANG_PROFILE;
+
+    RefPtr<IRSerialDeferredBodyLoader> loader = new IRSerialDeferredBodyLoader;
+    return loader->load(
+        irModuleChunk,
+        blobHoldingSerializedData,
+        session,
+        sourceLocReader,
+        outModule);
+}
+
 } // namespace Slang
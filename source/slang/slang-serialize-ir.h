@@ -97,23 +97,77 @@ struct IRSerialReader
     /// Read a stream to fill in dataOut IRSerialData
     static Result readFrom(IRModuleChunk const* irModuleChunk, IRSerialData* outData);
 
+    /// Read a stream into `outView`, without copying the arrays where possible.
+    ///
+    /// Arrays whose data is suitably aligned are viewed in place in the stream, so the memory
+    /// holding `irModuleChunk` must outlive the view. Any other array is copied into `outData`.
+    static Result readInPlace(
+        IRModuleChunk const* irModuleChunk,
+        IRSerialData* outData,
+        IRSerialDataView* outView);
+
     /// Read a module from serial data
     Result read(
         const IRSerialData& data,
         Session* session,
         SerialSourceLocReader* sourceLocReader,
         RefPtr<IRModule>& outModule);
+    Result read(
+        const IRSerialDataView& data,
+        Session* session,
+        SerialSourceLocReader* sourceLocReader,
+        RefPtr<IRModule>& outModule);
+
+    /// Read a module from a stream, deferring the deserialization of function bodies until
+    /// they are first needed (see `IRModule::ensureBodyMaterialized`).
+    ///
+    /// All global instructions, including the functions themselves and their decorations,
+    /// are read up front, so the module's symbol table is complete. The serial data is held
+    /// by the module until every deferred body has been materialized.
+    ///
+    /// If `blobHoldingSerializedData` is set, it must hold `irModuleChunk`, and the serial
+    /// data is read in place from it (see `readInPlace`) rather than copied.
+    static Result readLazily(
+        IRModuleChunk const* irModuleChunk,
+        ISlangBlob* blobHoldingSerializedData,
+        Session* session,
+        SerialSourceLocReader* sourceLocReader,
+        RefPtr<IRModule>& outModule);
 
     IRSerialReader()
-        : m_serialData(nullptr), m_module(nullptr), m_stringTable(StringSlicePool::Style::Default)
+        : m_module(nullptr), m_stringTable(StringSlicePool::Style::Default)
     {
     }
 
 protected:
+    /// Create the module, and set up the state shared by all of the steps below
+    Result _initialize(
+        const IRSerialDataView& data,
+        Session* session,
+        SerialSourceLocReader* sourceLocReader,
+        RefPtr<IRModule>& outModule);
+
+    /// Allocate the instruction at `index`, without setting up its type, operands or parent
+    Result _allocateInst(Index index);
+    /// Set the type and operands of the instruction at `index`
+    void _patchOperands(Index index);
+    /// Add the children of `run` in the range [startIndex, endIndex) to their parent
+    void _addChildren(const Ser::InstRun& run, Index startIndex, Index endIndex);
+    /// Apply source locations to all of the allocated instructions in [startIndex, endIndex)
+    void _applySourceLocs(
+        const Ser::SourceLocRun* runs,
+        Index runCount,
+        Index startIndex,
+        Index endIndex);
+
     StringSlicePool m_stringTable;
 
-    const IRSerialData* m_serialData;
+    IRSerialDataView m_serialData;
     IRModule* m_module;
+    SerialSourceLocReader* m_sourceLocReader = nullptr;
+
+    /// The instruction for each serialized instruction index, or nullptr if not (yet) read
+    List<IRInst*> m_insts;
 };
 
 } // namespace Slang
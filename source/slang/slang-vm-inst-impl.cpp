@@ -489,6 +489,18 @@ void callHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
         memcpy(dst, src, nextParamOffset - func.m_parameterOffsets[i]);
     }
     ctx->m_currentWorkingSet = newWorkingSetPtr;
+
+    if (auto nativeFunction = ctx->getNativeFunction(func))
+    {
+        // The native code runs the callee to completion, so return to the caller right away.
+        nativeFunction(
+            newWorkingSetPtr,
+            ctx->m_moduleView.constants,
+            callerWorkingSetPtr + inst->getOperand(0).offset);
+        ctx->popFrame();
+        return;
+    }
+
     ctx->m_currentFuncCode = func.m_codeBuffer.getBuffer();
     ctx->m_currentInst = (VMExecInstHeader*)func.m_codeBuffer.getBuffer();
 }
@@ -1063,4 +1075,474 @@ VMExtFunction mapInstToFunction(
     return VMExtFunction();
 }
 
+//////// Pre-decoded and fused instructions
+
+// The target operands of a branch that was pre-decoded by `optimizeExecutableFunction` hold the
+// address of the target instruction in place of the section pointer.
+static VMExecInstHeader* getPredecodedInst(const VMExecOperand& operand)
+{
+    return reinterpret_cast<VMExecInstHeader*>(operand.section);
+}
+
+static void predecodedJumpHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
+{
+    convert(inCtx)->m_currentInst = getPredecodedInst(inst->getOperand(0));
+}
+
+static void predecodedJumpIfHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
+{
+    auto cond = *(uint32_t*)inst->getOperand(0).getPtr();
+    convert(inCtx)->m_currentInst = getPredecodedInst(inst->getOperand(cond ? 1 : 2));
+}
+
+// Each fused handler is installed on the first instruction of a sequence, and runs the
+// instructions of the sequence in order before moving on to the instruction after it.
+
+// A scalar comparison followed by a pre-decoded `JumpIf`.
+template<typename ScalarFunc, typename T>
+struct CompareAndBranchFunc
+{
+    static void run(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
+    {
+        uint32_t* dst = (uint32_t*)inst->getOperand(0).getPtr();
+        T* src1 = (T*)inst->getOperand(1).getPtr();
+        T* src2 = (T*)inst->getOperand(2).getPtr();
+        ScalarFunc::template run<uint32_t, T, T>(dst, src1, src2);
+
+        auto jumpIf = inst->getNextInst();
+        auto cond = *(uint32_t*)jumpIf->getOperand(0).getPtr();
+        convert(inCtx)->m_currentInst = getPredecodedInst(jumpIf->getOperand(cond ? 1 : 2));
+    }
+};
+
+// A `Load`, a scalar binary operation and a `Store`, such as `*p = *p + x`.
+template<typename ScalarFunc, typename T>
+struct LoadBinaryStoreFunc
+{
+    static void run(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
+    {
+        *(T*)inst->getOperand(0).getPtr() = **(T**)inst->getOperand(1).getPtr();
+
+        auto op = inst->getNextInst();
+        ScalarFunc::template run<T, T, T>(
+            (T*)op->getOperand(0).getPtr(),
+            (T*)op->getOperand(1).getPtr(),
+            (T*)op->getOperand(2).getPtr());
+
+        auto store = op->getNextInst();
+        **(T**)store->getOperand(0).getPtr() = *(T*)store->getOperand(1).getPtr();
+        convert(inCtx)->m_currentInst = store->getNextInst();
+    }
+};
+
+template<typename T>
+void getElementPtrLoadHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void* userData)
+{
+    getElementPtrHandler(inCtx, inst, userData);
+
+    auto load = inst->getNextInst();
+    *(T*)load->getOperand(0).getPtr() = **(T**)load->getOperand(1).getPtr();
+    convert(inCtx)->m_currentInst = load->getNextInst();
+}
+
+template<typename T>
+void getElementPtrStoreHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void* userData)
+{
+    getElementPtrHandler(inCtx, inst, userData);
+
+    auto store = inst->getNextInst();
+    **(T**)store->getOperand(0).getPtr() = *(T*)store->getOperand(1).getPtr();
+    convert(inCtx)->m_currentInst = store->getNextInst();
+}
+
+// A `Copy`, which usually writes a phi argument, followed by a pre-decoded `Jump`.
+template<typename T>
+void copyAndJumpHandler(IByteCodeRunner* inCtx, VMExecInstHeader* inst, void*)
+{
+    *(T*)inst->getOperand(0).getPtr() = *(T*)inst->getOperand(1).getPtr();
+
+    auto jump = inst->getNextInst();
+    convert(inCtx)->m_currentInst = getPredecodedInst(jump->getOperand(0));
+}
+
+// Get a handler for an operation on 32 or 64-bit scalars, which may be the first of a fused
+// sequence or an instruction executed in batches.
+template<
+    template<typename, typename>
+    class FusedFunc,
+    typename ScalarFunc,
+    typename TFunction = VMExtFunction>
+TFunction scalarFusedInstHandler(uint32_t extCode)
+{
+    ArithmeticExtCode arithExtCode;
+    memcpy(&arithExtCode, &extCode, sizeof(arithExtCode));
+    if (arithExtCode.vectorSize > 1)
+        return nullptr;
+    switch (arithExtCode.scalarType)
+    {
+    case kSlangByteCodeScalarTypeSignedInt:
+        switch (arithExtCode.scalarBitWidth)
+        {
+        case 2:
+            return FusedFunc<ScalarFunc, int32_t>::run;
+        case 3:
+            return FusedFunc<ScalarFunc, int64_t>::run;
+        }
+        break;
+    case kSlangByteCodeScalarTypeUnsignedInt:
+        switch (arithExtCode.scalarBitWidth)
+        {
+        case 2:
+            return FusedFunc<ScalarFunc, uint32_t>::run;
+        case 3:
+            return FusedFunc<ScalarFunc, uint64_t>::run;
+        }
+        break;
+    case kSlangByteCodeScalarTypeFloat:
+        switch (arithExtCode.scalarBitWidth)
+        {
+        case 2:
+            return FusedFunc<ScalarFunc, float>::run;
+        case 3:
+            return FusedFunc<ScalarFunc, double>::run;
+        }
+        break;
+    }
+    return nullptr;
+}
+
+static VMExtFunction getCompareAndBranchHandler(VMInstHeader* compareInst)
+{
+    auto extCode = compareInst->opcodeExtension;
+    switch (compareInst->opcode)
+    {
+    case VMOp::Less:
+        return scalarFusedInstHandler<CompareAndBranchFunc, LessScalarFunc>(extCode);
+    case VMOp::Leq:
+        return scalarFusedInstHandler<CompareAndBranchFunc, LeqScalarFunc>(extCode);
+    case VMOp::Greater:
+        return scalarFusedInstHandler<CompareAndBranchFunc, GreaterScalarFunc>(extCode);
+    case VMOp::Geq:
+        return scalarFusedInstHandler<CompareAndBranchFunc, GeqScalarFunc>(extCode);
+    case VMOp::Equal:
+        return scalarFusedInstHandler<CompareAndBranchFunc, EqualScalarFunc>(extCode);
+    case VMOp::Neq:
+        return scalarFusedInstHandler<CompareAndBranchFunc, NeqScalarFunc>(extCode);
+    default:
+        return nullptr;
+    }
+}
+
+static VMExtFunction getLoadBinaryStoreHandler(
+    VMInstHeader* loadInst,
+    VMInstHeader* opInst,
+    VMInstHeader* storeInst)
+{
+    // The loaded and stored values have to be the scalars of the operation.
+    ArithmeticExtCode arithExtCode;
+    memcpy(&arithExtCode, &opInst->opcodeExtension, sizeof(arithExtCode));
+    const uint32_t scalarSize = 1u << arithExtCode.scalarBitWidth;
+    if (loadInst->opcodeExtension != scalarSize || storeInst->opcodeExtension != scalarSize)
+        return nullptr;
+
+    auto extCode = opInst->opcodeExtension;
+    switch (opInst->opcode)
+    {
+    case VMOp::Add:
+        return scalarFusedInstHandler<LoadBinaryStoreFunc, AddScalarFunc>(extCode);
+    case VMOp::Sub:
+        return scalarFusedInstHandler<LoadBinaryStoreFunc, SubScalarFunc>(extCode);
+    case VMOp::Mul:
+        return scalarFusedInstHandler<LoadBinaryStoreFunc, MulScalarFunc>(extCode);
+    default:
+        return nullptr;
+    }
+}
+
+static VMExtFunction getElementPtrAccessHandler(VMInstHeader* accessInst)
+{
+    bool isLoad = accessInst->opcode == VMOp::Load;
+    switch (accessInst->opcodeExtension)
+    {
+    case 1:
+        return isLoad ? getElementPtrLoadHandler<uint8_t> : getElementPtrStoreHandler<uint8_t>;
+    case 2:
+        return isLoad ? getElementPtrLoadHandler<uint16_t> : getElementPtrStoreHandler<uint16_t>;
+    case 4:
+        return isLoad ? getElementPtrLoadHandler<uint32_t> : getElementPtrStoreHandler<uint32_t>;
+    case 8:
+        return isLoad ? getElementPtrLoadHandler<uint64_t> : getElementPtrStoreHandler<uint64_t>;
+    default:
+        return nullptr;
+    }
+}
+
+static VMExtFunction getCopyAndJumpHandler(VMInstHeader* copyInst)
+{
+    switch (copyInst->opcodeExtension)
+    {
+    case 4:
+        return copyAndJumpHandler<uint32_t>;
+    case 8:
+        return copyAndJumpHandler<uint64_t>;
+    default:
+        return nullptr;
+    }
+}
+
+static bool isPredecodableBranch(VMInstHeader* inst)
+{
+    uint32_t firstTarget = 0;
+    switch (inst->opcode)
+    {
+    case VMOp::Jump:
+        firstTarget = 0;
+        break;
+    case VMOp::JumpIf:
+        firstTarget = 1;
+        break;
+    default:
+        return false;
+    }
+    for (uint32_t i = firstTarget; i < inst->operandCount; i++)
+    {
+        if (inst->getOperand(i).sectionId != kSlangByteCodeSectionInsts)
+            return false;
+    }
+    return true;
+}
+
+void optimizeExecutableFunction(const VMFunctionView& func, ExecutableFunction& exeFunc)
+{
+    // The relocated instructions no longer hold their opcodes, so walk them along with the
+    // instructions they were relocated from.
+    List<VMInstHeader*> insts;
+    for (auto inst : func)
+        insts.add(inst);
+    List<VMExecInstHeader*> exeInsts;
+    for (auto inst : exeFunc)
+        exeInsts.add(inst);
+    if (insts.getCount() != exeInsts.getCount())
+        return;
+
+    // Branch targets are always in the code of the function itself, whose address doesn't
+    // change once relocated.
+    auto codeBase = (uint8_t*)exeFunc.m_codeBuffer.getBuffer();
+    List<bool> isPredecodedBranch;
+    isPredecodedBranch.setCount(insts.getCount());
+    for (Index i = 0; i < insts.getCount(); i++)
+    {
+        auto inst = insts[i];
+        isPredecodedBranch[i] = isPredecodableBranch(inst);
+        if (!isPredecodedBranch[i])
+            continue;
+
+        auto exeInst = exeInsts[i];
+        uint32_t firstTarget = inst->opcode == VMOp::Jump ? 0 : 1;
+        for (uint32_t j = firstTarget; j < inst->operandCount; j++)
+        {
+            exeInst->getOperand(j).section = (uint8_t**)(codeBase + inst->getOperand(j).offset);
+        }
+        exeInst->functionPtr =
+            inst->opcode == VMOp::Jump ? predecodedJumpHandler : predecodedJumpIfHandler;
+    }
+
+    // Only the handler of the first instruction of a sequence is replaced, so a branch to an
+    // instruction in the middle of a sequence runs the rest of it one instruction at a time.
+    for (Index i = 0; i + 1 < insts.getCount(); i++)
+    {
+        auto inst = insts[i];
+        auto next = insts[i + 1];
+        VMExtFunction fusedHandler = nullptr;
+        switch (inst->opcode)
+        {
+        case VMOp::Less:
+        case VMOp::Leq:
+        case VMOp::Greater:
+        case VMOp::Geq:
+        case VMOp::Equal:
+        case VMOp::Neq:
+            if (next->opcode == VMOp::JumpIf && isPredecodedBranch[i + 1])
+                fusedHandler = getCompareAndBranchHandler(inst);
+            break;
+        case VMOp::GetElementPtr:
+            if (next->opcode == VMOp::Load || next->opcode == VMOp::Store)
+                fusedHandler = getElementPtrAccessHandler(next);
+            break;
+        case VMOp::Load:
+            if (i + 2 < insts.getCount() && insts[i + 2]->opcode == VMOp::Store)
+                fusedHandler = getLoadBinaryStoreHandler(inst, next, insts[i + 2]);
+            break;
+        case VMOp::Copy:
+            if (next->opcode == VMOp::Jump && isPredecodedBranch[i + 1])
+                fusedHandler = getCopyAndJumpHandler(inst);
+            break;
+        default:
+            break;
+        }
+        if (fusedHandler)
+            exeInsts[i]->functionPtr = fusedHandler;
+    }
+}
+
+//////// Batched instructions
+
+template<typename ScalarFunc, typename TR, typename T>
+struct BatchedBinaryFunc
+{
+    static void run(const VMBatchContext& batch, VMExecInstHeader* inst)
+    {
+        auto dst = batch.getLaneOperand(inst->getOperand(0));
+        auto src1 = batch.getLaneOperand(inst->getOperand(1));
+        auto src2 = batch.getLaneOperand(inst->getOperand(2));
+        for (uint32_t i = 0; i < batch.laneCount; ++i)
+        {
+            auto lane = batch.lanes[i];
+            ScalarFunc::template run<TR, T, T>(
+                (TR*)dst.getPtr(lane),
+                (T*)src1.getPtr(lane),
+                (T*)src2.getPtr(lane));
+        }
+    }
+};
+
+template<typename ScalarFunc, typename T>
+struct BatchedArithmeticFunc : BatchedBinaryFunc<ScalarFunc, T, T>
+{
+};
+
+template<typename ScalarFunc, typename T>
+struct BatchedCompareFunc : BatchedBinaryFunc<ScalarFunc, uint32_t, T>
+{
+};
+
+template<typename T>
+void batchedCopyHandler(const VMBatchContext& batch, VMExecInstHeader* inst)
+{
+    auto dst = batch.getLaneOperand(inst->getOperand(0));
+    auto src = batch.getLaneOperand(inst->getOperand(1));
+    for (uint32_t i = 0; i < batch.laneCount; ++i)
+    {
+        auto lane = batch.lanes[i];
+        *(T*)dst.getPtr(lane) = *(T*)src.getPtr(lane);
+    }
+}
+
+// Get a handler that executes an instruction for all lanes of a batch, or nullptr if the
+// instruction has to execute one lane at a time.
+static VMBatchFunction mapInstToBatchFunction(VMInstHeader* inst)
+{
+    auto extCode = inst->opcodeExtension;
+    switch (inst->opcode)
+    {
+    case VMOp::Add:
+        return scalarFusedInstHandler<BatchedArithmeticFunc, AddScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Sub:
+        return scalarFusedInstHandler<BatchedArithmeticFunc, SubScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Mul:
+        return scalarFusedInstHandler<BatchedArithmeticFunc, MulScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Div:
+        return scalarFusedInstHandler<BatchedArithmeticFunc, DivScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Rem:
+        return scalarFusedInstHandler<BatchedArithmeticFunc, ModScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Less:
+        return scalarFusedInstHandler<BatchedCompareFunc, LessScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Leq:
+        return scalarFusedInstHandler<BatchedCompareFunc, LeqScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Greater:
+        return scalarFusedInstHandler<BatchedCompareFunc, GreaterScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Geq:
+        return scalarFusedInstHandler<BatchedCompareFunc, GeqScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Equal:
+        return scalarFusedInstHandler<BatchedCompareFunc, EqualScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Neq:
+        return scalarFusedInstHandler<BatchedCompareFunc, NeqScalarFunc, VMBatchFunction>(
+            extCode);
+    case VMOp::Copy:
+        switch (extCode)
+        {
+        case 4:
+            return batchedCopyHandler<uint32_t>;
+        case 8:
+            return batchedCopyHandler<uint64_t>;
+        }
+        return nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+void prepareBatchInsts(const VMFunctionView& func, ExecutableFunction& exeFunc)
+{
+    exeFunc.m_batchInsts.clear();
+
+    List<VMInstHeader*> insts;
+    for (auto inst : func)
+        insts.add(inst);
+    List<VMExecInstHeader*> exeInsts;
+    for (auto inst : exeFunc)
+        exeInsts.add(inst);
+    if (insts.getCount() != exeInsts.getCount())
+        return;
+
+    Dictionary<uint32_t, Index> mapOffsetToInstIndex;
+    for (Index i = 0; i < insts.getCount(); i++)
+        mapOffsetToInstIndex[uint32_t((uint8_t*)insts[i] - func.functionCode)] = i;
+
+    List<VMBatchInst> batchInsts;
+    for (Index i = 0; i < insts.getCount(); i++)
+    {
+        auto inst = insts[i];
+
+        VMBatchInst batchInst;
+        batchInst.inst = exeInsts[i];
+        batchInst.opcode = inst->opcode;
+        batchInst.handler = exeInsts[i]->functionPtr;
+        batchInst.batchHandler = mapInstToBatchFunction(inst);
+        batchInst.targets[0] = -1;
+        batchInst.targets[1] = -1;
+
+        switch (inst->opcode)
+        {
+        case VMOp::Call:
+        case VMOp::CallExt:
+        case VMOp::Dispatch:
+        case VMOp::Print:
+            // Calls would need a stack for each lane, and the other instructions have
+            // effects outside of the VM that have to happen in the order of invocations.
+            // Loads and stores through pointers are allowed to interleave across lanes.
+            return;
+        case VMOp::Jump:
+        case VMOp::JumpIf:
+            {
+                uint32_t firstTarget = inst->opcode == VMOp::Jump ? 0 : 1;
+                for (uint32_t j = firstTarget; j < inst->operandCount; j++)
+                {
+                    auto& operand = inst->getOperand(j);
+                    Index targetIndex = -1;
+                    if (operand.sectionId != kSlangByteCodeSectionInsts ||
+                        !mapOffsetToInstIndex.tryGetValue(operand.offset, targetIndex))
+                        return;
+                    batchInst.targets[j - firstTarget] = targetIndex;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+        batchInsts.add(batchInst);
+    }
+    exeFunc.m_batchInsts = _Move(batchInsts);
+}
+
 } // namespace Slang
@@ -6,11 +6,24 @@
 namespace Slang
 {
 
+class ExecutableFunction;
+struct VMBatchContext;
+
 slang::VMExtFunction mapInstToFunction(
     VMInstHeader* instHeader,
     VMModuleView* module,
     Dictionary<String, slang::VMExtFunction>& extInstHandlers);
 
+// Optimize a relocated function: branch targets are pre-decoded into direct instruction
+// pointers, and common instruction sequences are fused so that they execute with one
+// dispatch. `func` is the function as it was loaded, and `exeFunc` its relocated code.
+void optimizeExecutableFunction(const VMFunctionView& func, ExecutableFunction& exeFunc);
+
+// Prepare `exeFunc` for execution in batches, see `ByteCodeInterpreter::executeBatch`. This
+// must be done before `optimizeExecutableFunction`, which replaces handlers with ones that
+// execute sequences of instructions.
+void prepareBatchInsts(const VMFunctionView& func, ExecutableFunction& exeFunc);
+
 } // namespace Slang
 
 #endif
@@ -0,0 +1,375 @@
+#include "slang-vm-jit.h"
+
+#include "../compiler-core/slang-artifact-associated.h"
+#include "../compiler-core/slang-artifact-util.h"
+#include "../compiler-core/slang-downstream-compiler-util.h"
+#include "../core/slang-blob.h"
+#include "../core/slang-shared-library.h"
+
+namespace Slang
+{
+
+static const char kNativeFunctionName[] = "slangVMNativeFunction";
+
+// Declarations the translated functions are written against. slang-llvm compiles without the
+// C standard headers, and all working set accesses may alias each other.
+static const char kNativeFunctionPrelude[] = R"(
+typedef signed char vm_i8 __attribute__((may_alias));
+typedef short vm_i16 __attribute__((may_alias));
+typedef int vm_i32 __attribute__((may_alias));
+typedef long long vm_i64 __attribute__((may_alias));
+typedef unsigned char vm_u8 __attribute__((may_alias));
+typedef unsigned short vm_u16 __attribute__((may_alias));
+typedef unsigned int vm_u32 __attribute__((may_alias));
+typedef unsigned long long vm_u64 __attribute__((may_alias));
+typedef float vm_f32 __attribute__((may_alias));
+typedef double vm_f64 __attribute__((may_alias));
+typedef unsigned char* vm_ptr __attribute__((may_alias));
+)";
+
+/* static */ RefPtr<VMJITCompiler> VMJITCompiler::create()
+{
+    ComPtr<ISlangSharedLibrary> library;
+    if (SLANG_FAILED(DownstreamCompilerUtil::loadSharedLibrary(
+            String(),
+            DefaultSharedLibraryLoader::getSingleton(),
+            nullptr,
+            "slang-llvm",
+            library)))
+    {
+        return nullptr;
+    }
+
+    typedef SlangResult (
+        *CreateDownstreamCompilerFunc)(const Guid& intf, IDownstreamCompiler** outCompiler);
+    auto createCompiler =
+        (CreateDownstreamCompilerFunc)library->findFuncByName("createLLVMDownstreamCompiler_V4");
+    if (!createCompiler)
+        return nullptr;
+
+    RefPtr<VMJITCompiler> jitCompiler = new VMJITCompiler();
+    if (SLANG_FAILED(createCompiler(
+            IDownstreamCompiler::getTypeGuid(),
+            jitCompiler->m_compiler.writeRef())))
+    {
+        return nullptr;
+    }
+    jitCompiler->m_llvmLibrary = library;
+    return jitCompiler;
+}
+
+// Get the C type of the elements of an arithmetic instruction, as selected by the handlers in
+// `mapInstToFunction`.
+static const char* _getScalarTypeName(uint32_t scalarType, uint32_t scalarBitWidth)
+{
+    static const char* const kIntTypes[] = {"vm_i8", "vm_i16", "vm_i32", "vm_i64"};
+    static const char* const kUIntTypes[] = {"vm_u8", "vm_u16", "vm_u32", "vm_u64"};
+    switch (scalarType)
+    {
+    case kSlangByteCodeScalarTypeSignedInt:
+        return kIntTypes[scalarBitWidth];
+    case kSlangByteCodeScalarTypeUnsignedInt:
+        return kUIntTypes[scalarBitWidth];
+    case kSlangByteCodeScalarTypeFloat:
+        switch (scalarBitWidth)
+        {
+        case 2:
+            return "vm_f32";
+        case 3:
+            return "vm_f64";
+        }
+        break;
+    }
+    return nullptr;
+}
+
+static const char* _getUnsignedTypeName(uint32_t scalarBitWidth)
+{
+    return _getScalarTypeName(kSlangByteCodeScalarTypeUnsignedInt, scalarBitWidth);
+}
+
+// Get the C type to compute integer arithmetic that wraps around in. Signed overflow is
+// undefined in C, and would let the compiled code differ from the interpreter's wrapping
+// results, so the arithmetic is done on an unsigned type that isn't promoted to `int`, and the
+// result converted back.
+static const char* _getWrappingTypeName(uint32_t scalarType, uint32_t scalarBitWidth)
+{
+    if (scalarType == kSlangByteCodeScalarTypeFloat)
+        return nullptr;
+    return scalarBitWidth == 3 ? "vm_u64" : "vm_u32";
+}
+
+// Get the C expression for the address of `operand`, offset by `offset` bytes. Returns an empty
+// string for operands the translated function has no access to.
+static String _getOperandAddress(const VMOperand& operand, uint32_t offset = 0)
+{
+    StringBuilder sb;
+    switch (operand.sectionId)
+    {
+    case kSlangByteCodeSectionWorkingSet:
+        sb << "(ws + " << operand.offset + offset << ")";
+        break;
+    case kSlangByteCodeSectionConstants:
+        sb << "(constants + " << operand.offset + offset << ")";
+        break;
+    }
+    return sb.produceString();
+}
+
+// Emit an element-wise binary operation. The result has the type of the operands, except for
+// comparisons, whose result elements are `uint32_t`. If `computeType` is set, the operands are
+// converted to it for the operation.
+static bool _emitBinaryArithmetic(
+    StringBuilder& out,
+    VMInstHeader* inst,
+    const char* operandType,
+    const char* op,
+    bool isComparison = false,
+    const char* computeType = nullptr)
+{
+    ArithmeticExtCode extCode;
+    memcpy(&extCode, &inst->opcodeExtension, sizeof(extCode));
+    if (!operandType)
+        return false;
+
+    const char* resultType = isComparison ? "vm_u32" : operandType;
+    const uint32_t operandSize = 1u << extCode.scalarBitWidth;
+    const uint32_t resultSize = isComparison ? uint32_t(sizeof(uint32_t)) : operandSize;
+    const uint32_t elementCount = Math::Max(uint32_t(extCode.vectorSize), 1u);
+    for (uint32_t i = 0; i < elementCount; i++)
+    {
+        auto dst = _getOperandAddress(inst->getOperand(0), i * resultSize);
+        auto src1 = _getOperandAddress(inst->getOperand(1), i * operandSize);
+        auto src2 = _getOperandAddress(inst->getOperand(2), i * operandSize);
+        if (!dst.getLength() || !src1.getLength() || !src2.getLength())
+            return false;
+
+        out << "    *(" << resultType << "*)" << dst << " = (" << resultType << ")";
+        if (UnownedStringSlice(op) == "fmod")
+        {
+            out << (extCode.scalarBitWidth == 2 ? "__builtin_fmodf" : "__builtin_fmod") << "(*("
+                << operandType << "*)" << src1 << ", *(" << operandType << "*)" << src2 << ");\n";
+        }
+        else
+        {
+            const char* cast = computeType ? computeType : operandType;
+            out << "((" << cast << ")*(" << operandType << "*)" << src1 << " " << op << " ("
+                << cast << ")*(" << operandType << "*)" << src2 << ");\n";
+        }
+    }
+    return true;
+}
+
+static bool _emitUnaryArithmetic(
+    StringBuilder& out,
+    VMInstHeader* inst,
+    const char* type,
+    const char* op,
+    const char* computeType = nullptr)
+{
+    ArithmeticExtCode extCode;
+    memcpy(&extCode, &inst->opcodeExtension, sizeof(extCode));
+    if (!type)
+        return false;
+
+    const uint32_t elementSize = 1u << extCode.scalarBitWidth;
+    const uint32_t elementCount = Math::Max(uint32_t(extCode.vectorSize), 1u);
+    for (uint32_t i = 0; i < elementCount; i++)
+    {
+        auto dst = _getOperandAddress(inst->getOperand(0), i * elementSize);
+        auto src = _getOperandAddress(inst->getOperand(1), i * elementSize);
+        if (!dst.getLength() || !src.getLength())
+            return false;
+        out << "    *(" << type << "*)" << dst << " = (" << type << ")(" << op << "("
+            << (computeType ? computeType : type) << ")*(" << type << "*)" << src << ");\n";
+    }
+    return true;
+}
+
+// Emit the C statements for `inst`, following the semantics of its interpreter handler.
+static bool _emitInst(StringBuilder& out, VMInstHeader* inst, uint32_t& ioReturnValueSize)
+{
+    ArithmeticExtCode extCode;
+    memcpy(&extCode, &inst->opcodeExtension, sizeof(extCode));
+    const bool isFloat = extCode.scalarType == kSlangByteCodeScalarTypeFloat;
+    const auto arithmeticType = _getScalarTypeName(extCode.scalarType, extCode.scalarBitWidth);
+    const auto intType = isFloat ? nullptr : arithmeticType;
+    const auto unsignedType = _getUnsignedTypeName(extCode.scalarBitWidth);
+    const auto negType =
+        isFloat ? arithmeticType
+                : _getScalarTypeName(kSlangByteCodeScalarTypeSignedInt, extCode.scalarBitWidth);
+    const auto wrappingType = _getWrappingTypeName(extCode.scalarType, extCode.scalarBitWidth);
+
+    switch (inst->opcode)
+    {
+    case VMOp::Nop:
+        return true;
+    case VMOp::Add:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "+", false, wrappingType);
+    case VMOp::Sub:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "-", false, wrappingType);
+    case VMOp::Mul:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "*", false, wrappingType);
+    case VMOp::Div:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "/");
+    case VMOp::Rem:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, isFloat ? "fmod" : "%");
+    case VMOp::And:
+        return _emitBinaryArithmetic(out, inst, unsignedType, "&&");
+    case VMOp::Or:
+        return _emitBinaryArithmetic(out, inst, unsignedType, "||");
+    case VMOp::BitAnd:
+        return _emitBinaryArithmetic(out, inst, unsignedType, "&");
+    case VMOp::BitOr:
+        return _emitBinaryArithmetic(out, inst, unsignedType, "|");
+    case VMOp::BitXor:
+        return _emitBinaryArithmetic(out, inst, unsignedType, "^");
+    case VMOp::Shl:
+        return _emitBinaryArithmetic(out, inst, intType, "<<", false, wrappingType);
+    case VMOp::Shr:
+        return _emitBinaryArithmetic(out, inst, intType, ">>");
+    case VMOp::Less:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "<", true);
+    case VMOp::Leq:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "<=", true);
+    case VMOp::Greater:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, ">", true);
+    case VMOp::Geq:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, ">=", true);
+    case VMOp::Equal:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "==", true);
+    case VMOp::Neq:
+        return _emitBinaryArithmetic(out, inst, arithmeticType, "!=", true);
+    case VMOp::Neg:
+        return _emitUnaryArithmetic(out, inst, negType, "-", wrappingType);
+    case VMOp::Not:
+        return _emitUnaryArithmetic(out, inst, unsignedType, "!");
+    case VMOp::BitNot:
+        return _emitUnaryArithmetic(out, inst, intType, "~");
+    default:
+        break;
+    }
+
+    // The remaining instructions take operands of any type.
+    String operands[3];
+    for (uint32_t i = 0; i < inst->operandCount && i < 3; i++)
+    {
+        if (inst->getOperand(i).sectionId == kSlangByteCodeSectionInsts)
+            continue;
+        operands[i] = _getOperandAddress(inst->getOperand(i));
+        if (!operands[i].getLength())
+            return false;
+    }
+    const uint32_t size = inst->opcodeExtension;
+
+    switch (inst->opcode)
+    {
+    case VMOp::Ret:
+        if (size)
+        {
+            out << "    __builtin_memcpy(returnValue, " << operands[0] << ", " << size << "u);\n";
+            ioReturnValueSize = Math::Max(ioReturnValueSize, size);
+        }
+        out << "    return " << size << "u;\n";
+        return true;
+    case VMOp::Jump:
+        out << "    goto L" << inst->getOperand(0).offset << ";\n";
+        return true;
+    case VMOp::JumpIf:
+        out << "    if (*(vm_u32*)" << operands[0] << ") goto L" << inst->getOperand(1).offset
+            << "; else goto L" << inst->getOperand(2).offset << ";\n";
+        return true;
+    case VMOp::Load:
+        out << "    __builtin_memcpy(" << operands[0] << ", *(vm_ptr*)" << operands[1] << ", "
+            << size << "u);\n";
+        return true;
+    case VMOp::Store:
+        out << "    __builtin_memcpy(*(vm_ptr*)" << operands[0] << ", " << operands[1] << ", "
+            << size << "u);\n";
+        return true;
+    case VMOp::Copy:
+        out << "    __builtin_memcpy(" << operands[0] << ", " << operands[1] << ", " << size
+            << "u);\n";
+        return true;
+    case VMOp::GetWorkingSetPtr:
+        out << "    *(vm_ptr*)" << operands[0] << " = ws + " << size << "u;\n";
+        return true;
+    case VMOp::GetElementPtr:
+        out << "    *(vm_ptr*)" << operands[0] << " = *(vm_ptr*)" << operands[1]
+            << " + (vm_u32)(*(vm_u32*)" << operands[2] << " * " << size << "u);\n";
+        return true;
+    case VMOp::OffsetPtr:
+        out << "    *(vm_ptr*)" << operands[0] << " = *(vm_ptr*)" << operands[1]
+            << " + (vm_u32)(*(vm_i32*)" << operands[2] << " * " << size << "u);\n";
+        return true;
+    case VMOp::GetElement:
+        out << "    __builtin_memcpy(" << operands[0] << ", " << operands[1]
+            << " + (vm_u32)(*(vm_u32*)" << operands[2] << " * " << size << "u), " << size
+            << "u);\n";
+        return true;
+    default:
+        // Calls need the interpreter's stack, and the other instructions aren't translated yet.
+        return false;
+    }
+}
+
+/* static */ SlangResult VMJITCompiler::emitFunctionSource(
+    const VMFunctionView& func,
+    const char* name,
+    StringBuilder& out,
+    uint32_t& outReturnValueSize)
+{
+    outReturnValueSize = 0;
+    out << kNativeFunctionPrelude;
+    out << "unsigned int " << name
+        << "(vm_u8* ws, const vm_u8* constants, vm_u8* returnValue)\n{\n";
+    for (auto inst : func)
+    {
+        // Every instruction gets a label, since branch targets are byte offsets into the code.
+        out << "L" << uint32_t((uint8_t*)inst - func.functionCode) << ":;\n";
+        if (!_emitInst(out, inst, outReturnValueSize))
+            return SLANG_E_NOT_IMPLEMENTED;
+    }
+    out << "    return 0u;\n}\n";
+    return SLANG_OK;
+}
+
+SlangResult VMJITCompiler::compileFunction(
+    const VMFunctionView& func,
+    ComPtr<ISlangSharedLibrary>& outLibrary,
+    VMNativeFunction& outFunction,
+    uint32_t& outReturnValueSize)
+{
+    StringBuilder source;
+    SLANG_RETURN_ON_FAIL(
+        emitFunctionSource(func, kNativeFunctionName, source, outReturnValueSize));
+
+    auto sourceArtifact = ArtifactUtil::createArtifact(
+        ArtifactDesc::make(ArtifactKind::Source, ArtifactPayload::C, ArtifactStyle::Unknown));
+    sourceArtifact->addRepresentationUnknown(StringBlob::moveCreate(source));
+    sourceArtifact->setName(func.name);
+
+    DownstreamCompileOptions options;
+    options.sourceLanguage = SLANG_SOURCE_LANGUAGE_C;
+    options.targetType = SLANG_SHADER_HOST_CALLABLE;
+    options.flags = 0;
+    options.debugInfoType = DownstreamCompileOptions::DebugInfoType::None;
+    options.sourceArtifacts = makeSlice(sourceArtifact.readRef(), 1);
+
+    ComPtr<IArtifact> artifact;
+    SLANG_RETURN_ON_FAIL(m_compiler->compile(options, artifact.writeRef()));
+    if (auto diagnostics = findAssociatedRepresentation<IArtifactDiagnostics>(artifact))
+        SLANG_RETURN_ON_FAIL(diagnostics->getResult());
+
+    ComPtr<ISlangSharedLibrary> library;
+    SLANG_RETURN_ON_FAIL(artifact->loadSharedLibrary(ArtifactKeep::Yes, library.writeRef()));
+    auto function = (VMNativeFunction)library->findFuncByName(kNativeFunctionName);
+    if (!function)
+        return SLANG_FAIL;
+
+    outLibrary = library;
+    outFunction = function;
+    return SLANG_OK;
+}
+
+} // namespace Slang
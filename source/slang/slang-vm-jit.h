@@ -0,0 +1,50 @@
+#ifndef SLANG_VM_JIT_H
+#define SLANG_VM_JIT_H
+
+#include "../compiler-core/slang-downstream-compiler.h"
+#include "slang-vm-bytecode.h"
+
+namespace Slang
+{
+
+// A byte code function compiled to native code. It runs the function to completion on the
+// working set `workingSet`, copies the return value, if any, to `returnValue` and returns its
+// size in bytes.
+typedef uint32_t (*VMNativeFunction)(void* workingSet, const void* constants, void* returnValue);
+
+// Compiles byte code functions to native code with slang-llvm, so that functions the
+// interpreter runs often don't pay the dispatch cost of each instruction.
+//
+// Functions are translated to C, which slang-llvm lowers to LLVM IR and compiles with its JIT.
+// Only functions that don't call other functions and don't use swizzles, casts or prints can be
+// translated. Other functions keep running in the interpreter.
+class VMJITCompiler : public RefObject
+{
+public:
+    // Load slang-llvm. Returns nullptr if it isn't available.
+    static RefPtr<VMJITCompiler> create();
+
+    // Write C source for `func` that defines a `VMNativeFunction` called `name`. Fails if `func`
+    // uses instructions that can't be translated. `outReturnValueSize` is set to the size of the
+    // largest value the function returns.
+    static SlangResult emitFunctionSource(
+        const VMFunctionView& func,
+        const char* name,
+        StringBuilder& out,
+        uint32_t& outReturnValueSize);
+
+    // Compile `func` to native code. The function stays valid as long as `outLibrary` is alive.
+    SlangResult compileFunction(
+        const VMFunctionView& func,
+        ComPtr<ISlangSharedLibrary>& outLibrary,
+        VMNativeFunction& outFunction,
+        uint32_t& outReturnValueSize);
+
+protected:
+    ComPtr<ISlangSharedLibrary> m_llvmLibrary;
+    ComPtr<IDownstreamCompiler> m_compiler;
+};
+
+} // namespace Slang
+
+#endif
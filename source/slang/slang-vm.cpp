@@ -17,6 +17,10 @@ ISlangUnknown* ByteCodeInterpreter::getInterface(const Guid& guid)
 {
     if (guid == ISlangUnknown::getTypeGuid() || guid == IByteCodeRunner::getTypeGuid())
         return static_cast<IByteCodeRunner*>(this);
+    if (guid == IByteCodeDispatchRunner::getTypeGuid())
+        return static_cast<IByteCodeDispatchRunner*>(this);
+    if (guid == IByteCodeBatchRunner::getTypeGuid())
+        return static_cast<IByteCodeBatchRunner*>(this);
 
     return nullptr;
 }
@@ -86,6 +90,10 @@ SlangResult ByteCodeInterpreter::prepareModuleForExecution()
                 }
             }
         }
+
+        prepareBatchInsts(func, exeFunc);
+        if (m_enableOptimizations)
+            optimizeExecutableFunction(func, exeFunc);
     }
 
     return SLANG_OK;
@@ -98,6 +106,7 @@ SLANG_NO_THROW SlangResult SLANG_MCALL ByteCodeInterpreter::loadModule(IBlob* mo
     m_currentWorkingSet = m_workingSetBuffer.getBuffer();
 
     m_errorBuilder.clear();
+    m_dispatchContexts.clear();
     m_code.addRange((uint8_t*)(moduleBlob->getBufferPointer()), moduleBlob->getBufferSize());
     SLANG_RETURN_ON_FAIL(
         initVMModule(m_code.getBuffer(), (uint32_t)moduleBlob->getBufferSize(), &m_moduleView));
@@ -153,6 +162,7 @@ ByteCodeInterpreter::selectFunctionByIndex(uint32_t functionIndex)
     m_currentInst = reinterpret_cast<VMExecInstHeader*>(m_currentFuncCode);
     m_workingSetBuffer.setCount(func.header->workingSetSizeInBytes / sizeof(uint64_t));
     m_currentWorkingSet = m_workingSetBuffer.getBuffer();
+    m_selectedFunctionIndex = Index(functionIndex);
     return SLANG_OK;
 }
 
@@ -181,6 +191,27 @@ ByteCodeInterpreter::execute(void* argumentData, size_t argumentSize)
         memcpy(m_currentWorkingSet, argumentData, argumentSize);
     }
     m_returnValSize = 0;
+
+    if (m_stack.getCount() == 0 && m_selectedFunctionIndex >= 0)
+    {
+        auto& func = m_functions[m_selectedFunctionIndex];
+        if (m_currentInst == (VMExecInstHeader*)func.m_codeBuffer.getBuffer())
+        {
+            if (auto nativeFunction = getNativeFunction(func))
+            {
+                m_returnRegister.setCount(func.m_nativeReturnValueSize);
+                const uint32_t returnValueSize = nativeFunction(
+                    m_currentWorkingSet,
+                    m_moduleView.constants,
+                    m_returnRegister.getBuffer());
+                if (returnValueSize)
+                    m_returnValSize = returnValueSize;
+                m_currentInst = nullptr;
+                return SLANG_OK;
+            }
+        }
+    }
+
     while (m_currentInst)
     {
         auto nextInst = m_currentInst->getNextInst();
@@ -191,6 +222,374 @@ ByteCodeInterpreter::execute(void* argumentData, size_t argumentSize)
     return SLANG_OK;
 }
 
+VMNativeFunction ByteCodeInterpreter::getNativeFunction(
+    ExecutableFunction& func,
+    uint32_t invocationCount)
+{
+    if (func.m_nativeFunction || !func.m_canCompile || m_jitInvocationThreshold == 0)
+        return func.m_nativeFunction;
+
+    func.m_invocationCount += Math::Min(invocationCount, m_jitInvocationThreshold);
+    if (func.m_invocationCount < m_jitInvocationThreshold)
+        return nullptr;
+
+    // Compilation is only tried once. When it fails, the function keeps running in the
+    // interpreter.
+    func.m_canCompile = false;
+    if (!m_jitCompiler && !m_isJITCompilerUnavailable)
+    {
+        m_jitCompiler = VMJITCompiler::create();
+        m_isJITCompilerUnavailable = !m_jitCompiler;
+    }
+    if (!m_jitCompiler)
+        return nullptr;
+
+    auto funcView = m_moduleView.getFunction(Index(&func - m_functions.getBuffer()));
+    if (SLANG_FAILED(m_jitCompiler->compileFunction(
+            funcView,
+            func.m_nativeLibrary,
+            func.m_nativeFunction,
+            func.m_nativeReturnValueSize)))
+    {
+        func.m_nativeFunction = nullptr;
+        func.m_nativeLibrary = nullptr;
+    }
+    return func.m_nativeFunction;
+}
+
+VMLaneOperand VMBatchContext::getLaneOperand(const VMExecOperand& operand) const
+{
+    VMLaneOperand result;
+    if (operand.section == (uint8_t**)&interpreter->m_currentWorkingSet)
+    {
+        result.base = workingSets + operand.offset;
+        result.laneStride = workingSetStride;
+    }
+    else
+    {
+        result.base = (uint8_t*)operand.getPtr();
+        result.laneStride = 0;
+    }
+    return result;
+}
+
+// The most lanes that execute in lockstep, which bounds the memory used for working sets.
+static const uint32_t kMaxLockstepLaneCount = 64;
+
+SLANG_NO_THROW SlangResult SLANG_MCALL ByteCodeInterpreter::executeBatch(
+    const void* argumentData,
+    size_t argumentSize,
+    size_t argumentStride,
+    uint32_t invocationCount,
+    void* outReturnValues)
+{
+    if (m_selectedFunctionIndex < 0)
+    {
+        reportError("No function selected for execution");
+        return SLANG_FAIL;
+    }
+    const uint32_t functionIndex = uint32_t(m_selectedFunctionIndex);
+    auto& func = m_functions[m_selectedFunctionIndex];
+    const size_t returnValueSize = func.m_header->returnValueSizeInBytes;
+    auto args = (const uint8_t*)argumentData;
+    auto returnValues = (uint8_t*)outReturnValues;
+
+    if (func.m_batchInsts.getCount() == 0 || getNativeFunction(func, invocationCount))
+    {
+        // The function can't run in lockstep, or it runs faster as native code, so run the
+        // invocations one after another.
+        for (uint32_t i = 0; i < invocationCount; i++)
+        {
+            SLANG_RETURN_ON_FAIL(selectFunctionByIndex(functionIndex));
+            SLANG_RETURN_ON_FAIL(
+                execute(args ? (void*)(args + i * argumentStride) : nullptr, argumentSize));
+            if (returnValues && m_returnValSize)
+            {
+                memcpy(
+                    returnValues + i * returnValueSize,
+                    m_returnRegister.getBuffer(),
+                    Math::Min(m_returnValSize, returnValueSize));
+            }
+        }
+        return selectFunctionByIndex(functionIndex);
+    }
+
+    if (argumentSize > func.m_header->workingSetSizeInBytes)
+    {
+        reportError("Argument size exceeds working set.");
+        return SLANG_FAIL;
+    }
+    for (uint32_t first = 0; first < invocationCount; first += kMaxLockstepLaneCount)
+    {
+        _executeLockstep(
+            func,
+            args ? args + first * argumentStride : nullptr,
+            argumentSize,
+            argumentStride,
+            Math::Min(kMaxLockstepLaneCount, invocationCount - first),
+            returnValues ? returnValues + first * returnValueSize : nullptr);
+    }
+    return selectFunctionByIndex(functionIndex);
+}
+
+void ByteCodeInterpreter::_executeLockstep(
+    ExecutableFunction& func,
+    const uint8_t* argumentData,
+    size_t argumentSize,
+    size_t argumentStride,
+    uint32_t laneCount,
+    uint8_t* outReturnValues)
+{
+    // Each lane has its own working set and its own instruction. At each step, the lanes at
+    // the earliest instruction execute it together, so lanes that took different branches
+    // execute together again from where the branches join.
+    //
+    // Accesses to memory outside of the working sets therefore interleave across lanes, which
+    // is documented on `IByteCodeBatchRunner::executeBatch`. Instructions whose effects are
+    // visible outside of the VM are excluded by `prepareBatchInsts`.
+    const size_t workingSetStride = (func.m_header->workingSetSizeInBytes + 7) & ~size_t(7);
+    const size_t returnValueSize = func.m_header->returnValueSizeInBytes;
+
+    List<uint64_t> workingSetBuffer;
+    workingSetBuffer.setCount(laneCount * workingSetStride / sizeof(uint64_t));
+    auto workingSets = (uint8_t*)workingSetBuffer.getBuffer();
+    if (argumentData && argumentSize > 0)
+    {
+        for (uint32_t lane = 0; lane < laneCount; lane++)
+        {
+            memcpy(
+                workingSets + lane * workingSetStride,
+                argumentData + lane * argumentStride,
+                argumentSize);
+        }
+    }
+
+    List<Index> laneInstIndices;
+    laneInstIndices.setCount(laneCount);
+    List<uint32_t> activeLanes;
+    for (uint32_t lane = 0; lane < laneCount; lane++)
+    {
+        laneInstIndices[lane] = 0;
+        activeLanes.add(lane);
+    }
+    List<uint32_t> stepLanes;
+
+    VMBatchContext batch;
+    batch.interpreter = this;
+    batch.workingSets = workingSets;
+    batch.workingSetStride = workingSetStride;
+    m_currentFuncCode = func.m_codeBuffer.getBuffer();
+
+    const Index instCount = func.m_batchInsts.getCount();
+    while (activeLanes.getCount())
+    {
+        Index instIndex = laneInstIndices[activeLanes[0]];
+        for (auto lane : activeLanes)
+            instIndex = Math::Min(instIndex, laneInstIndices[lane]);
+
+        stepLanes.clear();
+        for (auto lane : activeLanes)
+        {
+            if (laneInstIndices[lane] == instIndex)
+                stepLanes.add(lane);
+        }
+        batch.lanes = stepLanes.getBuffer();
+        batch.laneCount = uint32_t(stepLanes.getCount());
+
+        bool hasFinishedLanes = false;
+        if (instIndex >= instCount)
+        {
+            // Lanes that run past the end of the function are finished.
+            for (auto lane : stepLanes)
+                laneInstIndices[lane] = -1;
+            hasFinishedLanes = true;
+        }
+        else
+        {
+            auto& batchInst = func.m_batchInsts[instIndex];
+            auto inst = batchInst.inst;
+            switch (batchInst.opcode)
+            {
+            case VMOp::Jump:
+                for (auto lane : stepLanes)
+                    laneInstIndices[lane] = batchInst.targets[0];
+                break;
+            case VMOp::JumpIf:
+                {
+                    auto cond = batch.getLaneOperand(inst->getOperand(0));
+                    for (auto lane : stepLanes)
+                    {
+                        laneInstIndices[lane] = *(uint32_t*)cond.getPtr(lane)
+                                                    ? batchInst.targets[0]
+                                                    : batchInst.targets[1];
+                    }
+                }
+                break;
+            case VMOp::Ret:
+                {
+                    const size_t valueSize =
+                        Math::Min(size_t(inst->opcodeExtension), returnValueSize);
+                    VMLaneOperand value = {};
+                    if (valueSize)
+                        value = batch.getLaneOperand(inst->getOperand(0));
+                    for (auto lane : stepLanes)
+                    {
+                        if (outReturnValues && valueSize)
+                        {
+                            memcpy(
+                                outReturnValues + lane * returnValueSize,
+                                value.getPtr(lane),
+                                valueSize);
+                        }
+                        laneInstIndices[lane] = -1;
+                    }
+                    hasFinishedLanes = true;
+                }
+                break;
+            default:
+                if (batchInst.batchHandler)
+                {
+                    batchInst.batchHandler(batch, inst);
+                }
+                else
+                {
+                    for (auto lane : stepLanes)
+                    {
+                        m_currentWorkingSet = workingSets + lane * workingSetStride;
+                        batchInst.handler(this, inst, m_extInstHandlerUserData);
+                    }
+                }
+                for (auto lane : stepLanes)
+                    laneInstIndices[lane]++;
+                break;
+            }
+        }
+
+        if (hasFinishedLanes)
+        {
+            Index activeCount = 0;
+            for (auto lane : activeLanes)
+            {
+                if (laneInstIndices[lane] >= 0)
+                    activeLanes[activeCount++] = lane;
+            }
+            activeLanes.setCount(activeCount);
+        }
+    }
+}
+
+SlangResult ByteCodeInterpreter::_initDispatchContext(ByteCodeInterpreter* source)
+{
+    // The module code stays owned by `source`, which outlives its dispatch contexts.
+    m_moduleView = source->m_moduleView;
+    m_enableOptimizations = source->m_enableOptimizations;
+    m_extInstHandlers = source->m_extInstHandlers;
+    m_stack.reserve(128);
+    return prepareModuleForExecution();
+}
+
+SLANG_NO_THROW SlangResult SLANG_MCALL ByteCodeInterpreter::dispatch(
+    const uint32_t groupCount[3],
+    const void* argumentData,
+    size_t argumentSize,
+    uint32_t threadCount)
+{
+    if (m_selectedFunctionIndex < 0)
+    {
+        reportError("No function selected for execution");
+        return SLANG_FAIL;
+    }
+    const uint32_t functionIndex = uint32_t(m_selectedFunctionIndex);
+    auto& func = m_functions[m_selectedFunctionIndex];
+    const size_t groupIDSize = sizeof(uint32_t) * 3;
+    if (func.m_header->parameterCount == 0 ||
+        func.m_parameterOffsets[1] - func.m_parameterOffsets[0] < groupIDSize)
+    {
+        reportError("The first parameter of a dispatched function must be a uint3 group ID.");
+        return SLANG_FAIL;
+    }
+    const size_t groupIDOffset = func.m_parameterOffsets[0];
+
+    const uint64_t groupTotal = uint64_t(groupCount[0]) * groupCount[1] * groupCount[2];
+    if (groupTotal == 0)
+        return SLANG_OK;
+
+    // Functions are compiled to native code here rather than by the dispatch contexts, so each
+    // is compiled once.
+    getNativeFunction(func, uint32_t(Math::Min(groupTotal, uint64_t(0xffffffff))));
+
+    Count workerCount = threadCount ? Count(threadCount) : ThreadPool::getHardwareThreadCount();
+    if (uint64_t(workerCount) > groupTotal)
+        workerCount = Count(groupTotal);
+    if (!m_threadPool || m_threadPool->getThreadCount() != workerCount)
+        m_threadPool = new ThreadPool(workerCount);
+
+    while (m_dispatchContexts.getCount() < workerCount)
+    {
+        RefPtr<ByteCodeInterpreter> context = new ByteCodeInterpreter();
+        if (SLANG_FAILED(context->_initDispatchContext(this)))
+        {
+            m_errorBuilder.append(context->m_errorBuilder);
+            return SLANG_FAIL;
+        }
+        m_dispatchContexts.add(context);
+    }
+    for (auto& context : m_dispatchContexts)
+    {
+        context->m_extInstHandlerUserData = m_extInstHandlerUserData;
+        context->m_printCallback = m_printCallback;
+        context->m_printCallbackUserData = m_printCallbackUserData;
+        for (Index i = 0; i < m_functions.getCount(); i++)
+        {
+            auto& contextFunc = context->m_functions[i];
+            contextFunc.m_nativeFunction = m_functions[i].m_nativeFunction;
+            contextFunc.m_nativeLibrary = m_functions[i].m_nativeLibrary;
+            contextFunc.m_nativeReturnValueSize = m_functions[i].m_nativeReturnValueSize;
+        }
+    }
+
+    // Each worker runs groups on its own context until none are left, so workers that get
+    // cheap groups take more of them.
+    std::atomic<uint64_t> nextGroup = 0;
+    std::atomic<bool> failed = false;
+    m_threadPool->parallelFor(
+        workerCount,
+        [&](Index worker)
+        {
+            auto context = m_dispatchContexts[worker];
+            List<uint8_t> arguments;
+            arguments.setCount(Math::Max(argumentSize, groupIDOffset + groupIDSize));
+            memset(arguments.getBuffer(), 0, arguments.getCount());
+            if (argumentData && argumentSize > 0)
+                memcpy(arguments.getBuffer(), argumentData, argumentSize);
+            auto groupID = (uint32_t*)(arguments.getBuffer() + groupIDOffset);
+
+            for (uint64_t group = nextGroup++; group < groupTotal && !failed;
+                 group = nextGroup++)
+            {
+                groupID[0] = uint32_t(group % groupCount[0]);
+                groupID[1] = uint32_t(group / groupCount[0] % groupCount[1]);
+                groupID[2] = uint32_t(group / (uint64_t(groupCount[0]) * groupCount[1]));
+                if (SLANG_FAILED(context->selectFunctionByIndex(functionIndex)) ||
+                    SLANG_FAILED(context->execute(arguments.getBuffer(), arguments.getCount())))
+                {
+                    failed = true;
+                }
+            }
+        });
+
+    if (failed)
+    {
+        for (auto& context : m_dispatchContexts)
+        {
+            m_errorBuilder.append(context->m_errorBuilder);
+            context->m_errorBuilder.clear();
+        }
+        return SLANG_FAIL;
+    }
+    return SLANG_OK;
+}
+
 ByteCodeInterpreter::ByteCodeInterpreter()
 {
     m_printCallback = defaultPrintCallback;
@@ -233,8 +632,19 @@ SLANG_EXTERN_C SLANG_API SlangResult slang_createByteCodeRunner(
     const slang::ByteCodeRunnerDesc* desc,
     slang::IByteCodeRunner** outByteCodeRunner)
 {
-    SLANG_UNUSED(desc);
     Slang::RefPtr<Slang::ByteCodeInterpreter> runner = new Slang::ByteCodeInterpreter();
+    const size_t enableOptimizationsEnd =
+        SLANG_OFFSET_OF(slang::ByteCodeRunnerDesc, enableOptimizations) + sizeof(bool);
+    if (desc && desc->structSize >= enableOptimizationsEnd)
+    {
+        runner->m_enableOptimizations = desc->enableOptimizations;
+    }
+    const size_t jitInvocationThresholdEnd =
+        SLANG_OFFSET_OF(slang::ByteCodeRunnerDesc, jitInvocationThreshold) + sizeof(uint32_t);
+    if (desc && desc->structSize >= jitInvocationThresholdEnd)
+    {
+        runner->m_jitInvocationThreshold = desc->jitInvocationThreshold;
+    }
     *outByteCodeRunner = static_cast<slang::IByteCodeRunner*>(runner.detach());
     return SLANG_OK;
 }
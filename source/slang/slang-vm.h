@@ -2,7 +2,9 @@
 #define SLANG_VM_H
 
 #include "core/slang-string-util.h"
+#include "core/slang-thread-pool.h"
 #include "slang-vm-bytecode.h"
+#include "slang-vm-jit.h"
 
 using namespace slang;
 
@@ -17,6 +19,44 @@ struct ByteCodeExecutionContext
 
 class ByteCodeInterpreter;
 
+// The address of an operand in each lane of a batch. Operands in the working set have an
+// address per lane, and other operands have the same address in all lanes.
+struct VMLaneOperand
+{
+    uint8_t* base;
+    size_t laneStride;
+    void* getPtr(uint32_t lane) const { return base + lane * laneStride; }
+};
+
+// The lanes of a batch that execute an instruction together, see
+// `ByteCodeInterpreter::executeBatch`.
+struct VMBatchContext
+{
+    ByteCodeInterpreter* interpreter;
+    uint8_t* workingSets;
+    size_t workingSetStride;
+    const uint32_t* lanes;
+    uint32_t laneCount;
+
+    VMLaneOperand getLaneOperand(const VMExecOperand& operand) const;
+};
+
+// Executes an instruction for each lane of a batch.
+typedef void (*VMBatchFunction)(const VMBatchContext& batch, VMExecInstHeader* inst);
+
+// An instruction of a function that can execute in batches.
+struct VMBatchInst
+{
+    VMExecInstHeader* inst;
+    VMOp opcode;
+    // Handler that executes the instruction alone, which is used for the lanes one at a time
+    // when there is no `batchHandler`.
+    VMExtFunction handler;
+    VMBatchFunction batchHandler;
+    // Indices of the target instructions of a `Jump` or `JumpIf`.
+    Index targets[2];
+};
+
 // Represents a relocated function code ready for execution.
 // Relocated functions are VMInsts allocated in a 8-byte aligned buffer, and instruction headers
 // Replaced with actual function pointers that can execute the instruction.
@@ -28,6 +68,18 @@ public:
     VMFuncHeader* m_header;
     List<uint32_t> m_parameterOffsets;
 
+    // The instructions for executing the function in batches, empty if it uses instructions
+    // that can't run in lockstep, such as calls.
+    List<VMBatchInst> m_batchInsts;
+
+    // The number of times the function started running in the interpreter, and its native code
+    // once it ran `ByteCodeInterpreter::m_jitInvocationThreshold` times.
+    uint32_t m_invocationCount = 0;
+    bool m_canCompile = true;
+    VMNativeFunction m_nativeFunction = nullptr;
+    ComPtr<ISlangSharedLibrary> m_nativeLibrary;
+    uint32_t m_nativeReturnValueSize = 0;
+
     InstIterator begin();
     InstIterator end();
 };
@@ -39,7 +91,10 @@ struct StackFrame
     size_t m_workingSetOffset = 0;
 };
 
-class ByteCodeInterpreter : public RefObject, public IByteCodeRunner
+class ByteCodeInterpreter : public RefObject,
+                            public IByteCodeRunner,
+                            public IByteCodeDispatchRunner,
+                            public IByteCodeBatchRunner
 {
 public:
     SLANG_REF_OBJECT_IUNKNOWN_ALL
@@ -48,10 +103,19 @@ public:
 public:
     VMModuleView m_moduleView;
     List<uint8_t> m_code;
+    bool m_enableOptimizations = true;
+    uint32_t m_jitInvocationThreshold = 0;
+    RefPtr<VMJITCompiler> m_jitCompiler;
+    bool m_isJITCompilerUnavailable = false;
     StringBuilder m_errorBuilder;
     List<ExecutableFunction> m_functions;
+    Index m_selectedFunctionIndex = -1;
     Dictionary<String, VMExtFunction> m_extInstHandlers;
     SlangResult prepareModuleForExecution();
+
+    // Count an invocation of `func`, and get its native code if it has been compiled, which
+    // happens once it has been invoked `m_jitInvocationThreshold` times.
+    VMNativeFunction getNativeFunction(ExecutableFunction& func, uint32_t invocationCount = 1);
     void* m_extInstHandlerUserData = nullptr;
     List<uint8_t> m_returnRegister;
     List<uint64_t> m_workingSetBuffer;
@@ -61,6 +125,13 @@ public:
 
     size_t m_returnValSize = 0;
 
+    // Interpreters that run the functions of this one on the threads of a `dispatch`. They share
+    // the loaded module, but each has its own working set, stack and registers, and its own
+    // relocated functions, since operands refer to the registers of the interpreter running
+    // them. They are created by the first dispatch after the module or handlers change.
+    List<RefPtr<ByteCodeInterpreter>> m_dispatchContexts;
+    RefPtr<ThreadPool> m_threadPool;
+
     void pushFrame(uint32_t size)
     {
         StackFrame frame;
@@ -128,11 +199,38 @@ public:
     registerExtCall(const char* name, VMExtFunction functionPtr) override
     {
         m_extInstHandlers[name] = functionPtr;
+        m_dispatchContexts.clear();
         return SLANG_OK;
     }
 
     virtual SLANG_NO_THROW SlangResult SLANG_MCALL
     setPrintCallback(VMPrintFunc callback, void* userData) override;
+
+    // IByteCodeDispatchRunner
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL dispatch(
+        const uint32_t groupCount[3],
+        const void* argumentData,
+        size_t argumentSize,
+        uint32_t threadCount) override;
+
+    // IByteCodeBatchRunner
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL executeBatch(
+        const void* argumentData,
+        size_t argumentSize,
+        size_t argumentStride,
+        uint32_t invocationCount,
+        void* outReturnValues) override;
+
+private:
+    SlangResult _initDispatchContext(ByteCodeInterpreter* source);
+
+    void _executeLockstep(
+        ExecutableFunction& func,
+        const uint8_t* argumentData,
+        size_t argumentSize,
+        size_t argumentStride,
+        uint32_t laneCount,
+        uint8_t* outReturnValues);
 };
 
 } // namespace Slang
@@ -6,6 +6,7 @@
 #include "../core/slang-performance-profiler.h"
 #include "../core/slang-shared-library.h"
 #include "../core/slang-string-util.h"
+#include "../core/slang-thread-pool.h"
 #include "../core/slang-type-convert-util.h"
 #include "../core/slang-type-text-util.h"
 // Artifact
@@ -404,9 +405,121 @@ const char* getBuiltinModuleNameStr(slang::BuiltinModuleName name)
     return result;
 }
 
-TypeCheckingCache* Session::getTypeCheckingCache()
+RefPtr<TypeCheckingCache> Session::createTypeCheckingCache()
 {
-    return static_cast<TypeCheckingCache*>(m_typeCheckingCache.get());
+    RefPtr<TypeCheckingCache> cache = new TypeCheckingCache();
+
+    std::lock_guard<std::mutex> lock(m_typeCheckingCacheMutex);
+    cache->version = ++m_typeCheckingCacheVersion;
+    if (!m_sharedTypeCheckingCache)
+        m_sharedTypeCheckingCache = new SharedTypeCheckingCache();
+    cache->shared = static_cast<SharedTypeCheckingCache*>(m_sharedTypeCheckingCache.get());
+    return cache;
+}
+
+// Shared entries are copied out by linkages on any thread, so they can't hold reference
+// counted objects, such as the breadcrumbs of a lookup result.
+static bool _isShareableTypeCheckingCacheEntry(const ResolvedOperatorOverload& entry)
+{
+    return !entry.candidate.item.breadcrumbs;
+}
+
+static bool _isShareableTypeCheckingCacheEntry(const ConversionCost&)
+{
+    return true;
+}
+
+template<typename K, typename V>
+static void _mergeTypeCheckingCacheEntries(Dictionary<K, V>& dst, Dictionary<K, V>& staged)
+{
+    for (const auto& [key, value] : staged)
+    {
+        if (_isShareableTypeCheckingCacheEntry(value))
+            dst[key] = value;
+    }
+    staged.clear();
+}
+
+template<typename K, typename V>
+static void _copyTypeCheckingCacheEntries(Dictionary<K, V>& dst, const Dictionary<K, V>& src)
+{
+    for (const auto& [key, value] : src)
+        dst[key] = value;
+}
+
+// Combine a table with the newer table `newer`, whose entries take precedence.
+static RefPtr<TypeCheckingCacheTable> _combineTypeCheckingCacheTables(
+    TypeCheckingCacheTable* older,
+    TypeCheckingCacheTable* newer)
+{
+    RefPtr<TypeCheckingCacheTable> table = new TypeCheckingCacheTable();
+    table->resolvedOperatorOverloadCache = older->resolvedOperatorOverloadCache;
+    table->resolvedCallOverloadCache = older->resolvedCallOverloadCache;
+    table->conversionCostCache = older->conversionCostCache;
+    _copyTypeCheckingCacheEntries(
+        table->resolvedOperatorOverloadCache,
+        newer->resolvedOperatorOverloadCache);
+    _copyTypeCheckingCacheEntries(
+        table->resolvedCallOverloadCache,
+        newer->resolvedCallOverloadCache);
+    _copyTypeCheckingCacheEntries(table->conversionCostCache, newer->conversionCostCache);
+    return table;
+}
+
+void Session::mergeTypeCheckingCache(TypeCheckingCache* cache)
+{
+    std::lock_guard<std::mutex> lock(m_typeCheckingCacheMutex);
+
+    auto& stats = m_typeCheckingCacheStats;
+    stats.localHitCount += cache->stats.localHitCount;
+    stats.sharedHitCount += cache->stats.sharedHitCount;
+    stats.missCount += cache->stats.missCount;
+    cache->stats = TypeCheckingCacheStats();
+
+    auto latest = static_cast<SharedTypeCheckingCache*>(m_sharedTypeCheckingCache.get());
+    if (latest && cache->getStagedEntryCount())
+    {
+        // Other linkages may be reading the published snapshot, so the staged entries are
+        // added to a new snapshot, which shares the tables of the published one.
+        RefPtr<TypeCheckingCacheTable> table = new TypeCheckingCacheTable();
+        _mergeTypeCheckingCacheEntries(
+            table->resolvedOperatorOverloadCache,
+            cache->resolvedOperatorOverloadCache);
+        _mergeTypeCheckingCacheEntries(
+            table->resolvedCallOverloadCache,
+            cache->resolvedCallOverloadCache);
+        _mergeTypeCheckingCacheEntries(table->conversionCostCache, cache->conversionCostCache);
+
+        RefPtr<SharedTypeCheckingCache> snapshot = new SharedTypeCheckingCache();
+        snapshot->tables = latest->tables;
+        while (snapshot->tables.getCount() &&
+               snapshot->tables.getLast()->getEntryCount() <= table->getEntryCount())
+        {
+            table = _combineTypeCheckingCacheTables(snapshot->tables.getLast(), table);
+            snapshot->tables.removeLast();
+        }
+        if (table->getEntryCount())
+            snapshot->tables.add(table);
+        m_sharedTypeCheckingCache = snapshot;
+
+        stats.mergeCount++;
+        stats.sharedEntryCount = UInt64(snapshot->getEntryCount());
+    }
+
+    // Move the linkage on to the latest snapshot, so it sees the entries merged by others.
+    cache->shared = static_cast<SharedTypeCheckingCache*>(m_sharedTypeCheckingCache.get());
+}
+
+void Session::releaseTypeCheckingCache(RefPtr<RefObject>& cache)
+{
+    std::lock_guard<std::mutex> lock(m_typeCheckingCacheMutex);
+    cache = nullptr;
+}
+
+TypeCheckingCacheStats Session::getTypeCheckingCacheStats()
+{
+    std::lock_guard<std::mutex> lock(m_typeCheckingCacheMutex);
+    return m_typeCheckingCacheStats;
 }
 
 Session::BuiltinModuleInfo Session::getBuiltinModuleInfo(slang::BuiltinModuleName name)
@@ -532,6 +645,15 @@ SlangResult Session::loadBuiltinModule(
     slang::BuiltinModuleName moduleName,
     const void* moduleData,
     size_t sizeInBytes)
+{
+    // The caller only guarantees the data is valid for the duration of the call,
+    // so the module has to be read from a copy.
+    return loadBuiltinModuleFromBlob(moduleName, RawBlob::create(moduleData, sizeInBytes));
+}
+
+SlangResult Session::loadBuiltinModuleFromBlob(
+    slang::BuiltinModuleName moduleName,
+    ISlangBlob* moduleBlob)
 {
     SLANG_PROFILE;
 
@@ -548,7 +670,7 @@ SlangResult Session::loadBuiltinModule(
 
     // Make a file system to read it from
     ComPtr<ISlangFileSystemExt> fileSystem;
-    SLANG_RETURN_ON_FAIL(loadArchiveFileSystem(moduleData, sizeInBytes, fileSystem));
+    SLANG_RETURN_ON_FAIL(loadArchiveFileSystem(moduleBlob, fileSystem));
 
     // Let's try loading serialized modules and adding them
     Module* module = nullptr;
@@ -762,8 +884,19 @@ SlangResult Session::_readBuiltinModule(
     // After the AST module has been read in, we next look
     // to deserialize the IR module.
     //
+    // Most of the functions in a builtin module are never used by a given
+    // compilation, so by default their bodies are only read when they are linked.
+    // Everything is read in place from `fileContents`, which is a view into
+    // the archive for an uncompressed archive.
+    //
     RefPtr<IRModule> irModule;
-    SLANG_RETURN_ON_FAIL(decodeModuleIR(irModule, irChunk, this, sourceLocReader));
+    SLANG_RETURN_ON_FAIL(decodeModuleIR(
+        irModule,
+        irChunk,
+        fileContents,
+        this,
+        sourceLocReader,
+        deferBuiltinFunctionBodies));
 
     irModule->setName(module->getNameObj());
     module->setIRModule(irModule);
@@ -874,13 +1007,6 @@ Session::createSession(slang::SessionDesc const& inDesc, slang::ISession** outSe
         linkage->m_optionSet.set(CompilerOptionName::SkipSPIRVValidation, true);
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_typeCheckingCacheMutex);
-        if (m_typeCheckingCache)
-            linkage->m_typeCheckingCache =
-                new TypeCheckingCache(*static_cast<TypeCheckingCache*>(m_typeCheckingCache.get()));
-    }
-
     Int searchPathCount = desc.searchPathCount;
     for (Int ii = 0; ii < searchPathCount; ++ii)
     {
@@ -1368,6 +1494,7 @@ Linkage::Linkage(Session* session, ASTBuilder* astBuilder, Linkage* builtinLinka
     , m_sourceManager(&m_defaultSourceManager)
     , m_astBuilder(astBuilder)
     , m_cmdLineContext(new CommandLineContext())
+    , m_includedFileTokenCache(new IncludedFileTokenCache())
 {
     getNamePool()->setRootNamePool(session->getRootNamePool());
 
@@ -1394,24 +1521,69 @@ ISlangUnknown* Linkage::getInterface(const Guid& guid)
 {
     if (guid == ISlangUnknown::getTypeGuid() || guid == ISession::getTypeGuid())
         return asExternal(this);
+    if (guid == ICompilationCacheService_Experimental::getTypeGuid())
+        return static_cast<slang::ICompilationCacheService_Experimental*>(this);
 
     return nullptr;
 }
 
+PersistentCache* Linkage::getCompilationCache()
+{
+    if (!m_isCompilationCacheInitialized)
+    {
+        m_isCompilationCacheInitialized = true;
+
+        auto cachePath = m_optionSet.getStringOption(CompilerOptionName::CompilationCachePath);
+        if (cachePath.getLength())
+        {
+            PersistentCache::Desc desc;
+            desc.directory = cachePath.getBuffer();
+            desc.maxEntryCount =
+                m_optionSet.getIntOption(CompilerOptionName::CompilationCacheMaxEntryCount);
+            m_compilationCache = new PersistentCache(desc);
+        }
+    }
+    return m_compilationCache;
+}
+
+SLANG_NO_THROW SlangResult SLANG_MCALL
+Linkage::getCacheStatistics(SlangInt* outHitCount, SlangInt* outMissCount, SlangInt* outEntryCount)
+{
+    auto cache = getCompilationCache();
+    if (!cache)
+        return SLANG_E_NOT_AVAILABLE;
+
+    const auto& stats = cache->getStats();
+    if (outHitCount)
+        *outHitCount = stats.hitCount;
+    if (outMissCount)
+        *outMissCount = stats.missCount;
+    if (outEntryCount)
+        *outEntryCount = stats.entryCount;
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW void SLANG_MCALL Linkage::resetCacheStatistics()
+{
+    if (auto cache = getCompilationCache())
+        cache->resetStats();
+}
+
+SLANG_NO_THROW SlangResult SLANG_MCALL Linkage::clearCache()
+{
+    auto cache = getCompilationCache();
+    if (!cache)
+        return SLANG_E_NOT_AVAILABLE;
+    return cache->clear();
+}
+
 Linkage::~Linkage()
 {
     // Upstream type checking cache.
     if (m_typeCheckingCache)
     {
-        auto globalSession = getSessionImpl();
-        std::lock_guard<std::mutex> lock(globalSession->m_typeCheckingCacheMutex);
-        if (!globalSession->m_typeCheckingCache ||
-            globalSession->getTypeCheckingCache()->resolvedOperatorOverloadCache.getCount() <
-                getTypeCheckingCache()->resolvedOperatorOverloadCache.getCount())
-        {
-            globalSession->m_typeCheckingCache = m_typeCheckingCache;
-            getTypeCheckingCache()->version++;
-        }
+        getSessionImpl()->mergeTypeCheckingCache(
+            static_cast<TypeCheckingCache*>(m_typeCheckingCache.get()));
         destroyTypeCheckingCache();
     }
 }
@@ -1432,14 +1604,19 @@ TypeCheckingCache* Linkage::getTypeCheckingCache()
 {
     if (!m_typeCheckingCache)
     {
-        m_typeCheckingCache = new TypeCheckingCache();
+        m_typeCheckingCache = getSessionImpl()->createTypeCheckingCache();
     }
-    return static_cast<TypeCheckingCache*>(m_typeCheckingCache.get());
+    auto cache = static_cast<TypeCheckingCache*>(m_typeCheckingCache.get());
+    if (cache->getStagedEntryCount() >= TypeCheckingCache::kMergeThreshold)
+    {
+        getSessionImpl()->mergeTypeCheckingCache(cache);
+    }
+    return cache;
 }
 
 void Linkage::destroyTypeCheckingCache()
 {
-    m_typeCheckingCache = nullptr;
+    getSessionImpl()->releaseTypeCheckingCache(m_typeCheckingCache);
 }
 
 SLANG_NO_THROW slang::IGlobalSession* SLANG_MCALL Linkage::getGlobalSession()
@@ -2685,10 +2862,43 @@ EndToEndCompileRequest::~EndToEndCompileRequest()
     // Flush any writers associated with the request
     m_writers->flushWriters();
 
+    if (m_restoreLinkage)
+    {
+        _restoreLinkage();
+    }
+
     m_linkage.setNull();
     m_frontEndReq.setNull();
 }
 
+void EndToEndCompileRequest::_restoreLinkage()
+{
+    auto linkage = getLinkage();
+
+    linkage->m_optionSet = m_savedLinkageOptionSet;
+
+    // Loaded modules cache programs by target, so they have to forget the targets that are
+    // removed. Otherwise a target created later at the same address would find them.
+    for (Index i = m_savedLinkageTargetCount; i < linkage->targets.getCount(); ++i)
+    {
+        TargetRequest* target = linkage->targets[i];
+        for (auto module : linkage->loadedModulesList)
+        {
+            module->removeTargetProgram(target);
+        }
+    }
+    linkage->targets.setCount(m_savedLinkageTargetCount);
+
+    // Files can change before the linkage is used again, so don't keep their contents.
+    // Source files that are read again get a new digest, which invalidates any tokens the
+    // included file token cache holds for them.
+    if (auto fileSystem = linkage->getFileSystemExt())
+    {
+        fileSystem->clearCache();
+    }
+    linkage->getSourceManager()->forgetSourceFileIdentities();
+}
+
 static ISlangWriter* _getDefaultWriter(WriterChannel chan)
 {
     static FileWriter stdOut(stdout, WriterFlag::IsStatic | WriterFlag::IsUnowned);
@@ -3586,6 +3796,14 @@ void FrontEndCompileRequest::checkAllTranslationUnits()
     if (additionalLoadedModules)
         loadedModules = *additionalLoadedModules;
 
+    // Get the files of any modules that will be imported while checking read,
+    // so that they aren't read one at a time as each `import` is checked.
+    for (auto& translationUnit : translationUnits)
+    {
+        if (!translationUnit->isChecked)
+            getLinkage()->prefetchImportedModuleFiles(translationUnit->getModuleDecl());
+    }
+
     // Iterate over all translation units and
     // apply the semantic checking logic.
     for (auto& translationUnit : translationUnits)
@@ -3776,6 +3994,13 @@ EndToEndCompileRequest::EndToEndCompileRequest(Linkage* linkage)
     init();
 }
 
+void EndToEndCompileRequest::setRestoreLinkageOnDestroy()
+{
+    m_restoreLinkage = true;
+    m_savedLinkageOptionSet = m_linkage->m_optionSet;
+    m_savedLinkageTargetCount = m_linkage->targets.getCount();
+}
+
 SLANG_NO_THROW SlangResult SLANG_MCALL
 EndToEndCompileRequest::queryInterface(SlangUUID const& uuid, void** outObject)
 {
@@ -4258,6 +4483,7 @@ RefPtr<Module> Linkage::loadSerializedModule(
     SourceLoc const& requestingLoc,
     DiagnosticSink* sink)
 {
+    SLANG_PROFILE;
     auto astBuilder = getASTBuilder();
     SLANG_AST_BUILDER_RAII(astBuilder);
 
@@ -4403,6 +4629,49 @@ RefPtr<Module> Linkage::loadModuleImpl(
     }
 }
 
+SlangResult Linkage::_loadModuleFile(
+    ModuleBlobType blobType,
+    const PathInfo& pathInfo,
+    IncludeSystem& includeSystem,
+    ComPtr<ISlangBlob>& outBlob)
+{
+    // Precompiled modules are read in place, so rather than loading a copy of the
+    // file, it can be mapped directly. That avoids reading the parts that aren't used,
+    // and lets processes loading the same module share its pages.
+    //
+    // This is only possible when the file system works with paths of the OS.
+    //
+    // Files read ahead of time by `prefetchImportedModuleFiles` aren't mapped,
+    // but are registered with the source manager just as if the include system
+    // had loaded them.
+    //
+    ComPtr<ISlangBlob> prefetchedContents;
+    if (m_prefetchedModuleFiles.tryGetValue(pathInfo.foundPath, prefetchedContents))
+    {
+        m_prefetchedModuleFiles.remove(pathInfo.foundPath);
+
+        auto sourceManager = getSourceManager();
+        if (!sourceManager->findSourceFileRecursively(pathInfo.uniqueIdentity))
+        {
+            auto sourceFile = sourceManager->createSourceFileWithBlob(pathInfo, prefetchedContents);
+            sourceManager->addSourceFile(pathInfo.uniqueIdentity, sourceFile);
+            outBlob = prefetchedContents;
+            return SLANG_OK;
+        }
+    }
+
+    if (blobType == ModuleBlobType::IR &&
+        m_optionSet.getBoolOption(CompilerOptionName::MemoryMapModules) &&
+        m_fileSystemExt->getOSPathKind() == OSPathKind::Direct)
+    {
+        if (SLANG_SUCCEEDED(MemoryMappedFileBlob::create(pathInfo.foundPath, outBlob)))
+        {
+            return SLANG_OK;
+        }
+    }
+    return includeSystem.loadFile(pathInfo, outBlob);
+}
+
 RefPtr<Module> Linkage::loadSourceModuleImpl(
     Name* name,
     const PathInfo& filePathInfo,
@@ -4411,6 +4680,7 @@ RefPtr<Module> Linkage::loadSourceModuleImpl(
     DiagnosticSink* sink,
     const LoadedModuleDictionary* additionalLoadedModules)
 {
+    SLANG_PROFILE;
     RefPtr<FrontEndCompileRequest> frontEndReq = new FrontEndCompileRequest(this, nullptr, sink);
 
     frontEndReq->additionalLoadedModules = additionalLoadedModules;
@@ -4544,6 +4814,190 @@ String getFileNameFromModuleName(Name* name, bool translateUnderScore)
     return fileName;
 }
 
+void Linkage::_getModuleFileCandidates(Name* moduleName, List<ModuleFileCandidate>& outCandidates)
+{
+    // There are a few key choices to account for:
+    //
+    // * We can both load modules from a source `.slang` file,
+    //   or from a binary `.slang-module` file.
+    //
+    // * For a variety of reasons, the `import` logic has historically
+    //   translated underscores in a module name into dashes (so that
+    //   `import my_module` will look for `my-module.slang`), and we
+    //   try to support both that convention as well as a convention
+    //   that preserves underscores.
+    //
+    // To try to keep this logic as orthogonal as possible, we first
+    // construct lists of the options we want to iterate over, and
+    // then produce every combination of them.
+
+    ShortList<ModuleBlobType, 2> typesToTry;
+    if (isInLanguageServer())
+    {
+        // When in language server, we always prefer to use source module if it is available.
+        typesToTry.add(ModuleBlobType::Source);
+        typesToTry.add(ModuleBlobType::IR);
+    }
+    else
+    {
+        // Look for a precompiled module first, if not exist, load from source.
+        typesToTry.add(ModuleBlobType::IR);
+        typesToTry.add(ModuleBlobType::Source);
+    }
+
+    // We will always search for a file name that directly matches the
+    // module name as written first, and then search for one with
+    // underscores replaced by dashes. The latter is the original
+    // behavior that `import` provided, but it seems safest to prefer
+    // the exact name spelled in the user's code when there might
+    // actually be ambiguity.
+    //
+    auto defaultSourceFileName = getFileNameFromModuleName(moduleName, false);
+    auto alternativeSourceFileName = getFileNameFromModuleName(moduleName, true);
+    String sourceFileNamesToTry[] = {defaultSourceFileName, alternativeSourceFileName};
+
+    for (auto type : typesToTry)
+    {
+        for (auto sourceFileName : sourceFileNamesToTry)
+        {
+            // The `sourceFileName` will have the `.slang` extension,
+            // so if we are looking for a binary module, we need
+            // to change the extension we will look for.
+            //
+            ModuleFileCandidate candidate;
+            candidate.type = type;
+            switch (type)
+            {
+            case ModuleBlobType::Source:
+                candidate.fileName = sourceFileName;
+                break;
+
+            case ModuleBlobType::IR:
+                candidate.fileName = Path::replaceExt(sourceFileName, "slang-module");
+                break;
+            }
+            outCandidates.add(candidate);
+        }
+    }
+}
+
+// Returns true if the file system of a linkage reads from the OS file system. A null file
+// system is the default, which does.
+static bool _readsFromOSFileSystem(ISlangFileSystem* fileSystem)
+{
+    if (!fileSystem)
+        return true;
+    if (auto cacheFileSystem = as<CacheFileSystem>(fileSystem))
+        fileSystem = cacheFileSystem->getInnerFileSystem();
+    return fileSystem == OSFileSystem::getLoadSingleton() ||
+           fileSystem == OSFileSystem::getExtSingleton() ||
+           fileSystem == OSFileSystem::getMutableSingleton();
+}
+
+void Linkage::prefetchImportedModuleFiles(ModuleDecl* moduleDecl)
+{
+    if (!m_optionSet.hasOption(CompilerOptionName::ParallelModuleLoading))
+        return;
+
+    // Files are read on worker threads directly from the OS file system, bypassing the
+    // linkage's file system, which caches what it reads without any synchronization.
+    // That is only equivalent if the linkage's file system reads from the OS too. Any
+    // other file system supplied by the user may not be thread safe at all.
+    //
+    if (!_readsFromOSFileSystem(m_fileSystem))
+        return;
+
+    Count threadCount = m_optionSet.getIntOption(CompilerOptionName::ParallelModuleLoading);
+    if (threadCount <= 0)
+        threadCount = ThreadPool::getHardwareThreadCount();
+    if (threadCount <= 1)
+        return;
+
+    SLANG_PROFILE;
+
+    // Gather the `import` declarations of the module, including those in
+    // files it `__include`s.
+    //
+    List<ImportDecl*> importDecls;
+    for (auto importDecl : moduleDecl->getMembersOfType<ImportDecl>())
+        importDecls.add(importDecl);
+    for (auto fileDecl : moduleDecl->getMembersOfType<FileDecl>())
+    {
+        for (auto importDecl : fileDecl->getMembersOfType<ImportDecl>())
+            importDecls.add(importDecl);
+    }
+
+    // Finding the files involves the linkage's file system and source manager,
+    // so that part is done up front on this thread. The same search as
+    // `findOrImportModule` is used, and only the first file found is read.
+    // In the rare case that it fails to load, `findOrImportModule` reads the
+    // next candidate itself.
+    //
+    IncludeSystem includeSystem(&getSearchDirectories(), getFileSystemExt(), getSourceManager());
+    const bool mapBinaryModules = m_optionSet.getBoolOption(CompilerOptionName::MemoryMapModules);
+
+    List<String> pathsToRead;
+    for (auto importDecl : importDecls)
+    {
+        auto moduleName = importDecl->moduleNameAndLoc.name;
+        if (!moduleName || mapNameToLoadedModules.containsKey(moduleName) ||
+            moduleName == getSessionImpl()->glslModuleName)
+            continue;
+
+        PathInfo requestingPathInfo = getSourceManager()->getPathInfo(
+            importDecl->moduleNameAndLoc.loc,
+            SourceLocType::Actual);
+
+        List<ModuleFileCandidate> candidates;
+        _getModuleFileCandidates(moduleName, candidates);
+        for (auto& candidate : candidates)
+        {
+            PathInfo filePathInfo;
+            if (SLANG_FAILED(includeSystem.findFile(
+                    candidate.fileName,
+                    requestingPathInfo.foundPath,
+                    filePathInfo)))
+                continue;
+
+            // Binary modules that will be memory mapped don't need reading.
+            const bool isMapped = candidate.type == ModuleBlobType::IR && mapBinaryModules;
+            if (!isMapped &&
+                !mapPathToLoadedModule.containsKey(filePathInfo.getMostUniqueIdentity()) &&
+                !m_prefetchedModuleFiles.containsKey(filePathInfo.foundPath) &&
+                !pathsToRead.contains(filePathInfo.foundPath))
+            {
+                pathsToRead.add(filePathInfo.foundPath);
+            }
+            break;
+        }
+    }
+
+    if (pathsToRead.getCount() <= 1)
+        return;
+
+    List<ComPtr<ISlangBlob>> fileContents;
+    fileContents.setCount(pathsToRead.getCount());
+
+    // The pool is kept for the imports of later modules.
+    if (!m_moduleLoadingThreadPool || m_moduleLoadingThreadPool->getThreadCount() != threadCount)
+        m_moduleLoadingThreadPool = new ThreadPool(threadCount);
+    m_moduleLoadingThreadPool->parallelFor(
+        pathsToRead.getCount(),
+        [&](Index index)
+        {
+            // A file that can't be read is left for `findOrImportModule` to diagnose.
+            OSFileSystem::getExtSingleton()->loadFile(
+                pathsToRead[index].getBuffer(),
+                fileContents[index].writeRef());
+        });
+
+    for (Index i = 0; i < pathsToRead.getCount(); ++i)
+    {
+        if (fileContents[i])
+            m_prefetchedModuleFiles[pathsToRead[i]] = fileContents[i];
+    }
+}
+
 RefPtr<Module> Linkage::findOrImportModule(
     Name* moduleName,
     SourceLoc const& requestingLoc,
@@ -4618,45 +5072,11 @@ RefPtr<Module> Linkage::findOrImportModule(
     }
 
     // We are going to use a loop to search for a suitable file to
-    // load the module from, to account for a few key choices:
-    //
-    // * We can both load modules from a source `.slang` file,
-    //   or from a binary `.slang-module` file.
-    //
-    // * For a variety of reasons, the `import` logic has historically
-    //   translated underscores in a module name into dashes (so that
-    //   `import my_module` will look for `my-module.slang`), and we
-    //   try to support both that convention as well as a convention
-    //   that preserves underscores.
-    //
-    // To try to keep this logic as orthogonal as possible, we first
-    // construct lists of the options we want to iterate over, and
-    // then do the actual loop later.
-
-    ShortList<ModuleBlobType, 2> typesToTry;
-    if (isInLanguageServer())
-    {
-        // When in language server, we always prefer to use source module if it is available.
-        typesToTry.add(ModuleBlobType::Source);
-        typesToTry.add(ModuleBlobType::IR);
-    }
-    else
-    {
-        // Look for a precompiled module first, if not exist, load from source.
-        typesToTry.add(ModuleBlobType::IR);
-        typesToTry.add(ModuleBlobType::Source);
-    }
-
-    // We will always search for a file name that directly matches the
-    // module name as written first, and then search for one with
-    // underscores replaced by dashes. The latter is the original
-    // behavior that `import` provided, but it seems safest to prefer
-    // the exact name spelled in the user's code when there might
-    // actually be ambiguity.
+    // load the module from, trying each of the candidate files
+    // for the module in order of preference.
     //
-    auto defaultSourceFileName = getFileNameFromModuleName(moduleName, false);
-    auto alternativeSourceFileName = getFileNameFromModuleName(moduleName, true);
-    String sourceFileNamesToTry[] = {defaultSourceFileName, alternativeSourceFileName};
+    List<ModuleFileCandidate> candidates;
+    _getModuleFileCandidates(moduleName, candidates);
 
     // We are going to look for the candidate file using the same
     // logic that would be used for a preprocessor `#include`,
@@ -4672,109 +5092,93 @@ RefPtr<Module> Linkage::findOrImportModule(
     PathInfo requestingPathInfo =
         getSourceManager()->getPathInfo(requestingLoc, SourceLocType::Actual);
 
-    for (auto type : typesToTry)
+    for (auto& candidate : candidates)
     {
-        for (auto sourceFileName : sourceFileNamesToTry)
+        // We now search for a file matching the desired name,
+        // using the same logic as for a `#include`.
+        //
+        // TODO: We might want to consider how to handle the case
+        // of an `import` with a relative path a little specially,
+        // since it could in theory be possible for two `.slang`
+        // files with the same base name to exist in different
+        // directories in a project, and we'd want file-relative
+        // `import`s to work for each, without having either one
+        // be able to "claim" the bare identifier of the base
+        // name for itself.
+        //
+        PathInfo filePathInfo;
+        if (SLANG_FAILED(includeSystem.findFile(
+                candidate.fileName,
+                requestingPathInfo.foundPath,
+                filePathInfo)))
         {
-            // The `sourceFileName` will have the `.slang` extension,
-            // so if we are looking for a binary module, we need
-            // to change the extension we will look for.
+            // If we failed to find the file at this step, we
+            // will continue the search for our other options.
             //
-            String fileName;
-            switch (type)
-            {
-            case ModuleBlobType::Source:
-                fileName = sourceFileName;
-                break;
-
-            case ModuleBlobType::IR:
-                fileName = Path::replaceExt(sourceFileName, "slang-module");
-                break;
-            }
+            continue;
+        }
 
-            // We now search for a file matching the desired name,
-            // using the same logic as for a `#include`.
-            //
-            // TODO: We might want to consider how to handle the case
-            // of an `import` with a relative path a little specially,
-            // since it could in theory be possible for two `.slang`
-            // files with the same base name to exist in different
-            // directories in a project, and we'd want file-relative
-            // `import`s to work for each, without having either one
-            // be able to "claim" the bare identifier of the base
-            // name for itself.
+        // We will *again* search for a previously loaded module.
+        //
+        // It is possible that the same file will have been loaded
+        // as a module under two different module names. The easiest
+        // way for this to happen is if there are `import` declarations
+        // using both the underscore and dash conventions (e.g., both
+        // `import "my-module.slang"` and `import my_module`).
+        //
+        // This case may also arise if one file `import`s a module using
+        // just an identifier for its name, but another `import`s it
+        // using a path (e.g., `import "subdir/file.slang"`).
+        //
+        // No matter how the situation arises, we only want to have one
+        // copy of the "same" module loaded at a given time, so we
+        // will re-use the existing module if we find one here.
+        //
+        if (mapPathToLoadedModule.tryGetValue(
+                filePathInfo.getMostUniqueIdentity(),
+                previouslyLoadedModule))
+        {
+            // TODO: If we find a previously-loaded module at this step,
+            // then we should probably register that module under the
+            // given `moduleName` in the map of loaded modules, so
+            // that subsequent `import`s using the same form will find it.
             //
-            PathInfo filePathInfo;
-            if (SLANG_FAILED(
-                    includeSystem.findFile(fileName, requestingPathInfo.foundPath, filePathInfo)))
-            {
-                // If we failed to find the file at this step, we
-                // will continue the search for our other options.
-                //
-                continue;
-            }
+            return previouslyLoadedModule;
+        }
 
-            // We will *again* search for a previously loaded module.
-            //
-            // It is possible that the same file will have been loaded
-            // as a module under two different module names. The easiest
-            // way for this to happen is if there are `import` declarations
-            // using both the underscore and dash conventions (e.g., both
-            // `import "my-module.slang"` and `import my_module`).
-            //
-            // This case may also arise if one file `import`s a module using
-            // just an identifier for its name, but another `import`s it
-            // using a path (e.g., `import "subdir/file.slang"`).
-            //
-            // No matter how the situation arises, we only want to have one
-            // copy of the "same" module loaded at a given time, so we
-            // will re-use the existing module if we find one here.
-            //
-            if (mapPathToLoadedModule.tryGetValue(
-                    filePathInfo.getMostUniqueIdentity(),
-                    previouslyLoadedModule))
-            {
-                // TODO: If we find a previously-loaded module at this step,
-                // then we should probably register that module under the
-                // given `moduleName` in the map of loaded modules, so
-                // that subsequent `import`s using the same form will find it.
-                //
-                return previouslyLoadedModule;
-            }
+        // Now we try to load the content of the file.
+        //
+        // If for some reason we could find a file at the
+        // given path, but for some reason couldn't *open*
+        // and *read* it, then we continue the search
+        // using whatever other candidate file names are left.
+        //
+        ComPtr<ISlangBlob> fileContents;
+        if (SLANG_FAILED(
+                _loadModuleFile(candidate.type, filePathInfo, includeSystem, fileContents)))
+        {
+            continue;
+        }
 
-            // Now we try to load the content of the file.
-            //
-            // If for some reason we could find a file at the
-            // given path, but for some reason couldn't *open*
-            // and *read* it, then we continue the search
-            // using whatever other candidate file names are left.
-            //
-            ComPtr<ISlangBlob> fileContents;
-            if (SLANG_FAILED(includeSystem.loadFile(filePathInfo, fileContents)))
-            {
-                continue;
-            }
+        // If we found a real file and were able to load its contents,
+        // then we'll go ahead and try to load a module from it,
+        // whether by compiling it or decoding the binary.
+        //
+        auto module = loadModuleImpl(
+            moduleName,
+            filePathInfo,
+            fileContents,
+            requestingLoc,
+            sink,
+            loadedModules,
+            candidate.type);
 
-            // If we found a real file and were able to load its contents,
-            // then we'll go ahead and try to load a module from it,
-            // whether by compiling it or decoding the binary.
-            //
-            auto module = loadModuleImpl(
-                moduleName,
-                filePathInfo,
-                fileContents,
-                requestingLoc,
-                sink,
-                loadedModules,
-                type);
-
-            // If the attempt to load the module from the given path
-            // was successful, we go ahead and use it, without trying
-            // out any other options.
-            //
-            if (module)
-                return module;
-        }
+        // If the attempt to load the module from the given path
+        // was successful, we go ahead and use it, without trying
+        // out any other options.
+        //
+        if (module)
+            return module;
     }
 
     // If we tried out all of our candidate file names
@@ -4793,7 +5197,10 @@ RefPtr<Module> Linkage::findOrImportModule(
     // list of the file names that were tried, if
     // nothing was even found via the include system).
     //
-    sink->diagnose(requestingLoc, Diagnostics::cannotOpenFile, defaultSourceFileName);
+    sink->diagnose(
+        requestingLoc,
+        Diagnostics::cannotOpenFile,
+        getFileNameFromModuleName(moduleName, false));
 
     // If the attempt to import the module failed, then
     // we will stick a null pointer into the map of loaded
@@ -5432,7 +5839,13 @@ SLANG_NO_THROW SlangResult SLANG_MCALL ComponentType::getResultAsFileSystem(
 
     auto targetProgram = getTargetProgram(target);
 
-    IArtifact* artifact = targetProgram->getExistingEntryPointResult(entryPointIndex);
+    ComPtr<IArtifact> artifact(targetProgram->getExistingEntryPointResult(entryPointIndex));
+    if (!artifact)
+    {
+        // The code came from the compilation cache, so there is only the code itself.
+        artifact = ArtifactUtil::createArtifactForCompileTarget(asExternal(target->getTarget()));
+        artifact->addRepresentationUnknown(code);
+    }
 
     // Add diagnostics id needs be...
     if (diagnostics && !_findDiagnosticRepresentation(artifact))
@@ -5502,6 +5915,22 @@ SLANG_NO_THROW SlangResult SLANG_MCALL ComponentType::getEntryPointCode(
 
     auto targetProgram = getTargetProgram(target);
 
+    // If the code hasn't been generated in this session, it may be in the compilation
+    // cache, in which case we don't need to generate it at all.
+    //
+    PersistentCache* cache = nullptr;
+    PersistentCache::Key cacheKey;
+    if (!targetProgram->getExistingEntryPointResult(entryPointIndex))
+    {
+        cache = linkage->getCompilationCache();
+        if (cache)
+        {
+            cacheKey = _getCompilationCacheKey(entryPointIndex, targetIndex);
+            if (SLANG_SUCCEEDED(cache->readEntry(cacheKey, outCode)))
+                return SLANG_OK;
+        }
+    }
+
     DiagnosticSink sink(linkage->getSourceManager(), Lexer::sourceLocationLexer);
     applySettingsToDiagnosticSink(&sink, &sink, linkage->m_optionSet);
     applySettingsToDiagnosticSink(&sink, &sink, m_optionSet);
@@ -5512,7 +5941,60 @@ SLANG_NO_THROW SlangResult SLANG_MCALL ComponentType::getEntryPointCode(
     if (artifact == nullptr)
         return SLANG_FAIL;
 
-    return artifact->loadBlob(ArtifactKeep::Yes, outCode);
+    SLANG_RETURN_ON_FAIL(artifact->loadBlob(ArtifactKeep::Yes, outCode));
+
+    // Failing to write to the cache isn't an error, as it only means we will have
+    // to generate the code again next time.
+    if (cache)
+        cache->writeEntry(cacheKey, *outCode);
+
+    return SLANG_OK;
+}
+
+void ComponentType::_appendEntryPointToHash(DigestBuilder<SHA1>& builder, SlangInt entryPointIndex)
+{
+    // Add the name and name override for the specified entry point to the hash.
+    auto entryPoint = getEntryPoint(entryPointIndex);
+    if (entryPoint)
+    {
+        auto entryPointName = entryPoint->getName()->text;
+        builder.append(entryPointName);
+        auto entryPointMangledName = getEntryPointMangledName(entryPointIndex);
+        builder.append(entryPointMangledName);
+        auto entryPointNameOverride = getEntryPointNameOverride(entryPointIndex);
+        builder.append(entryPointNameOverride);
+    }
+}
+
+PersistentCache::Key ComponentType::_getCompilationCacheKey(
+    SlangInt entryPointIndex,
+    SlangInt targetIndex)
+{
+    // The code for a single entry point is keyed by its entry point hash.
+    if (entryPointIndex >= 0)
+    {
+        ComPtr<ISlangBlob> hash;
+        getEntryPointHash(entryPointIndex, targetIndex, hash.writeRef());
+
+        PersistentCache::Key key;
+        SLANG_ASSERT(hash->getBufferSize() == sizeof(key.data));
+        ::memcpy(key.data, hash->getBufferPointer(), sizeof(key.data));
+        return key;
+    }
+
+    // The code for the whole program depends on all of the entry points.
+    DigestBuilder<SHA1> builder;
+    getLinkage()->buildHash(builder, targetIndex);
+    buildHash(builder);
+
+    const Index entryPointCount = getEntryPointCount();
+    builder.append(entryPointCount);
+    for (Index i = 0; i < entryPointCount; ++i)
+    {
+        _appendEntryPointToHash(builder, i);
+    }
+
+    return builder.finalize();
 }
 
 SLANG_NO_THROW void SLANG_MCALL ComponentType::getEntryPointHash(
@@ -5532,17 +6014,7 @@ SLANG_NO_THROW void SLANG_MCALL ComponentType::getEntryPointHash(
 
     buildHash(builder);
 
-    // Add the name and name override for the specified entry point to the hash.
-    auto entryPoint = getEntryPoint(entryPointIndex);
-    if (entryPoint)
-    {
-        auto entryPointName = entryPoint->getName()->text;
-        builder.append(entryPointName);
-        auto entryPointMangledName = getEntryPointMangledName(entryPointIndex);
-        builder.append(entryPointMangledName);
-        auto entryPointNameOverride = getEntryPointNameOverride(entryPointIndex);
-        builder.append(entryPointNameOverride);
-    }
+    _appendEntryPointToHash(builder, entryPointIndex);
 
     auto hash = builder.finalize().toBlob();
     *outHash = hash.detach();
@@ -5955,12 +6427,35 @@ IArtifact* ComponentType::getTargetArtifact(Int targetIndex, slang::IBlob** outD
 SLANG_NO_THROW SlangResult SLANG_MCALL
 ComponentType::getTargetCode(Int targetIndex, slang::IBlob** outCode, slang::IBlob** outDiagnostics)
 {
+    // As for `getEntryPointCode`, code that hasn't been generated in this session
+    // may be in the compilation cache.
+    //
+    auto linkage = getLinkage();
+    PersistentCache* cache = nullptr;
+    PersistentCache::Key cacheKey;
+    if (targetIndex >= 0 && targetIndex < linkage->targets.getCount() &&
+        !m_targetArtifacts.containsKey(targetIndex))
+    {
+        cache = linkage->getCompilationCache();
+        if (cache)
+        {
+            cacheKey = _getCompilationCacheKey(-1, targetIndex);
+            if (SLANG_SUCCEEDED(cache->readEntry(cacheKey, outCode)))
+                return SLANG_OK;
+        }
+    }
+
     IArtifact* artifact = getTargetArtifact(targetIndex, outDiagnostics);
 
     if (artifact == nullptr)
         return SLANG_FAIL;
 
-    return artifact->loadBlob(ArtifactKeep::Yes, outCode);
+    SLANG_RETURN_ON_FAIL(artifact->loadBlob(ArtifactKeep::Yes, outCode));
+
+    if (cache)
+        cache->writeEntry(cacheKey, *outCode);
+
+    return SLANG_OK;
 }
 
 SLANG_NO_THROW SlangResult SLANG_MCALL ComponentType::getTargetMetadata(
@@ -6801,7 +7296,13 @@ SlangResult Linkage::loadSerializedModuleContents(
     module->setModuleDecl(moduleDecl);
 
     RefPtr<IRModule> irModule;
-    SLANG_RETURN_ON_FAIL(decodeModuleIR(irModule, irChunk, session, sourceLocReader));
+    SLANG_RETURN_ON_FAIL(decodeModuleIR(
+        irModule,
+        irChunk,
+        blobHoldingSerializedData,
+        session,
+        sourceLocReader,
+        m_optionSet.getBoolOption(CompilerOptionName::LazyIRLoading)));
     module->setIRModule(irModule);
 
     // The handling of file dependencies is complicated, because of
@@ -7626,6 +8127,12 @@ SlangResult EndToEndCompileRequest::compile()
         getSession()->getCompilerElapsedTime(&totalStartTime, &downstreamStartTime);
         PerformanceProfiler::getProfiler()->clear();
     }
+    const String perfTraceFileName =
+        getOptionSet().getStringOption(CompilerOptionName::ReportPerfTrace);
+    if (perfTraceFileName.getLength())
+    {
+        PerformanceProfiler::getProfiler()->clear();
+    }
 #if !defined(SLANG_DEBUG_INTERNAL_ERROR)
     // By default we'd like to catch as many internal errors as possible,
     // and report them to the user nicely (rather than just crash their
@@ -7702,11 +8209,120 @@ SlangResult EndToEndCompileRequest::compile()
         StringBuilder perfResult;
         PerformanceProfiler::getProfiler()->getResult(perfResult);
         perfResult << "\nType Dictionary Size: " << getSession()->m_typeDictionarySize << "\n";
+
+        // Report the memory held by the IR of loaded modules, and how much of the modules
+        // loaded with deferred function bodies, including the builtin modules, was actually read
+        size_t loadedIRMemory = 0;
+        IRDeferredBodyLoader::Stats lazyIRStats;
+        auto addLazyIRStats = [&](IRModule* irModule)
+        {
+            auto loader = irModule->getDeferredBodyLoader();
+            if (!loader)
+                return;
+            const auto stats = loader->getStats();
+            lazyIRStats.deferredBodyCount += stats.deferredBodyCount;
+            lazyIRStats.materializedBodyCount += stats.materializedBodyCount;
+            lazyIRStats.deferredInstCount += stats.deferredInstCount;
+            lazyIRStats.materializedInstCount += stats.materializedInstCount;
+            lazyIRStats.serialDataSize += stats.serialDataSize;
+            lazyIRStats.copiedSerialDataSize += stats.copiedSerialDataSize;
+        };
+        for (auto loadedModule : getLinkage()->loadedModulesList)
+        {
+            auto irModule = loadedModule->getIRModule();
+            if (!irModule)
+                continue;
+            loadedIRMemory += irModule->getMemoryArena().calcTotalMemoryAllocated();
+            addLazyIRStats(irModule);
+        }
+        for (auto& coreModule : getSession()->coreModules)
+        {
+            if (auto irModule = coreModule->getIRModule())
+                addLazyIRStats(irModule);
+        }
+        perfResult << "Loaded IR Module Memory: " << UInt64(loadedIRMemory) << "\n";
+        if (getOptionSet().getBoolOption(CompilerOptionName::ReclaimIRMemory))
+        {
+            perfResult << "Recycled IR Memory: " << UInt64(getSession()->m_recycledIRMemory)
+                       << "\n";
+            perfResult << "Compacted IR Memory: " << UInt64(getSession()->m_compactedIRMemory)
+                       << "\n";
+        }
+        const auto downstreamCompileStats =
+            getSession()->m_downstreamCompileScheduler.getStats();
+        if (downstreamCompileStats.compileCount)
+        {
+            perfResult << "Downstream Compilations: " << Int64(downstreamCompileStats.compileCount)
+                       << " (waited: " << Int64(downstreamCompileStats.waitCount)
+                       << ", max concurrent: " << Int64(downstreamCompileStats.maxActiveCount)
+                       << ")\n";
+        }
+        if (getOptionSet().getBoolOption(CompilerOptionName::SPIRVOptimizerCache))
+        {
+            const UInt64 hitCount = getSession()->m_spirvOptimizerCacheHitCount;
+            const UInt64 missCount = getSession()->m_spirvOptimizerCacheMissCount;
+            perfResult << "SPIR-V Optimizer Cache Hits: " << hitCount << "/"
+                       << (hitCount + missCount) << "\n";
+        }
+        {
+            // Only report the caches that were looked up.
+            auto typeCheckingCache = getLinkage()->getTypeCheckingCache();
+            auto stats = getSession()->getTypeCheckingCacheStats();
+            stats.localHitCount += typeCheckingCache->stats.localHitCount;
+            stats.sharedHitCount += typeCheckingCache->stats.sharedHitCount;
+            stats.missCount += typeCheckingCache->stats.missCount;
+            if (stats.localHitCount + stats.sharedHitCount + stats.missCount)
+            {
+                perfResult << "Type Checking Cache Hits: " << stats.localHitCount << " local, "
+                           << stats.sharedHitCount << " shared, " << stats.missCount
+                           << " missed (" << stats.sharedEntryCount << " shared entries, "
+                           << stats.mergeCount << " merges)\n";
+            }
+
+            const UInt64 hitCount = typeCheckingCache->callOverloadCacheHitCount;
+            const UInt64 missCount = typeCheckingCache->callOverloadCacheMissCount;
+            if (hitCount + missCount)
+            {
+                perfResult << "Call Overload Cache Hits: " << hitCount << "/"
+                           << (hitCount + missCount) << "\n";
+            }
+        }
+        {
+            auto includedFileTokenCache = getLinkage()->getIncludedFileTokenCache();
+            if (includedFileTokenCache->lexCount)
+            {
+                perfResult << "Included File Token Cache: "
+                           << Int64(includedFileTokenCache->replayCount) << " replayed, "
+                           << Int64(includedFileTokenCache->lexCount) << " lexed, "
+                           << Int64(includedFileTokenCache->invalidatedCount) << " invalidated\n";
+            }
+        }
+        if (lazyIRStats.deferredBodyCount)
+        {
+            perfResult << "Lazy IR Bodies Materialized: "
+                       << Int64(lazyIRStats.materializedBodyCount) << "/"
+                       << Int64(lazyIRStats.deferredBodyCount) << "\n";
+            perfResult << "Lazy IR Insts Materialized: "
+                       << Int64(lazyIRStats.materializedInstCount) << "/"
+                       << Int64(lazyIRStats.deferredInstCount) << "\n";
+            perfResult << "Lazy IR Serial Data Copied: "
+                       << UInt64(lazyIRStats.copiedSerialDataSize) << "/"
+                       << UInt64(lazyIRStats.serialDataSize) << " bytes\n";
+        }
         getSink()->diagnose(
             SourceLoc(),
             Diagnostics::performanceBenchmarkResult,
             perfResult.produceString());
     }
+    if (perfTraceFileName.getLength())
+    {
+        StringBuilder trace;
+        PerformanceProfiler::getProfiler()->getChromeTrace(trace);
+        if (SLANG_FAILED(File::writeAllText(perfTraceFileName, trace.produceString())))
+        {
+            getSink()->diagnose(SourceLoc(), Diagnostics::cannotWriteOutputFile, perfTraceFileName);
+        }
+    }
 
     // Repro dump handling
     {
@@ -7,6 +7,7 @@ SLANG_API void spSetCommandLineCompilerMode(SlangCompileRequest* request);
 #include "../core/slang-io.h"
 #include "../core/slang-test-tool-util.h"
 #include "../slang/slang-internal.h"
+#include "slangc-server.h"
 
 using namespace Slang;
 
@@ -25,7 +26,10 @@ static void _diagnosticCallback(char const* message, void* /*userData*/)
     stdError.flush();
 }
 
-static SlangResult _compile(SlangCompileRequest* compileRequest, int argc, const char* const* argv)
+SlangResult compileWithCommandLine(
+    SlangCompileRequest* compileRequest,
+    int argc,
+    const char* const* argv)
 {
     spSetDiagnosticCallback(compileRequest, &_diagnosticCallback, nullptr);
     spSetCommandLineCompilerMode(compileRequest);
@@ -116,7 +120,7 @@ SLANG_TEST_TOOL_API SlangResult innerMain(
 
     SlangCompileRequest* compileRequest = spCreateCompileRequest(session);
     compileRequest->addSearchPath(Path::getParentDirectory(Path::getExecutablePath()).getBuffer());
-    SlangResult res = _compile(compileRequest, argc, argv);
+    SlangResult res = compileWithCommandLine(compileRequest, argc, argv);
     // Now that we are done, clean up after ourselves
     spDestroyCompileRequest(compileRequest);
 
@@ -126,7 +130,20 @@ SLANG_TEST_TOOL_API SlangResult innerMain(
 int MAIN(int argc, char** argv)
 {
     auto stdWriters = StdWriters::initDefaultSingleton();
-    SlangResult res = innerMain(stdWriters, nullptr, argc, argv);
+
+    SlangResult res;
+    if (argc > 1 && UnownedStringSlice(argv[1]) == "-server")
+    {
+        res = runCompileServer(argc, argv);
+    }
+    else if (argc > 1 && UnownedStringSlice(argv[1]) == "-client")
+    {
+        res = runCompileClient(argc, argv);
+    }
+    else
+    {
+        res = innerMain(stdWriters, nullptr, argc, argv);
+    }
     slang::shutdown();
     return (int)TestToolUtil::getReturnCode(res);
 }
@@ -0,0 +1,556 @@
+// slangc-server.cpp
+#include "slangc-server.h"
+
+#include "../compiler-core/slang-compile-server-protocol.h"
+#include "../compiler-core/slang-json-rpc-connection.h"
+#include "../core/slang-crypto.h"
+#include "../core/slang-http.h"
+#include "../core/slang-io.h"
+#include "../core/slang-process.h"
+#include "../core/slang-std-writers.h"
+#include "../core/slang-string-escape-util.h"
+#include "../core/slang-test-tool-util.h"
+#include "../core/slang-writer.h"
+#include "../slang/slang-internal.h"
+
+#include <stdio.h>
+
+namespace Slang
+{
+
+class CompileServer
+{
+public:
+    SlangResult init(int argc, const char* const* argv);
+
+    /// Execute the server
+    SlangResult execute();
+
+protected:
+    struct DependencyFile
+    {
+        uint64_t modificationTime = 0;
+        SHA1::Digest digest;
+    };
+
+    /// A linkage kept between requests, with the modules loaded by the requests that used it.
+    class WarmLinkage : public RefObject
+    {
+    public:
+        ComPtr<slang::ISession> session;
+        /// The files the loaded modules were compiled from, and their state when they were.
+        Dictionary<String, DependencyFile> dependencies;
+        /// Set if a dependency can't be checked, in which case the linkage isn't reused.
+        bool hasUncheckedDependency = false;
+    };
+
+    /// The most warm linkages that are kept at once.
+    static const Index kMaxWarmLinkageCount = 16;
+
+    SlangResult _executeSingle();
+    SlangResult _executeCompile(const JSONRPCCall& call);
+
+    slang::IGlobalSession* _getOrCreateGlobalSession(bool embedPrelude);
+
+    /// Get the warm linkage for command lines that load modules in the same way as `args`,
+    /// creating a new one if there isn't one, or the modules it has loaded are out of date.
+    WarmLinkage* _getOrCreateWarmLinkage(
+        slang::IGlobalSession* globalSession,
+        const List<String>& args,
+        bool& outIsReused);
+
+    /// Record the files the modules loaded into `linkage` depend on.
+    static void _addDependencies(WarmLinkage* linkage);
+    /// True if none of the files the modules loaded into `linkage` depend on have changed.
+    static bool _isUpToDate(WarmLinkage* linkage);
+
+    static String _getLinkageKey(const List<String>& args);
+    static SlangResult _calcDigest(const String& path, SHA1::Digest& outDigest);
+
+    bool m_quit = false;
+
+    String m_exePath;      ///< Path to the executable
+    String m_exeDirectory; ///< The directory that holds the executable
+
+    /// Global sessions, indexed by whether the prelude is embedded.
+    ComPtr<slang::IGlobalSession> m_globalSessions[2];
+    Dictionary<String, RefPtr<WarmLinkage>> m_warmLinkages;
+
+    RefPtr<JSONRPCConnection> m_connection; ///< Receives compile calls and returns results
+};
+
+SlangResult CompileServer::init(int argc, const char* const* argv)
+{
+    SLANG_UNUSED(argc);
+
+    m_exePath = argv[0];
+    m_exeDirectory = Path::getParentDirectory(Path::getExecutablePath());
+
+    m_connection = new JSONRPCConnection;
+    SLANG_RETURN_ON_FAIL(m_connection->initWithStdStreams());
+    return SLANG_OK;
+}
+
+slang::IGlobalSession* CompileServer::_getOrCreateGlobalSession(bool embedPrelude)
+{
+    auto& session = m_globalSessions[embedPrelude ? 1 : 0];
+    if (!session)
+    {
+        SlangGlobalSessionDesc desc = {};
+        desc.enableGLSL = true;
+        Slang::GlobalSessionInternalDesc internalDesc = {};
+        if (SLANG_FAILED(slang_createGlobalSessionImpl(&desc, &internalDesc, session.writeRef())))
+        {
+            return nullptr;
+        }
+        if (!embedPrelude)
+        {
+            TestToolUtil::setSessionDefaultPreludeFromExePath(m_exePath.getBuffer(), session);
+        }
+    }
+    return session;
+}
+
+/* static */ String CompileServer::_getLinkageKey(const List<String>& args)
+{
+    // Command lines that only differ in the files they compile, and where the output goes, load
+    // modules in the same way. An input file is an argument that isn't an option, or the value
+    // of one, and an option's value always follows it.
+    StringBuilder key;
+    key << Path::getCurrentPath();
+
+    for (Index i = 0; i < args.getCount(); ++i)
+    {
+        const auto& arg = args[i];
+        if (arg == "-o")
+        {
+            ++i;
+            continue;
+        }
+
+        const bool isOption = arg.startsWith("-");
+        const bool followsOption = i > 0 && args[i - 1].startsWith("-");
+        if (!isOption && !followsOption && arg.indexOf('.') >= 0)
+        {
+            continue;
+        }
+
+        key << "\n" << arg;
+    }
+    return key.produceString();
+}
+
+/* static */ SlangResult CompileServer::_calcDigest(const String& path, SHA1::Digest& outDigest)
+{
+    List<unsigned char> contents;
+    SLANG_RETURN_ON_FAIL(File::readAllBytes(path, contents));
+    outDigest = SHA1::compute(contents.getBuffer(), contents.getCount());
+    return SLANG_OK;
+}
+
+/* static */ void CompileServer::_addDependencies(WarmLinkage* linkage)
+{
+    auto session = linkage->session;
+
+    const SlangInt moduleCount = session->getLoadedModuleCount();
+    for (SlangInt i = 0; i < moduleCount; ++i)
+    {
+        auto module = session->getLoadedModule(i);
+
+        const SlangInt32 fileCount = module->getDependencyFileCount();
+        for (SlangInt32 j = 0; j < fileCount; ++j)
+        {
+            String path = module->getDependencyFilePath(j);
+            if (linkage->dependencies.containsKey(path))
+            {
+                continue;
+            }
+
+            DependencyFile file;
+            if (SLANG_FAILED(File::getModificationTime(path, file.modificationTime)) ||
+                SLANG_FAILED(_calcDigest(path, file.digest)))
+            {
+                linkage->hasUncheckedDependency = true;
+                continue;
+            }
+            linkage->dependencies.add(path, file);
+        }
+    }
+}
+
+/* static */ bool CompileServer::_isUpToDate(WarmLinkage* linkage)
+{
+    if (linkage->hasUncheckedDependency)
+    {
+        return false;
+    }
+
+    for (auto& [path, file] : linkage->dependencies)
+    {
+        uint64_t modificationTime;
+        if (SLANG_FAILED(File::getModificationTime(path, modificationTime)))
+        {
+            return false;
+        }
+        if (modificationTime == file.modificationTime)
+        {
+            continue;
+        }
+
+        // The file has been written to, but it only matters if the contents are different.
+        SHA1::Digest digest;
+        if (SLANG_FAILED(_calcDigest(path, digest)) || digest != file.digest)
+        {
+            return false;
+        }
+        file.modificationTime = modificationTime;
+    }
+    return true;
+}
+
+CompileServer::WarmLinkage* CompileServer::_getOrCreateWarmLinkage(
+    slang::IGlobalSession* globalSession,
+    const List<String>& args,
+    bool& outIsReused)
+{
+    outIsReused = false;
+
+    const String key = _getLinkageKey(args);
+
+    RefPtr<WarmLinkage> linkage;
+    if (m_warmLinkages.tryGetValue(key, linkage))
+    {
+        if (_isUpToDate(linkage))
+        {
+            outIsReused = true;
+            return linkage;
+        }
+        m_warmLinkages.remove(key);
+    }
+
+    // Rather than track which linkages were used least recently, start over when there are
+    // too many.
+    if (m_warmLinkages.getCount() >= kMaxWarmLinkageCount)
+    {
+        m_warmLinkages.clear();
+    }
+
+    linkage = new WarmLinkage;
+    slang::SessionDesc sessionDesc = {};
+    if (SLANG_FAILED(globalSession->createSession(sessionDesc, linkage->session.writeRef())))
+    {
+        return nullptr;
+    }
+
+    m_warmLinkages.add(key, linkage);
+    return linkage;
+}
+
+SlangResult CompileServer::_executeCompile(const JSONRPCCall& call)
+{
+    auto id = m_connection->getPersistentValue(call.id);
+
+    CompileServerProtocol::CompileArgs args;
+    SLANG_RETURN_ON_FAIL(m_connection->toNativeArgsOrSendError(call.params, &args, id));
+
+    if (args.workingDirectory.getLength() &&
+        SLANG_FAILED(Path::setCurrentPath(args.workingDirectory)))
+    {
+        return m_connection->sendError(JSONRPC::ErrorCode::InvalidParams, id);
+    }
+
+    // Work out the command line, including the 'exe' name
+    List<const char*> argv;
+    argv.add(m_exePath.getBuffer());
+    for (const auto& arg : args.args)
+    {
+        argv.add(arg.getBuffer());
+    }
+    const int argc = int(argv.getCount());
+
+    StdWriters stdWriters;
+    StringBuilder stdOut;
+    StringBuilder stdError;
+
+    // Make writer/s act as if they are the console.
+    RefPtr<StringWriter> stdOutWriter(new StringWriter(&stdOut, WriterFlag::IsConsole));
+    RefPtr<StringWriter> stdErrorWriter(new StringWriter(&stdError, WriterFlag::IsConsole));
+
+    stdWriters.setWriter(SLANG_WRITER_CHANNEL_STD_ERROR, stdErrorWriter);
+    stdWriters.setWriter(SLANG_WRITER_CHANNEL_STD_OUTPUT, stdOutWriter);
+    stdWriters.setWriter(SLANG_WRITER_CHANNEL_DIAGNOSTIC, stdErrorWriter);
+
+    StdWriters* const prevStdWriters = StdWriters::getSingleton();
+    StdWriters::setSingleton(&stdWriters);
+
+    ComPtr<slang::IGlobalSession> globalSession;
+    WarmLinkage* linkage = nullptr;
+    bool isReused = false;
+
+    const bool embedPrelude = shouldEmbedPrelude(argv.getBuffer(), argc);
+    if (TestToolUtil::hasDeferredCoreModule(Index(argc - 1), argv.getBuffer() + 1))
+    {
+        // A command line that sets up the core module needs a global session of its own, so
+        // nothing is kept.
+        if (SLANG_SUCCEEDED(slang_createGlobalSessionWithoutCoreModule(
+                SLANG_API_VERSION,
+                globalSession.writeRef())) &&
+            !embedPrelude)
+        {
+            TestToolUtil::setSessionDefaultPreludeFromExePath(m_exePath.getBuffer(), globalSession);
+        }
+    }
+    else
+    {
+        globalSession = _getOrCreateGlobalSession(embedPrelude);
+        if (globalSession)
+        {
+            linkage = _getOrCreateWarmLinkage(globalSession, args.args, isReused);
+        }
+    }
+
+    SlangResult res = SLANG_FAIL;
+
+    SlangCompileRequest* compileRequest = nullptr;
+    if (linkage)
+    {
+        if (SLANG_SUCCEEDED(linkage->session->createCompileRequest(&compileRequest)))
+        {
+            slang_setCompileRequestRestoresLinkage(compileRequest);
+        }
+    }
+    else if (globalSession)
+    {
+        compileRequest = spCreateCompileRequest(globalSession);
+    }
+
+    if (compileRequest)
+    {
+        for (int i = 0; i < int{SLANG_WRITER_CHANNEL_COUNT_OF}; ++i)
+        {
+            const auto channel = SlangWriterChannel(i);
+            compileRequest->setWriter(channel, stdWriters.getWriter(channel));
+        }
+        compileRequest->addSearchPath(m_exeDirectory.getBuffer());
+
+        res = compileWithCommandLine(compileRequest, argc, argv.getBuffer());
+
+        // Destroying the request puts the linkage back as it was, apart from the modules the
+        // request loaded.
+        spDestroyCompileRequest(compileRequest);
+
+        if (linkage)
+        {
+            _addDependencies(linkage);
+        }
+    }
+
+    StdWriters::setSingleton(prevStdWriters);
+
+    CompileServerProtocol::CompileResult result;
+    result.result = res;
+    result.stdError = stdError;
+    result.stdOut = stdOut;
+    result.returnCode = int32_t(TestToolUtil::getReturnCode(res));
+    result.reusedLinkage = isReused;
+    return m_connection->sendResult(&result, id);
+}
+
+SlangResult CompileServer::_executeSingle()
+{
+    // Block waiting for content (or error/closed)
+    SLANG_RETURN_ON_FAIL(m_connection->waitForResult());
+
+    // If we don't have a message, we can quit for now
+    if (!m_connection->hasMessage())
+    {
+        return SLANG_OK;
+    }
+
+    if (m_connection->getMessageType() != JSONRPCMessageType::Call)
+    {
+        return m_connection->sendError(
+            JSONRPC::ErrorCode::InvalidRequest,
+            m_connection->getCurrentMessageId());
+    }
+
+    JSONRPCCall call;
+    SLANG_RETURN_ON_FAIL(m_connection->getRPCOrSendError(&call));
+
+    if (call.method == CompileServerProtocol::QuitArgs::g_methodName)
+    {
+        m_quit = true;
+        return SLANG_OK;
+    }
+    else if (call.method == CompileServerProtocol::CompileArgs::g_methodName)
+    {
+        return _executeCompile(call);
+    }
+
+    return m_connection->sendError(JSONRPC::ErrorCode::MethodNotFound, call.id);
+}
+
+SlangResult CompileServer::execute()
+{
+    while (m_connection->isActive() && !m_quit)
+    {
+        // Failure doesn't make the execution terminate
+        [[maybe_unused]] const SlangResult res = _executeSingle();
+    }
+
+    return SLANG_OK;
+}
+
+/* !!!!!!!!!!!!!!!!!!!!!!!!!!!! CompileClient !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+
+/// Read a line from `file` into `out`, without the line ending. Returns false at the end of the
+/// file.
+static bool _readLine(FILE* file, StringBuilder& out)
+{
+    out.clear();
+
+    char buffer[1024];
+    bool hasContent = false;
+    while (fgets(buffer, SLANG_COUNT_OF(buffer), file))
+    {
+        hasContent = true;
+        UnownedStringSlice slice(buffer);
+        if (slice.endsWith("\n"))
+        {
+            out << slice.trim();
+            return true;
+        }
+        out << slice;
+    }
+    return hasContent;
+}
+
+/// Split a command line into arguments. Arguments that contain spaces can be quoted.
+static SlangResult _splitCommandLine(const UnownedStringSlice& line, List<String>& outArgs)
+{
+    auto escapeHandler = StringEscapeUtil::getHandler(StringEscapeUtil::Style::Space);
+
+    const char* cursor = line.begin();
+    const char* const end = line.end();
+    while (cursor < end)
+    {
+        if (*cursor == ' ' || *cursor == '\t')
+        {
+            ++cursor;
+            continue;
+        }
+
+        const char* const argBegin = cursor;
+        while (cursor < end && *cursor != ' ' && *cursor != '\t')
+        {
+            if (*cursor == '"')
+            {
+                SLANG_RETURN_ON_FAIL(escapeHandler->lexQuoted(cursor, &cursor));
+            }
+            else
+            {
+                ++cursor;
+            }
+        }
+
+        StringBuilder arg;
+        SLANG_RETURN_ON_FAIL(StringEscapeUtil::appendMaybeUnquoted(
+            escapeHandler,
+            UnownedStringSlice(argBegin, cursor),
+            arg));
+        outArgs.add(arg.produceString());
+    }
+    return SLANG_OK;
+}
+
+static SlangResult _createServerConnection(RefPtr<JSONRPCConnection>& out)
+{
+    RefPtr<Process> process;
+    {
+        CommandLine cmdLine;
+        cmdLine.setExecutableLocation(ExecutableLocation(Path::getExecutablePath()));
+        cmdLine.addArg("-server");
+        SLANG_RETURN_ON_FAIL(
+            Process::create(cmdLine, Process::Flag::DisableStdErrRedirection, process));
+    }
+
+    Stream* writeStream = process->getStream(StdStreamType::In);
+    RefPtr<BufferedReadStream> readStream(
+        new BufferedReadStream(process->getStream(StdStreamType::Out)));
+
+    RefPtr<HTTPPacketConnection> connection = new HTTPPacketConnection(readStream, writeStream);
+    RefPtr<JSONRPCConnection> rpcConnection = new JSONRPCConnection;
+
+    SLANG_RETURN_ON_FAIL(
+        rpcConnection->init(connection, JSONRPCConnection::CallStyle::Default, process));
+
+    out = rpcConnection;
+    return SLANG_OK;
+}
+
+static SlangResult _executeClient()
+{
+    RefPtr<JSONRPCConnection> connection;
+    SLANG_RETURN_ON_FAIL(_createServerConnection(connection));
+
+    const String workingDirectory = Path::getCurrentPath();
+
+    // The result is the first failure, if there is one.
+    SlangResult res = SLANG_OK;
+
+    StringBuilder line;
+    while (_readLine(stdin, line))
+    {
+        CompileServerProtocol::CompileArgs args;
+        args.workingDirectory = workingDirectory;
+        SLANG_RETURN_ON_FAIL(_splitCommandLine(line.getUnownedSlice(), args.args));
+        if (args.args.getCount() == 0)
+        {
+            continue;
+        }
+
+        SLANG_RETURN_ON_FAIL(
+            connection->sendCall(CompileServerProtocol::CompileArgs::g_methodName, &args));
+        SLANG_RETURN_ON_FAIL(connection->waitForResult());
+        if (!connection->hasMessage() ||
+            connection->getMessageType() != JSONRPCMessageType::Result)
+        {
+            return SLANG_FAIL;
+        }
+
+        CompileServerProtocol::CompileResult result;
+        SLANG_RETURN_ON_FAIL(connection->getMessage(&result));
+
+        StdWriters::getOut().put(result.stdOut.getUnownedSlice());
+        StdWriters::getOut().flush();
+        StdWriters::getError().put(result.stdError.getUnownedSlice());
+        StdWriters::getError().flush();
+
+        if (SLANG_SUCCEEDED(res) && SLANG_FAILED(result.result))
+        {
+            res = result.result;
+        }
+    }
+
+    // Sends `quit`, and waits for the server to exit.
+    connection->disconnect();
+    return res;
+}
+
+} // namespace Slang
+
+using namespace Slang;
+
+SlangResult runCompileServer(int argc, const char* const* argv)
+{
+    CompileServer server;
+    SLANG_RETURN_ON_FAIL(server.init(argc, argv));
+    return server.execute();
+}
+
+SlangResult runCompileClient(int argc, const char* const* argv)
+{
+    SLANG_UNUSED(argc);
+    SLANG_UNUSED(argv);
+    return _executeClient();
+}
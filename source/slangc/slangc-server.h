@@ -0,0 +1,32 @@
+// slangc-server.h
+#ifndef SLANGC_SERVER_H
+#define SLANGC_SERVER_H
+
+#include "slang.h"
+
+/// Compile with the `slangc` command line `argv` (which includes the executable name), using a
+/// compile request that has already been created.
+SlangResult compileWithCommandLine(
+    SlangCompileRequest* compileRequest,
+    int argc,
+    const char* const* argv);
+
+/// True if the command line has `-embed-prelude`.
+bool shouldEmbedPrelude(const char* const* argv, int argc);
+
+/// Run `slangc -server`.
+///
+/// Compile requests are read as JSON-RPC calls from stdin, and results are written to stdout,
+/// until a `quit` call is received or stdin is closed. Global sessions and the modules each
+/// kind of command line loads are kept between requests, so only what changed is compiled
+/// again.
+SlangResult runCompileServer(int argc, const char* const* argv);
+
+/// Run `slangc -client`.
+///
+/// Starts a `slangc -server` and sends it each line read from stdin as a `slangc` command line.
+/// Output of each compilation is written to stdout and stderr, as `slangc` would. The server is
+/// stopped when stdin ends, so modules are only reused between the lines of one client.
+SlangResult runCompileClient(int argc, const char* const* argv);
+
+#endif // SLANGC_SERVER_H
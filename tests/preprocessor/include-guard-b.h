@@ -0,0 +1,18 @@
+// include-guard-b.h
+
+// Used by the `include-guard.slang` test
+//
+// This looks like an include guard, but the macro defined
+// after the `#endif` means including it again does something.
+
+#ifndef INCLUDE_GUARD_B_H
+#define INCLUDE_GUARD_B_H
+
+float guardedB(float x)
+{
+    return x;
+}
+
+#endif
+
+#define INCLUDED_B 1
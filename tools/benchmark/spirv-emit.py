@@ -0,0 +1,111 @@
+import os
+import sys
+import time
+import argparse
+import tempfile
+import subprocess
+
+# Compiles a large generated kernel to SPIR-V, so that most of the compile time goes into
+# emitting SPIR-V, and reports the time and peak memory of each compile.
+#
+# Given a `--reference` slangc, for example one built before a change to the SPIR-V emitter,
+# the same kernel is compiled with it too, and the two outputs have to be byte-identical.
+#
+# Peak memory is the maximum resident set size of the slangc process, and is only measured
+# where `os.wait4` is available.
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--slangc', type=str, default=os.path.join('..', '..', 'build', 'Release', 'bin', 'slangc'))
+parser.add_argument('--reference', type=str, default=None)
+parser.add_argument('--functions', type=int, default=200)
+parser.add_argument('--samples', type=int, default=10)
+
+args = parser.parse_args(sys.argv[1:])
+
+def generate_kernel(function_count):
+    lines = []
+    lines.append('RWStructuredBuffer<float4> outputBuffer;')
+    lines.append('struct Data { float4 a; float4 b; int c; };')
+    for i in range(function_count):
+        lines.append(f'float4 f{i}(Data d, int n)')
+        lines.append('{')
+        lines.append(f'    float4 r = d.a * {i}.5f + d.b;')
+        lines.append('    for (int j = 0; j < n; j++)')
+        lines.append('    {')
+        lines.append(f'        if ((j & {i % 7 + 1}) == 0)')
+        lines.append('            r = sin(r) + cos(d.a * j);')
+        lines.append('        else')
+        lines.append(f'            r = r * d.b + float4(j, d.c, {i}, 1);')
+        lines.append('    }')
+        lines.append('    return r;')
+        lines.append('}')
+    lines.append('[shader("compute")]')
+    lines.append('[numthreads(64, 1, 1)]')
+    lines.append('void main(uint3 tid : SV_DispatchThreadID)')
+    lines.append('{')
+    lines.append('    Data d = { outputBuffer[0], outputBuffer[1], int(tid.x) };')
+    lines.append('    float4 r = 0;')
+    for i in range(function_count):
+        lines.append(f'    r += f{i}(d, int(tid.x) + {i});')
+    lines.append('    outputBuffer[tid.x] = r;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+# Returns the time in seconds and the peak memory in kilobytes, or None if it can't be measured.
+def compile(slangc, source, output):
+    cmd = [slangc, source, '-target', 'spirv', '-profile', 'spirv_1_5', '-entry', 'main', '-stage', 'compute', '-o', output]
+    start = time.perf_counter()
+    process = subprocess.Popen(cmd)
+    if hasattr(os, 'wait4'):
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        process.returncode = os.waitstatus_to_exitcode(status)
+        # ru_maxrss is in kilobytes on Linux, and in bytes on macOS.
+        peak = usage.ru_maxrss // 1024 if sys.platform == 'darwin' else usage.ru_maxrss
+    else:
+        process.wait()
+        elapsed = time.perf_counter() - start
+        peak = None
+    if process.returncode != 0:
+        print(f'[Error] Failed to run command: {" ".join(cmd)}')
+        sys.exit(1)
+    return elapsed, peak
+
+def read_bytes(path):
+    with open(path, 'rb') as file:
+        return file.read()
+
+def run(slangc, source, output):
+    times = []
+    peaks = []
+    code = None
+    for i in range(args.samples):
+        elapsed, peak = compile(slangc, source, output)
+        times.append(elapsed)
+        if peak is not None:
+            peaks.append(peak)
+
+        # Emission has to be deterministic.
+        sample_code = read_bytes(output)
+        if code is None:
+            code = sample_code
+        elif sample_code != code:
+            print(f'[Error] {slangc} produced different SPIR-V from run to run')
+            sys.exit(1)
+
+    peak = f'{max(peaks)} KB' if peaks else 'not measured'
+    print(f'{slangc}: {1000 * min(times):.1f} ms (min of {args.samples}), {1000 * sum(times) / len(times):.1f} ms (mean), peak memory {peak}')
+    return code
+
+with tempfile.TemporaryDirectory() as directory:
+    source = os.path.join(directory, 'spirv-emit.slang')
+    with open(source, 'w') as file:
+        file.write(generate_kernel(args.functions))
+
+    code = run(args.slangc, source, os.path.join(directory, 'spirv-emit.spv'))
+    if args.reference:
+        reference_code = run(args.reference, source, os.path.join(directory, 'spirv-emit-reference.spv'))
+        if code != reference_code:
+            print(f'[Error] SPIR-V differs from that of {args.reference}')
+            sys.exit(1)
+        print('SPIR-V is identical to the reference')
@@ -0,0 +1,179 @@
+#include "core/slang-basic.h"
+#include "gfx-test-util.h"
+#include "gfx-util/shader-cursor.h"
+#include "slang-gfx.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace gfx;
+
+namespace gfx_test
+{
+static const int kElementCount = 256;
+
+static ComPtr<IDevice> createCPUDevice(UnitTestContext* context, uint32_t threadCount)
+{
+    Slang::List<const char*> searchPaths = getSlangSearchPaths();
+
+    IDevice::Desc deviceDesc = {};
+    deviceDesc.deviceType = DeviceType::CPU;
+    deviceDesc.slang.slangGlobalSession = context->slangGlobalSession;
+    deviceDesc.slang.searchPaths = searchPaths.getBuffer();
+    deviceDesc.slang.searchPathCount = (GfxCount)searchPaths.getCount();
+
+    CPUDeviceExtendedDesc cpuDesc = {};
+    cpuDesc.threadCount = threadCount;
+    void* extDescPtrs[1] = {&cpuDesc};
+    deviceDesc.extendedDescCount = 1;
+    deviceDesc.extendedDescs = extDescPtrs;
+
+    ComPtr<IDevice> device;
+    if (SLANG_FAILED(gfxCreateDevice(&deviceDesc, device.writeRef())))
+        return nullptr;
+    return device;
+}
+
+static ComPtr<IBufferResource> createBuffer(IDevice* device, int elementCount, uint32_t* data)
+{
+    IBufferResource::Desc bufferDesc = {};
+    bufferDesc.sizeInBytes = elementCount * sizeof(uint32_t);
+    bufferDesc.format = gfx::Format::Unknown;
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBufferResource> buffer;
+    GFX_CHECK_CALL_ABORT(device->createBufferResource(bufferDesc, data, buffer.writeRef()));
+    return buffer;
+}
+
+static ComPtr<IResourceView> createBufferView(IDevice* device, IBufferResource* buffer)
+{
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    GFX_CHECK_CALL_ABORT(
+        device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+    return bufferView;
+}
+
+// Run the kernel on a CPU device that dispatches on `threadCount` threads, and read back the
+// values written by each thread, and the number of threads that ran.
+static void runDispatch(
+    UnitTestContext* context,
+    uint32_t threadCount,
+    Slang::List<uint32_t>& outValues,
+    uint32_t& outCount)
+{
+    auto device = createCPUDevice(context, threadCount);
+    if (!device)
+    {
+        SLANG_IGNORE_TEST
+    }
+
+    Slang::ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    GFX_CHECK_CALL_ABORT(
+        device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    GFX_CHECK_CALL_ABORT(loadComputeProgram(
+        device,
+        shaderProgram,
+        "cpu-multithreaded-dispatch",
+        "computeMain",
+        slangReflection));
+
+    ComputePipelineStateDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<gfx::IPipelineState> pipelineState;
+    GFX_CHECK_CALL_ABORT(
+        device->createComputePipelineState(pipelineDesc, pipelineState.writeRef()));
+
+    Slang::List<uint32_t> initialValues;
+    initialValues.setCount(kElementCount);
+    for (auto& value : initialValues)
+        value = 0;
+    uint32_t initialCount = 0;
+
+    auto valuesBuffer = createBuffer(device, kElementCount, initialValues.getBuffer());
+    auto countBuffer = createBuffer(device, 1, &initialCount);
+    auto valuesView = createBufferView(device, valuesBuffer);
+    auto countView = createBufferView(device, countBuffer);
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+
+        auto rootObject = encoder->bindPipeline(pipelineState);
+        ShaderCursor(rootObject).getPath("buffer").setResource(valuesView);
+        ShaderCursor(rootObject).getPath("counter").setResource(countView);
+
+        // 8 * 4 threads wide, 4 high and 2 deep.
+        encoder->dispatchCompute(8, 4, 2);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    ComPtr<ISlangBlob> valuesBlob;
+    GFX_CHECK_CALL_ABORT(device->readBufferResource(
+        valuesBuffer,
+        0,
+        kElementCount * sizeof(uint32_t),
+        valuesBlob.writeRef()));
+    outValues.setCount(kElementCount);
+    memcpy(outValues.getBuffer(), valuesBlob->getBufferPointer(), kElementCount * sizeof(uint32_t));
+
+    ComPtr<ISlangBlob> countBlob;
+    GFX_CHECK_CALL_ABORT(
+        device->readBufferResource(countBuffer, 0, sizeof(uint32_t), countBlob.writeRef()));
+    memcpy(&outCount, countBlob->getBufferPointer(), sizeof(uint32_t));
+}
+
+// Test that dispatching on several threads on the CPU device gives the same results as
+// dispatching on one.
+SLANG_UNIT_TEST(cpuMultithreadedDispatch)
+{
+    if ((Slang::RenderApiFlag::CPU & unitTestContext->enabledApis) == 0)
+    {
+        SLANG_IGNORE_TEST
+    }
+
+    Slang::List<uint32_t> expectedValues;
+    for (uint32_t index = 0; index < kElementCount; ++index)
+    {
+        uint32_t value = index;
+        for (uint32_t i = 0; i < index % 16; ++i)
+            value = value * 1664525u + 1013904223u;
+        expectedValues.add(value);
+    }
+
+    Slang::List<uint32_t> singleThreadedValues;
+    uint32_t singleThreadedCount = 0;
+    runDispatch(unitTestContext, 1, singleThreadedValues, singleThreadedCount);
+    SLANG_CHECK(singleThreadedValues == expectedValues);
+    SLANG_CHECK(singleThreadedCount == kElementCount);
+
+    for (uint32_t threadCount : {2u, 4u, 0u})
+    {
+        Slang::List<uint32_t> values;
+        uint32_t count = 0;
+        runDispatch(unitTestContext, threadCount, values, count);
+        SLANG_CHECK(values == singleThreadedValues);
+        SLANG_CHECK(count == singleThreadedCount);
+    }
+}
+
+} // namespace gfx_test
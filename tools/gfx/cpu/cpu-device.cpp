@@ -35,6 +35,20 @@ SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::initialize(const Desc& desc)
 
     SLANG_RETURN_ON_FAIL(RendererBase::initialize(desc));
 
+    // Read properties from extended device descriptions
+    for (GfxIndex i = 0; i < desc.extendedDescCount; i++)
+    {
+        StructType stype;
+        memcpy(&stype, desc.extendedDescs[i], sizeof(stype));
+        switch (stype)
+        {
+        case StructType::CPUDeviceExtendedDesc:
+            m_dispatchThreadCount =
+                static_cast<CPUDeviceExtendedDesc*>(desc.extendedDescs[i])->threadCount;
+            break;
+        }
+    }
+
     // Initialize DeviceInfo
     {
         m_info.deviceType = DeviceType::CPU;
@@ -279,17 +293,71 @@ void DeviceImpl::dispatchCompute(int x, int y, int z)
 
     auto func = (slang_prelude::ComputeFunc)sharedLibrary->findSymbolAddressByName(entryPointName);
 
-    slang_prelude::ComputeVaryingInput varyingInput;
-    varyingInput.startGroupID.x = 0;
-    varyingInput.startGroupID.y = 0;
-    varyingInput.startGroupID.z = 0;
-    varyingInput.endGroupID.x = x;
-    varyingInput.endGroupID.y = y;
-    varyingInput.endGroupID.z = z;
-
     auto globalParamsData = m_currentRootObject->getDataBuffer();
     auto entryPointParamsData = entryPointObject->getDataBuffer();
-    func(&varyingInput, entryPointParamsData, globalParamsData);
+
+    if (x <= 0 || y <= 0 || z <= 0)
+        return;
+
+    if (m_dispatchThreadCount != 1 && !m_threadPool)
+        m_threadPool = new ThreadPool(Count(m_dispatchThreadCount));
+
+    // The kernel runs all groups in the box [startGroupID, endGroupID), so the dispatch is split
+    // into boxes of groups (tiles) that are run concurrently. Groups don't share any state on the
+    // CPU target, as group shared variables are local to each call of the kernel.
+    //
+    // A few tiles per thread are made so that threads that finish their tiles early can pick
+    // up more, which balances the load when groups take different amounts of time.
+    const Count threadCount = m_threadPool ? m_threadPool->getThreadCount() : 1;
+    const int64_t targetTileCount = int64_t(threadCount) * 4;
+
+    const int groupCount[3] = {x, y, z};
+    int tileSize[3] = {x, y, z};
+    auto getTileCount = [&](int axis)
+    { return int64_t((groupCount[axis] + tileSize[axis] - 1) / tileSize[axis]); };
+    auto getTotalTileCount = [&]() { return getTileCount(0) * getTileCount(1) * getTileCount(2); };
+
+    // Halve the largest side of the tile until there are enough tiles. Splitting the outermost
+    // axes first where sides are equal keeps the groups of a tile contiguous in memory, as
+    // group IDs usually map to buffer indices with x varying fastest.
+    while (threadCount > 1 && getTotalTileCount() < targetTileCount)
+    {
+        int axis = 2;
+        for (int i = 1; i >= 0; --i)
+        {
+            if (tileSize[i] > tileSize[axis])
+                axis = i;
+        }
+        if (tileSize[axis] <= 1)
+            break;
+        tileSize[axis] = (tileSize[axis] + 1) / 2;
+    }
+
+    const int64_t tileCountX = getTileCount(0);
+    const int64_t tileCountY = getTileCount(1);
+    const int64_t totalTileCount = getTotalTileCount();
+
+    auto runTile = [&](Index tileIndex)
+    {
+        const int64_t tileX = int64_t(tileIndex) % tileCountX;
+        const int64_t tileY = (int64_t(tileIndex) / tileCountX) % tileCountY;
+        const int64_t tileZ = int64_t(tileIndex) / (tileCountX * tileCountY);
+
+        slang_prelude::ComputeVaryingInput varyingInput;
+        varyingInput.startGroupID.x = uint32_t(tileX * tileSize[0]);
+        varyingInput.startGroupID.y = uint32_t(tileY * tileSize[1]);
+        varyingInput.startGroupID.z = uint32_t(tileZ * tileSize[2]);
+        varyingInput.endGroupID.x = uint32_t(Math::Min(int64_t(x), (tileX + 1) * tileSize[0]));
+        varyingInput.endGroupID.y = uint32_t(Math::Min(int64_t(y), (tileY + 1) * tileSize[1]));
+        varyingInput.endGroupID.z = uint32_t(Math::Min(int64_t(z), (tileZ + 1) * tileSize[2]));
+
+        func(&varyingInput, entryPointParamsData, globalParamsData);
+    };
+
+    if (totalTileCount == 1)
+        runTile(0);
+    else
+        m_threadPool->parallelFor(Index(totalTileCount), runTile);
 }
 
 void DeviceImpl::copyBuffer(
@@ -1,5 +1,6 @@
 // cpu-device.h
 #pragma once
+#include "core/slang-thread-pool.h"
 #include "cpu-base.h"
 #include "cpu-pipeline-state.h"
 #include "cpu-shader-object.h"
@@ -83,6 +84,11 @@ private:
     RefPtr<RootShaderObjectImpl> m_currentRootObject = nullptr;
     DeviceInfo m_info;
 
+    // Number of threads to run dispatches on, 0 for all hardware threads.
+    uint32_t m_dispatchThreadCount = 1;
+    // Created on the first dispatch that is split across threads.
+    RefPtr<ThreadPool> m_threadPool;
+
     virtual void setPipelineState(IPipelineState* state) override;
 
     virtual void bindRootShaderObject(IShaderObject* object) override;
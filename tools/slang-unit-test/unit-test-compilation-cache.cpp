@@ -0,0 +1,137 @@
+// unit-test-compilation-cache.cpp
+
+#include "../../source/core/slang-io.h"
+#include "../../source/core/slang-process.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kCompilationCacheTestSource = R"(
+    RWStructuredBuffer<float> outputBuffer;
+
+    [shader("compute")]
+    [numthreads(1, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = tid.x * 2.0f;
+    }
+    )";
+
+static ComPtr<slang::ISession> _createSessionWithCache(
+    slang::IGlobalSession* globalSession,
+    const String& cacheDirectory)
+{
+    slang::TargetDesc targetDesc = {};
+    targetDesc.format = SLANG_HLSL;
+    targetDesc.profile = globalSession->findProfile("sm_5_0");
+
+    slang::CompilerOptionEntry option;
+    option.name = slang::CompilerOptionName::CompilationCachePath;
+    option.value.kind = slang::CompilerOptionValueKind::String;
+    option.value.stringValue0 = cacheDirectory.getBuffer();
+
+    slang::SessionDesc sessionDesc = {};
+    sessionDesc.targetCount = 1;
+    sessionDesc.targets = &targetDesc;
+    sessionDesc.compilerOptionEntryCount = 1;
+    sessionDesc.compilerOptionEntries = &option;
+
+    ComPtr<slang::ISession> session;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+    return session;
+}
+
+static ComPtr<slang::IComponentType> _linkTestProgram(slang::ISession* session)
+{
+    ComPtr<slang::IBlob> diagnosticBlob;
+    auto module = session->loadModuleFromSourceString(
+        "m",
+        "m.slang",
+        kCompilationCacheTestSource,
+        diagnosticBlob.writeRef());
+    SLANG_CHECK(module != nullptr);
+
+    ComPtr<slang::IEntryPoint> entryPoint;
+    module->findEntryPointByName("computeMain", entryPoint.writeRef());
+    SLANG_CHECK(entryPoint != nullptr);
+
+    slang::IComponentType* components[] = {module, entryPoint};
+    ComPtr<slang::IComponentType> composite;
+    session->createCompositeComponentType(components, 2, composite.writeRef());
+
+    ComPtr<slang::IComponentType> linkedProgram;
+    composite->link(linkedProgram.writeRef(), diagnosticBlob.writeRef());
+    SLANG_CHECK(linkedProgram != nullptr);
+    return linkedProgram;
+}
+
+// Test that code generated by one session is found in the compilation cache by
+// another session compiling the same program.
+//
+SLANG_UNIT_TEST(compilationCache)
+{
+    String cacheDirectory = Path::simplify(
+        Path::getParentDirectory(Path::getExecutablePath()) + "/compilation-cache-test" +
+        String(Process::getId()));
+
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    ComPtr<slang::IBlob> firstCode;
+    {
+        auto session = _createSessionWithCache(globalSession, cacheDirectory);
+
+        ComPtr<slang::ICompilationCacheService_Experimental> cacheService;
+        session->queryInterface(SLANG_IID_PPV_ARGS(cacheService.writeRef()));
+        SLANG_CHECK(cacheService != nullptr);
+        SLANG_CHECK(cacheService->clearCache() == SLANG_OK);
+
+        auto program = _linkTestProgram(session);
+        SLANG_CHECK(program->getEntryPointCode(0, 0, firstCode.writeRef()) == SLANG_OK);
+        SLANG_CHECK(firstCode != nullptr);
+
+        SlangInt hitCount = -1, missCount = -1, entryCount = -1;
+        SLANG_CHECK(
+            cacheService->getCacheStatistics(&hitCount, &missCount, &entryCount) == SLANG_OK);
+        SLANG_CHECK(hitCount == 0);
+        SLANG_CHECK(missCount == 1);
+        SLANG_CHECK(entryCount == 1);
+    }
+
+    {
+        auto session = _createSessionWithCache(globalSession, cacheDirectory);
+
+        ComPtr<slang::ICompilationCacheService_Experimental> cacheService;
+        session->queryInterface(SLANG_IID_PPV_ARGS(cacheService.writeRef()));
+        SLANG_CHECK(cacheService != nullptr);
+
+        auto program = _linkTestProgram(session);
+        ComPtr<slang::IBlob> secondCode;
+        SLANG_CHECK(program->getEntryPointCode(0, 0, secondCode.writeRef()) == SLANG_OK);
+        SLANG_CHECK(secondCode != nullptr);
+        SLANG_CHECK(secondCode->getBufferSize() == firstCode->getBufferSize());
+        SLANG_CHECK(
+            ::memcmp(
+                secondCode->getBufferPointer(),
+                firstCode->getBufferPointer(),
+                firstCode->getBufferSize()) == 0);
+
+        SlangInt hitCount = -1, missCount = -1;
+        SLANG_CHECK(cacheService->getCacheStatistics(&hitCount, &missCount, nullptr) == SLANG_OK);
+        SLANG_CHECK(hitCount == 1);
+        SLANG_CHECK(missCount == 0);
+
+        // Resetting the statistics only resets the hit and miss counts.
+        cacheService->resetCacheStatistics();
+        SlangInt entryCount = -1;
+        SLANG_CHECK(
+            cacheService->getCacheStatistics(&hitCount, &missCount, &entryCount) == SLANG_OK);
+        SLANG_CHECK(hitCount == 0);
+        SLANG_CHECK(missCount == 0);
+        SLANG_CHECK(entryCount == 1);
+
+        SLANG_CHECK(cacheService->clearCache() == SLANG_OK);
+    }
+}
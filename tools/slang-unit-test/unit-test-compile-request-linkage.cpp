@@ -0,0 +1,100 @@
+// unit-test-compile-request-linkage.cpp
+
+#include "../../source/slang/slang-internal.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kCompileRequestLinkageHelperSource = R"(
+    public float helper(float x) { return x * 2; }
+    )";
+
+static const char* kCompileRequestLinkageFirstSource = R"(
+    import helper;
+
+    RWStructuredBuffer<float> outputBuffer;
+
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = helper(outputBuffer[tid.x]);
+    }
+    )";
+
+static const char* kCompileRequestLinkageSecondSource = R"(
+    import helper;
+
+    #ifdef FROM_FIRST_REQUEST
+    #error "a define from an earlier request was used"
+    #endif
+
+    RWStructuredBuffer<float> outputBuffer;
+
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = helper(outputBuffer[tid.x]) + 1;
+    }
+    )";
+
+static SlangResult _compileWithSession(
+    slang::ISession* session,
+    const char* source,
+    const char* define)
+{
+    ComPtr<slang::ICompileRequest> request;
+    SLANG_RETURN_ON_FAIL(session->createCompileRequest(request.writeRef()));
+    slang_setCompileRequestRestoresLinkage(request);
+
+    if (define)
+    {
+        request->addPreprocessorDefine(define, "1");
+    }
+
+    const int targetIndex = request->addCodeGenTarget(SLANG_HLSL);
+    const int translationUnitIndex =
+        request->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    request->addTranslationUnitSourceString(translationUnitIndex, "main.slang", source);
+    const int entryPointIndex =
+        request->addEntryPoint(translationUnitIndex, "computeMain", SLANG_STAGE_COMPUTE);
+
+    SLANG_RETURN_ON_FAIL(request->compile());
+
+    ComPtr<ISlangBlob> code;
+    SLANG_RETURN_ON_FAIL(
+        request->getEntryPointCodeBlob(entryPointIndex, targetIndex, code.writeRef()));
+    return code && code->getBufferSize() > 0 ? SLANG_OK : SLANG_FAIL;
+}
+
+// Test that a compile request created for a session, and set to restore it, doesn't leave its
+// options on the session, and that modules loaded into the session are reused by each request.
+//
+SLANG_UNIT_TEST(compileRequestRestoresLinkage)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    slang::SessionDesc sessionDesc = {};
+    ComPtr<slang::ISession> session;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+    ComPtr<slang::IBlob> diagnosticBlob;
+    auto module = session->loadModuleFromSourceString(
+        "helper",
+        "helper.slang",
+        kCompileRequestLinkageHelperSource,
+        diagnosticBlob.writeRef());
+    SLANG_CHECK(module != nullptr);
+    SLANG_CHECK(session->getLoadedModuleCount() == 1);
+
+    SLANG_CHECK(
+        _compileWithSession(session, kCompileRequestLinkageFirstSource, "FROM_FIRST_REQUEST") ==
+        SLANG_OK);
+    SLANG_CHECK(
+        _compileWithSession(session, kCompileRequestLinkageSecondSource, nullptr) == SLANG_OK);
+
+    // Both requests imported the module that was already loaded.
+    SLANG_CHECK(session->getLoadedModuleCount() == 1);
+}
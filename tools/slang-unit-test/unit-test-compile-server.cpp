@@ -0,0 +1,163 @@
+// unit-test-compile-server.cpp
+
+#include "../../source/compiler-core/slang-compile-server-protocol.h"
+#include "../../source/compiler-core/slang-json-rpc-connection.h"
+#include "../../source/core/slang-http.h"
+#include "../../source/core/slang-io.h"
+#include "../../source/core/slang-process.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kCompileServerHelperSource = R"(
+    public int helperValue() { return 1234; }
+    )";
+
+static const char* kCompileServerChangedHelperSource = R"(
+    public int helperValue() { return 5678; }
+    )";
+
+static const char* kCompileServerMainSource = R"(
+    import helper;
+
+    RWStructuredBuffer<int> outputBuffer;
+
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = helperValue() + int(tid.x);
+    }
+    )";
+
+static SlangResult _createServerConnection(
+    UnitTestContext* context,
+    RefPtr<JSONRPCConnection>& outConnection)
+{
+    RefPtr<Process> process;
+    {
+        CommandLine cmdLine;
+        cmdLine.setExecutableLocation(ExecutableLocation(context->executableDirectory, "slangc"));
+        cmdLine.addArg("-server");
+        SLANG_RETURN_ON_FAIL(
+            Process::create(cmdLine, Process::Flag::DisableStdErrRedirection, process));
+    }
+
+    Stream* writeStream = process->getStream(StdStreamType::In);
+    RefPtr<BufferedReadStream> readStream(
+        new BufferedReadStream(process->getStream(StdStreamType::Out)));
+    RefPtr<HTTPPacketConnection> connection = new HTTPPacketConnection(readStream, writeStream);
+
+    outConnection = new JSONRPCConnection;
+    return outConnection->init(connection, JSONRPCConnection::CallStyle::Default, process);
+}
+
+static SlangResult _compile(
+    JSONRPCConnection* connection,
+    const String& workingDirectory,
+    const char* fileName,
+    const char* extraArg,
+    CompileServerProtocol::CompileResult& outResult)
+{
+    CompileServerProtocol::CompileArgs args;
+    args.workingDirectory = workingDirectory;
+    args.args.add(fileName);
+    for (auto arg :
+         {"-target", "hlsl", "-entry", "computeMain", "-stage", "compute", "-line-directive-mode",
+          "none"})
+        args.args.add(arg);
+    if (extraArg)
+        args.args.add(extraArg);
+
+    SLANG_RETURN_ON_FAIL(
+        connection->sendCall(CompileServerProtocol::CompileArgs::g_methodName, &args));
+    SLANG_RETURN_ON_FAIL(connection->waitForResult());
+    if (!connection->hasMessage() || connection->getMessageType() != JSONRPCMessageType::Result)
+        return SLANG_FAIL;
+    SLANG_RETURN_ON_FAIL(connection->getMessage(&outResult));
+    return outResult.result;
+}
+
+/// Write `text` to `path`, making sure its modification time changes.
+static SlangResult _rewriteFile(const String& path, const char* text)
+{
+    uint64_t previousTime = 0;
+    SLANG_RETURN_ON_FAIL(File::getModificationTime(path, previousTime));
+    for (int i = 0; i < 200; ++i)
+    {
+        SLANG_RETURN_ON_FAIL(File::writeAllText(path, text));
+        uint64_t time = 0;
+        SLANG_RETURN_ON_FAIL(File::getModificationTime(path, time));
+        if (time != previousTime)
+            return SLANG_OK;
+
+        // The file system doesn't record times this precisely.
+        Process::sleepCurrentThread(10);
+    }
+    return SLANG_FAIL;
+}
+
+static SlangResult _runCompileServerTest(UnitTestContext* context, const String& directory)
+{
+    const String helperPath = Path::combine(directory, "helper.slang");
+    SLANG_RETURN_ON_FAIL(File::writeAllText(helperPath, kCompileServerHelperSource));
+    SLANG_RETURN_ON_FAIL(
+        File::writeAllText(Path::combine(directory, "a.slang"), kCompileServerMainSource));
+    SLANG_RETURN_ON_FAIL(
+        File::writeAllText(Path::combine(directory, "b.slang"), kCompileServerMainSource));
+
+    RefPtr<JSONRPCConnection> connection;
+    SLANG_RETURN_ON_FAIL(_createServerConnection(context, connection));
+
+    CompileServerProtocol::CompileResult first;
+    SLANG_RETURN_ON_FAIL(_compile(connection, directory, "a.slang", nullptr, first));
+    SLANG_CHECK(!first.reusedLinkage);
+    SLANG_CHECK(first.stdOut.indexOf(toSlice("1234")) >= 0);
+
+    // A command line that only differs in its input file reuses the loaded modules.
+    CompileServerProtocol::CompileResult other;
+    SLANG_RETURN_ON_FAIL(_compile(connection, directory, "b.slang", nullptr, other));
+    SLANG_CHECK(other.reusedLinkage);
+    SLANG_CHECK(other.stdOut == first.stdOut);
+
+    // One with different options doesn't.
+    CompileServerProtocol::CompileResult defined;
+    SLANG_RETURN_ON_FAIL(_compile(connection, directory, "a.slang", "-DUNUSED", defined));
+    SLANG_CHECK(!defined.reusedLinkage);
+
+    // Writing the same contents again doesn't make the modules out of date.
+    SLANG_RETURN_ON_FAIL(_rewriteFile(helperPath, kCompileServerHelperSource));
+    CompileServerProtocol::CompileResult same;
+    SLANG_RETURN_ON_FAIL(_compile(connection, directory, "a.slang", nullptr, same));
+    SLANG_CHECK(same.reusedLinkage);
+    SLANG_CHECK(same.stdOut == first.stdOut);
+
+    // Changing an imported file does.
+    SLANG_RETURN_ON_FAIL(_rewriteFile(helperPath, kCompileServerChangedHelperSource));
+    CompileServerProtocol::CompileResult changed;
+    SLANG_RETURN_ON_FAIL(_compile(connection, directory, "a.slang", nullptr, changed));
+    SLANG_CHECK(!changed.reusedLinkage);
+    SLANG_CHECK(changed.stdOut != first.stdOut);
+    SLANG_CHECK(changed.stdOut.indexOf(toSlice("5678")) >= 0);
+
+    // Sends `quit`, and waits for the server to exit.
+    connection->disconnect();
+    return SLANG_OK;
+}
+
+// Test that `slangc -server` reuses the modules loaded by earlier compiles for command lines
+// that load modules the same way, and loads them again when a file they import changes.
+//
+SLANG_UNIT_TEST(compileServer)
+{
+    String directory;
+    SLANG_CHECK_ABORT(
+        SLANG_SUCCEEDED(File::generateTemporary(toSlice("compile-server"), directory)));
+    File::remove(directory);
+    SLANG_CHECK_ABORT(Path::createDirectory(directory));
+
+    SLANG_CHECK(SLANG_SUCCEEDED(_runCompileServerTest(unitTestContext, directory)));
+
+    for (auto name : {"helper.slang", "a.slang", "b.slang"})
+        File::remove(Path::combine(directory, name));
+    Path::remove(directory);
+}
@@ -0,0 +1,99 @@
+// unit-test-deferred-builtin-bodies.cpp
+
+#include "../../source/slang/slang-internal.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+// Uses builtin functions directly, and through forward and backward differentiation, which
+// link the derivative functions of the builtins.
+static const char* kDeferredBuiltinBodiesSource = R"(
+    RWStructuredBuffer<float> outputBuffer;
+
+    [Differentiable]
+    float f(float x)
+    {
+        return sin(x) * exp(x) + pow(x, 3.0) + length(float2(x, 1.0)) + smoothstep(0.0, 1.0, x);
+    }
+
+    [shader("compute")]
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        float x = outputBuffer[tid.x];
+        var dp = diffPair(x, 0.0);
+        bwd_diff(f)(dp, 1.0);
+        outputBuffer[tid.x] = f(x) + fwd_diff(f)(diffPair(x, 1.0)).d + dp.d + clamp(x, 0.0, 1.0);
+    }
+    )";
+
+static const SlangCompileTarget kDeferredBuiltinBodiesTargets[] = {SLANG_HLSL, SLANG_GLSL};
+
+// Generate the code of the test program for every target, with a global session that either
+// defers the function bodies of builtin modules or reads them all up front.
+static SlangResult _compileWithBuiltinBodies(bool deferBodies, List<String>& outCode)
+{
+    SlangGlobalSessionDesc desc = {};
+    GlobalSessionInternalDesc internalDesc = {};
+    internalDesc.deferBuiltinFunctionBodies = deferBodies;
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_RETURN_ON_FAIL(
+        slang_createGlobalSessionImpl(&desc, &internalDesc, globalSession.writeRef()));
+
+    for (auto target : kDeferredBuiltinBodiesTargets)
+    {
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = target;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+        ComPtr<slang::ISession> session;
+        SLANG_RETURN_ON_FAIL(globalSession->createSession(sessionDesc, session.writeRef()));
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "m",
+            "m.slang",
+            kDeferredBuiltinBodiesSource,
+            diagnosticBlob.writeRef());
+        if (!module)
+            return SLANG_FAIL;
+
+        ComPtr<slang::IEntryPoint> entryPoint;
+        SLANG_RETURN_ON_FAIL(module->findEntryPointByName("computeMain", entryPoint.writeRef()));
+
+        slang::IComponentType* components[] = {module, entryPoint};
+        ComPtr<slang::IComponentType> composite;
+        SLANG_RETURN_ON_FAIL(
+            session->createCompositeComponentType(components, 2, composite.writeRef()));
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        SLANG_RETURN_ON_FAIL(composite->link(linkedProgram.writeRef(), diagnosticBlob.writeRef()));
+
+        ComPtr<slang::IBlob> code;
+        SLANG_RETURN_ON_FAIL(
+            linkedProgram->getEntryPointCode(0, 0, code.writeRef(), diagnosticBlob.writeRef()));
+        outCode.add(String(
+            (const char*)code->getBufferPointer(),
+            (const char*)code->getBufferPointer() + code->getBufferSize()));
+    }
+    return SLANG_OK;
+}
+
+// Test that deferring the deserialization of function bodies in builtin modules doesn't
+// change the code generated from them, including for derivatives of builtin functions.
+//
+SLANG_UNIT_TEST(deferredBuiltinFunctionBodies)
+{
+    List<String> eagerCode;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(_compileWithBuiltinBodies(false, eagerCode)));
+
+    List<String> deferredCode;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(_compileWithBuiltinBodies(true, deferredCode)));
+
+    SLANG_CHECK_ABORT(deferredCode.getCount() == eagerCode.getCount());
+    for (Index i = 0; i < eagerCode.getCount(); ++i)
+        SLANG_CHECK(deferredCode[i] == eagerCode[i]);
+}
@@ -0,0 +1,98 @@
+// unit-test-downstream-compile-scheduler.cpp
+
+#include "../../source/compiler-core/slang-downstream-compile-scheduler.h"
+#include "../../source/core/slang-thread-pool.h"
+#include "unit-test/slang-unit-test.h"
+
+#include <chrono>
+
+using namespace Slang;
+
+namespace
+{
+
+// A compiler that is never invoked, only used to identify which compiler a compilation
+// is for.
+class SchedulerTestCompiler : public DownstreamCompilerBase
+{
+public:
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL
+    compile(const CompileOptions& options, IArtifact** outArtifact) SLANG_OVERRIDE
+    {
+        SLANG_UNUSED(options);
+        SLANG_UNUSED(outArtifact);
+        return SLANG_E_NOT_IMPLEMENTED;
+    }
+    virtual SLANG_NO_THROW bool SLANG_MCALL isFileBased() SLANG_OVERRIDE { return false; }
+
+    SchedulerTestCompiler(bool isThreadSafe)
+        : Super(Desc(SLANG_PASS_THROUGH_GENERIC_C_CPP))
+    {
+        if (isThreadSafe)
+            m_desc.flags |= Desc::Flag::ThreadSafe;
+    }
+
+    typedef DownstreamCompilerBase Super;
+};
+
+} // namespace
+
+// Run `compileCount` compilations with `compiler` on `threadCount` threads, and return the
+// most that were running at the same time.
+static Count _runCompilations(
+    DownstreamCompileScheduler& scheduler,
+    IDownstreamCompiler* compiler,
+    Count maxActiveCount,
+    Count threadCount,
+    Count compileCount)
+{
+    std::atomic<Count> activeCount = 0;
+    std::atomic<Count> observedMaxActiveCount = 0;
+
+    RefPtr<ThreadPool> threadPool = new ThreadPool(threadCount);
+    threadPool->parallelFor(
+        compileCount,
+        [&](Index)
+        {
+            DownstreamCompileScheduler::Slot slot(&scheduler, compiler, maxActiveCount);
+
+            const Count count = ++activeCount;
+            Count observed = observedMaxActiveCount;
+            while (count > observed && !observedMaxActiveCount.compare_exchange_weak(observed, count))
+            {
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            --activeCount;
+        });
+    return observedMaxActiveCount;
+}
+
+SLANG_UNIT_TEST(downstreamCompileScheduler)
+{
+    const Count threadCount = 4;
+    const Count compileCount = 32;
+
+    ComPtr<IDownstreamCompiler> threadSafeCompiler(new SchedulerTestCompiler(true));
+    ComPtr<IDownstreamCompiler> serialCompiler(new SchedulerTestCompiler(false));
+
+    DownstreamCompileScheduler scheduler;
+
+    // A compiler that isn't thread safe only runs one compilation at a time.
+    SLANG_CHECK(_runCompilations(scheduler, serialCompiler, 0, threadCount, compileCount) == 1);
+
+    // The limit is respected for thread safe compilers.
+    SLANG_CHECK(
+        _runCompilations(scheduler, threadSafeCompiler, 2, threadCount, compileCount) <= 2);
+    SLANG_CHECK(
+        _runCompilations(scheduler, threadSafeCompiler, 1, threadCount, compileCount) == 1);
+
+    // Without a limit, every thread can be running a compilation.
+    SLANG_CHECK(
+        _runCompilations(scheduler, threadSafeCompiler, 0, threadCount, compileCount) <=
+        threadCount);
+
+    const auto stats = scheduler.getStats();
+    SLANG_CHECK(stats.compileCount == compileCount * 4);
+    SLANG_CHECK(stats.maxActiveCount <= threadCount);
+}
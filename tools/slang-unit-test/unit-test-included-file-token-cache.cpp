@@ -0,0 +1,118 @@
+// unit-test-included-file-token-cache.cpp
+
+#include "../../source/core/slang-io.h"
+#include "../../source/slang/slang-internal.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kIncludedFileTokenCacheSharedSource = R"(
+    int sharedValue() { return 1; }
+    )";
+
+static const char* kIncludedFileTokenCacheChangedSharedSource = R"(
+    int sharedValue() { return 2; }
+    )";
+
+static const char* kIncludedFileTokenCacheMainSource = R"(
+    #include "shared.h"
+
+    int mainValue() { return sharedValue(); }
+    )";
+
+/// Compile `fileNames` from `directory` as translation units of one request for `session`, and
+/// return the diagnostic output, which includes the -report-perf-benchmark result.
+static SlangResult _compileTranslationUnits(
+    slang::ISession* session,
+    const String& directory,
+    const char* const* fileNames,
+    Index fileCount,
+    String& outDiagnostics)
+{
+    ComPtr<slang::ICompileRequest> request;
+    SLANG_RETURN_ON_FAIL(session->createCompileRequest(request.writeRef()));
+    slang_setCompileRequestRestoresLinkage(request);
+
+    const char* args[] = {"-report-perf-benchmark"};
+    SLANG_RETURN_ON_FAIL(request->processCommandLineArguments(args, SLANG_COUNT_OF(args)));
+
+    for (Index i = 0; i < fileCount; ++i)
+    {
+        const int translationUnitIndex =
+            request->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+        const String path = Path::combine(directory, fileNames[i]);
+        request->addTranslationUnitSourceFile(translationUnitIndex, path.getBuffer());
+    }
+
+    SLANG_RETURN_ON_FAIL(request->compile());
+    outDiagnostics = request->getDiagnosticOutput();
+    return SLANG_OK;
+}
+
+/// Returns true if `diagnostics` reports the included file token cache `counts`
+static bool _hasCacheCounts(const String& diagnostics, const char* counts)
+{
+    StringBuilder line;
+    line << "Included File Token Cache: " << counts << "\n";
+    return diagnostics.indexOf(line.getUnownedSlice()) >= 0;
+}
+
+static SlangResult _runIncludedFileTokenCacheTest(const String& directory)
+{
+    const String sharedPath = Path::combine(directory, "shared.h");
+    SLANG_RETURN_ON_FAIL(File::writeAllText(sharedPath, kIncludedFileTokenCacheSharedSource));
+    SLANG_RETURN_ON_FAIL(
+        File::writeAllText(Path::combine(directory, "a.slang"), kIncludedFileTokenCacheMainSource));
+    SLANG_RETURN_ON_FAIL(
+        File::writeAllText(Path::combine(directory, "b.slang"), kIncludedFileTokenCacheMainSource));
+
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_RETURN_ON_FAIL(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()));
+
+    slang::SessionDesc sessionDesc = {};
+    ComPtr<slang::ISession> session;
+    SLANG_RETURN_ON_FAIL(globalSession->createSession(sessionDesc, session.writeRef()));
+
+    // The counts reported are for the linkage of the session, so they add up over the requests.
+    const char* bothNames[] = {"a.slang", "b.slang"};
+    const char* firstName[] = {"a.slang"};
+    const char* secondName[] = {"b.slang"};
+    String diagnostics;
+
+    // The second translation unit replays the tokens the first one lexed.
+    SLANG_RETURN_ON_FAIL(_compileTranslationUnits(session, directory, bothNames, 2, diagnostics));
+    SLANG_CHECK(_hasCacheCounts(diagnostics, "1 replayed, 1 lexed, 0 invalidated"));
+
+    // When the file changes, the next request for the linkage reads it again, and the entry
+    // for its old contents is replaced.
+    SLANG_RETURN_ON_FAIL(
+        File::writeAllText(sharedPath, kIncludedFileTokenCacheChangedSharedSource));
+    SLANG_RETURN_ON_FAIL(_compileTranslationUnits(session, directory, firstName, 1, diagnostics));
+    SLANG_CHECK(_hasCacheCounts(diagnostics, "1 replayed, 2 lexed, 1 invalidated"));
+
+    // Reading the file again with the same contents replays the tokens.
+    SLANG_RETURN_ON_FAIL(_compileTranslationUnits(session, directory, secondName, 1, diagnostics));
+    SLANG_CHECK(_hasCacheCounts(diagnostics, "2 replayed, 2 lexed, 1 invalidated"));
+
+    return SLANG_OK;
+}
+
+// Test that the tokens of a file included by several translation units of a linkage are only
+// lexed once, and are lexed again when the contents of the file change.
+//
+SLANG_UNIT_TEST(includedFileTokenCache)
+{
+    String directory;
+    SLANG_CHECK_ABORT(
+        SLANG_SUCCEEDED(File::generateTemporary(toSlice("included-file-token-cache"), directory)));
+    File::remove(directory);
+    SLANG_CHECK_ABORT(Path::createDirectory(directory));
+
+    SLANG_CHECK(SLANG_SUCCEEDED(_runIncludedFileTokenCacheTest(directory)));
+
+    for (auto name : {"shared.h", "a.slang", "b.slang"})
+        File::remove(Path::combine(directory, name));
+    Path::remove(directory);
+}
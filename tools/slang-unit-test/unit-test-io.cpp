@@ -57,7 +57,55 @@ static SlangResult _checkGenerateTemporary()
     return SLANG_OK;
 }
 
+static bool _isBlobFilledWith(ISlangBlob* blob, size_t size, uint8_t value)
+{
+    if (blob->getBufferSize() != size)
+        return false;
+    auto data = (const uint8_t*)blob->getBufferPointer();
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (data[i] != value)
+            return false;
+    }
+    return true;
+}
+
+static SlangResult _checkMemoryMappedFileBlob()
+{
+    String path;
+    SLANG_RETURN_ON_FAIL(File::generateTemporary(toSlice("slang-check"), path));
+
+    // A small file is copied, so rewriting it in place doesn't change the blob.
+    {
+        List<uint8_t> contents = List<uint8_t>::makeRepeated(1, 1024);
+        SLANG_RETURN_ON_FAIL(File::writeAllBytes(path, contents.getBuffer(), contents.getCount()));
+
+        ComPtr<ISlangBlob> blob;
+        SLANG_RETURN_ON_FAIL(MemoryMappedFileBlob::create(path, blob));
+        SLANG_CHECK(_isBlobFilledWith(blob, 1024, 1));
+
+        contents = List<uint8_t>::makeRepeated(2, 1024);
+        SLANG_RETURN_ON_FAIL(File::writeAllBytes(path, contents.getBuffer(), contents.getCount()));
+        SLANG_CHECK(_isBlobFilledWith(blob, 1024, 1));
+    }
+
+    // A large file is mapped.
+    {
+        const size_t size = MemoryMappedFileBlob::kMinMappedFileSize + 16;
+        List<uint8_t> contents = List<uint8_t>::makeRepeated(3, Index(size));
+        SLANG_RETURN_ON_FAIL(File::writeAllBytes(path, contents.getBuffer(), contents.getCount()));
+
+        ComPtr<ISlangBlob> blob;
+        SLANG_RETURN_ON_FAIL(MemoryMappedFileBlob::create(path, blob));
+        SLANG_CHECK(_isBlobFilledWith(blob, size, 3));
+    }
+
+    SLANG_RETURN_ON_FAIL(File::remove(path));
+    return SLANG_OK;
+}
+
 SLANG_UNIT_TEST(io)
 {
     SLANG_CHECK(SLANG_SUCCEEDED(_checkGenerateTemporary()));
+    SLANG_CHECK(SLANG_SUCCEEDED(_checkMemoryMappedFileBlob()));
 }
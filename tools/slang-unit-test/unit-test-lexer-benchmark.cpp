@@ -0,0 +1,155 @@
+// unit-test-lexer-benchmark.cpp
+
+#include "../../source/compiler-core/slang-lexer.h"
+#include "../../source/compiler-core/slang-name.h"
+#include "../../source/compiler-core/slang-source-loc.h"
+#include "../../source/core/slang-io.h"
+#include "../../tools/platform/performance-counter.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+// Lex the core module sources, which are the largest sources the lexer sees, with and without
+// the fast scanning paths. The tokens have to be the same, and the throughput of each is
+// reported.
+
+namespace
+{
+
+struct LexedToken
+{
+    TokenType type;
+    TokenFlags flags;
+    SourceLoc loc;
+    UnownedStringSlice content;
+};
+
+struct LexerBenchmarkResult
+{
+    List<LexedToken> tokens;
+    double seconds = 0;
+};
+
+} // namespace
+
+static void _lexAll(
+    SourceManager* sourceManager,
+    const List<SourceFile*>& sourceFiles,
+    LexerFlags lexerFlags,
+    int passCount,
+    LexerBenchmarkResult& outResult)
+{
+    DiagnosticSink sink(sourceManager, nullptr);
+    RootNamePool rootPool;
+    NamePool namePool;
+    namePool.setRootNamePool(&rootPool);
+    MemoryArena memory;
+    memory.init(1 << 16);
+
+    auto start = platform::PerformanceCounter::now();
+    for (int pass = 0; pass < passCount; pass++)
+    {
+        for (auto sourceFile : sourceFiles)
+        {
+            SourceView* sourceView =
+                sourceManager->createSourceView(sourceFile, nullptr, SourceLoc());
+
+            Lexer lexer;
+            lexer.initialize(sourceView, &sink, &namePool, &memory);
+            lexer.m_lexerFlags |= lexerFlags;
+
+            for (;;)
+            {
+                Token token = lexer.lexToken();
+                if (pass == 0)
+                {
+                    LexedToken lexedToken;
+                    lexedToken.type = token.type;
+                    lexedToken.flags = token.flags;
+                    lexedToken.loc = token.loc;
+                    lexedToken.content = token.getContent();
+                    outResult.tokens.add(lexedToken);
+                }
+                if (token.type == TokenType::EndOfFile)
+                    break;
+            }
+        }
+    }
+    outResult.seconds = platform::PerformanceCounter::getElapsedTimeInSeconds(start);
+}
+
+static bool _isSameTokens(
+    const List<LexedToken>& a,
+    const List<LexedToken>& b,
+    SourceManager* sourceManager)
+{
+    if (a.getCount() != b.getCount())
+        return false;
+
+    for (Index i = 0; i < a.getCount(); ++i)
+    {
+        const auto& x = a[i];
+        const auto& y = b[i];
+        if (x.type != y.type || x.flags != y.flags || x.content != y.content)
+            return false;
+
+        // Each source view gets its own range of locations, so compare the offsets.
+        auto xView = sourceManager->findSourceView(x.loc);
+        auto yView = sourceManager->findSourceView(y.loc);
+        if (!xView || !yView ||
+            x.loc.getRaw() - xView->getRange().begin.getRaw() !=
+                y.loc.getRaw() - yView->getRange().begin.getRaw())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+SLANG_UNIT_TEST(lexerBenchmark)
+{
+    const char* const paths[] = {
+        "source/slang/core.meta.slang",
+        "source/slang/hlsl.meta.slang",
+        "source/slang/glsl.meta.slang",
+        "source/slang/diff.meta.slang",
+    };
+
+    SourceManager sourceManager;
+    sourceManager.initialize(nullptr, nullptr);
+
+    List<SourceFile*> sourceFiles;
+    size_t totalSize = 0;
+    for (auto path : paths)
+    {
+        String contents;
+        if (SLANG_FAILED(File::readAllText(path, contents)))
+        {
+            // The sources are only available when run from the root of the repository.
+            SLANG_IGNORE_TEST
+        }
+        totalSize += contents.getLength();
+        sourceFiles.add(
+            sourceManager.createSourceFileWithString(PathInfo::makePath(path), contents));
+    }
+
+    const int passCount = 10;
+
+    LexerBenchmarkResult scalarResult;
+    _lexAll(&sourceManager, sourceFiles, kLexerFlag_DisableFastScan, passCount, scalarResult);
+
+    LexerBenchmarkResult fastResult;
+    _lexAll(&sourceManager, sourceFiles, 0, passCount, fastResult);
+
+    SLANG_CHECK(fastResult.tokens.getCount() > 0);
+    SLANG_CHECK(_isSameTokens(fastResult.tokens, scalarResult.tokens, &sourceManager));
+
+    const double megabytes = double(totalSize) * passCount / (1024.0 * 1024.0);
+
+    StringBuilder buf;
+    buf << "lexer: " << megabytes / scalarResult.seconds << " MB/s scalar, "
+        << megabytes / fastResult.seconds << " MB/s fast";
+    getTestReporter()->message(TestMessageType::Info, buf.getBuffer());
+
+    getTestReporter()->addExecutionTime(fastResult.seconds);
+}
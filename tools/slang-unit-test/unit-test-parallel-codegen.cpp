@@ -0,0 +1,157 @@
+// unit-test-parallel-codegen.cpp
+
+#include "../../source/core/slang-string-util.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kParallelCodeGenSource = R"(
+    RWStructuredBuffer<float> outputBuffer;
+
+    float helper(float x)
+    {
+        return x * 2 + 1;
+    }
+
+    [shader("compute")]
+    [numthreads(4, 1, 1)]
+    void main1(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = helper(outputBuffer[tid.x]);
+    }
+
+    [shader("compute")]
+    [numthreads(4, 1, 1)]
+    void main2(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = helper(float(tid.x)) + 2;
+    }
+
+    [shader("compute")]
+    [numthreads(4, 1, 1)]
+    void main3(uint3 tid : SV_DispatchThreadID)
+    {
+        outputBuffer[tid.x] = sin(outputBuffer[tid.x]) + 3;
+    }
+    )";
+
+static const char* const kParallelCodeGenEntryPoints[] = {"main1", "main2", "main3"};
+static const SlangCompileTarget kParallelCodeGenTargets[] = {SLANG_HLSL, SLANG_GLSL};
+
+// Compile all of the entry points for all of the targets, with `-parallel-codegen
+// threadCount` if `threadCount` isn't null, and add the code for each pair to `outCode`.
+// The diagnostic output, which has the -report-perf-benchmark result, is written to
+// `outDiagnostics` if it isn't null.
+static SlangResult _compileAll(
+    slang::IGlobalSession* globalSession,
+    const char* threadCount,
+    List<String>& outCode,
+    String* outDiagnostics = nullptr)
+{
+    slang::SessionDesc sessionDesc = {};
+    ComPtr<slang::ISession> session;
+    SLANG_RETURN_ON_FAIL(globalSession->createSession(sessionDesc, session.writeRef()));
+
+    ComPtr<slang::ICompileRequest> request;
+    SLANG_RETURN_ON_FAIL(session->createCompileRequest(request.writeRef()));
+
+    if (threadCount)
+    {
+        const char* args[] = {"-parallel-codegen", threadCount};
+        SLANG_RETURN_ON_FAIL(request->processCommandLineArguments(args, 2));
+    }
+    if (outDiagnostics)
+    {
+        const char* args[] = {"-report-perf-benchmark"};
+        SLANG_RETURN_ON_FAIL(request->processCommandLineArguments(args, 1));
+    }
+
+    // Every job emits `#line` directives for the same source file.
+    request->setLineDirectiveMode(SLANG_LINE_DIRECTIVE_MODE_STANDARD);
+
+    for (auto target : kParallelCodeGenTargets)
+        request->addCodeGenTarget(target);
+
+    const int translationUnitIndex =
+        request->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    request->addTranslationUnitSourceString(
+        translationUnitIndex,
+        "parallel-codegen.slang",
+        kParallelCodeGenSource);
+    for (auto name : kParallelCodeGenEntryPoints)
+        request->addEntryPoint(translationUnitIndex, name, SLANG_STAGE_COMPUTE);
+
+    SLANG_RETURN_ON_FAIL(request->compile());
+    if (outDiagnostics)
+        *outDiagnostics = request->getDiagnosticOutput();
+
+    for (Index targetIndex = 0; targetIndex < SLANG_COUNT_OF(kParallelCodeGenTargets);
+         ++targetIndex)
+    {
+        for (Index entryPointIndex = 0;
+             entryPointIndex < SLANG_COUNT_OF(kParallelCodeGenEntryPoints);
+             ++entryPointIndex)
+        {
+            ComPtr<ISlangBlob> code;
+            SLANG_RETURN_ON_FAIL(request->getEntryPointCodeBlob(
+                int(entryPointIndex),
+                int(targetIndex),
+                code.writeRef()));
+            outCode.add(String(
+                (const char*)code->getBufferPointer(),
+                (const char*)code->getBufferPointer() + code->getBufferSize()));
+        }
+    }
+    return SLANG_OK;
+}
+
+// Test that generating code for several targets and entry points concurrently, with all of
+// them emitting `#line` directives for the same source file, produces the same code as
+// generating it serially.
+//
+SLANG_UNIT_TEST(parallelCodeGen)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    List<String> serialCode;
+    SLANG_CHECK_ABORT(_compileAll(globalSession, nullptr, serialCode) == SLANG_OK);
+    for (auto& code : serialCode)
+        SLANG_CHECK(code.indexOf(UnownedStringSlice("#line")) >= 0);
+
+    // Run it a few times, as any races depend on how the jobs are scheduled.
+    for (int i = 0; i < 4; ++i)
+    {
+        List<String> parallelCode;
+        SLANG_CHECK_ABORT(_compileAll(globalSession, "4", parallelCode) == SLANG_OK);
+        SLANG_CHECK_ABORT(parallelCode.getCount() == serialCode.getCount());
+        for (Index j = 0; j < serialCode.getCount(); ++j)
+            SLANG_CHECK(parallelCode[j] == serialCode[j]);
+    }
+}
+
+// Test that generating code concurrently only reads the deferred bodies of builtin functions
+// that the entry points use, rather than all of them.
+//
+SLANG_UNIT_TEST(parallelCodeGenDeferredBodies)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    List<String> code;
+    String diagnostics;
+    SLANG_CHECK_ABORT(_compileAll(globalSession, "4", code, &diagnostics) == SLANG_OK);
+
+    const auto output = diagnostics.getUnownedSlice();
+    const auto prefix = toSlice("Lazy IR Bodies Materialized: ");
+    Index pos = output.indexOf(prefix);
+    SLANG_CHECK_ABORT(pos >= 0);
+    pos += prefix.getLength();
+    const int materializedCount = StringUtil::parseIntAndAdvancePos(output, pos);
+    SLANG_CHECK_ABORT(pos < output.getLength() && output[pos] == '/');
+    pos++;
+    const int deferredCount = StringUtil::parseIntAndAdvancePos(output, pos);
+    SLANG_CHECK(materializedCount < deferredCount);
+}
@@ -0,0 +1,48 @@
+// unit-test-perfect-hash.cpp
+
+#include "../../source/compiler-core/slang-perfect-hash.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+SLANG_UNIT_TEST(perfectHash)
+{
+    // Names similar to the overloaded intrinsics in the core module, with enough of them that
+    // the last buckets need many salt tryouts to be placed.
+    List<String> names;
+    for (Index i = 0; i < 2000; ++i)
+    {
+        StringBuilder buf;
+        buf << "intrinsic_" << i;
+        names.add(buf.produceString());
+    }
+
+    HashParams hashParams;
+    SLANG_CHECK(minimalPerfectHash(names, hashParams) == HashFindResult::Success);
+
+    const UInt32 count = UInt32(names.getCount());
+    SLANG_CHECK(hashParams.saltTable.getCount() == Index(count));
+    SLANG_CHECK(hashParams.destTable.getCount() == Index(count));
+
+    // Every name is found with one probe.
+    for (const auto& name : names)
+    {
+        const auto slice = name.getUnownedSlice();
+        const UInt32 salt = hashParams.saltTable[perfectHash(slice, 0, count)];
+        SLANG_CHECK(hashParams.destTable[perfectHash(slice, salt, count)] == name);
+    }
+
+    // A name that isn't in the input leads to a slot holding some other name.
+    {
+        const auto slice = UnownedStringSlice::fromLiteral("notAnIntrinsic");
+        const UInt32 salt = hashParams.saltTable[perfectHash(slice, 0, count)];
+        SLANG_CHECK(hashParams.destTable[perfectHash(slice, salt, count)] != slice);
+    }
+
+    // Bytes that aren't ASCII hash the same whether `char` is signed or not.
+    SLANG_CHECK(perfectHash(UnownedStringSlice("caf\xc3\xa9"), 0, 1000) == 34);
+
+    // Repeated names can't have a perfect hash.
+    names.add(names[0]);
+    SLANG_CHECK(minimalPerfectHash(names, hashParams) == HashFindResult::NonUniqueKeys);
+}
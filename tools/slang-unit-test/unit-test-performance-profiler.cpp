@@ -0,0 +1,108 @@
+// unit-test-performance-profiler.cpp
+
+#include "../../source/core/slang-performance-profiler.h"
+#include "slang-com-ptr.h"
+#include "unit-test/slang-unit-test.h"
+
+#include <thread>
+
+using namespace Slang;
+
+static void _profiledInner()
+{
+    SLANG_PROFILE;
+}
+
+static void _profiledOuter()
+{
+    SLANG_PROFILE;
+    _profiledInner();
+    _profiledInner();
+}
+
+static void _profiledStages()
+{
+    SLANG_PROFILE_STAGES;
+    SLANG_PROFILE_STAGE(firstStage);
+    _profiledInner();
+    SLANG_PROFILE_STAGE(secondStage);
+}
+
+static Index _findFlatEntry(const List<const char*>& names, const char* name)
+{
+    for (Index i = 0; i < names.getCount(); ++i)
+    {
+        if (strcmp(names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+SLANG_UNIT_TEST(performanceProfiler)
+{
+    auto profiler = PerformanceProfiler::getProfiler();
+    profiler->clear();
+
+    _profiledOuter();
+    _profiledStages();
+
+    // Run on another thread as well, recording in this thread's profiler, which is attributed
+    // separately but summed in the flat results.
+    std::thread thread(
+        [profiler]()
+        {
+            PerformanceProfilerThreadRAII profilerScope(profiler);
+            _profiledOuter();
+        });
+    thread.join();
+
+    // A thread that doesn't record in this profiler has its own.
+    std::thread otherThread(
+        [profiler]()
+        {
+            _profiledOuter();
+            SLANG_CHECK(PerformanceProfiler::getProfiler() != profiler);
+        });
+    otherThread.join();
+
+    List<const char*> names;
+    List<FuncProfileInfo> infos;
+    profiler->getFlatResult(names, infos);
+
+    const Index outerIndex = _findFlatEntry(names, "_profiledOuter");
+    const Index innerIndex = _findFlatEntry(names, "_profiledInner");
+    SLANG_CHECK(outerIndex >= 0 && infos[outerIndex].invocationCount == 2);
+    SLANG_CHECK(innerIndex >= 0 && infos[innerIndex].invocationCount == 5);
+    SLANG_CHECK(_findFlatEntry(names, "firstStage") >= 0);
+    SLANG_CHECK(_findFlatEntry(names, "secondStage") >= 0);
+
+    // The call tree shows the inner function nested under both of its callers.
+    StringBuilder result;
+    profiler->getResult(result);
+    SLANG_CHECK(result.indexOf("    _profiledInner") >= 0);
+    SLANG_CHECK(result.indexOf("Thread ") >= 0);
+
+    StringBuilder trace;
+    profiler->getChromeTrace(trace);
+    SLANG_CHECK(trace.indexOf("\"traceEvents\"") >= 0);
+    SLANG_CHECK(trace.indexOf("\"name\":\"_profiledOuter\"") >= 0);
+    SLANG_CHECK(trace.indexOf("\"name\":\"secondStage\"") >= 0);
+
+    // The ISlangProfiler snapshot exposes the same data, and the trace through
+    // ISlangProfilerTrace.
+    ComPtr<ISlangProfiler> slangProfiler(new SlangProfiler(profiler));
+    SLANG_CHECK(slangProfiler->getEntryCount() == (size_t)names.getCount());
+    ComPtr<ISlangProfilerTrace> profilerTrace;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(slangProfiler->queryInterface(
+        ISlangProfilerTrace::getTypeGuid(),
+        (void**)profilerTrace.writeRef())));
+
+    profiler->clear();
+    profiler->getFlatResult(names, infos);
+    SLANG_CHECK(names.getCount() == 0);
+
+    // The trace is only written when asked for, from the events recorded before the clear.
+    ComPtr<ISlangBlob> traceBlob;
+    SLANG_CHECK(SLANG_SUCCEEDED(profilerTrace->getChromeTrace(traceBlob.writeRef())));
+    SLANG_CHECK(traceBlob && traceBlob->getBufferSize() == (size_t)trace.getLength());
+}
@@ -13,6 +13,11 @@
 #include <mutex>
 #include <thread>
 
+#if !SLANG_WINDOWS_FAMILY
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace Slang;
 
 static DefaultRandomGenerator rng(0xdeadbeef);
@@ -80,9 +85,12 @@ struct PersistentCacheTest
 {
     ISlangMutableFileSystem* osFileSystem;
     String cacheDirectory;
+    Count maxEntryCount;
+    uint64_t maxTotalSize;
     RefPtr<PersistentCache> cache;
 
-    PersistentCacheTest(Count maxEntryCount = 0)
+    PersistentCacheTest(Count maxEntryCount = 0, uint64_t maxTotalSize = 0)
+        : maxEntryCount(maxEntryCount), maxTotalSize(maxTotalSize)
     {
         osFileSystem = OSFileSystem::getMutableSingleton();
         cacheDirectory = Path::simplify(
@@ -91,9 +99,18 @@ struct PersistentCacheTest
 
         removeCacheFiles();
 
+        reopenCache();
+    }
+
+    // Destroy the cache and create a new one for the same directory.
+    void reopenCache()
+    {
+        cache = nullptr;
+
         PersistentCache::Desc desc;
         desc.directory = cacheDirectory.getBuffer();
         desc.maxEntryCount = maxEntryCount;
+        desc.maxTotalSize = maxTotalSize;
         cache = new PersistentCache(desc);
     }
 
@@ -155,8 +172,11 @@ struct PersistentCacheTest
     // Get the absolute filename for a cache entry file.
     String getEntryFileName(const Entry& entry) { return cache->getEntryFileName(entry.key); }
 
-    // Get the absolute filename of the cache index file.
-    String getIndexFilename() { return cache->m_indexFileName; }
+    // Get the absolute filename of the cache index file (shard) containing an entry.
+    String getIndexFilename(const Entry& entry) { return cache->getIndexFileName(entry.key); }
+
+    // Get the absolute filename of the cache summary file.
+    String getSummaryFilename() { return cache->getSummaryFileName(); }
 };
 
 } // namespace Slang
@@ -222,11 +242,23 @@ struct BasicTest : public PersistentCacheTest
         SLANG_CHECK(cache->getStats().hitCount == 10);
         SLANG_CHECK(cache->getStats().missCount == 10);
 
+        // Reset stats. Check that the entries are still counted.
+        cache->resetStats();
+        SLANG_CHECK(cache->getStats().entryCount == 10);
+        SLANG_CHECK(cache->getStats().hitCount == 0);
+        SLANG_CHECK(cache->getStats().missCount == 0);
+
+        for (size_t i = 0; i < 10; ++i)
+        {
+            ComPtr<ISlangBlob> data;
+            SLANG_CHECK(cache->readEntry(entries[i].key, data.writeRef()) == SLANG_OK);
+        }
+
         // Clear the cache. Check that entry count is reset.
         SLANG_CHECK(cache->clear() == SLANG_OK);
         SLANG_CHECK(cache->getStats().entryCount == 0);
         SLANG_CHECK(cache->getStats().hitCount == 10);
-        SLANG_CHECK(cache->getStats().missCount == 10);
+        SLANG_CHECK(cache->getStats().missCount == 0);
 
         // Reset stats.
         cache->resetStats();
@@ -303,6 +335,134 @@ struct EvictionTest : public PersistentCacheTest
     }
 };
 
+// Tests the least-recently-used cache eviction policy when limited by total size.
+// Entries are spread over multiple shards, so this also checks that eviction is global.
+struct SizeEvictionTest : public PersistentCacheTest
+{
+    SizeEvictionTest()
+        : PersistentCacheTest(0, 3 * 4096)
+    {
+    }
+
+    void run()
+    {
+        // Setup a list of entries to store in the cache.
+        List<Entry> entries;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto data = createRandomBlob(4096);
+            auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+            entries.add(Entry{key, data});
+        }
+
+        writeEntry(entries[0]);
+        writeEntry(entries[1]);
+        writeEntry(entries[2]);
+        SLANG_CHECK(cache->getStats().entryCount == 3);
+
+        // Evict LRU entry 1.
+        SLANG_CHECK(readEntry(entries[0]) == true);
+        writeEntry(entries[3]);
+        SLANG_CHECK(cache->getStats().entryCount == 3);
+        SLANG_CHECK(readEntry(entries[1]) == false);
+        SLANG_CHECK(readEntry(entries[0]) == true);
+        SLANG_CHECK(readEntry(entries[2]) == true);
+        SLANG_CHECK(readEntry(entries[3]) == true);
+
+        // A large entry evicts multiple smaller ones.
+        auto data = createRandomBlob(2 * 4096);
+        auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+        Entry largeEntry{key, data};
+        writeEntry(largeEntry);
+        SLANG_CHECK(cache->getStats().entryCount == 2);
+        SLANG_CHECK(readEntry(entries[0]) == false);
+        SLANG_CHECK(readEntry(entries[2]) == false);
+        SLANG_CHECK(readEntry(entries[3]) == true);
+        SLANG_CHECK(readEntry(largeEntry) == true);
+    }
+};
+
+// Tests that accesses recorded by reads are kept when the cache is destroyed, as reads don't
+// write to the index themselves.
+struct AccessFlushTest : public PersistentCacheTest
+{
+    AccessFlushTest()
+        : PersistentCacheTest(3)
+    {
+    }
+
+    void run()
+    {
+        List<Entry> entries;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            auto data = createRandomBlob(4096);
+            auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+            entries.add(Entry{key, data});
+        }
+
+        writeEntry(entries[0]);
+        writeEntry(entries[1]);
+        writeEntry(entries[2]);
+        SLANG_CHECK(readEntry(entries[0]) == true);
+
+        // Evict LRU entry 1 from another cache for the same directory.
+        reopenCache();
+        SLANG_CHECK(cache->getStats().entryCount == 3);
+        writeEntry(entries[3]);
+        SLANG_CHECK(cache->getStats().entryCount == 3);
+        SLANG_CHECK(readEntry(entries[1]) == false);
+        SLANG_CHECK(readEntry(entries[0]) == true);
+        SLANG_CHECK(readEntry(entries[2]) == true);
+        SLANG_CHECK(readEntry(entries[3]) == true);
+    }
+};
+
+// Tests that the summary of the shards is rebuilt from the shard indices if it is missing or
+// corrupt.
+struct SummaryTest : public PersistentCacheTest
+{
+    SummaryTest()
+        : PersistentCacheTest(4)
+    {
+    }
+
+    void run()
+    {
+        List<Entry> entries;
+        for (size_t i = 0; i < 5; ++i)
+        {
+            auto data = createRandomBlob(1024);
+            auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+            entries.add(Entry{key, data});
+        }
+        for (Index i = 0; i < 4; ++i)
+            writeEntry(entries[i]);
+
+        osFileSystem->remove(getSummaryFilename().getBuffer());
+        reopenCache();
+        SLANG_CHECK(cache->getStats().entryCount == 4);
+
+        {
+            FileStream fs;
+            fs.init(
+                getSummaryFilename(),
+                FileMode::Open,
+                FileAccess::ReadWrite,
+                FileShare::ReadWrite);
+            fs.write("x", 1);
+        }
+        reopenCache();
+        SLANG_CHECK(cache->getStats().entryCount == 4);
+
+        // The rebuilt summary still finds the LRU entry 0 to evict.
+        writeEntry(entries[4]);
+        SLANG_CHECK(cache->getStats().entryCount == 4);
+        SLANG_CHECK(readEntry(entries[0]) == false);
+        for (Index i = 1; i < 5; ++i)
+            SLANG_CHECK(readEntry(entries[i]) == true);
+    }
+};
 
 // Tests the cache to be robust against various corruptions.
 // These can happen if the cache files are manipulated externally.
@@ -359,20 +519,20 @@ struct CorruptionTest : public PersistentCacheTest
         // Test behavior when the index file is removed before reading.
         writeEntry(entries[0]);
         SLANG_CHECK(readEntry(entries[0]) == true);
-        osFileSystem->remove(getIndexFilename().getBuffer());
+        osFileSystem->remove(getIndexFilename(entries[0]).getBuffer());
         // We expect a SLANG_E_NOT_FOUND because the cache has an empty index now.
         SLANG_CHECK(cache->readEntry(entries[0].key, data.writeRef()) == SLANG_E_NOT_FOUND);
 
         // Test behavior when the index file is removed before writing.
         writeEntry(entries[0]);
         SLANG_CHECK(readEntry(entries[0]) == true);
-        osFileSystem->remove(getIndexFilename().getBuffer());
+        osFileSystem->remove(getIndexFilename(entries[0]).getBuffer());
         writeEntry(entries[1]);
         SLANG_CHECK(readEntry(entries[1]) == true);
 
         // Test different corruptions of the index file.
         testIndexCorruption(
-            [this]() { osFileSystem->remove(getIndexFilename().getBuffer()); },
+            [this]() { osFileSystem->remove(getIndexFilename(entries[0]).getBuffer()); },
             SLANG_E_NOT_FOUND);
 
         testIndexCorruption(
@@ -380,7 +540,7 @@ struct CorruptionTest : public PersistentCacheTest
             {
                 FileStream fs;
                 fs.init(
-                    getIndexFilename(),
+                    getIndexFilename(entries[0]),
                     FileMode::Open,
                     FileAccess::ReadWrite,
                     FileShare::ReadWrite);
@@ -393,7 +553,7 @@ struct CorruptionTest : public PersistentCacheTest
             {
                 FileStream fs;
                 fs.init(
-                    getIndexFilename(),
+                    getIndexFilename(entries[0]),
                     FileMode::Open,
                     FileAccess::ReadWrite,
                     FileShare::ReadWrite);
@@ -408,7 +568,7 @@ struct CorruptionTest : public PersistentCacheTest
             {
                 FileStream fs;
                 fs.init(
-                    getIndexFilename(),
+                    getIndexFilename(entries[0]),
                     FileMode::Open,
                     FileAccess::ReadWrite,
                     FileShare::ReadWrite);
@@ -423,7 +583,7 @@ struct CorruptionTest : public PersistentCacheTest
             {
                 FileStream fs;
                 fs.init(
-                    getIndexFilename(),
+                    getIndexFilename(entries[0]),
                     FileMode::Open,
                     FileAccess::ReadWrite,
                     FileShare::ReadWrite);
@@ -438,7 +598,7 @@ struct CorruptionTest : public PersistentCacheTest
             {
                 FileStream fs;
                 fs.init(
-                    getIndexFilename(),
+                    getIndexFilename(entries[0]),
                     FileMode::Open,
                     FileAccess::ReadWrite,
                     FileShare::ReadWrite);
@@ -449,6 +609,84 @@ struct CorruptionTest : public PersistentCacheTest
     }
 };
 
+#if !SLANG_WINDOWS_FAMILY
+// Tests that a cache in a directory that can't be written to can still be read.
+struct ReadOnlyTest : public PersistentCacheTest
+{
+    // Change the permissions of the cache directory and all files in it.
+    void setCachePermissions(mode_t directoryMode, mode_t fileMode)
+    {
+        struct Visitor : Path::Visitor
+        {
+            const String& directory;
+            mode_t mode;
+
+            Visitor(const String& directory, mode_t mode)
+                : directory(directory), mode(mode)
+            {
+            }
+
+            void accept(Path::Type type, const UnownedStringSlice& fileName) SLANG_OVERRIDE
+            {
+                if (type == Path::Type::File)
+                    ::chmod(Path::simplify(directory + "/" + fileName).getBuffer(), mode);
+            }
+        };
+
+        if (directoryMode & S_IWUSR)
+            ::chmod(cacheDirectory.getBuffer(), directoryMode);
+        Visitor visitor(cacheDirectory, fileMode);
+        Path::find(cacheDirectory, nullptr, &visitor);
+        if (!(directoryMode & S_IWUSR))
+            ::chmod(cacheDirectory.getBuffer(), directoryMode);
+    }
+
+    void run()
+    {
+        List<Entry> entries;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            auto data = createRandomBlob(1024);
+            auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+            entries.add(Entry{key, data});
+        }
+        for (const auto& entry : entries)
+            writeEntry(entry);
+        cache = nullptr;
+
+        setCachePermissions(S_IRUSR | S_IXUSR, S_IRUSR);
+
+        // Permissions don't apply to a privileged user, in which case there is nothing to test.
+        if (::access(cacheDirectory.getBuffer(), W_OK) != 0)
+        {
+            PersistentCache::Desc desc;
+            desc.directory = cacheDirectory.getBuffer();
+            RefPtr<PersistentCache> readOnlyCache = new PersistentCache(desc);
+            SLANG_CHECK(readOnlyCache->getStats().entryCount == entries.getCount());
+
+            for (const auto& entry : entries)
+            {
+                ComPtr<ISlangBlob> data;
+                SLANG_CHECK(readOnlyCache->readEntry(entry.key, data.writeRef()) == SLANG_OK);
+                SLANG_CHECK(data && isBlobEqual(data, entry.data));
+            }
+            SLANG_CHECK(readOnlyCache->getStats().hitCount == entries.getCount());
+            SLANG_CHECK(readOnlyCache->getStats().missCount == 0);
+
+            // Writing fails, and leaves the cache as it was.
+            auto data = createRandomBlob(1024);
+            auto key = SHA1::compute(data->getBufferPointer(), data->getBufferSize());
+            SLANG_CHECK(SLANG_FAILED(readOnlyCache->writeEntry(key, data)));
+            ComPtr<ISlangBlob> readData;
+            SLANG_CHECK(readOnlyCache->readEntry(key, readData.writeRef()) == SLANG_E_NOT_FOUND);
+        }
+
+        // Let the files be removed.
+        setCachePermissions(S_IRWXU, S_IRUSR | S_IWUSR);
+    }
+};
+#endif
+
 #undef ENABLE_LOGGING
 #undef ENABLE_WRITE_TEST
 
@@ -625,12 +863,40 @@ SLANG_UNIT_TEST(persistentCacheEviction)
     test.run();
 }
 
+SLANG_UNIT_TEST(persistentCacheSizeEviction)
+{
+    SizeEvictionTest test;
+    test.run();
+}
+
+SLANG_UNIT_TEST(persistentCacheAccessFlush)
+{
+    AccessFlushTest test;
+    test.run();
+}
+
+SLANG_UNIT_TEST(persistentCacheSummary)
+{
+    SummaryTest test;
+    test.run();
+}
+
 SLANG_UNIT_TEST(persistentCacheCorruption)
 {
     CorruptionTest test;
     test.run();
 }
 
+SLANG_UNIT_TEST(persistentCacheReadOnly)
+{
+#if SLANG_WINDOWS_FAMILY
+    SLANG_IGNORE_TEST
+#else
+    ReadOnlyTest test;
+    test.run();
+#endif
+}
+
 SLANG_UNIT_TEST(persistentCacheStress)
 {
     // aarch64 builds currently fail to run multi-threaded tests within the test-server.
@@ -100,3 +100,362 @@ SLANG_UNIT_TEST(slangVM)
     SLANG_CHECK(returnValSize == sizeof(int));
     SLANG_CHECK(*returnVal == 100);
 }
+
+SLANG_UNIT_TEST(slangVMBatch)
+{
+    // Invocations take different branches and run loops for different counts, so the lanes of
+    // a batch diverge and join again.
+    const char* testSource = R"(
+        [shader("dispatch")]
+        int dispatchMain(uniform int2 v, out int c)
+        {
+            int x = v.x;
+            int result = 0;
+            if (x % 3 == 0)
+                result = x * 2;
+            else
+                result = x - v.y;
+            for (int i = 0; i < x; i++)
+                result += i;
+            c = result;
+            return result + 1;
+        }
+    )";
+
+    ComPtr<slang::IBlob> code;
+    {
+        ComPtr<slang::IGlobalSession> globalSession;
+        SLANG_CHECK(
+            slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_HOST_VM;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "test",
+            "test.slang",
+            testSource,
+            diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(module != nullptr);
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        module->link(linkedProgram.writeRef());
+        SLANG_CHECK_ABORT(linkedProgram != nullptr);
+        linkedProgram->getTargetCode(0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(code && code->getBufferSize() > 0);
+    }
+
+    ComPtr<slang::IByteCodeRunner> runner;
+    slang::ByteCodeRunnerDesc runnerDesc = {};
+    SLANG_CHECK(slang_createByteCodeRunner(&runnerDesc, runner.writeRef()) == SLANG_OK);
+    SLANG_CHECK(runner->loadModule(code) == SLANG_OK);
+    SLANG_CHECK(runner->selectFunctionByIndex(0) == SLANG_OK);
+
+    struct Params
+    {
+        int a;
+        int b;
+        int* result;
+    };
+
+    // More invocations than run in lockstep at once.
+    const int invocationCount = 100;
+    List<Params> params;
+    List<int> results;
+    List<int> returnValues;
+    params.setCount(invocationCount);
+    results.setCount(invocationCount);
+    returnValues.setCount(invocationCount);
+    for (int i = 0; i < invocationCount; i++)
+    {
+        params[i] = {i, 5, &results[i]};
+        results[i] = 0;
+        returnValues[i] = 0;
+    }
+    ComPtr<slang::IByteCodeBatchRunner> batchRunner;
+    SLANG_CHECK_ABORT(
+        runner->queryInterface(
+            slang::IByteCodeBatchRunner::getTypeGuid(),
+            (void**)batchRunner.writeRef()) == SLANG_OK);
+    SLANG_CHECK(
+        batchRunner->executeBatch(
+            params.getBuffer(),
+            sizeof(Params),
+            sizeof(Params),
+            uint32_t(invocationCount),
+            returnValues.getBuffer()) == SLANG_OK);
+
+    for (int i = 0; i < invocationCount; i++)
+    {
+        int expected = i % 3 == 0 ? i * 2 : i - 5;
+        for (int j = 0; j < i; j++)
+            expected += j;
+        SLANG_CHECK(results[i] == expected);
+        SLANG_CHECK(returnValues[i] == expected + 1);
+    }
+}
+
+SLANG_UNIT_TEST(slangVMDispatch)
+{
+    // Groups take different amounts of time, and each writes its own element of the output.
+    const char* testSource = R"(
+        [shader("dispatch")]
+        void dispatchMain(uniform uint3 groupID, uniform int* results)
+        {
+            int index = int((groupID.z * 4 + groupID.y) * 8 + groupID.x);
+            int sum = 0;
+            for (int i = 0; i <= index; i++)
+                sum += i;
+            results[index] = sum;
+        }
+    )";
+
+    ComPtr<slang::IBlob> code;
+    {
+        ComPtr<slang::IGlobalSession> globalSession;
+        SLANG_CHECK(
+            slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_HOST_VM;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "test",
+            "test.slang",
+            testSource,
+            diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(module != nullptr);
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        module->link(linkedProgram.writeRef());
+        SLANG_CHECK_ABORT(linkedProgram != nullptr);
+        linkedProgram->getTargetCode(0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(code && code->getBufferSize() > 0);
+    }
+
+    ComPtr<slang::IByteCodeRunner> runner;
+    slang::ByteCodeRunnerDesc runnerDesc = {};
+    SLANG_CHECK(slang_createByteCodeRunner(&runnerDesc, runner.writeRef()) == SLANG_OK);
+    SLANG_CHECK(runner->loadModule(code) == SLANG_OK);
+    SLANG_CHECK(runner->selectFunctionByIndex(0) == SLANG_OK);
+
+    ComPtr<slang::IByteCodeDispatchRunner> dispatchRunner;
+    SLANG_CHECK_ABORT(
+        runner->queryInterface(
+            slang::IByteCodeDispatchRunner::getTypeGuid(),
+            (void**)dispatchRunner.writeRef()) == SLANG_OK);
+
+    struct Params
+    {
+        uint32_t groupID[3];
+        int* results;
+    };
+
+    const uint32_t groupCount[3] = {8, 4, 2};
+    const int totalGroupCount = 8 * 4 * 2;
+    List<int> results;
+    results.setCount(totalGroupCount);
+
+    // Dispatch on several threads, and then again reusing the same threads.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (auto& result : results)
+            result = -1;
+        Params params = {{0, 0, 0}, results.getBuffer()};
+        SLANG_CHECK(dispatchRunner->dispatch(groupCount, &params, sizeof(params), 4) == SLANG_OK);
+        for (int i = 0; i < totalGroupCount; i++)
+            SLANG_CHECK(results[i] == i * (i + 1) / 2);
+    }
+}
+
+SLANG_UNIT_TEST(slangVMTieredJIT)
+{
+    // `sum` has no calls and is compiled to native code once it ran often enough, while
+    // `dispatchMain` calls it and keeps running in the interpreter. The results must not change
+    // when execution moves to native code, or when slang-llvm isn't available.
+    const char* testSource = R"(
+        int sum(int x, int y)
+        {
+            int result = 0;
+            for (int i = 0; i <= x; i++)
+            {
+                if (i % 3 == 0)
+                    result += i * y;
+                else
+                    result -= i;
+            }
+            return result;
+        }
+        [shader("dispatch")]
+        int dispatchMain(uniform int2 v, out int c)
+        {
+            c = sum(v.x, v.y);
+            return c + 1;
+        }
+    )";
+
+    ComPtr<slang::IBlob> code;
+    {
+        ComPtr<slang::IGlobalSession> globalSession;
+        SLANG_CHECK(
+            slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_HOST_VM;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "test",
+            "test.slang",
+            testSource,
+            diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(module != nullptr);
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        module->link(linkedProgram.writeRef());
+        SLANG_CHECK_ABORT(linkedProgram != nullptr);
+        linkedProgram->getTargetCode(0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(code && code->getBufferSize() > 0);
+    }
+
+    ComPtr<slang::IByteCodeRunner> runner;
+    slang::ByteCodeRunnerDesc runnerDesc = {};
+    runnerDesc.jitInvocationThreshold = 2;
+    SLANG_CHECK(slang_createByteCodeRunner(&runnerDesc, runner.writeRef()) == SLANG_OK);
+    SLANG_CHECK(runner->loadModule(code) == SLANG_OK);
+    const int funcIndex = runner->findFunctionByName("dispatchMain");
+    SLANG_CHECK_ABORT(funcIndex >= 0);
+
+    struct Params
+    {
+        int a;
+        int b;
+        int* result;
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+        int expected = 0;
+        for (int j = 0; j <= i; j++)
+            expected += j % 3 == 0 ? j * 5 : -j;
+
+        int result = 0;
+        Params params = {i, 5, &result};
+        SLANG_CHECK(runner->selectFunctionByIndex(uint32_t(funcIndex)) == SLANG_OK);
+        SLANG_CHECK(runner->execute(&params, sizeof(params)) == SLANG_OK);
+        SLANG_CHECK(result == expected);
+
+        size_t returnValSize = 0;
+        int* returnVal = (int*)runner->getReturnValue(&returnValSize);
+        SLANG_CHECK(returnValSize == sizeof(int));
+        SLANG_CHECK(*returnVal == expected + 1);
+    }
+}
+
+SLANG_UNIT_TEST(slangVMTieredJITOverflow)
+{
+    // `hash` overflows `int` for every input. Signed overflow is undefined in C, so the code
+    // compiled from it must still wrap around the way the interpreter does.
+    const char* testSource = R"(
+        int hash(int x, int y)
+        {
+            int h = x;
+            for (int i = 0; i < 4; i++)
+            {
+                h = h * 16777619 + y;
+                h = -(h << 3) - 2147483647;
+            }
+            return h;
+        }
+        [shader("dispatch")]
+        int dispatchMain(uniform int2 v, out int c)
+        {
+            c = hash(v.x, v.y);
+            return c;
+        }
+    )";
+
+    ComPtr<slang::IBlob> code;
+    {
+        ComPtr<slang::IGlobalSession> globalSession;
+        SLANG_CHECK(
+            slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_HOST_VM;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "test",
+            "test.slang",
+            testSource,
+            diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(module != nullptr);
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        module->link(linkedProgram.writeRef());
+        SLANG_CHECK_ABORT(linkedProgram != nullptr);
+        linkedProgram->getTargetCode(0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(code && code->getBufferSize() > 0);
+    }
+
+    struct Params
+    {
+        int a;
+        int b;
+        int* result;
+    };
+
+    // The first runner only interprets, and the second compiles `hash` after two calls.
+    for (uint32_t threshold : {0u, 2u})
+    {
+        ComPtr<slang::IByteCodeRunner> runner;
+        slang::ByteCodeRunnerDesc runnerDesc = {};
+        runnerDesc.jitInvocationThreshold = threshold;
+        SLANG_CHECK(slang_createByteCodeRunner(&runnerDesc, runner.writeRef()) == SLANG_OK);
+        SLANG_CHECK(runner->loadModule(code) == SLANG_OK);
+        const int funcIndex = runner->findFunctionByName("dispatchMain");
+        SLANG_CHECK_ABORT(funcIndex >= 0);
+
+        for (int i = 0; i < 8; i++)
+        {
+            const int x = i * 123456789;
+            const int y = 2147483647 - i;
+
+            uint32_t expected = uint32_t(x);
+            for (int j = 0; j < 4; j++)
+            {
+                expected = expected * 16777619u + uint32_t(y);
+                expected = 0u - (expected << 3) - 2147483647u;
+            }
+
+            int result = 0;
+            Params params = {x, y, &result};
+            SLANG_CHECK(runner->selectFunctionByIndex(uint32_t(funcIndex)) == SLANG_OK);
+            SLANG_CHECK(runner->execute(&params, sizeof(params)) == SLANG_OK);
+            SLANG_CHECK(uint32_t(result) == expected);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+// unit-test-spirv-emit-deterministic.cpp
+
+#include "../../source/core/slang-string-util.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Slang;
+
+// Check that compiling a kernel with many functions repeatedly produces the same SPIR-V words.
+//
+// This doesn't check the words against known SPIR-V, or measure time or memory. For that,
+// tools/benchmark/spirv-emit.py compiles a larger version of the kernel, measures the time and
+// peak memory of each compile, and with `--reference` checks the output is byte-identical to
+// that of another slangc build.
+
+static String _generateKernelSource(int functionCount)
+{
+    StringBuilder sb;
+    sb << "RWStructuredBuffer<float4> outputBuffer;\n";
+    sb << "struct Data { float4 a; float4 b; int c; };\n";
+    for (int i = 0; i < functionCount; i++)
+    {
+        sb << "float4 f" << i << "(Data d, int n)\n";
+        sb << "{\n";
+        sb << "    float4 r = d.a * " << i << ".5f + d.b;\n";
+        sb << "    for (int j = 0; j < n; j++)\n";
+        sb << "    {\n";
+        sb << "        if ((j & " << (i % 7 + 1) << ") == 0)\n";
+        sb << "            r = sin(r) + cos(d.a * j);\n";
+        sb << "        else\n";
+        sb << "            r = r * d.b + float4(j, d.c, " << i << ", 1);\n";
+        sb << "    }\n";
+        sb << "    return r;\n";
+        sb << "}\n";
+    }
+    sb << "[shader(\"compute\")]\n";
+    sb << "[numthreads(64, 1, 1)]\n";
+    sb << "void main(uint3 tid : SV_DispatchThreadID)\n";
+    sb << "{\n";
+    sb << "    Data d = { outputBuffer[0], outputBuffer[1], int(tid.x) };\n";
+    sb << "    float4 r = 0;\n";
+    for (int i = 0; i < functionCount; i++)
+        sb << "    r += f" << i << "(d, int(tid.x) + " << i << ");\n";
+    sb << "    outputBuffer[tid.x] = r;\n";
+    sb << "}\n";
+    return sb.produceString();
+}
+
+SLANG_UNIT_TEST(spirvEmitDeterministic)
+{
+    String userSource = _generateKernelSource(20);
+
+    ComPtr<slang::IGlobalSession> globalSession;
+    SlangGlobalSessionDesc globalDesc = {};
+    globalDesc.enableGLSL = false;
+    SLANG_CHECK(slang_createGlobalSession2(&globalDesc, globalSession.writeRef()) == SLANG_OK);
+    slang::TargetDesc targetDesc = {};
+    targetDesc.format = SLANG_SPIRV;
+    targetDesc.profile = globalSession->findProfile("spirv_1_5");
+    slang::SessionDesc sessionDesc = {};
+    sessionDesc.targetCount = 1;
+    sessionDesc.targets = &targetDesc;
+
+    ComPtr<slang::IBlob> firstCode;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "m",
+            "m.slang",
+            userSource.getBuffer(),
+            diagnosticBlob.writeRef());
+        SLANG_CHECK(module != nullptr);
+
+        ComPtr<slang::IEntryPoint> entryPoint;
+        SlangResult res = module->findAndCheckEntryPoint(
+            "main",
+            SLANG_STAGE_COMPUTE,
+            entryPoint.writeRef(),
+            diagnosticBlob.writeRef());
+        SLANG_CHECK(res == SLANG_OK);
+
+        slang::IComponentType* componentTypes[2] = {module, entryPoint.get()};
+        ComPtr<slang::IComponentType> composedProgram;
+        session->createCompositeComponentType(
+            componentTypes,
+            2,
+            composedProgram.writeRef(),
+            diagnosticBlob.writeRef());
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        composedProgram->link(linkedProgram.writeRef(), diagnosticBlob.writeRef());
+
+        ComPtr<slang::IBlob> code;
+        res = linkedProgram->getEntryPointCode(0, 0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK(res == SLANG_OK);
+        SLANG_CHECK(code && code->getBufferSize() > 5 * sizeof(uint32_t));
+
+        // The module should start with the SPIR-V magic number.
+        SLANG_CHECK(*(const uint32_t*)code->getBufferPointer() == 0x07230203);
+
+        // Emission has to be deterministic.
+        if (!firstCode)
+        {
+            firstCode = code;
+        }
+        else
+        {
+            SLANG_CHECK(code->getBufferSize() == firstCode->getBufferSize());
+            SLANG_CHECK(
+                memcmp(
+                    code->getBufferPointer(),
+                    firstCode->getBufferPointer(),
+                    code->getBufferSize()) == 0);
+        }
+    }
+}
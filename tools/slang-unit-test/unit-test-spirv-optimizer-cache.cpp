@@ -0,0 +1,140 @@
+// unit-test-spirv-optimizer-cache.cpp
+
+#include "../../source/core/slang-string-util.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+static const char* kSPIRVOptimizerCacheTestSource = R"(
+    RWStructuredBuffer<float> outputBuffer;
+
+    float square(float x) { return x * x; }
+
+    [shader("compute")]
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        float sum = 0;
+        for (int i = 0; i < 4; i++)
+            sum += square(outputBuffer[tid.x + i]);
+        outputBuffer[tid.x] = sum;
+    }
+    )";
+
+static ComPtr<slang::IBlob> _compileWithSPIRVOptimizerCache(
+    slang::IGlobalSession* globalSession,
+    bool enableCache)
+{
+    slang::TargetDesc targetDesc = {};
+    targetDesc.format = SLANG_SPIRV;
+    targetDesc.profile = globalSession->findProfile("spirv_1_5");
+
+    slang::CompilerOptionEntry option;
+    option.name = slang::CompilerOptionName::SPIRVOptimizerCache;
+    option.value.kind = slang::CompilerOptionValueKind::Int;
+    option.value.intValue0 = enableCache ? 1 : 0;
+
+    slang::SessionDesc sessionDesc = {};
+    sessionDesc.targetCount = 1;
+    sessionDesc.targets = &targetDesc;
+    sessionDesc.compilerOptionEntryCount = 1;
+    sessionDesc.compilerOptionEntries = &option;
+
+    ComPtr<slang::ISession> session;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+    ComPtr<slang::IBlob> diagnosticBlob;
+    auto module = session->loadModuleFromSourceString(
+        "m",
+        "m.slang",
+        kSPIRVOptimizerCacheTestSource,
+        diagnosticBlob.writeRef());
+    SLANG_CHECK(module != nullptr);
+
+    ComPtr<slang::IEntryPoint> entryPoint;
+    module->findEntryPointByName("computeMain", entryPoint.writeRef());
+    SLANG_CHECK(entryPoint != nullptr);
+
+    slang::IComponentType* components[] = {module, entryPoint};
+    ComPtr<slang::IComponentType> composite;
+    session->createCompositeComponentType(components, 2, composite.writeRef());
+
+    ComPtr<slang::IComponentType> linkedProgram;
+    composite->link(linkedProgram.writeRef(), diagnosticBlob.writeRef());
+    SLANG_CHECK(linkedProgram != nullptr);
+
+    ComPtr<slang::IBlob> code;
+    SLANG_CHECK(
+        linkedProgram->getEntryPointCode(0, 0, code.writeRef(), diagnosticBlob.writeRef()) ==
+        SLANG_OK);
+    SLANG_CHECK(code != nullptr);
+    return code;
+}
+
+// Compile the test program with the SPIR-V optimizer cache, and return the number of cache
+// hits in the global session that the compile reports, or -1 if it fails.
+static int _compileAndGetSPIRVOptimizerCacheHitCount(slang::IGlobalSession* globalSession)
+{
+    slang::SessionDesc sessionDesc = {};
+    ComPtr<slang::ISession> session;
+    if (SLANG_FAILED(globalSession->createSession(sessionDesc, session.writeRef())))
+        return -1;
+
+    ComPtr<slang::ICompileRequest> request;
+    if (SLANG_FAILED(session->createCompileRequest(request.writeRef())))
+        return -1;
+
+    const char* args[] =
+        {"-target", "spirv", "-profile", "spirv_1_5", "-spirv-opt-cache", "-report-perf-benchmark"};
+    if (SLANG_FAILED(request->processCommandLineArguments(args, SLANG_COUNT_OF(args))))
+        return -1;
+
+    const int translationUnitIndex =
+        request->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    request->addTranslationUnitSourceString(
+        translationUnitIndex,
+        "m.slang",
+        kSPIRVOptimizerCacheTestSource);
+    request->addEntryPoint(translationUnitIndex, "computeMain", SLANG_STAGE_COMPUTE);
+    if (SLANG_FAILED(request->compile()))
+        return -1;
+
+    const auto output = UnownedStringSlice(request->getDiagnosticOutput());
+    const auto prefix = toSlice("SPIR-V Optimizer Cache Hits: ");
+    Index pos = output.indexOf(prefix);
+    if (pos < 0)
+        return -1;
+    pos += prefix.getLength();
+    return StringUtil::parseIntAndAdvancePos(output, pos);
+}
+
+static bool _isSameBlob(slang::IBlob* a, slang::IBlob* b)
+{
+    return a->getBufferSize() == b->getBufferSize() &&
+           ::memcmp(a->getBufferPointer(), b->getBufferPointer(), a->getBufferSize()) == 0;
+}
+
+// Test that SPIR-V optimized by one session and reused from the optimizer cache by
+// another session is the same as the SPIR-V produced without the cache.
+//
+SLANG_UNIT_TEST(spirvOptimizerCache)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    auto uncachedCode = _compileWithSPIRVOptimizerCache(globalSession, false);
+    auto firstCode = _compileWithSPIRVOptimizerCache(globalSession, true);
+    auto secondCode = _compileWithSPIRVOptimizerCache(globalSession, true);
+
+    SLANG_CHECK(_isSameBlob(firstCode, uncachedCode));
+    SLANG_CHECK(_isSameBlob(secondCode, uncachedCode));
+
+    // The code is the same either way, so also check that the second compile of the same
+    // program is a hit, as reported by -report-perf-benchmark.
+    const int firstHitCount = _compileAndGetSPIRVOptimizerCacheHitCount(globalSession);
+    const int secondHitCount = _compileAndGetSPIRVOptimizerCacheHitCount(globalSession);
+    SLANG_CHECK(firstHitCount >= 0);
+    SLANG_CHECK(secondHitCount == firstHitCount + 1);
+}
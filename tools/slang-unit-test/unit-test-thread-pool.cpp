@@ -0,0 +1,40 @@
+// unit-test-thread-pool.cpp
+
+#include "../../source/core/slang-list.h"
+#include "../../source/core/slang-thread-pool.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+SLANG_UNIT_TEST(threadPool)
+{
+    for (Count threadCount : {1, 2, 4, 7})
+    {
+        RefPtr<ThreadPool> threadPool = new ThreadPool(threadCount);
+        SLANG_CHECK(threadPool->getThreadCount() == threadCount);
+
+        // Run a few batches, to check that the pool can be reused.
+        for (Index batch = 0; batch < 16; ++batch)
+        {
+            const Index count = batch * 37;
+
+            List<int> visitCounts;
+            visitCounts.setCount(count);
+            for (auto& visitCount : visitCounts)
+                visitCount = 0;
+
+            std::atomic<Index> total = 0;
+            threadPool->parallelFor(
+                count,
+                [&](Index index)
+                {
+                    visitCounts[index]++;
+                    total += index;
+                });
+
+            // Every index should have been run exactly once.
+            SLANG_CHECK(total == (count * (count - 1)) / 2);
+            SLANG_CHECK(visitCounts.findFirstIndex([](int c) { return c != 1; }) == -1);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// unit-test-type-checking-cache.cpp
+
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+#include <thread>
+
+using namespace Slang;
+
+static const char* kTypeCheckingCacheSource = R"(
+    RWStructuredBuffer<float4> outputBuffer;
+
+    [numthreads(4, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID)
+    {
+        float4 v = outputBuffer[tid.x];
+        float s = dot(v, v) + max(v.x, 1.0) + float(tid.x) * 2;
+        int i = max(int(tid.x), 2) + min(int(tid.y), 3);
+        outputBuffer[tid.x] = lerp(v, float4(s), 0.5) + float4(i);
+    }
+    )";
+
+static SlangResult _loadModule(slang::ISession* session, const char* moduleName)
+{
+    ComPtr<slang::IBlob> diagnosticBlob;
+    auto module = session->loadModuleFromSourceString(
+        moduleName,
+        "type-checking-cache.slang",
+        kTypeCheckingCacheSource,
+        diagnosticBlob.writeRef());
+    return module ? SLANG_OK : SLANG_FAIL;
+}
+
+// Test that sessions of one global session can check code with entries that the type checking
+// cache staged in another session, both while that session is alive and after it is destroyed.
+//
+SLANG_UNIT_TEST(typeCheckingCacheShared)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    slang::SessionDesc sessionDesc = {};
+
+    ComPtr<slang::ISession> first;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, first.writeRef()) == SLANG_OK);
+    SLANG_CHECK(_loadModule(first, "first") == SLANG_OK);
+
+    ComPtr<slang::ISession> second;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, second.writeRef()) == SLANG_OK);
+    SLANG_CHECK(_loadModule(second, "second") == SLANG_OK);
+
+    // Destroying the first session merges its entries into the shared entries.
+    first = nullptr;
+
+    ComPtr<slang::ISession> third;
+    SLANG_CHECK(globalSession->createSession(sessionDesc, third.writeRef()) == SLANG_OK);
+    SLANG_CHECK(_loadModule(third, "third") == SLANG_OK);
+    SLANG_CHECK(_loadModule(second, "secondAgain") == SLANG_OK);
+}
+
+// Test that sessions of one global session can check code on several threads at once, while
+// their type checking caches merge entries into, and look entries up in, the shared entries.
+//
+SLANG_UNIT_TEST(typeCheckingCacheSharedMultithreaded)
+{
+    ComPtr<slang::IGlobalSession> globalSession;
+    SLANG_CHECK(slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+
+    const int kThreadCount = 4;
+    const int kSessionCount = 8;
+
+    SlangResult results[kThreadCount];
+    std::thread threads[kThreadCount];
+    for (int threadIndex = 0; threadIndex < kThreadCount; ++threadIndex)
+    {
+        results[threadIndex] = SLANG_OK;
+        threads[threadIndex] = std::thread(
+            [&globalSession, &results, threadIndex]()
+            {
+                // Each session is destroyed before the next is created, merging its entries
+                // while the sessions on other threads are looking entries up.
+                for (int i = 0; i < kSessionCount && SLANG_SUCCEEDED(results[threadIndex]); ++i)
+                {
+                    slang::SessionDesc sessionDesc = {};
+                    ComPtr<slang::ISession> session;
+                    results[threadIndex] =
+                        globalSession->createSession(sessionDesc, session.writeRef());
+                    if (SLANG_FAILED(results[threadIndex]))
+                        break;
+
+                    StringBuilder moduleName;
+                    moduleName << "module" << threadIndex << "_" << i;
+                    results[threadIndex] = _loadModule(session, moduleName.getBuffer());
+                }
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto result : results)
+        SLANG_CHECK(result == SLANG_OK);
+}
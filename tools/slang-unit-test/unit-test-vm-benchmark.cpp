@@ -0,0 +1,145 @@
+// unit-test-vm-benchmark.cpp
+
+#include "../../tools/platform/performance-counter.h"
+#include "slang-com-ptr.h"
+#include "slang.h"
+#include "unit-test/slang-unit-test.h"
+
+using namespace Slang;
+
+// Run a kernel with loops, arithmetic and array accesses on the byte code VM, with and without
+// the optimizations applied when a module is loaded. The results have to be the same, and the
+// time taken by each is reported.
+//
+// This is a unit test, like the compile benchmark, rather than part of tools/benchmark, as the
+// scripts there time slangc, which can't run byte code.
+
+static const char* kVMBenchmarkSource = R"(
+    [shader("dispatch")]
+    int dispatchMain(uniform int2 v, out int c)
+    {
+        int values[64];
+        for (int i = 0; i < 64; i++)
+            values[i] = (i * v.y) & 255;
+
+        int sum = 0;
+        for (int iter = 0; iter < v.x; iter++)
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                sum += values[i] * 3 - (i & 7);
+                values[i] = (values[i] + iter) & 1023;
+            }
+        }
+        c = sum;
+        return sum;
+    }
+)";
+
+static int _runVMBenchmarkReference(int iterationCount, int seed)
+{
+    int values[64];
+    for (int i = 0; i < 64; i++)
+        values[i] = (i * seed) & 255;
+
+    int sum = 0;
+    for (int iter = 0; iter < iterationCount; iter++)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            sum += values[i] * 3 - (i & 7);
+            values[i] = (values[i] + iter) & 1023;
+        }
+    }
+    return sum;
+}
+
+static SlangResult _runVMBenchmark(
+    slang::IBlob* code,
+    bool enableOptimizations,
+    int iterationCount,
+    int seed,
+    int& outResult,
+    double& outSeconds)
+{
+    ComPtr<slang::IByteCodeRunner> runner;
+    slang::ByteCodeRunnerDesc runnerDesc = {};
+    runnerDesc.enableOptimizations = enableOptimizations;
+    SLANG_RETURN_ON_FAIL(slang_createByteCodeRunner(&runnerDesc, runner.writeRef()));
+    SLANG_RETURN_ON_FAIL(runner->loadModule(code));
+
+    const int funcIndex = runner->findFunctionByName("dispatchMain");
+    if (funcIndex < 0)
+        return SLANG_FAIL;
+    SLANG_RETURN_ON_FAIL(runner->selectFunctionByIndex(uint32_t(funcIndex)));
+
+    struct Params
+    {
+        int iterationCount;
+        int seed;
+        int* result;
+    };
+    Params params = {iterationCount, seed, &outResult};
+
+    auto start = platform::PerformanceCounter::now();
+    SLANG_RETURN_ON_FAIL(runner->execute(&params, sizeof(params)));
+    outSeconds = platform::PerformanceCounter::getElapsedTimeInSeconds(start);
+    return SLANG_OK;
+}
+
+SLANG_UNIT_TEST(vmBenchmark)
+{
+    ComPtr<slang::IBlob> code;
+    {
+        ComPtr<slang::IGlobalSession> globalSession;
+        SLANG_CHECK(
+            slang_createGlobalSession(SLANG_API_VERSION, globalSession.writeRef()) == SLANG_OK);
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_HOST_VM;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targetCount = 1;
+        sessionDesc.targets = &targetDesc;
+
+        ComPtr<slang::ISession> session;
+        SLANG_CHECK(globalSession->createSession(sessionDesc, session.writeRef()) == SLANG_OK);
+
+        ComPtr<slang::IBlob> diagnosticBlob;
+        auto module = session->loadModuleFromSourceString(
+            "vmBenchmark",
+            "vm-benchmark.slang",
+            kVMBenchmarkSource,
+            diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(module != nullptr);
+
+        ComPtr<slang::IComponentType> linkedProgram;
+        module->link(linkedProgram.writeRef());
+        SLANG_CHECK_ABORT(linkedProgram != nullptr);
+        linkedProgram->getTargetCode(0, code.writeRef(), diagnosticBlob.writeRef());
+        SLANG_CHECK_ABORT(code && code->getBufferSize() > 0);
+    }
+
+    const int iterationCount = 2000;
+    const int seed = 7;
+    const int expected = _runVMBenchmarkReference(iterationCount, seed);
+
+    int baselineResult = 0;
+    double baselineSeconds = 0;
+    SLANG_CHECK(
+        _runVMBenchmark(code, false, iterationCount, seed, baselineResult, baselineSeconds) ==
+        SLANG_OK);
+    SLANG_CHECK(baselineResult == expected);
+
+    int optimizedResult = 0;
+    double optimizedSeconds = 0;
+    SLANG_CHECK(
+        _runVMBenchmark(code, true, iterationCount, seed, optimizedResult, optimizedSeconds) ==
+        SLANG_OK);
+    SLANG_CHECK(optimizedResult == expected);
+
+    StringBuilder buf;
+    buf << "vm: " << baselineSeconds * 1000.0 << " ms unoptimized, " << optimizedSeconds * 1000.0
+        << " ms optimized";
+    getTestReporter()->message(TestMessageType::Info, buf.getBuffer());
+
+    getTestReporter()->addExecutionTime(optimizedSeconds);
+}